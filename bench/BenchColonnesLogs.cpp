@@ -0,0 +1,167 @@
+/// Banc d'essai des colonnes de logs: requêtes d'AnalyseurLogs par noyaux vectorisés contre un parcours des LigneLog.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "Horodatage.h"
+#include "NoyauxColonnes.h"
+
+namespace
+{
+    constexpr std::size_t nombreFilms = 20000;
+    constexpr std::size_t nombreUtilisateurs = 10000;
+    constexpr std::size_t nombreLignes = 1 << 22;
+    constexpr std::int64_t debutTimestamps = 1514764800; // 2018-01-01T00:00:00Z
+
+    /// Mesure la meilleure de cinq exécutions d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        double meilleur = 0.0;
+        for (int essai = 0; essai < 5; essai++)
+        {
+            auto debut = std::chrono::steady_clock::now();
+            fonction();
+            double duree = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+            meilleur = essai == 0 ? duree : std::min(meilleur, duree);
+        }
+        return meilleur;
+    }
+
+    void afficher(const std::string& requete, double dureeLignes, double dureeColonnes, bool identiques)
+    {
+        std::cout << std::left << std::setw(42) << requete << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << dureeLignes << std::setw(14) << dureeColonnes << std::setw(10)
+                  << dureeLignes / dureeColonnes << (identiques ? "" : "  (résultats différents)") << '\n';
+    }
+} // namespace
+
+int main()
+{
+    GestionnaireFilms gestionnaireFilms;
+    for (std::size_t i = 0; i < nombreFilms; i++)
+    {
+        gestionnaireFilms.ajouterFilm(
+            Film{"Film " + std::to_string(i), Film::Genre::Action, Pays::Canada, "Réalisateur", 2000});
+    }
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    for (std::size_t i = 0; i < nombreUtilisateurs; i++)
+    {
+        gestionnaireUtilisateurs.ajouterUtilisateur(
+            Utilisateur{"utilisateur" + std::to_string(i), "Prénom Nom", static_cast<int>(i % 100), Pays::Canada});
+    }
+    std::vector<const Film*> films = gestionnaireFilms.getFilms();
+    std::vector<const Utilisateur*> utilisateurs;
+    for (std::size_t i = 0; i < nombreUtilisateurs; i++)
+    {
+        utilisateurs.push_back(gestionnaireUtilisateurs.getUtilisateurParId("utilisateur" + std::to_string(i)));
+    }
+
+    // Popularité des films biaisée vers les petits index, utilisateurs uniformes, un an de timestamps
+    std::vector<LigneLog> lignesLog;
+    lignesLog.reserve(nombreLignes);
+    std::uint32_t etat = 12345;
+    for (std::size_t i = 0; i < nombreLignes; i++)
+    {
+        etat = etat * 1664525u + 1013904223u;
+        std::size_t film = (static_cast<std::size_t>(etat >> 8) % nombreFilms) * ((etat >> 4) % 4 + 1) / 4;
+        lignesLog.push_back(LigneLog{formaterTimestamp(debutTimestamps + static_cast<std::int64_t>(etat % 31536000)),
+                                     utilisateurs[(etat >> 12) % nombreUtilisateurs],
+                                     films[film]});
+    }
+    AnalyseurLogs analyseurLogs;
+    analyseurLogs.ajouterLignesLog(lignesLog);
+
+    const Utilisateur* utilisateur = utilisateurs[42];
+    const Film* film = films[0];
+    std::vector<const Utilisateur*> audience(utilisateurs.begin(), utilisateurs.begin() + nombreUtilisateurs / 10);
+    const std::string debut = "2018-03-01T00:00:00Z";
+    const std::string fin = "2018-06-01T00:00:00Z";
+
+    std::cout << "Noyaux: " << NoyauxColonnes::getJeuInstructions() << ", " << nombreLignes << " lignes\n"
+              << std::left << std::setw(42) << "requete" << std::right << std::setw(14) << "lignes (ms)"
+              << std::setw(14) << "colonnes (ms)" << std::setw(10) << "accel." << '\n';
+
+    int vuesLignes = 0;
+    int vuesColonnes = 0;
+    double dureeLignes = mesurer([&] {
+        vuesLignes = static_cast<int>(std::count_if(lignesLog.begin(), lignesLog.end(), [utilisateur](const LigneLog& l) {
+            return l.utilisateur == utilisateur;
+        }));
+    });
+    double dureeColonnes = mesurer([&] { vuesColonnes = analyseurLogs.getNombreVuesPourUtilisateur(utilisateur); });
+    afficher("getNombreVuesPourUtilisateur", dureeLignes, dureeColonnes, vuesLignes == vuesColonnes);
+
+    dureeLignes = mesurer([&] {
+        vuesLignes = static_cast<int>(std::count_if(lignesLog.begin(), lignesLog.end(), [&](const LigneLog& l) {
+            return l.film == film && l.timestamp >= debut && l.timestamp < fin;
+        }));
+    });
+    dureeColonnes = mesurer([&] { vuesColonnes = analyseurLogs.getNombreVuesFilmEntre(film, debut, fin); });
+    afficher("getNombreVuesFilmEntre", dureeLignes, dureeColonnes, vuesLignes == vuesColonnes);
+
+    std::vector<const Film*> filmsLignes;
+    std::vector<const Film*> filmsColonnes;
+    dureeLignes = mesurer([&] {
+        std::unordered_set<const Film*> filmsVus;
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            if (ligneLog.utilisateur == utilisateur)
+            {
+                filmsVus.insert(ligneLog.film);
+            }
+        }
+        filmsLignes.assign(filmsVus.begin(), filmsVus.end());
+    });
+    dureeColonnes = mesurer([&] { filmsColonnes = analyseurLogs.getFilmsVusParUtilisateur(utilisateur); });
+    std::sort(filmsLignes.begin(), filmsLignes.end());
+    std::sort(filmsColonnes.begin(), filmsColonnes.end());
+    afficher("getFilmsVusParUtilisateur", dureeLignes, dureeColonnes, filmsLignes == filmsColonnes);
+
+    std::unordered_set<const Utilisateur*> ensemble(audience.begin(), audience.end());
+    dureeLignes = mesurer([&] {
+        vuesLignes = static_cast<int>(std::count_if(lignesLog.begin(), lignesLog.end(), [&](const LigneLog& l) {
+            return ensemble.count(l.utilisateur) != 0;
+        }));
+    });
+    dureeColonnes = mesurer([&] { vuesColonnes = analyseurLogs.getNombreVuesPourUtilisateurs(audience); });
+    afficher("getNombreVuesPourUtilisateurs (10 %)", dureeLignes, dureeColonnes, vuesLignes == vuesColonnes);
+
+    std::vector<std::pair<const Film*, int>> meilleursLignes;
+    std::vector<std::pair<const Film*, int>> meilleursColonnes;
+    auto aPlusDeVues = [](const auto& film1, const auto& film2) { return film1.second > film2.second; };
+    dureeLignes = mesurer([&] {
+        std::unordered_map<const Film*, int> vues;
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            if (ensemble.count(ligneLog.utilisateur) != 0)
+            {
+                vues[ligneLog.film]++;
+            }
+        }
+        meilleursLignes.resize(std::min<std::size_t>(vues.size(), 10));
+        std::partial_sort_copy(vues.begin(), vues.end(), meilleursLignes.begin(), meilleursLignes.end(), aPlusDeVues);
+    });
+    dureeColonnes = mesurer([&] { meilleursColonnes = analyseurLogs.getNFilmsPlusPopulairesPourUtilisateurs(10, audience); });
+    bool memesVues = meilleursLignes.size() == meilleursColonnes.size() &&
+                     std::equal(meilleursLignes.begin(), meilleursLignes.end(), meilleursColonnes.begin(),
+                                [](const auto& film1, const auto& film2) { return film1.second == film2.second; });
+    afficher("getNFilmsPlusPopulairesPourUtilisateurs", dureeLignes, dureeColonnes, memesVues);
+
+    UtilisationMemoire utilisationMemoire = analyseurLogs.getUtilisationMemoire();
+    std::cout << "Octets par ligne: logs_ " << std::setprecision(1)
+              << static_cast<double>(utilisationMemoire.getOctets("logs_") + utilisationMemoire.getOctets("logs_.timestamp")) /
+                     nombreLignes
+              << ", colonnes_ " << static_cast<double>(utilisationMemoire.getOctets("colonnes_")) / nombreLignes << '\n';
+}
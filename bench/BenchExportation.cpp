@@ -0,0 +1,122 @@
+/// Banc d'essai de l'export: débit de l'exportation en CSV, JSON et NDJSON, comparé à l'écriture champ par champ
+/// dans un std::ostream.
+///
+/// Usage: BenchExportation [echelle]
+///   echelle   Nombre de films et d'utilisateurs générés, avec 10 lignes de log par film (défaut: 100000)
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "AnalyseurLogs.h"
+#include "Exportation.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+
+namespace
+{
+    /// Mesure une exécution d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        auto debut = std::chrono::steady_clock::now();
+        fonction();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+    }
+
+    /// Affiche une ligne de résultat.
+    /// \param nom          Le nom de la mesure.
+    /// \param duree        La durée en millisecondes.
+    /// \param octets       Le nombre d'octets écrits.
+    /// \param ecritures    Le nombre d'appels système d'écriture, ou 0 s'il n'est pas connu.
+    void afficher(const std::string& nom, double duree, std::uintmax_t octets, std::size_t ecritures)
+    {
+        std::cout << "  " << std::left << std::setw(40) << nom << std::right << std::setw(10) << duree << std::setw(10)
+                  << static_cast<double>(octets) / 1e6 / (duree / 1000) << std::setw(10) << ecritures << '\n';
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t echelle = argc > 1 ? std::stoul(argv[1]) : 100000;
+    OptionsGenerateur options;
+    options.graine = echelle;
+    options.nombreFilms = echelle;
+    options.nombreUtilisateurs = echelle;
+    options.nombreLignesLog = echelle * 10;
+    GenerateurDonnees generateur(options);
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench_exportation";
+    std::filesystem::remove_all(dossier);
+    std::filesystem::create_directories(dossier);
+    {
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    AnalyseurLogs analyseurLogs;
+    gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string());
+    gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+    analyseurLogs.chargerDepuisFichier((dossier / "logs.txt").string(), gestionnaireUtilisateurs, gestionnaireFilms);
+
+    std::filesystem::path sortie = dossier / "export";
+    std::cout << std::fixed << std::setprecision(1) << gestionnaireFilms.getNombreFilms() << " films, "
+              << gestionnaireUtilisateurs.getNombreUtilisateurs() << " utilisateurs, "
+              << analyseurLogs.getLogs().size() << " lignes de log\n\n"
+              << "  " << std::left << std::setw(40) << "export" << std::right << std::setw(10) << "ms" << std::setw(10)
+              << "Mo/s" << std::setw(10) << "write" << '\n';
+
+    double duree = mesurer([&] {
+        std::ofstream fichier(sortie);
+        fichier << gestionnaireFilms;
+    });
+    afficher("films, operator<<", duree, std::filesystem::file_size(sortie), 0);
+    duree = mesurer([&] {
+        std::ofstream fichier(sortie);
+        for (const LigneLog& ligneLog : analyseurLogs.getLogs())
+        {
+            fichier << ligneLog.timestamp << ',' << ligneLog.utilisateur->id << ',' << ligneLog.film->nom << '\n';
+        }
+    });
+    afficher("logs, std::ostream champ par champ", duree, std::filesystem::file_size(sortie), 0);
+
+    struct Format
+    {
+        const char* nom;
+        FormatExport format;
+    };
+    for (const Format& format : {Format{"CSV", FormatExport::Csv},
+                                 Format{"JSON", FormatExport::Json},
+                                 Format{"NDJSON", FormatExport::Ndjson}})
+    {
+        BilanExport bilan;
+        duree = mesurer([&] { bilan = Exportation::exporterFilms(gestionnaireFilms, sortie, format.format); });
+        afficher(std::string("films, ") + format.nom, duree, bilan.nombreOctets, bilan.nombreEcritures);
+        duree = mesurer([&] {
+            bilan = Exportation::exporterUtilisateurs(gestionnaireUtilisateurs, sortie, format.format);
+        });
+        afficher(std::string("utilisateurs, ") + format.nom, duree, bilan.nombreOctets, bilan.nombreEcritures);
+        duree = mesurer([&] { bilan = Exportation::exporterLogs(analyseurLogs, sortie, format.format); });
+        afficher(std::string("logs, ") + format.nom, duree, bilan.nombreOctets, bilan.nombreEcritures);
+        duree = mesurer([&] {
+            bilan = Exportation::exporterVuesFilms(analyseurLogs, gestionnaireFilms, sortie, format.format);
+        });
+        afficher(std::string("vues par film, ") + format.nom, duree, bilan.nombreOctets, bilan.nombreEcritures);
+        if (!bilan.succes)
+        {
+            std::cerr << "Erreur BenchExportation: l'export a échoué\n";
+            return 1;
+        }
+    }
+    std::filesystem::remove_all(dossier);
+}
@@ -0,0 +1,141 @@
+/// Banc d'essai de mise à l'échelle de l'ingestion concurrente (1 à 64 threads producteurs).
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "IngesteurConcurrent.h"
+
+namespace
+{
+    constexpr std::size_t nombreUtilisateurs = 1000;
+    constexpr std::size_t nombreFilms = 1000;
+    constexpr std::size_t nombreLignes = 1 << 17;
+
+    /// Une ligne de log brute pré-générée pour ne pas mesurer le formatage des chaînes.
+    struct LigneBrute
+    {
+        std::string timestamp;
+        std::string idUtilisateur;
+        std::string nomFilm;
+    };
+
+    /// Génère des lignes de log pseudo-aléatoires déterministes, en ordre chronologique.
+    /// \return Le vecteur des lignes générées.
+    std::vector<LigneBrute> genererLignes()
+    {
+        std::vector<LigneBrute> lignes;
+        lignes.reserve(nombreLignes);
+        std::uint32_t etat = 12345;
+        for (std::size_t i = 0; i < nombreLignes; i++)
+        {
+            etat = etat * 1664525u + 1013904223u;
+            std::size_t seconde = i * 86400 / nombreLignes;
+            std::ostringstream timestamp;
+            timestamp << "2018-01-01T" << std::setfill('0') << std::setw(2) << seconde / 3600 << ':' << std::setw(2)
+                      << seconde / 60 % 60 << ':' << std::setw(2) << seconde % 60 << 'Z';
+            lignes.push_back(LigneBrute{timestamp.str(),
+                                        "utilisateur" + std::to_string((etat >> 8) % nombreUtilisateurs),
+                                        "Film" + std::to_string((etat >> 16) % nombreFilms)});
+        }
+        return lignes;
+    }
+
+    /// Exécute une fonction sur plusieurs threads. Le thread t traite les lignes t, t + n, t + 2n, etc., de sorte que
+    /// l'ordre d'arrivée global reste à peu près chronologique comme pour un vrai flux de lecteurs.
+    /// \param nombreThreads    Le nombre de threads à lancer.
+    /// \param traiter          La fonction appelée par chaque thread avec son index et le pas entre ses lignes.
+    /// \return                 Le temps écoulé en secondes.
+    template<typename Fonction>
+    double mesurer(std::size_t nombreThreads, Fonction traiter)
+    {
+        auto debut = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < nombreThreads; t++)
+        {
+            threads.emplace_back(traiter, t, nombreThreads);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+    }
+} // namespace
+
+int main()
+{
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    for (std::size_t i = 0; i < nombreUtilisateurs; i++)
+    {
+        gestionnaireUtilisateurs.ajouterUtilisateur(
+            Utilisateur{"utilisateur" + std::to_string(i), "Prénom Nom", 20, Pays::Canada});
+    }
+    GestionnaireFilms gestionnaireFilms;
+    for (std::size_t i = 0; i < nombreFilms; i++)
+    {
+        gestionnaireFilms.ajouterFilm(
+            Film{"Film" + std::to_string(i), Film::Genre::Drame, Pays::France, "Réalisateur", 2000});
+    }
+    const std::vector<LigneBrute> lignes = genererLignes();
+
+    std::cout << "Ingestion de " << lignes.size() << " lignes de log (" << std::thread::hardware_concurrency()
+              << " coeurs disponibles)\n";
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(28) << "verrou global (lignes/s)"
+              << std::setw(28) << "shards (lignes/s)" << "accélération\n";
+
+    for (std::size_t nombreThreads = 1; nombreThreads <= 64; nombreThreads *= 2)
+    {
+        // Référence: un seul AnalyseurLogs protégé par un mutex global
+        AnalyseurLogs analyseurVerrou;
+        std::mutex mutexGlobal;
+        double tempsVerrou = mesurer(nombreThreads, [&](std::size_t premier, std::size_t pas) {
+            for (std::size_t i = premier; i < lignes.size(); i += pas)
+            {
+                std::lock_guard<std::mutex> verrou(mutexGlobal);
+                analyseurVerrou.creerLigneLog(lignes[i].timestamp,
+                                              lignes[i].idUtilisateur,
+                                              lignes[i].nomFilm,
+                                              gestionnaireUtilisateurs,
+                                              gestionnaireFilms);
+            }
+        });
+
+        AnalyseurLogs analyseurShards;
+        double tempsShards = 0.0;
+        {
+            IngesteurConcurrent ingesteur(analyseurShards, gestionnaireUtilisateurs, gestionnaireFilms, nombreThreads);
+            auto debut = std::chrono::steady_clock::now();
+            mesurer(nombreThreads, [&](std::size_t premier, std::size_t pas) {
+                IngesteurConcurrent::Producteur producteur = ingesteur.creerProducteur();
+                for (std::size_t i = premier; i < lignes.size(); i += pas)
+                {
+                    producteur.creerLigneLog(lignes[i].timestamp, lignes[i].idUtilisateur, lignes[i].nomFilm);
+                }
+            });
+            ingesteur.terminer();
+            tempsShards = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+            if (ingesteur.getNombreVuesFilm(gestionnaireFilms.getFilmParNom("Film0")) !=
+                analyseurVerrou.getNombreVuesFilm(gestionnaireFilms.getFilmParNom("Film0")))
+            {
+                std::cerr << "Erreur: les compteurs répartis ne concordent pas avec la référence\n";
+                return 1;
+            }
+        }
+
+        double debitVerrou = static_cast<double>(lignes.size()) / tempsVerrou;
+        double debitShards = static_cast<double>(lignes.size()) / tempsShards;
+        std::cout << std::left << std::setw(10) << nombreThreads << std::setw(28) << std::fixed
+                  << std::setprecision(0) << debitVerrou << std::setw(28) << debitShards << std::setprecision(2)
+                  << debitShards / debitVerrou << "x\n";
+    }
+}
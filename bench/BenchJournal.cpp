@@ -0,0 +1,196 @@
+/// Banc d'essai du journal des mutations: surcoût d'écriture selon la taille des groupes et durée de récupération
+/// depuis un point de contrôle, comparée au rechargement des fichiers texte.
+///
+/// Usage: BenchJournal [echelle]
+///   echelle   Nombre de films et d'utilisateurs générés, avec 10 lignes de log par film (défaut: 10000)
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "JournalMutations.h"
+
+namespace
+{
+    /// Mesure une exécution d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        auto debut = std::chrono::steady_clock::now();
+        fonction();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+    }
+
+    /// Mutations à appliquer: les films, puis les utilisateurs, puis les lignes de log qui les référencent.
+    struct Mutations
+    {
+        std::vector<Film> films;
+        std::vector<Utilisateur> utilisateurs;
+        std::vector<AnalyseurLogs::EntreeLog> entreesLog;
+
+        std::size_t getTaille() const { return films.size() + utilisateurs.size() + entreesLog.size(); }
+
+        /// Applique les mutations d'indices [debut, fin) avec les fonctions d'ajout d'une cible.
+        template<typename Cible>
+        void appliquer(Cible& cible, std::size_t debut, std::size_t fin) const
+        {
+            for (std::size_t i = debut; i < fin; i++)
+            {
+                if (i < films.size())
+                {
+                    cible.ajouterFilm(films[i]);
+                }
+                else if (i < films.size() + utilisateurs.size())
+                {
+                    cible.ajouterUtilisateur(utilisateurs[i - films.size()]);
+                }
+                else
+                {
+                    const AnalyseurLogs::EntreeLog& entreeLog = entreesLog[i - films.size() - utilisateurs.size()];
+                    cible.creerLigneLog(entreeLog.timestamp, entreeLog.idUtilisateur, entreeLog.nomFilm);
+                }
+            }
+        }
+    };
+
+    /// Cible sans journal, qui applique les mutations directement aux gestionnaires.
+    struct CibleDirecte
+    {
+        GestionnaireFilms films;
+        GestionnaireUtilisateurs utilisateurs;
+        AnalyseurLogs analyseur;
+
+        void ajouterFilm(const Film& film) { films.ajouterFilm(film); }
+        void ajouterUtilisateur(const Utilisateur& utilisateur) { utilisateurs.ajouterUtilisateur(utilisateur); }
+        void creerLigneLog(const std::string& timestamp, const std::string& id, const std::string& nomFilm)
+        {
+            analyseur.creerLigneLog(timestamp, id, nomFilm, utilisateurs, films);
+        }
+    };
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t echelle = argc > 1 ? std::stoul(argv[1]) : 10000;
+    OptionsGenerateur options;
+    options.graine = echelle;
+    options.nombreFilms = echelle;
+    options.nombreUtilisateurs = echelle;
+    options.nombreLignesLog = echelle * 10;
+    GenerateurDonnees generateur(options);
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench_journal";
+    std::filesystem::remove_all(dossier);
+    std::filesystem::create_directories(dossier);
+    {
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+
+    CibleDirecte source;
+    double dureeTexte = mesurer([&] {
+        source.films.chargerDepuisFichier((dossier / "films.txt").string());
+        source.utilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+        source.analyseur.chargerDepuisFichier((dossier / "logs.txt").string(), source.utilisateurs, source.films);
+    });
+    Mutations mutations;
+    for (const Film* film : source.films.getFilms())
+    {
+        mutations.films.push_back(*film);
+    }
+    for (const Utilisateur* utilisateur : source.utilisateurs.getUtilisateurs())
+    {
+        mutations.utilisateurs.push_back(*utilisateur);
+    }
+    for (const LigneLog& ligneLog : source.analyseur.getLogs())
+    {
+        mutations.entreesLog.push_back({ligneLog.timestamp, ligneLog.utilisateur->id, ligneLog.film->nom});
+    }
+    std::size_t nombreMutations = mutations.getTaille();
+    auto microsecondesParMutation = [nombreMutations](double millisecondes) {
+        return millisecondes * 1000 / static_cast<double>(nombreMutations);
+    };
+
+    std::cout << std::fixed << std::setprecision(2) << nombreMutations << " mutations (" << mutations.films.size()
+              << " films, " << mutations.utilisateurs.size() << " utilisateurs, " << mutations.entreesLog.size()
+              << " lignes de log)\n\nDébit d'écriture (us par mutation)\n";
+    CibleDirecte directe;
+    double dureeDirecte = mesurer([&] { mutations.appliquer(directe, 0, nombreMutations); });
+    std::cout << "  sans journal                         " << std::setw(8) << microsecondesParMutation(dureeDirecte)
+              << '\n';
+
+    struct Configuration
+    {
+        const char* nom;
+        std::size_t tailleGroupe;
+        bool synchroniser;
+    };
+    for (const Configuration& configuration : {Configuration{"groupes de 1, fdatasync      ", 1, true},
+                                               Configuration{"groupes de 16, fdatasync     ", 16, true},
+                                               Configuration{"groupes de 256, fdatasync    ", 256, true},
+                                               Configuration{"groupes de 256, sans fdatasync", 256, false}})
+    {
+        std::filesystem::remove_all(dossier / "journal");
+        OptionsJournal optionsJournal;
+        optionsJournal.tailleGroupe = configuration.tailleGroupe;
+        optionsJournal.synchroniser = configuration.synchroniser;
+        optionsJournal.mutationsParPointControle = 0;
+        CibleDirecte cible;
+        JournalMutations journal(cible.films, cible.utilisateurs, cible.analyseur, dossier / "journal", optionsJournal);
+        journal.recuperer();
+        double duree = mesurer([&] {
+            mutations.appliquer(journal, 0, nombreMutations);
+            journal.valider();
+        });
+        std::cout << "  " << configuration.nom << "       " << std::setw(8) << microsecondesParMutation(duree) << " ("
+                  << journal.getNombreGroupesEcrits() << " groupes)\n";
+    }
+
+    // Le journal de la dernière configuration contient toutes les mutations; un second dossier reçoit un point de
+    // contrôle à 90 % des mutations, suivi d'un journal qui ne contient que les 10 % restants
+    std::size_t debutQueue = nombreMutations - nombreMutations / 10;
+    {
+        OptionsJournal optionsJournal;
+        optionsJournal.mutationsParPointControle = 0;
+        CibleDirecte cible;
+        JournalMutations journal(
+            cible.films, cible.utilisateurs, cible.analyseur, dossier / "point_controle", optionsJournal);
+        journal.recuperer();
+        mutations.appliquer(journal, 0, debutQueue);
+        journal.creerPointControle();
+        mutations.appliquer(journal, debutQueue, nombreMutations);
+    }
+
+    std::cout << "\nRécupération (ms)\n"
+              << "  rechargement des fichiers texte      " << std::setw(8) << dureeTexte << '\n';
+    for (const char* sousDossier : {"journal", "point_controle"})
+    {
+        CibleDirecte cible;
+        JournalMutations journal(cible.films, cible.utilisateurs, cible.analyseur, dossier / sousDossier);
+        double duree = mesurer([&] { journal.recuperer(); });
+        std::cout << "  " << (journal.getGeneration() == 0 ? "journal complet                      "
+                                                           : "point de contrôle + 10 % du journal ")
+                  << std::setw(8) << duree << " (" << journal.getNombreMutationsRejouees()
+                  << " mutations rejouées)\n";
+        if (cible.analyseur.getLogs().size() != source.analyseur.getLogs().size() ||
+            cible.films.getNombreFilms() != source.films.getNombreFilms())
+        {
+            std::cerr << "Erreur BenchJournal: état récupéré différent\n";
+            return 1;
+        }
+    }
+    std::filesystem::remove_all(dossier);
+}
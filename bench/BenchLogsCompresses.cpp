@@ -0,0 +1,122 @@
+/// Banc d'essai de la compression des logs: octets par ligne et coût des requêtes sur les blocs compressés.
+///
+/// Usage: BenchLogsCompresses [echelle]
+///   echelle   Nombre de films et d'utilisateurs générés, avec 10 lignes de log par film (défaut: 100000)
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include "AnalyseurLogs.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "LogsCompresses.h"
+
+namespace
+{
+    /// Mesure la meilleure de cinq exécutions d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        double meilleur = 0.0;
+        for (int essai = 0; essai < 5; essai++)
+        {
+            auto debut = std::chrono::steady_clock::now();
+            fonction();
+            double duree = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+            meilleur = essai == 0 ? duree : std::min(meilleur, duree);
+        }
+        return meilleur;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // Mêmes paramètres que la plus grande échelle de BenchSuite
+    std::size_t echelle = argc > 1 ? std::stoul(argv[1]) : 100000;
+    OptionsGenerateur options;
+    options.graine = echelle;
+    options.nombreFilms = echelle;
+    options.nombreUtilisateurs = echelle;
+    options.nombreLignesLog = echelle * 10;
+    GenerateurDonnees generateur(options);
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench_compression";
+    std::filesystem::create_directories(dossier);
+    {
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    AnalyseurLogs analyseurLogs;
+    gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string());
+    gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+    analyseurLogs.chargerDepuisFichier((dossier / "logs.txt").string(), gestionnaireUtilisateurs, gestionnaireFilms);
+    std::filesystem::remove_all(dossier);
+
+    LogsCompresses logsCompresses;
+    double dureeCompression = mesurer([&] { logsCompresses = analyseurLogs.compresserLogs(); });
+    std::size_t nombreLignes = logsCompresses.getTaille();
+    double dureeDecompression = mesurer([&] { logsCompresses.decompresser(); });
+
+    UtilisationMemoire memoireAnalyseur = analyseurLogs.getUtilisationMemoire();
+    auto parLigne = [nombreLignes](std::size_t octets) {
+        return static_cast<double>(octets) / static_cast<double>(nombreLignes);
+    };
+    std::cout << std::fixed << std::setprecision(2) << nombreLignes << " lignes, " << logsCompresses.getNombreBlocs()
+              << " blocs de " << LogsCompresses::tailleBloc << " lignes\n"
+              << "octets par ligne:\n"
+              << "  logs_ (LigneLog et timestamps)  "
+              << parLigne(memoireAnalyseur.getOctets("logs_") + memoireAnalyseur.getOctets("logs_.timestamp")) << '\n'
+              << "  colonnes_                       " << parLigne(memoireAnalyseur.getOctets("colonnes_")) << '\n'
+              << "  LogsCompresses                  " << logsCompresses.getOctetsParLigne() << '\n'
+              << logsCompresses.getUtilisationMemoire() << '\n'
+              << "compression: " << dureeCompression << " ms, décompression: " << dureeDecompression << " ms\n\n";
+
+    // Requêtes sur le film le plus populaire, dans des fenêtres d'un jour, d'un mois et d'un an
+    const Film* film = analyseurLogs.getFilmPlusPopulaire();
+    const Utilisateur* utilisateur =
+        gestionnaireUtilisateurs.getUtilisateurParId(GenerateurDonnees::getIdUtilisateur(echelle / 2));
+    std::cout << std::left << std::setw(40) << "requete" << std::right << std::setw(16) << "colonnes (ms)"
+              << std::setw(18) << "compresses (ms)" << '\n';
+    bool resultatsIdentiques = true;
+    for (const auto& [description, debut, fin] :
+         {std::make_tuple("getNombreVuesFilmEntre (1 jour)", "2018-06-01T00:00:00Z", "2018-06-02T00:00:00Z"),
+          std::make_tuple("getNombreVuesFilmEntre (1 mois)", "2018-06-01T00:00:00Z", "2018-07-01T00:00:00Z"),
+          std::make_tuple("getNombreVuesFilmEntre (1 an)", "2018-01-01T00:00:00Z", "2019-01-01T00:00:00Z")})
+    {
+        int vuesColonnes = 0;
+        int vuesCompresses = 0;
+        double dureeColonnes = mesurer([&] { vuesColonnes = analyseurLogs.getNombreVuesFilmEntre(film, debut, fin); });
+        double dureeCompresses =
+            mesurer([&] { vuesCompresses = logsCompresses.getNombreVuesFilmEntre(film, debut, fin); });
+        resultatsIdentiques &= vuesColonnes == vuesCompresses;
+        std::cout << std::left << std::setw(40) << description << std::right << std::setw(16) << dureeColonnes
+                  << std::setw(18) << dureeCompresses << '\n';
+    }
+    int vuesColonnes = 0;
+    int vuesCompresses = 0;
+    double dureeColonnes = mesurer([&] { vuesColonnes = analyseurLogs.getNombreVuesPourUtilisateur(utilisateur); });
+    double dureeCompresses = mesurer([&] { vuesCompresses = logsCompresses.getNombreVuesPourUtilisateur(utilisateur); });
+    resultatsIdentiques &= vuesColonnes == vuesCompresses;
+    std::cout << std::left << std::setw(40) << "getNombreVuesPourUtilisateur" << std::right << std::setw(16)
+              << dureeColonnes << std::setw(18) << dureeCompresses << '\n';
+
+    if (!resultatsIdentiques)
+    {
+        std::cerr << "Erreur BenchLogsCompresses: résultats différents\n";
+        return 1;
+    }
+}
@@ -0,0 +1,78 @@
+/// Banc d'essai des insertions de lignes en retard: AnalyseurLogs, qui les range dans un LogsLSM jusqu'au repli de
+/// getLogs(), comparé à LogsLSM seul.
+///
+/// Usage: BenchLogsLSM [nombre]
+///   nombre    Nombre de lignes insérées, aux timestamps tirés au hasard sur deux ans (défaut: 200000)
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "Horodatage.h"
+#include "LogsLSM.h"
+
+namespace
+{
+    /// Mesure une exécution d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        auto debut = std::chrono::steady_clock::now();
+        fonction();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t nombreLignes = argc > 1 ? std::stoul(argv[1]) : 200000;
+    Film film{"Film", Film::Genre::Documentaire, Pays::Canada, "Réalisateur", 2000};
+    Utilisateur utilisateur{"utilisateur@email.com", "Prénom Nom", 30, Pays::Canada};
+
+    std::mt19937_64 generateur(nombreLignes);
+    std::uniform_int_distribution<std::int64_t> instants(1514764800, 1577836800);
+    std::vector<LigneLog> lignesLog;
+    lignesLog.reserve(nombreLignes);
+    for (std::size_t i = 0; i < nombreLignes; i++)
+    {
+        lignesLog.push_back(LigneLog{formaterTimestamp(instants(generateur)), &utilisateur, &film});
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << nombreLignes
+              << " lignes insérées une à une dans le désordre\n";
+    AnalyseurLogs analyseurLogs;
+    double dureeAnalyseur = mesurer([&] {
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            analyseurLogs.ajouterLigneLog(ligneLog);
+        }
+    });
+    double dureeRepli = mesurer([&] { analyseurLogs.getLogs(); });
+    std::cout << "  AnalyseurLogs::ajouterLigneLog  " << std::setw(10) << dureeAnalyseur << " ms (+ " << dureeRepli
+              << " ms pour replier les lignes en retard)\n";
+
+    LogsLSM logsLSM;
+    double dureeLSM = mesurer([&] {
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            logsLSM.ajouterLigneLog(ligneLog);
+        }
+    });
+    double dureeCompactions = mesurer([&] { logsLSM.attendreCompactions(); });
+    std::cout << "  LogsLSM::ajouterLigneLog        " << std::setw(10) << dureeLSM << " ms (+ " << dureeCompactions
+              << " ms pour terminer les compactions, " << logsLSM.getNombreCompactions() << " compactions, "
+              << logsLSM.getNombreSequences() << " séquences)\n";
+
+    int vuesAnalyseur = analyseurLogs.getNombreVuesFilmEntre(&film, "2018-06-01T00:00:00Z", "2018-07-01T00:00:00Z");
+    int vuesLSM = logsLSM.getNombreVuesFilmEntre(&film, "2018-06-01T00:00:00Z", "2018-07-01T00:00:00Z");
+    if (vuesAnalyseur != vuesLSM)
+    {
+        std::cerr << "Erreur BenchLogsLSM: résultats différents\n";
+        return 1;
+    }
+}
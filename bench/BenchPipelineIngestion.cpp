@@ -0,0 +1,84 @@
+/// Banc d'essai du chargement des logs: chargement séquentiel comparé au pipeline à quatre étapes.
+///
+/// Usage: BenchPipelineIngestion [lignes]
+///   lignes    Nombre de lignes de log générées (défaut: 1000000)
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "AnalyseurLogs.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "PipelineIngestion.h"
+
+namespace
+{
+    /// Mesure la durée d'un chargement.
+    /// \param fonction La fonction qui effectue le chargement.
+    /// \return         La durée en secondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        auto debut = std::chrono::steady_clock::now();
+        fonction();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    OptionsGenerateur options;
+    options.nombreFilms = 10000;
+    options.nombreUtilisateurs = 10000;
+    options.nombreLignesLog = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    GenerateurDonnees generateur(options);
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench_pipeline";
+    std::filesystem::create_directories(dossier);
+    {
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string());
+    gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+    std::string fichierLogs = (dossier / "logs.txt").string();
+
+    std::cout << "Chargement de " << options.nombreLignesLog << " lignes de log ("
+              << std::thread::hardware_concurrency() << " coeurs disponibles)\n";
+
+    AnalyseurLogs analyseurSequentiel;
+    double tempsSequentiel = mesurer([&] {
+        analyseurSequentiel.chargerDepuisFichier(fichierLogs, gestionnaireUtilisateurs, gestionnaireFilms);
+    });
+    std::cout << "sequentiel: " << tempsSequentiel << " s\n";
+
+    AnalyseurLogs analyseurPipeline;
+    PipelineIngestion pipeline(analyseurPipeline, gestionnaireUtilisateurs, gestionnaireFilms);
+    double tempsPipeline = mesurer([&] { pipeline.chargerDepuisFichier(fichierLogs); });
+    std::cout << "pipeline:   " << tempsPipeline << " s (accélération " << tempsSequentiel / tempsPipeline
+              << ")\n\n"
+              << pipeline;
+
+    bool resultatsIdentiques = true;
+    for (const Film* film : gestionnaireFilms.getFilms())
+    {
+        resultatsIdentiques &= analyseurPipeline.getNombreVuesFilm(film) == analyseurSequentiel.getNombreVuesFilm(film);
+    }
+    std::filesystem::remove_all(dossier);
+    if (!resultatsIdentiques)
+    {
+        std::cerr << "Erreur BenchPipelineIngestion: les deux chargements donnent des résultats différents\n";
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+/// Banc d'essai du pool de tâches: accélération des opérations parallélisées par rapport à leur version séquentielle.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "PoolTaches.h"
+
+namespace
+{
+    constexpr std::size_t nombreElements = 1 << 24;
+    constexpr std::size_t nombreFilms = 1 << 19;
+    constexpr std::size_t nombreUtilisateurs = 10000;
+    constexpr std::size_t nombreLignes = 1 << 22;
+
+    /// Mesure la meilleure de trois exécutions d'une fonction.
+    /// \param fonction La fonction à mesurer.
+    /// \return         La durée en millisecondes.
+    template<typename Fonction>
+    double mesurer(Fonction&& fonction)
+    {
+        double meilleur = 0.0;
+        for (int essai = 0; essai < 3; essai++)
+        {
+            auto debut = std::chrono::steady_clock::now();
+            fonction();
+            double duree = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+            meilleur = essai == 0 ? duree : std::min(meilleur, duree);
+        }
+        return meilleur;
+    }
+
+    void afficher(const std::string& operation, double dureeSequentielle, double dureeParallele)
+    {
+        std::cout << std::left << std::setw(40) << operation << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << dureeSequentielle << std::setw(14) << dureeParallele << std::setw(12)
+                  << std::setprecision(2) << dureeSequentielle / dureeParallele << '\n';
+    }
+
+    std::vector<Film> creerFilms()
+    {
+        std::vector<Film> films;
+        films.reserve(nombreFilms);
+        for (std::size_t i = 0; i < nombreFilms; i++)
+        {
+            films.push_back(Film{"Film " + std::to_string(i),
+                                 static_cast<Film::Genre>(i % 9),
+                                 static_cast<Pays>(i % 9),
+                                 "Réalisateur",
+                                 static_cast<int>(1920 + i % 100)});
+        }
+        return films;
+    }
+} // namespace
+
+int main()
+{
+    PoolTaches& pool = PoolTaches::getPoolGlobal();
+    std::cout << "Pool global: " << pool.getNombreTravailleurs() << " travailleurs + thread appelant ("
+              << std::thread::hardware_concurrency() << " coeurs)\n"
+              << std::left << std::setw(40) << "operation" << std::right << std::setw(14) << "seq (ms)"
+              << std::setw(14) << "pool (ms)" << std::setw(12) << "accel." << '\n';
+
+    // parallelReduce sur un calcul purement arithmétique
+    std::vector<std::uint64_t> valeurs(nombreElements);
+    std::iota(valeurs.begin(), valeurs.end(), 0);
+    std::uint64_t sommeSequentielle = 0;
+    std::uint64_t sommeParallele = 0;
+    double dureeSequentielle = mesurer([&] {
+        sommeSequentielle = std::accumulate(valeurs.begin(), valeurs.end(), std::uint64_t(0),
+                                            [](std::uint64_t somme, std::uint64_t valeur) { return somme + valeur * valeur; });
+    });
+    double dureeParallele = mesurer([&] {
+        sommeParallele = pool.parallelReduce(
+            0, valeurs.size(), 0, std::uint64_t(0),
+            [&](std::size_t debut, std::size_t fin) {
+                std::uint64_t somme = 0;
+                for (std::size_t i = debut; i < fin; i++)
+                {
+                    somme += valeurs[i] * valeurs[i];
+                }
+                return somme;
+            },
+            std::plus<std::uint64_t>());
+    });
+    afficher("parallelReduce (somme des carrés)", dureeSequentielle, dureeParallele);
+
+    // Construction des index de GestionnaireFilms
+    const std::vector<Film> films = creerFilms();
+    dureeSequentielle = mesurer([&] {
+        GestionnaireFilms gestionnaire;
+        for (const Film& film : films)
+        {
+            gestionnaire.ajouterFilm(film);
+        }
+    });
+    GestionnaireFilms gestionnaireFilms;
+    dureeParallele = mesurer([&] {
+        gestionnaireFilms = GestionnaireFilms();
+        gestionnaireFilms.ajouterFilms(films);
+    });
+    afficher("GestionnaireFilms::ajouterFilms", dureeSequentielle, dureeParallele);
+
+    // Agrégats d'AnalyseurLogs sur un groupe d'utilisateurs
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    for (std::size_t i = 0; i < nombreUtilisateurs; i++)
+    {
+        gestionnaireUtilisateurs.ajouterUtilisateur(
+            Utilisateur{"utilisateur" + std::to_string(i), "Prénom Nom", static_cast<int>(i % 100), Pays::Canada});
+    }
+    std::vector<const Film*> pointeursFilms = gestionnaireFilms.getFilms();
+    std::vector<const Utilisateur*> audience;
+    std::vector<LigneLog> lignesLog;
+    lignesLog.reserve(nombreLignes);
+    std::uint32_t etat = 12345;
+    for (std::size_t i = 0; i < nombreLignes; i++)
+    {
+        etat = etat * 1664525u + 1013904223u;
+        const Utilisateur* utilisateur = gestionnaireUtilisateurs.getUtilisateurParId(
+            "utilisateur" + std::to_string(etat % nombreUtilisateurs));
+        lignesLog.push_back(LigneLog{"2018-01-01T00:00:00Z", utilisateur, pointeursFilms[(etat >> 8) % nombreFilms]});
+        if (i < nombreUtilisateurs / 10)
+        {
+            audience.push_back(utilisateur);
+        }
+    }
+    AnalyseurLogs analyseurLogs;
+    analyseurLogs.ajouterLignesLog(lignesLog);
+
+    std::size_t puits = 0;
+    dureeSequentielle = mesurer([&] {
+        std::unordered_set<const Utilisateur*> ensemble(audience.begin(), audience.end());
+        std::unordered_map<const Film*, int> vues;
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            if (ensemble.count(ligneLog.utilisateur) != 0)
+            {
+                vues[ligneLog.film]++;
+            }
+        }
+        std::vector<std::pair<const Film*, int>> meilleurs(std::min<std::size_t>(vues.size(), 10));
+        std::partial_sort_copy(vues.begin(), vues.end(), meilleurs.begin(), meilleurs.end(),
+                               [](const auto& film1, const auto& film2) { return film1.second > film2.second; });
+        puits += meilleurs.size();
+    });
+    dureeParallele = mesurer([&] { puits += analyseurLogs.getNFilmsPlusPopulairesPourUtilisateurs(10, audience).size(); });
+    afficher("getNFilmsPlusPopulairesPourUtilisateurs", dureeSequentielle, dureeParallele);
+
+    // Fusion des meilleurs films sur tous les films vus
+    std::unordered_map<const Film*, int> vuesFilms;
+    for (const LigneLog& ligneLog : lignesLog)
+    {
+        vuesFilms[ligneLog.film]++;
+    }
+    dureeSequentielle = mesurer([&] {
+        std::vector<std::pair<const Film*, int>> meilleurs(100);
+        std::partial_sort_copy(vuesFilms.begin(), vuesFilms.end(), meilleurs.begin(), meilleurs.end(),
+                               [](const auto& film1, const auto& film2) { return film1.second > film2.second; });
+        puits += meilleurs.size();
+    });
+    dureeParallele = mesurer([&] { puits += analyseurLogs.getNFilmsPlusPopulaires(100).size(); });
+    afficher("getNFilmsPlusPopulaires (top 100)", dureeSequentielle, dureeParallele);
+
+    if (sommeSequentielle != sommeParallele || puits == 0)
+    {
+        std::cerr << "Erreur BenchPoolTaches: résultats différents\n";
+        return 1;
+    }
+}
@@ -0,0 +1,443 @@
+/// Suite de bancs d'essai couvrant les opérations publiques des gestionnaires et de l'analyseur de logs.
+///
+/// Usage: BenchSuite [--json] [--echelles n1,n2,...] [--instrumentation]
+///   --json            Écrit une ligne JSON par mesure (format stable, comparable entre deux commits)
+///   --echelles        Nombres de films et d'utilisateurs à générer (10 lignes de log par film), 1000,10000,100000
+///                     par défaut
+///   --instrumentation Écrit le rapport JSON de l'instrumentation sur la sortie d'erreur à la fin (nécessite une
+///                     compilation avec make instrumentation=1 pour contenir des mesures)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "Instrumentation.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    constexpr std::chrono::milliseconds dureeMinimaleMesure(50);
+    constexpr std::size_t iterationsMaximales = 1000000;
+
+    /// Résultat d'une mesure.
+    struct Resultat
+    {
+        std::string classe;
+        std::string operation;
+        std::size_t echelle;
+        std::size_t iterations;
+        double nsParOperation;
+        long rssMaxKo;
+    };
+
+    /// Retourne le pic de mémoire résidente du processus.
+    /// \return Le pic de mémoire résidente en kilo-octets, ou 0 si la plateforme ne le permet pas.
+    long getRssMaxKo()
+    {
+#ifdef _WIN32
+        return 0;
+#else
+        rusage utilisation{};
+        getrusage(RUSAGE_SELF, &utilisation);
+#ifdef __APPLE__
+        return utilisation.ru_maxrss / 1024; // En octets sur macOS
+#else
+        return utilisation.ru_maxrss;
+#endif
+#endif
+    }
+
+    /// Générateur pseudo-aléatoire déterministe (xorshift) pour que deux exécutions utilisent les mêmes données.
+    class GenerateurAleatoire
+    {
+    public:
+        explicit GenerateurAleatoire(std::uint64_t graine)
+            : etat_(graine)
+        {
+        }
+
+        std::uint64_t operator()(std::uint64_t borne)
+        {
+            etat_ ^= etat_ << 13;
+            etat_ ^= etat_ >> 7;
+            etat_ ^= etat_ << 17;
+            return etat_ % borne;
+        }
+
+    private:
+        std::uint64_t etat_;
+    };
+
+    std::string getNomFilm(std::size_t index) { return GenerateurDonnees::getNomFilm(index); }
+    std::string getIdUtilisateur(std::size_t index) { return GenerateurDonnees::getIdUtilisateur(index); }
+
+    /// Écrit des fichiers de films, d'utilisateurs et de logs au format des fichiers du projet.
+    /// \param dossier  Le dossier dans lequel écrire les fichiers.
+    /// \param echelle  Le nombre de films et d'utilisateurs (le log contient 10 lignes par film).
+    void ecrireDonnees(const std::filesystem::path& dossier, std::size_t echelle)
+    {
+        OptionsGenerateur options;
+        options.graine = echelle;
+        options.nombreFilms = echelle;
+        options.nombreUtilisateurs = echelle;
+        options.nombreLignesLog = echelle * 10;
+        GenerateurDonnees generateur(options);
+
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+
+    /// Suite de mesures pour une échelle donnée.
+    class Suite
+    {
+    public:
+        explicit Suite(std::size_t echelle)
+            : echelle_(echelle)
+        {
+        }
+
+        /// Mesure une opération en la répétant jusqu'à atteindre une durée minimale.
+        /// \param classe       Le nom de la classe mesurée.
+        /// \param operation    Le nom de l'opération mesurée.
+        /// \param fonction     L'opération, appelée avec le numéro d'itération et retournant une valeur à conserver.
+        /// \param maximum      Le nombre maximal d'itérations.
+        template<typename Fonction>
+        void mesurer(const std::string& classe,
+                     const std::string& operation,
+                     Fonction fonction,
+                     std::size_t maximum = iterationsMaximales)
+        {
+            std::size_t iterations = 0;
+            auto debut = std::chrono::steady_clock::now();
+            auto ecoule = std::chrono::steady_clock::duration::zero();
+            while (iterations < maximum && ecoule < dureeMinimaleMesure)
+            {
+                puits_ += static_cast<std::size_t>(fonction(iterations));
+                iterations++;
+                if ((iterations & 0xF) == 0 || iterations < 16)
+                {
+                    ecoule = std::chrono::steady_clock::now() - debut;
+                }
+            }
+            ecoule = std::chrono::steady_clock::now() - debut;
+            double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(ecoule).count());
+            resultats_.push_back(
+                Resultat{classe, operation, echelle_, iterations, ns / static_cast<double>(iterations), getRssMaxKo()});
+        }
+
+        const std::vector<Resultat>& getResultats() const { return resultats_; }
+        std::size_t getPuits() const { return puits_; }
+
+    private:
+        std::size_t echelle_;
+        std::vector<Resultat> resultats_;
+        std::size_t puits_ = 0; // Empêche le compilateur d'éliminer les appels mesurés
+    };
+
+    /// Exécute toutes les mesures pour une échelle donnée.
+    /// \param dossier  Le dossier contenant les fichiers générés.
+    /// \param echelle  L'échelle des données.
+    /// \param suite    La suite dans laquelle conserver les résultats.
+    void executerMesures(const std::filesystem::path& dossier, std::size_t echelle, Suite& suite)
+    {
+        const std::string fichierFilms = (dossier / "films.txt").string();
+        const std::string fichierUtilisateurs = (dossier / "utilisateurs.txt").string();
+        const std::string fichierLogs = (dossier / "logs.txt").string();
+        GenerateurAleatoire aleatoire(42);
+
+        // GestionnaireFilms
+        GestionnaireFilms gestionnaireFilms;
+        suite.mesurer("GestionnaireFilms", "chargerDepuisFichier", [&](std::size_t) {
+            return gestionnaireFilms.chargerDepuisFichier(fichierFilms).nombreLignesChargees;
+        }, 5);
+        suite.mesurer("GestionnaireFilms", "chargerDepuisFichier + getFilmsParGenre", [&](std::size_t) {
+            gestionnaireFilms.chargerDepuisFichier(fichierFilms);
+            return gestionnaireFilms.getFilmsParGenre(Film::Genre::Drame).size();
+        }, 5);
+        std::vector<std::string> nomsFilms;
+        for (std::size_t i = 0; i < 1024; i++)
+        {
+            nomsFilms.push_back(getNomFilm(aleatoire(echelle)));
+        }
+        suite.mesurer("GestionnaireFilms", "getFilmParNom", [&](std::size_t i) {
+            return gestionnaireFilms.getFilmParNom(nomsFilms[i % nomsFilms.size()]) != nullptr;
+        });
+        suite.mesurer("GestionnaireFilms", "getFilmsParGenre", [&](std::size_t i) {
+            return gestionnaireFilms.getFilmsParGenre(static_cast<Film::Genre>(i % 9)).size();
+        });
+        suite.mesurer("GestionnaireFilms", "getFilmsParPays", [&](std::size_t i) {
+            return gestionnaireFilms.getFilmsParPays(static_cast<Pays>(i % 9)).size();
+        });
+        suite.mesurer("GestionnaireFilms", "getFilmsEntreAnnees", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 90);
+            return gestionnaireFilms.getFilmsEntreAnnees(debut, debut + 10).size();
+        });
+        gestionnaireFilms.definirCapaciteCache(0);
+        suite.mesurer("GestionnaireFilms", "getFilmsEntreAnnees (sans cache)", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 90);
+            return gestionnaireFilms.getFilmsEntreAnnees(debut, debut + 10).size();
+        });
+        suite.mesurer("GestionnaireFilms", "filtrages successifs annee, !genre", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 50);
+            Film::Genre genre = static_cast<Film::Genre>(i % 9);
+            std::vector<const Film*> filmsAnnees = gestionnaireFilms.getFilmsEntreAnnees(debut, debut + 50);
+            std::vector<const Film*> films;
+            std::copy_if(filmsAnnees.begin(), filmsAnnees.end(), std::back_inserter(films), [genre](const Film* film) {
+                return film->genre != genre;
+            });
+            return films.size();
+        });
+        suite.mesurer("GestionnaireFilms", "getFilmsSelon(annee && !genre)", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 50);
+            using namespace PredicatsFilms;
+            return gestionnaireFilms.getFilmsSelon(annee(debut, debut + 50) && !genre(static_cast<Film::Genre>(i % 9)))
+                .size();
+        });
+        gestionnaireFilms.definirCapaciteCache(capaciteCacheParDefaut);
+        suite.mesurer("GestionnaireFilms", "filtrages successifs genre, pays, annee", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 90);
+            Pays pays = static_cast<Pays>(i % 9);
+            std::vector<const Film*> filmsGenre = gestionnaireFilms.getFilmsParGenre(static_cast<Film::Genre>(i % 9));
+            std::vector<const Film*> filmsPays;
+            std::copy_if(filmsGenre.begin(), filmsGenre.end(), std::back_inserter(filmsPays), [pays](const Film* film) {
+                return film->pays == pays;
+            });
+            std::vector<const Film*> films;
+            std::copy_if(filmsPays.begin(), filmsPays.end(), std::back_inserter(films), [debut](const Film* film) {
+                return film->annee >= debut && film->annee <= debut + 10;
+            });
+            return films.size();
+        });
+        suite.mesurer("GestionnaireFilms", "getFilmsSelon(annee && genre && pays)", [&](std::size_t i) {
+            int debut = 1920 + static_cast<int>(i % 90);
+            using namespace PredicatsFilms;
+            return gestionnaireFilms
+                .getFilmsSelon(annee(debut, debut + 10) && genre(static_cast<Film::Genre>(i % 9)) &&
+                               pays(static_cast<Pays>(i % 9)))
+                .size();
+        });
+        suite.mesurer("GestionnaireFilms", "copie", [&](std::size_t) {
+            GestionnaireFilms copie(gestionnaireFilms);
+            return copie.getNombreFilms();
+        });
+        {
+            GestionnaireFilms copie(gestionnaireFilms);
+            suite.mesurer("GestionnaireFilms", "ajouterFilm", [&](std::size_t i) {
+                return copie.ajouterFilm(Film{"Nouveau " + std::to_string(i),
+                                              static_cast<Film::Genre>(i % 9),
+                                              static_cast<Pays>(i % 9),
+                                              "Réalisateur",
+                                              2000});
+            }, 100000);
+            suite.mesurer("GestionnaireFilms", "supprimerFilm", [&](std::size_t i) {
+                return copie.supprimerFilm(getNomFilm(i));
+            }, std::min<std::size_t>(echelle, 10000));
+        }
+        {
+            GestionnaireFilms copie(gestionnaireFilms);
+            std::vector<Film> lot;
+            std::vector<std::string> nomsLot;
+            for (std::size_t i = 0; i < 1000; i++)
+            {
+                lot.push_back(Film{"Lot " + std::to_string(i), Film::Genre::Drame, Pays::France, "Réalisateur", 2000});
+                nomsLot.push_back(getNomFilm(i % echelle));
+            }
+            suite.mesurer("GestionnaireFilms", "ajouterFilms(1000)", [&](std::size_t) {
+                return copie.ajouterFilms(lot).size();
+            }, 1);
+            suite.mesurer("GestionnaireFilms", "supprimerFilms(1000)", [&](std::size_t) {
+                return copie.supprimerFilms(nomsLot).size();
+            }, 1);
+        }
+
+        // GestionnaireUtilisateurs
+        GestionnaireUtilisateurs gestionnaireUtilisateurs;
+        suite.mesurer("GestionnaireUtilisateurs", "chargerDepuisFichier", [&](std::size_t) {
+            return gestionnaireUtilisateurs.chargerDepuisFichier(fichierUtilisateurs).nombreLignesChargees;
+        }, 5);
+        std::vector<std::string> idsUtilisateurs;
+        for (std::size_t i = 0; i < 1024; i++)
+        {
+            idsUtilisateurs.push_back(getIdUtilisateur(aleatoire(echelle)));
+        }
+        suite.mesurer("GestionnaireUtilisateurs", "getUtilisateurParId", [&](std::size_t i) {
+            return gestionnaireUtilisateurs.getUtilisateurParId(idsUtilisateurs[i % idsUtilisateurs.size()]) !=
+                   nullptr;
+        });
+        suite.mesurer("GestionnaireUtilisateurs", "getUtilisateursParPays", [&](std::size_t i) {
+            return gestionnaireUtilisateurs.getUtilisateursParPays(static_cast<Pays>(i % 9)).size();
+        });
+        suite.mesurer("GestionnaireUtilisateurs", "getUtilisateursEntreAges", [&](std::size_t i) {
+            int debut = 1 + static_cast<int>(i % 90);
+            return gestionnaireUtilisateurs.getUtilisateursEntreAges(debut, debut + 7).size();
+        });
+        suite.mesurer("GestionnaireUtilisateurs", "getUtilisateursParPaysEntreAges", [&](std::size_t i) {
+            int debut = 1 + static_cast<int>(i % 90);
+            return gestionnaireUtilisateurs.getUtilisateursParPaysEntreAges(static_cast<Pays>(i % 9), debut, debut + 7)
+                .size();
+        });
+        suite.mesurer("GestionnaireUtilisateurs", "ajouterUtilisateur", [&](std::size_t i) {
+            return gestionnaireUtilisateurs.ajouterUtilisateur(
+                Utilisateur{"nouveau" + std::to_string(i), "Prénom Nom", 20, Pays::Canada});
+        }, 100000);
+        suite.mesurer("GestionnaireUtilisateurs", "supprimerUtilisateur", [&](std::size_t i) {
+            return gestionnaireUtilisateurs.supprimerUtilisateur("nouveau" + std::to_string(i));
+        }, 100000);
+
+        // AnalyseurLogs
+        AnalyseurLogs analyseurLogs;
+        suite.mesurer("AnalyseurLogs", "chargerDepuisFichier", [&](std::size_t) {
+            return analyseurLogs.chargerDepuisFichier(fichierLogs, gestionnaireUtilisateurs, gestionnaireFilms)
+                .nombreLignesChargees;
+        }, 3);
+        std::vector<const Film*> films;
+        std::vector<const Utilisateur*> utilisateurs;
+        for (std::size_t i = 0; i < 1024; i++)
+        {
+            films.push_back(gestionnaireFilms.getFilmParNom(nomsFilms[i]));
+            utilisateurs.push_back(gestionnaireUtilisateurs.getUtilisateurParId(idsUtilisateurs[i]));
+        }
+        suite.mesurer("AnalyseurLogs", "getNombreVuesFilm", [&](std::size_t i) {
+            return analyseurLogs.getNombreVuesFilm(films[i % films.size()]);
+        });
+        suite.mesurer("AnalyseurLogs", "getFilmPlusPopulaire", [&](std::size_t) {
+            return analyseurLogs.getFilmPlusPopulaire() != nullptr;
+        });
+        suite.mesurer("AnalyseurLogs", "getNFilmsPlusPopulaires(10)", [&](std::size_t) {
+            return analyseurLogs.getNFilmsPlusPopulaires(10).size();
+        });
+        suite.mesurer("AnalyseurLogs", "getNombreVuesPourUtilisateur", [&](std::size_t i) {
+            return analyseurLogs.getNombreVuesPourUtilisateur(utilisateurs[i % utilisateurs.size()]);
+        });
+        suite.mesurer("AnalyseurLogs", "getFilmsVusParUtilisateur", [&](std::size_t i) {
+            return analyseurLogs.getFilmsVusParUtilisateur(utilisateurs[i % utilisateurs.size()]).size();
+        });
+        analyseurLogs.definirCapaciteCache(0);
+        suite.mesurer("AnalyseurLogs", "getNFilmsPlusPopulaires(10) (sans cache)", [&](std::size_t) {
+            return analyseurLogs.getNFilmsPlusPopulaires(10).size();
+        });
+        suite.mesurer("AnalyseurLogs", "getFilmsVusParUtilisateur (sans cache)", [&](std::size_t i) {
+            return analyseurLogs.getFilmsVusParUtilisateur(utilisateurs[i % utilisateurs.size()]).size();
+        });
+        analyseurLogs.definirCapaciteCache(capaciteCacheParDefaut);
+        suite.mesurer("AnalyseurLogs", "creerLigneLog", [&](std::size_t i) {
+            return analyseurLogs.creerLigneLog("2019-01-01T00:00:00Z",
+                                               idsUtilisateurs[i % idsUtilisateurs.size()],
+                                               nomsFilms[i % nomsFilms.size()],
+                                               gestionnaireUtilisateurs,
+                                               gestionnaireFilms);
+        }, 100000);
+    }
+
+    /// Affiche les résultats sous forme de tableau lisible.
+    /// \param resultats    Les résultats à afficher.
+    void afficherTableau(const std::vector<Resultat>& resultats)
+    {
+        std::cout << std::left << std::setw(26) << "classe" << std::setw(42) << "operation" << std::right
+                  << std::setw(10) << "echelle" << std::setw(16) << "ns/op" << std::setw(16) << "ops/s"
+                  << std::setw(14) << "rss max (ko)" << '\n';
+        for (const Resultat& resultat : resultats)
+        {
+            std::cout << std::left << std::setw(26) << resultat.classe << std::setw(42) << resultat.operation
+                      << std::right << std::setw(10) << resultat.echelle << std::setw(16) << std::fixed
+                      << std::setprecision(1) << resultat.nsParOperation << std::setw(16) << std::setprecision(0)
+                      << 1e9 / resultat.nsParOperation << std::setw(14) << resultat.rssMaxKo << '\n';
+        }
+    }
+
+    /// Affiche les résultats en JSON, un objet par ligne, avec des clés dans un ordre fixe.
+    /// \param resultats    Les résultats à afficher.
+    void afficherJson(const std::vector<Resultat>& resultats)
+    {
+        for (const Resultat& resultat : resultats)
+        {
+            std::cout << "{\"classe\":\"" << resultat.classe << "\",\"operation\":\"" << resultat.operation
+                      << "\",\"echelle\":" << resultat.echelle << ",\"iterations\":" << resultat.iterations
+                      << ",\"ns_par_op\":" << std::fixed << std::setprecision(1) << resultat.nsParOperation
+                      << ",\"ops_par_s\":" << std::setprecision(0) << 1e9 / resultat.nsParOperation
+                      << ",\"rss_max_ko\":" << resultat.rssMaxKo << "}\n";
+        }
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool formatJson = false;
+    bool rapportInstrumentation = false;
+    std::vector<std::size_t> echelles = {1000, 10000, 100000};
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--json")
+        {
+            formatJson = true;
+        }
+        else if (argument == "--instrumentation")
+        {
+            rapportInstrumentation = true;
+        }
+        else if (argument == "--echelles" && i + 1 < argc)
+        {
+            echelles.clear();
+            std::istringstream liste(argv[++i]);
+            std::string echelle;
+            while (std::getline(liste, echelle, ','))
+            {
+                echelles.push_back(std::stoul(echelle));
+            }
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--json] [--echelles n1,n2,...] [--instrumentation]\n";
+            return 1;
+        }
+    }
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench";
+    std::filesystem::create_directories(dossier);
+
+    std::vector<Resultat> resultats;
+    std::size_t puits = 0;
+    for (std::size_t echelle : echelles)
+    {
+        ecrireDonnees(dossier, echelle);
+        Suite suite(echelle);
+        executerMesures(dossier, echelle, suite);
+        resultats.insert(resultats.end(), suite.getResultats().begin(), suite.getResultats().end());
+        puits += suite.getPuits();
+    }
+    std::filesystem::remove_all(dossier);
+
+    if (formatJson)
+    {
+        afficherJson(resultats);
+    }
+    else
+    {
+        afficherTableau(resultats);
+    }
+    if (rapportInstrumentation)
+    {
+        Instrumentation::ecrireRapportJson(std::cerr);
+    }
+    volatile std::size_t puitsFinal = puits;
+    (void)puitsFinal;
+}
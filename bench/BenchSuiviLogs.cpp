@@ -0,0 +1,108 @@
+/// Banc d'essai du suivi d'un fichier de logs: latence entre l'écriture d'une ligne et sa visibilité dans les
+/// statistiques de l'analyseur.
+///
+/// Usage: BenchSuiviLogs [echelle] [ajouts]
+///   echelle   Nombre de films et d'utilisateurs générés, avec 10 lignes de log par film (défaut: 10000)
+///   ajouts    Nombre de lignes ajoutées une à une au fichier suivi (défaut: 2000)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GenerateurDonnees.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "Horodatage.h"
+#include "SuiviFichierLogs.h"
+
+int main(int argc, char* argv[])
+{
+    std::size_t echelle = argc > 1 ? std::stoul(argv[1]) : 10000;
+    std::size_t nombreAjouts = argc > 2 ? std::stoul(argv[2]) : 2000;
+    OptionsGenerateur options;
+    options.graine = echelle;
+    options.nombreFilms = echelle;
+    options.nombreUtilisateurs = echelle;
+    options.nombreLignesLog = echelle * 10;
+    GenerateurDonnees generateur(options);
+
+    std::filesystem::path dossier = std::filesystem::temp_directory_path() / "td5_bench_suivi";
+    std::filesystem::create_directories(dossier);
+    {
+        std::ofstream films(dossier / "films.txt");
+        generateur.ecrireFilms(films);
+        std::ofstream utilisateurs(dossier / "utilisateurs.txt");
+        generateur.ecrireUtilisateurs(utilisateurs);
+        std::ofstream logs(dossier / "logs.txt");
+        generateur.ecrireLogs(logs);
+    }
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string());
+    gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+
+    // L'analyseur n'est touché que par le thread de suivi; le nombre de lignes appliquées est publié après chaque
+    // rattrapage
+    AnalyseurLogs analyseurLogs;
+    std::string nomFichier = (dossier / "logs.txt").string();
+    SuiviFichierLogs suivi(analyseurLogs, gestionnaireUtilisateurs, gestionnaireFilms, nomFichier);
+    auto debutChargement = std::chrono::steady_clock::now();
+    suivi.rattraper();
+    double dureeChargement =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debutChargement).count();
+    std::atomic<std::size_t> lignesVisibles{suivi.getNombreLignesAppliquees()};
+    std::atomic<bool> arreter{false};
+    std::thread threadSuivi([&] {
+        while (!arreter.load(std::memory_order_relaxed))
+        {
+            if (suivi.attendre(std::chrono::milliseconds(100)))
+            {
+                suivi.rattraper();
+                lignesVisibles.store(suivi.getNombreLignesAppliquees(), std::memory_order_release);
+            }
+        }
+    });
+
+    std::vector<double> latences;
+    latences.reserve(nombreAjouts);
+    std::ofstream logs(nomFichier, std::ios::binary | std::ios::app);
+    std::size_t lignesAttendues = lignesVisibles.load();
+    for (std::size_t i = 0; i < nombreAjouts; i++)
+    {
+        std::string ligne = formaterTimestamp(1546300800 + static_cast<std::int64_t>(i)) + ' ' +
+                            GenerateurDonnees::getIdUtilisateur(i % echelle) + " \"" +
+                            GenerateurDonnees::getNomFilm(i % echelle) + "\"\n";
+        auto debut = std::chrono::steady_clock::now();
+        logs << ligne << std::flush;
+        lignesAttendues++;
+        while (lignesVisibles.load(std::memory_order_acquire) < lignesAttendues)
+        {
+            std::this_thread::yield();
+        }
+        auto fin = std::chrono::steady_clock::now();
+        latences.push_back(std::chrono::duration<double, std::micro>(fin - debut).count());
+    }
+    arreter = true;
+    threadSuivi.join();
+    std::filesystem::remove_all(dossier);
+
+    std::sort(latences.begin(), latences.end());
+    auto centile = [&latences](double fraction) {
+        auto index = static_cast<std::size_t>(fraction * static_cast<double>(latences.size()));
+        return latences[std::min(latences.size() - 1, index)];
+    };
+    std::cout << std::fixed << std::setprecision(1) << "chargement initial de " << echelle * 10 << " lignes: "
+              << dureeChargement << " ms\n"
+              << nombreAjouts << " lignes ajoutées, latence écriture -> requête (us): p50 " << centile(0.5)
+              << ", p99 " << centile(0.99) << ", max " << latences.back() << '\n';
+    return analyseurLogs.getNombreVuesFilm(gestionnaireFilms.getFilmParNom(GenerateurDonnees::getNomFilm(0))) > 0
+               ? 0
+               : 1;
+}
@@ -5,34 +5,143 @@
 #ifndef ANALYSEURLOGS_H
 #define ANALYSEURLOGS_H
 
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include "CacheResultats.h"
+#include "ColonnesLogs.h"
 #include "GestionnaireFilms.h"
 #include "GestionnaireUtilisateurs.h"
 #include "LigneLog.h"
+#include "LogsCompresses.h"
+#include "LogsLSM.h"
+#include "PartitionsLogs.h"
+#include "RejetsChargement.h"
 #include "Tests.h"
+#include "UtilisationMemoire.h"
 
 /// Classe contenant la liste des entrées du log pour en analyser les tendances pertinentes.
+///
+/// Une durée de rétention peut borner la mémoire: les lignes plus anciennes que cette durée, comptée depuis la ligne
+/// la plus récente, sont retirées par lots et repliées dans des agrégats par film et par utilisateur. Le nombre de
+/// vues d'un film, les films les plus populaires et le nombre de vues d'un utilisateur ou d'un groupe restent exacts
+/// sur tout l'historique; les autres requêtes ne voient que les lignes conservées. Les vues archivées sont gardées par
+/// utilisateur et par film, pour être décomptées des deux côtés si un utilisateur ou un film est supprimé.
+///
+/// Les lignes conservées peuvent aussi être réparties en partitions par jour ou par mois, tenues à jour à chaque
+/// ajout. Les partitions sont un index secondaire: logs_ reste le stockage principal et chaque ligne est copiée dans sa
+/// partition, ce qui double à peu près la mémoire des lignes. Seul le nombre de vues d'un film dans un intervalle en
+/// profite, en ne lisant que les partitions qu'il chevauche. La rétention, qui retire les partitions entièrement
+/// expirées en gardant celle de la limite jusqu'à ce qu'elle expire à son tour, efface toujours le préfixe expiré de
+/// logs_.
+///
+/// Les lignes qui arrivent en retard sur la plus récente sont rangées dans un arbre LSM (LogsLSM) plutôt qu'insérées
+/// au milieu du vecteur trié, et y sont repliées d'une seule fusion lorsque le vecteur complet est nécessaire:
+/// getLogs(), la rétention, les retraits et remplacements, la compression. Les agrégats, les colonnes et les
+/// partitions les comptent dès leur ajout, donc les requêtes n'attendent pas ce repli.
+///
+/// Les résultats de getNFilmsPlusPopulaires et de getFilmsVusParUtilisateur sont conservés dans des caches bornés.
+/// Une ligne ajoutée ne périme que les films vus de son utilisateur et les classements dont son film peut désormais
+/// faire partie.
 class AnalyseurLogs
 {
 public:
+    /// Entrée brute d'un log, avant que l'utilisateur et le film ne soient résolus.
+    struct EntreeLog
+    {
+        std::string timestamp;
+        std::string idUtilisateur;
+        std::string nomFilm;
+    };
+
+    static bool analyserLigne(const std::string& ligne, EntreeLog& entreeLog);
+    static std::string formaterLigne(const EntreeLog& entreeLog);
+
     // Opérations d'ajout de logs
-    bool chargerDepuisFichier(const std::string& nomFichier, GestionnaireUtilisateurs& gestionnaireUtilisateurs,
-                              GestionnaireFilms& gestionnaireFilms);
+    BilanChargement chargerDepuisFichier(const std::string& nomFichier,
+                                         GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                         GestionnaireFilms& gestionnaireFilms,
+                                         const OptionsRejets& options = OptionsRejets());
     bool creerLigneLog(const std::string& timestamp, const std::string& idUtilisateur, const std::string& nomFilm,
                        GestionnaireUtilisateurs& gestionnaireUtilisateurs, GestionnaireFilms& gestionnaireFilms);
+    std::vector<bool> creerLignesLog(std::vector<EntreeLog> entreesLog,
+                                     const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                     const GestionnaireFilms& gestionnaireFilms,
+                                     CollecteurRejets* rejets = nullptr);
     void ajouterLigneLog(const LigneLog& ligneLog);
+    void ajouterLignesLog(std::vector<LigneLog> lignesLog);
+    void vider();
+
+    // Opérations de retrait et de remplacement
+    std::size_t retirerLignesFilms(const std::vector<const Film*>& films);
+    std::size_t retirerLignesUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs);
+    void remplacerFilms(const std::unordered_map<const Film*, const Film*>& remplacements);
+
+    // Rétention
+    void definirRetention(std::optional<std::chrono::seconds> duree);
+    std::size_t appliquerRetention();
+    std::size_t getNombreLignesArchivees() const;
+
+    // Partitionnement
+    void definirPartitionnement(std::optional<GranularitePartition> granularite);
+    const std::optional<PartitionsLogs>& getPartitions() const;
+
+    // Getters
+    const std::vector<LigneLog>& getLogs() const;
 
     // Statistiques
     int getNombreVuesFilm(const Film* film) const;
+    int getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const;
     const Film* getFilmPlusPopulaire() const;
     std::vector<std::pair<const Film*, int>> getNFilmsPlusPopulaires(std::size_t nombre) const;
     int getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const;
     std::vector<const Film*> getFilmsVusParUtilisateur(const Utilisateur* utilisateur) const;
+    int getNombreVuesPourUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const;
+    std::vector<std::pair<const Film*, int>>
+        getNFilmsPlusPopulairesPourUtilisateurs(std::size_t nombre,
+                                                const std::vector<const Utilisateur*>& utilisateurs) const;
+    UtilisationMemoire getUtilisationMemoire() const;
+    LogsCompresses compresserLogs() const;
+
+    // Cache des requêtes
+    void definirCapaciteCache(std::size_t capacite);
+    StatistiquesCache getStatistiquesCache() const;
 
 private:
-    std::vector<LigneLog> logs_;
-    std::unordered_map<const Film*, int> vuesFilms_;
+    using Classement = std::vector<std::pair<const Film*, int>>;
+
+    static constexpr std::size_t capaciteCacheClassements = 16; // Chaque ligne ajoutée parcourt ces entrées
+
+    void reconstruireColonnes();
+    LogsLSM& getRetards();
+    void replierRetards() const;
+    std::size_t retirerLignesExpirees(std::size_t nombreMinimum);
+    std::size_t retirerLignes(const std::unordered_set<const Film*>& films,
+                              const std::unordered_set<const Utilisateur*>& utilisateurs);
+    void invaliderFilmsVus(const LigneLog* debut, const LigneLog* fin);
+    void invaliderClassements(const LigneLog* debut, const LigneLog* fin);
+
+    // Triées par timestamp. Les lignes en retard attendent dans retards_; les deux sont mutables parce que getLogs()
+    // const les replie
+    mutable std::vector<LigneLog> logs_;
+    mutable std::optional<LogsLSM> retards_; // Lignes plus anciennes que logs_.back() à leur arrivée
+    std::unordered_map<const Film*, int> vuesFilms_; // Vues de tout l'historique, lignes archivées comprises
+    // Les mêmes lignes que logs_, tenues à jour par chaque opération qui modifie logs_: en colonnes pour les requêtes
+    // qui parcourent les logs, et par période
+    ColonnesLogs colonnes_;
+    std::optional<PartitionsLogs> partitions_;
+
+    std::optional<std::int64_t> secondesRetention_;
+    // Vues des lignes retirées de logs_, par utilisateur puis par film
+    std::unordered_map<const Utilisateur*, std::unordered_map<const Film*, int>> vuesArchiveesUtilisateurs_;
+    std::size_t nombreLignesArchivees_ = 0;
+
+    mutable CacheResultats<std::size_t, Classement> cacheClassements_{capaciteCacheClassements};
+    mutable CacheResultats<const Utilisateur*, std::vector<const Film*>> cacheFilmsVus_;
 
     friend double Tests::testAnalyseurLogs(); // Pour les tests
 };
@@ -0,0 +1,94 @@
+/// Analyseur de logs hors mémoire, pour les fichiers de logs plus gros que la mémoire disponible.
+
+#ifndef ANALYSEURLOGSEXTERNE_H
+#define ANALYSEURLOGSEXTERNE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "RejetsChargement.h"
+#include "UtilisationMemoire.h"
+
+/// Classe qui répond aux mêmes statistiques qu'AnalyseurLogs sans garder les lignes de log en mémoire. Le
+/// chargement trie les lignes par tranches qui tiennent dans le budget mémoire et les écrit dans des séquences
+/// triées sur disque, puis les fusionne en segments immuables projetés en mémoire (mmap). Seuls les nombres de vues
+/// par film et par utilisateur, ainsi que les dictionnaires d'identifiants, restent résidents; les autres requêtes
+/// parcourent les segments en flux.
+///
+/// Les instants sont triés en secondes, ce qui équivaut à l'ordre d'AnalyseurLogs pour les timestamps bien formés.
+/// Le dossier de travail ne doit pas être partagé entre deux instances.
+class AnalyseurLogsExterne
+{
+public:
+    static constexpr std::size_t budgetMemoireDefaut = std::size_t(64) << 20;
+
+    /// Ligne de log résolue telle qu'écrite dans les séquences et les segments.
+    struct EnregistrementLog
+    {
+        std::int64_t secondes;
+        std::uint32_t utilisateur; // Identifiant dense, position dans utilisateurs_
+        std::uint32_t film;        // Identifiant dense, position dans films_
+    };
+
+    class Segment;
+
+    // Fonctions membres spéciales
+    explicit AnalyseurLogsExterne(std::filesystem::path dossierTravail,
+                                  std::size_t budgetMemoire = budgetMemoireDefaut);
+    ~AnalyseurLogsExterne();
+    AnalyseurLogsExterne(const AnalyseurLogsExterne&) = delete;
+    AnalyseurLogsExterne& operator=(const AnalyseurLogsExterne&) = delete;
+
+    // Opérations d'ajout de logs
+    BilanChargement chargerDepuisFichier(const std::string& nomFichier,
+                                         const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                         const GestionnaireFilms& gestionnaireFilms,
+                                         const OptionsRejets& options = OptionsRejets());
+
+    // Statistiques
+    int getNombreVuesFilm(const Film* film) const;
+    int getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const;
+    const Film* getFilmPlusPopulaire() const;
+    std::vector<std::pair<const Film*, int>> getNFilmsPlusPopulaires(std::size_t nombre) const;
+    int getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const;
+    std::vector<const Film*> getFilmsVusParUtilisateur(const Utilisateur* utilisateur) const;
+    int getNombreVuesPourUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const;
+    std::vector<std::pair<const Film*, int>>
+        getNFilmsPlusPopulairesPourUtilisateurs(std::size_t nombre,
+                                                const std::vector<const Utilisateur*>& utilisateurs) const;
+
+    // Getters
+    std::size_t getNombreLignes() const;
+    std::size_t getNombreSequences() const;
+    std::size_t getNombrePassesFusion() const;
+    std::size_t getNombreSegments() const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+private:
+    void vider();
+    bool ecrireSequence(std::vector<EnregistrementLog>& tampon, std::vector<std::filesystem::path>& sequences);
+    bool fusionner(std::vector<std::filesystem::path> sequences);
+    std::uint32_t getIdFilm(const Film* film) const;
+    std::uint32_t getIdUtilisateur(const Utilisateur* utilisateur) const;
+
+    std::filesystem::path dossierTravail_;
+    std::size_t budgetMemoire_;
+
+    std::vector<std::unique_ptr<Segment>> segments_;
+    std::size_t nombreSequences_ = 0;
+    std::size_t nombrePassesFusion_ = 0;
+
+    std::vector<const Film*> films_;
+    std::vector<const Utilisateur*> utilisateurs_;
+    std::unordered_map<const Film*, std::uint32_t> idsFilms_;
+    std::unordered_map<const Utilisateur*, std::uint32_t> idsUtilisateurs_;
+    std::vector<int> vuesFilms_;        // Indexé par identifiant de film
+    std::vector<int> vuesUtilisateurs_; // Indexé par identifiant d'utilisateur
+};
+
+#endif // ANALYSEURLOGSEXTERNE_H
@@ -0,0 +1,19 @@
+/// Bilan d'un rechargement incrémental d'un catalogue.
+
+#ifndef BILANRECHARGEMENT_H
+#define BILANRECHARGEMENT_H
+
+#include <cstddef>
+
+/// Nombre d'enregistrements touchés par chaque opération d'un rechargement qui n'applique que les différences entre
+/// le fichier et le contenu du gestionnaire.
+struct BilanRechargement
+{
+    bool succes = false; // Le fichier a été ouvert et toutes ses lignes ont été interprétées
+    std::size_t nombreAjouts = 0;
+    std::size_t nombreModifications = 0;
+    std::size_t nombreSuppressions = 0;
+    std::size_t nombreInchanges = 0;
+};
+
+#endif // BILANRECHARGEMENT_H
@@ -0,0 +1,248 @@
+/// Cache borné des résultats de requêtes, avec éviction du moins récemment utilisé.
+
+#ifndef CACHERESULTATS_H
+#define CACHERESULTATS_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include "UtilisationMemoire.h"
+
+/// Nombre maximal d'entrées d'un cache de résultats, sauf indication contraire.
+constexpr std::size_t capaciteCacheParDefaut = 256;
+
+/// Statistiques d'utilisation d'un cache de résultats.
+struct StatistiquesCache
+{
+    std::size_t nombreSucces = 0;        // Requêtes servies par le cache
+    std::size_t nombreDefauts = 0;       // Requêtes recalculées, y compris celles dont l'entrée était périmée
+    std::size_t nombreInvalidations = 0; // Entrées retirées parce qu'une modification les a rendues périmées
+    std::size_t nombreEvictions = 0;     // Entrées retirées pour respecter la capacité
+
+    StatistiquesCache& operator+=(const StatistiquesCache& autres)
+    {
+        nombreSucces += autres.nombreSucces;
+        nombreDefauts += autres.nombreDefauts;
+        nombreInvalidations += autres.nombreInvalidations;
+        nombreEvictions += autres.nombreEvictions;
+        return *this;
+    }
+};
+
+/// Cache des résultats d'une requête, borné à une capacité au-delà de laquelle l'entrée la moins récemment utilisée
+/// est évincée. Chaque entrée porte le numéro de génération de son propriétaire au moment du calcul: le propriétaire
+/// peut invalider ses entrées tout de suite (retirer, retirerSi), ou les valider à la lecture en comparant ce numéro
+/// aux générations des données dont elles dépendent (trouver).
+///
+/// Les opérations sont protégées par un verrou, pour que les requêtes const du propriétaire puissent remplir le cache
+/// depuis plusieurs threads. Une copie du cache est vide: les résultats sont propres aux données du propriétaire.
+/// \tparam Cle     Le type des paramètres de la requête (doit pouvoir être haché par std::hash).
+/// \tparam Valeur  Le type du résultat de la requête.
+template<typename Cle, typename Valeur>
+class CacheResultats
+{
+public:
+    // Fonctions membres spéciales
+    explicit CacheResultats(std::size_t capacite = capaciteCacheParDefaut) : capacite_(capacite) {}
+    CacheResultats(const CacheResultats& other) : capacite_(other.getCapacite()) {}
+    CacheResultats(CacheResultats&& other) noexcept : capacite_(other.capacite_) { echanger(other); }
+
+    /// Opérateur d'assignation utilisant le copy-and-swap idiom.
+    /// \param other    Le cache à partir duquel copier, ou déplacer, la capacité et les entrées.
+    /// \return         Référence à l'objet actuel.
+    CacheResultats& operator=(CacheResultats other)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        std::swap(capacite_, other.capacite_);
+        echanger(other);
+        return *this;
+    }
+
+    /// Cherche le résultat d'une requête. Une entrée que estAJour juge périmée est retirée et compte comme un défaut.
+    /// \param cle          Les paramètres de la requête.
+    /// \param estAJour     Appelée avec la génération de l'entrée; retourne false si les données ont changé depuis.
+    /// \return             Une copie du résultat, ou std::nullopt s'il doit être recalculé.
+    template<typename EstAJour>
+    std::optional<Valeur> trouver(const Cle& cle, EstAJour&& estAJour)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        auto entree = index_.find(cle);
+        if (entree == index_.end())
+        {
+            statistiques_.nombreDefauts++;
+            return std::nullopt;
+        }
+        if (!estAJour(entree->second->generation))
+        {
+            entrees_.erase(entree->second);
+            index_.erase(entree);
+            statistiques_.nombreInvalidations++;
+            statistiques_.nombreDefauts++;
+            return std::nullopt;
+        }
+        entrees_.splice(entrees_.begin(), entrees_, entree->second);
+        statistiques_.nombreSucces++;
+        return entree->second->valeur;
+    }
+
+    /// Cherche le résultat d'une requête dont les entrées sont invalidées dès qu'elles deviennent périmées.
+    /// \param cle  Les paramètres de la requête.
+    /// \return     Une copie du résultat, ou std::nullopt s'il doit être recalculé.
+    std::optional<Valeur> trouver(const Cle& cle)
+    {
+        return trouver(cle, [](std::uint64_t) { return true; });
+    }
+
+    /// Conserve le résultat d'une requête comme entrée la plus récemment utilisée, en évinçant au besoin la moins
+    /// récemment utilisée.
+    /// \param cle          Les paramètres de la requête.
+    /// \param valeur       Le résultat de la requête.
+    /// \param generation   La génération des données à partir desquelles le résultat a été calculé.
+    void inserer(const Cle& cle, Valeur valeur, std::uint64_t generation = 0)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        if (capacite_ == 0)
+        {
+            return;
+        }
+        auto entree = index_.find(cle);
+        if (entree != index_.end())
+        {
+            entree->second->valeur = std::move(valeur);
+            entree->second->generation = generation;
+            entrees_.splice(entrees_.begin(), entrees_, entree->second);
+            return;
+        }
+        entrees_.push_front(Entree{cle, std::move(valeur), generation});
+        index_.emplace(cle, entrees_.begin());
+        evincer();
+    }
+
+    /// Retire l'entrée d'une requête dont le résultat a changé.
+    /// \param cle  Les paramètres de la requête.
+    void retirer(const Cle& cle)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        auto entree = index_.find(cle);
+        if (entree != index_.end())
+        {
+            entrees_.erase(entree->second);
+            index_.erase(entree);
+            statistiques_.nombreInvalidations++;
+        }
+    }
+
+    /// Retire les entrées dont le résultat a changé.
+    /// \param estPerimee   Appelée avec la clé et le résultat de chaque entrée; retourne true pour la retirer.
+    template<typename EstPerimee>
+    void retirerSi(EstPerimee&& estPerimee)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        for (auto entree = entrees_.begin(); entree != entrees_.end();)
+        {
+            if (estPerimee(static_cast<const Cle&>(entree->cle), static_cast<const Valeur&>(entree->valeur)))
+            {
+                index_.erase(entree->cle);
+                entree = entrees_.erase(entree);
+                statistiques_.nombreInvalidations++;
+            }
+            else
+            {
+                ++entree;
+            }
+        }
+    }
+
+    /// Retire toutes les entrées, par exemple lorsque toutes les données sont remplacées. Les statistiques sont
+    /// conservées.
+    void vider()
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        statistiques_.nombreInvalidations += entrees_.size();
+        entrees_.clear();
+        index_.clear();
+    }
+
+    /// Change le nombre maximal d'entrées, en évinçant au besoin les moins récemment utilisées.
+    /// \param capacite     Le nombre maximal d'entrées; 0 désactive le cache.
+    void definirCapacite(std::size_t capacite)
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        capacite_ = capacite;
+        evincer();
+    }
+
+    /// \return True si le cache ne contient aucune entrée, ce qui permet d'éviter le calcul d'une invalidation.
+    bool estVide() const
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        return entrees_.empty();
+    }
+
+    /// \return Le nombre maximal d'entrées.
+    std::size_t getCapacite() const
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        return capacite_;
+    }
+
+    /// \return Les statistiques cumulées depuis la construction.
+    StatistiquesCache getStatistiques() const
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        return statistiques_;
+    }
+
+    /// \return Les octets alloués sur le tas par les entrées et leur index.
+    std::size_t getOctetsTas() const
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        std::size_t octets = entrees_.size() * (2 * sizeof(void*) + sizeof(Entree));
+        for (const Entree& entree : entrees_)
+        {
+            octets += octetsTas(entree.cle) + octetsTas(entree.valeur);
+        }
+        using ElementIndex = typename decltype(index_)::value_type;
+        return octets + index_.bucket_count() * sizeof(void*) + index_.size() * tailleNoeudHachage<Cle, ElementIndex>;
+    }
+
+private:
+    /// Entrée du cache, dans la liste triée de la plus récemment à la moins récemment utilisée.
+    struct Entree
+    {
+        Cle cle;
+        Valeur valeur;
+        std::uint64_t generation;
+    };
+
+    /// Échange les entrées et les statistiques avec un autre cache. Le verrou de l'objet actuel doit être tenu.
+    void echanger(CacheResultats& other)
+    {
+        std::lock_guard<std::mutex> verrou(other.mutex_);
+        entrees_.swap(other.entrees_);
+        index_.swap(other.index_);
+        std::swap(statistiques_, other.statistiques_);
+    }
+
+    /// Évince les entrées les moins récemment utilisées au-delà de la capacité. Le verrou doit être tenu.
+    void evincer()
+    {
+        while (entrees_.size() > capacite_)
+        {
+            index_.erase(entrees_.back().cle);
+            entrees_.pop_back();
+            statistiques_.nombreEvictions++;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::size_t capacite_;
+    std::list<Entree> entrees_;
+    std::unordered_map<Cle, typename std::list<Entree>::iterator> index_;
+    StatistiquesCache statistiques_;
+};
+
+#endif // CACHERESULTATS_H
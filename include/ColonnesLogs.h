@@ -0,0 +1,51 @@
+/// Stockage en colonnes des lignes de log.
+
+#ifndef COLONNESLOGS_H
+#define COLONNESLOGS_H
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "LigneLog.h"
+#include "UtilisationMemoire.h"
+
+/// Classe qui conserve les lignes de log sous forme de colonnes contiguës: l'instant en secondes, puis
+/// l'utilisateur et le film remplacés par des identifiants denses de 32 bits. Un parcours qui ne lit qu'une colonne
+/// ne charge ainsi que 4 ou 8 octets par ligne, plutôt qu'une LigneLog entière, et se prête aux noyaux de
+/// NoyauxColonnes. Les lignes sont conservées dans leur ordre d'ajout.
+class ColonnesLogs
+{
+public:
+    static constexpr std::int64_t secondesInvalides = std::numeric_limits<std::int64_t>::min();
+    static constexpr std::uint32_t idAbsent = std::numeric_limits<std::uint32_t>::max();
+
+    // Opérations d'ajout et de suppression
+    void ajouter(const LigneLog& ligneLog);
+    void reserver(std::size_t nombreLignes);
+    void vider();
+
+    // Getters
+    std::size_t getTaille() const;
+    std::uint32_t getIdUtilisateur(const Utilisateur* utilisateur) const;
+    std::uint32_t getIdFilm(const Film* film) const;
+    std::size_t getNombreUtilisateurs() const;
+    std::size_t getNombreFilms() const;
+    const Film* getFilm(std::uint32_t idFilm) const;
+    const std::int64_t* getSecondes() const;
+    const std::uint32_t* getUtilisateurs() const;
+    const std::uint32_t* getFilms() const;
+    std::vector<std::uint32_t> getMasqueUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+private:
+    std::vector<std::int64_t> secondes_;
+    std::vector<std::uint32_t> utilisateurs_;
+    std::vector<std::uint32_t> films_;
+
+    std::unordered_map<const Utilisateur*, std::uint32_t> idsUtilisateurs_;
+    std::unordered_map<const Film*, std::uint32_t> idsFilms_;
+    std::vector<const Film*> filmsParId_;
+};
+
+#endif // COLONNESLOGS_H
@@ -0,0 +1,50 @@
+/// Conteneur partagé avec copie sur écriture.
+
+#ifndef COPIESURECRITURE_H
+#define COPIESURECRITURE_H
+
+#include <memory>
+
+/// Enveloppe une valeur partagée entre plusieurs copies jusqu'à ce que l'une d'elles la modifie. La copie de
+/// l'enveloppe coûte O(1); la valeur n'est dupliquée qu'au premier appel à modifier() sur une instance partagée.
+/// \tparam T   Le type de la valeur partagée (doit être constructible par défaut et par copie).
+template<typename T>
+class CopieSurEcriture
+{
+public:
+    /// Retourne la valeur en lecture seule (une valeur vide si aucune n'a encore été créée).
+    /// \return Une référence constante à la valeur.
+    const T& lire() const
+    {
+        static const T valeurVide{};
+        return donnees_ ? *donnees_ : valeurVide;
+    }
+
+    /// Retourne la valeur en écriture, en la dupliquant d'abord si elle est partagée avec une autre instance.
+    /// \return Une référence à la valeur propre à cette instance.
+    T& modifier()
+    {
+        if (!donnees_)
+        {
+            donnees_ = std::make_shared<T>();
+        }
+        else if (donnees_.use_count() > 1)
+        {
+            donnees_ = std::make_shared<T>(*donnees_);
+        }
+        return *donnees_;
+    }
+
+    /// Indique si la valeur est présentement partagée avec une autre instance.
+    /// \return True si la valeur est partagée, false sinon.
+    bool estPartage() const { return donnees_.use_count() > 1; }
+
+    /// Indique si la valeur a été allouée, c'est-à-dire si modifier() a déjà été appelé.
+    /// \return True si la valeur existe sur le tas, false sinon.
+    bool estAlloue() const { return donnees_ != nullptr; }
+
+private:
+    std::shared_ptr<T> donnees_;
+};
+
+#endif // COPIESURECRITURE_H
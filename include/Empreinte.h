@@ -0,0 +1,37 @@
+/// Empreinte du contenu d'un enregistrement, pour détecter les enregistrements modifiés sans les comparer champ par
+/// champ.
+
+#ifndef EMPREINTE_H
+#define EMPREINTE_H
+
+#include <cstdint>
+#include <string>
+
+/// Classe qui accumule les champs d'un enregistrement dans une empreinte FNV-1a de 64 bits. Chaque chaîne est
+/// précédée de sa longueur, pour que ("ab", "c") et ("a", "bc") n'aient pas la même empreinte.
+class Empreinte
+{
+public:
+    void ajouter(const std::string& texte)
+    {
+        ajouter(static_cast<std::int64_t>(texte.size()));
+        ajouterOctets(texte.data(), texte.size());
+    }
+
+    void ajouter(std::int64_t valeur) { ajouterOctets(reinterpret_cast<const char*>(&valeur), sizeof(valeur)); }
+
+    std::uint64_t getValeur() const { return valeur_; }
+
+private:
+    void ajouterOctets(const char* octets, std::size_t taille)
+    {
+        for (std::size_t i = 0; i < taille; i++)
+        {
+            valeur_ = (valeur_ ^ static_cast<unsigned char>(octets[i])) * 1099511628211ull;
+        }
+    }
+
+    std::uint64_t valeur_ = 14695981039346656037ull;
+};
+
+#endif // EMPREINTE_H
@@ -0,0 +1,61 @@
+/// Export en flux des films, des utilisateurs, des logs et des vues par film aux formats CSV, JSON et NDJSON.
+
+#ifndef EXPORTATION_H
+#define EXPORTATION_H
+
+#include <cstddef>
+#include <filesystem>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+
+/// Format d'un fichier exporté.
+enum class FormatExport
+{
+    Csv,   // Une ligne d'en-tête, puis une ligne par enregistrement (RFC 4180)
+    Json,  // Un tableau d'objets
+    Ndjson // Un objet par ligne
+};
+
+/// Paramètres d'un export.
+struct OptionsExport
+{
+    std::size_t octetsTampon = std::size_t(1) << 22; // Octets accumulés avant chaque écriture
+    std::size_t octetsReference = 256;               // Taille à partir de laquelle un champ est écrit sans être copié
+};
+
+/// Bilan d'un export.
+struct BilanExport
+{
+    bool succes = false; // Le fichier a été créé et entièrement écrit
+    std::size_t nombreEnregistrements = 0;
+    std::size_t nombreOctets = 0;
+    std::size_t nombreEcritures = 0; // Appels système d'écriture
+};
+
+/// Fonctions qui écrivent un fichier complet à partir des données d'un gestionnaire ou de l'analyseur de logs, sans
+/// passer par std::ostream. Les champs sont formatés directement dans un grand tampon, les entiers avec std::to_chars.
+/// Un champ d'au moins octetsReference octets n'est pas copié: il est écrit depuis sa place en mémoire, avec les
+/// parties du tampon qui l'entourent, par un seul appel à writev. Les genres et les pays sont écrits par leur nom.
+namespace Exportation
+{
+    BilanExport exporterFilms(const GestionnaireFilms& gestionnaireFilms,
+                              const std::filesystem::path& chemin,
+                              FormatExport format,
+                              const OptionsExport& options = OptionsExport());
+    BilanExport exporterUtilisateurs(const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                     const std::filesystem::path& chemin,
+                                     FormatExport format,
+                                     const OptionsExport& options = OptionsExport());
+    BilanExport exporterLogs(const AnalyseurLogs& analyseurLogs,
+                             const std::filesystem::path& chemin,
+                             FormatExport format,
+                             const OptionsExport& options = OptionsExport());
+    BilanExport exporterVuesFilms(const AnalyseurLogs& analyseurLogs,
+                                  const GestionnaireFilms& gestionnaireFilms,
+                                  const std::filesystem::path& chemin,
+                                  FormatExport format,
+                                  const OptionsExport& options = OptionsExport());
+} // namespace Exportation
+
+#endif // EXPORTATION_H
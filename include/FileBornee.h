@@ -0,0 +1,107 @@
+/// File bornée sans verrou entre un producteur et un consommateur.
+
+#ifndef FILEBORNEE_H
+#define FILEBORNEE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// File circulaire de capacité fixe reliant exactement un thread producteur à un thread consommateur. Les positions
+/// de lecture et d'écriture sont des compteurs atomiques sur des lignes de cache distinctes; aucune opération ne
+/// prend de verrou. Un producteur qui trouve la file pleine attend que le consommateur la vide (contre-pression).
+/// \tparam T   Le type des éléments, habituellement un lot (vecteur) pour amortir le coût de synchronisation.
+template<typename T>
+class FileBornee
+{
+public:
+    /// Constructeur qui arrondit la capacité à la puissance de 2 supérieure.
+    /// \param capacite Le nombre maximal d'éléments en attente dans la file.
+    explicit FileBornee(std::size_t capacite)
+    {
+        std::size_t taille = 1;
+        while (taille < capacite)
+        {
+            taille *= 2;
+        }
+        elements_.resize(taille);
+        masque_ = taille - 1;
+    }
+
+    FileBornee(const FileBornee&) = delete;
+    FileBornee& operator=(const FileBornee&) = delete;
+
+    /// Ajoute un élément si la file n'est pas pleine. Appelé par le producteur seulement.
+    /// \param valeur   L'élément à ajouter, déplacé dans la file en cas de succès.
+    /// \return         True si l'élément a été ajouté, false si la file est pleine.
+    bool essayerAjouter(T& valeur)
+    {
+        std::size_t ecriture = positionEcriture_.load(std::memory_order_relaxed);
+        if (ecriture - positionLecture_.load(std::memory_order_acquire) > masque_)
+        {
+            return false;
+        }
+        elements_[ecriture & masque_] = std::move(valeur);
+        positionEcriture_.store(ecriture + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Retire un élément si la file n'est pas vide. Appelé par le consommateur seulement.
+    /// \param valeur   L'élément retiré.
+    /// \return         True si un élément a été retiré, false si la file est vide.
+    bool essayerRetirer(T& valeur)
+    {
+        std::size_t lecture = positionLecture_.load(std::memory_order_relaxed);
+        if (lecture == positionEcriture_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        valeur = std::move(elements_[lecture & masque_]);
+        positionLecture_.store(lecture + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Ajoute un élément en attendant qu'une place se libère.
+    /// \param valeur   L'élément à ajouter.
+    void ajouter(T valeur)
+    {
+        while (!essayerAjouter(valeur))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Retire un élément en attendant qu'il y en ait un ou que le producteur ait fermé la file.
+    /// \param valeur   L'élément retiré.
+    /// \return         True si un élément a été retiré, false si la file est fermée et vide.
+    bool retirer(T& valeur)
+    {
+        while (!essayerRetirer(valeur))
+        {
+            if (estFermee_.load(std::memory_order_acquire))
+            {
+                return essayerRetirer(valeur); // Un dernier élément a pu être ajouté juste avant la fermeture
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /// Indique au consommateur que le producteur n'ajoutera plus d'éléments.
+    void fermer() { estFermee_.store(true, std::memory_order_release); }
+
+    /// \return True si le producteur a fermé la file. Les éléments ajoutés avant la fermeture restent à retirer.
+    bool estFermee() const { return estFermee_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> elements_;
+    std::size_t masque_;
+
+    alignas(64) std::atomic<std::size_t> positionLecture_{0};
+    alignas(64) std::atomic<std::size_t> positionEcriture_{0};
+    alignas(64) std::atomic<bool> estFermee_{false};
+};
+
+#endif // FILEBORNEE_H
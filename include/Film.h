@@ -5,6 +5,7 @@
 #ifndef FILM_H
 #define FILM_H
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include "Pays.h"
@@ -34,6 +35,7 @@ struct Film
 };
 
 std::string getGenreString(Film::Genre genre);
+std::uint64_t getEmpreinte(const Film& film);
 std::ostream& operator<<(std::ostream& outputStream, const Film& film);
 
 #endif // FILM_H
@@ -9,7 +9,8 @@ class EstDansIntervalleDatesFilm
     //Constructeur
     EstDansIntervalleDatesFilm(int borneInf, int borneSup) : borneInf_(borneInf), borneSup_(borneSup){};
 
-    bool operator()(const std::unique_ptr<Film>& film)
+    template<typename PointeurFilm>
+    bool operator()(const PointeurFilm& film)
     {
         return (film->annee >= borneInf_ && film->annee <=borneSup_);
     }
@@ -23,7 +24,7 @@ class EstDansIntervalleDatesFilm
 class ComparateurLog
 {
     public :
-    bool operator()(const LigneLog& ligne1, const LigneLog& ligne2)
+    bool operator()(const LigneLog& ligne1, const LigneLog& ligne2) const
     {
         return ligne1.timestamp < ligne2.timestamp;
     };
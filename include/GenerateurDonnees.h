@@ -0,0 +1,51 @@
+/// Générateur déterministe de jeux de données aux formats de films.txt, utilisateurs.txt et logs.txt.
+
+#ifndef GENERATEURDONNEES_H
+#define GENERATEURDONNEES_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/// Ordre dans lequel les timestamps sont écrits dans le fichier de logs.
+enum class OrdreTimestamps
+{
+    Trie,
+    Melange,
+    PresqueTrie
+};
+
+/// Paramètres d'un jeu de données généré.
+struct OptionsGenerateur
+{
+    std::uint64_t graine = 1;
+    std::uint64_t nombreFilms = 1000;
+    std::uint64_t nombreUtilisateurs = 1000;
+    std::uint64_t nombreLignesLog = 10000;
+    double exposantZipf = 1.0;          // Popularité des films; 0 donne une distribution uniforme
+    OrdreTimestamps ordre = OrdreTimestamps::Trie;
+    double tauxDesordre = 0.01;         // Fraction des lignes en retard lorsque l'ordre est PresqueTrie
+    double tauxLignesInvalides = 0.0;   // Fraction des lignes volontairement mal formées
+    std::int64_t debutTimestamps = 1514764800; // 2018-01-01T00:00:00Z
+    std::int64_t dureeTimestamps = 365 * 86400;
+};
+
+/// Classe qui écrit des films, des utilisateurs et des lignes de log synthétiques en flux continu, sans conserver le
+/// jeu de données en mémoire. Pour des options données, la sortie est identique d'une exécution à l'autre.
+class GenerateurDonnees
+{
+public:
+    explicit GenerateurDonnees(const OptionsGenerateur& options);
+
+    void ecrireFilms(std::ostream& sortie) const;
+    void ecrireUtilisateurs(std::ostream& sortie) const;
+    void ecrireLogs(std::ostream& sortie) const;
+
+    static std::string getNomFilm(std::uint64_t index);
+    static std::string getIdUtilisateur(std::uint64_t index);
+
+private:
+    OptionsGenerateur options_;
+};
+
+#endif // GENERATEURDONNEES_H
@@ -5,16 +5,46 @@
 #ifndef GESTIONNAIREFILMS_H
 #define GESTIONNAIREFILMS_H
 
+#include <array>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "BilanRechargement.h"
+#include "CacheResultats.h"
+#include "CopieSurEcriture.h"
 #include "Film.h"
+#include "IndexParesseux.h"
+#include "PredicatsFilms.h"
+#include "RejetsChargement.h"
+#include "UtilisationMemoire.h"
+
+class AnalyseurLogs;
 
 /// Classe qui gère les informations de tous les films et qui conserve des filtres pour les rechercher rapidement.
+/// Les films et les filtres sont partagés entre les copies (copie sur écriture): copier un gestionnaire coûte O(1)
+/// et seules les parties modifiées par la suite (vecteur de films, shard du filtre par nom, catégories touchées) sont
+/// dupliquées. Les films eux-mêmes ne sont jamais dupliqués.
+///
+/// Les résultats de getFilmsEntreAnnees sont conservés dans un cache borné. Un ajout ou une suppression ne périme que
+/// les intervalles qui contiennent l'année du film touché.
+///
+/// Le filtre par nom garantit l'unicité des noms et est toujours maintenu. Les filtres par genre et par pays ne sont
+/// construits qu'à leur première requête, en parallèle, puis maintenus à chaque modification: un chargement qui
+/// n'est suivi que de recherches par nom ne les paie jamais. Un filtre désactivé libère sa mémoire et ses requêtes
+/// parcourent tous les films.
 class GestionnaireFilms
 {
 public:
+    /// Filtres secondaires qui peuvent être désactivés.
+    enum class Index
+    {
+        Genre,
+        Pays
+    };
+
     // Fonctions membres spéciales
     GestionnaireFilms() = default;
     GestionnaireFilms(const GestionnaireFilms& other);
@@ -25,24 +55,130 @@ public:
     friend std::ostream& operator<<(std::ostream& outputStream, const GestionnaireFilms& gestionnaireFilms);
 
     // Opérations d'ajout et de suppression
-    bool chargerDepuisFichier(const std::string& nomFichier);
+    BilanChargement chargerDepuisFichier(const std::string& nomFichier,
+                                         const OptionsRejets& options = OptionsRejets());
+    BilanRechargement rechargerDepuisFichier(const std::string& nomFichier, AnalyseurLogs* analyseurLogs = nullptr);
     bool ajouterFilm(const Film& film);
+    bool ajouterFilm(Film&& film);
     bool supprimerFilm(const std::string& nomFilm);
+    std::vector<bool> ajouterFilms(std::vector<Film> films);
+    std::vector<bool> supprimerFilms(const std::vector<std::string>& nomsFilms);
 
     // Getters
     std::size_t getNombreFilms() const;
+    std::vector<const Film*> getFilms() const;
     const Film* getFilmParNom(const std::string& nom) const;
     std::vector<const Film*> getFilmsParGenre(Film::Genre genre) const;
     std::vector<const Film*> getFilmsParPays(Pays pays) const;
     std::vector<const Film*> getFilmsEntreAnnees(int anneeDebut, int anneeFin);
+    template<typename Predicat>
+    std::vector<const Film*> getFilmsSelon(const Predicat& predicat) const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+    // Cache des requêtes
+    void definirCapaciteCache(std::size_t capacite);
+    StatistiquesCache getStatistiquesCache() const;
+
+    // Filtres secondaires
+    void activerIndex(Index index);
+    void desactiverIndex(Index index);
+    bool estIndexConstruit(Index index) const;
 
 private:
-    std::vector<std::unique_ptr<Film>> films_; // Vecteur de pointeurs pour ne pas que les éléments des filtres
-                                               // deviennent invalidés lors d'un resize du vecteur
+    static constexpr std::size_t nombreShardsNoms = 64;
+
+    using FiltreNoms = std::unordered_map<std::string, const Film*>;
+    using IndexGenres = IndexParesseux<Film::Genre, const Film*>;
+    using IndexPays = IndexParesseux<Pays, const Film*>;
+
+    static std::size_t getIndexShardNom(const std::string& nom);
+    const Film* insererFilm(std::shared_ptr<const Film> film);
+    void invaliderAnnee(int annee);
+    const IndexGenres::Filtre* getFiltreGenres() const;
+    const IndexPays::Filtre* getFiltrePays() const;
 
-    std::unordered_map<std::string, const Film*> filtreNomFilms_;
-    std::unordered_map<Film::Genre, std::vector<const Film*>> filtreGenreFilms_;
-    std::unordered_map<Pays, std::vector<const Film*>> filtrePaysFilms_;
+    // Vecteur de pointeurs pour ne pas que les éléments des filtres deviennent invalidés lors d'un resize du vecteur.
+    // Les pointeurs sont partagés pour que les copies du gestionnaire puissent partager les mêmes films. Les films sont
+    // créés non constants pour qu'un rechargement puisse modifier sur place ceux qu'aucune copie ne partage.
+    CopieSurEcriture<std::vector<std::shared_ptr<const Film>>> films_;
+
+    // Le filtre par nom est réparti en shards pour qu'une modification ne duplique qu'une fraction de l'index
+    std::array<CopieSurEcriture<FiltreNoms>, nombreShardsNoms> filtreNomFilms_;
+    IndexGenres filtreGenreFilms_;
+    IndexPays filtrePaysFilms_;
+
+    // Chaque année garde la génération de la dernière modification d'un de ses films: une entrée du cache n'est
+    // périmée que si une année de son intervalle a été modifiée après son calcul
+    CacheResultats<std::uint64_t, std::vector<const Film*>> cacheAnnees_;
+    std::map<int, std::uint64_t> generationsAnnees_;
+    std::uint64_t generation_ = 0;
 };
 
+/// Retourne les films qui satisfont un prédicat composé avec PredicatsFilms, évalué en un seul parcours. Si le
+/// prédicat impose un genre ou un pays, seul le plus petit des filtres correspondants est parcouru plutôt que tous
+/// les films; ces filtres sont construits au besoin. Les films sont dans l'ordre du vecteur parcouru, soit l'ordre
+/// d'ajout, sauf pour ceux qu'un rechargement a fait changer de catégorie.
+/// \param predicat     Le prédicat, par exemple annee(1990, 2000) && genre(Film::Genre::Horreur).
+/// \return             Les films qui satisfont le prédicat.
+template<typename Predicat>
+std::vector<const Film*> GestionnaireFilms::getFilmsSelon(const Predicat& predicat) const
+{
+    static_assert(PredicatsFilms::estPredicat<Predicat>, "Le prédicat doit être composé avec PredicatsFilms");
+    PredicatsFilms::ContraintesIndex contraintes;
+    predicat.ajouterContraintes(contraintes);
+
+    // Un filtre désactivé ne propose pas de candidats; les films sont alors tous parcourus
+    const std::vector<const Film*>* candidats = nullptr;
+    const IndexGenres::Filtre* filtreGenres = contraintes.genre ? getFiltreGenres() : nullptr;
+    if (filtreGenres != nullptr)
+    {
+        auto filtre = filtreGenres->find(*contraintes.genre);
+        if (filtre == filtreGenres->end())
+        {
+            return {};
+        }
+        candidats = &filtre->second.lire();
+    }
+    const IndexPays::Filtre* filtrePays = contraintes.pays ? getFiltrePays() : nullptr;
+    if (filtrePays != nullptr)
+    {
+        auto filtre = filtrePays->find(*contraintes.pays);
+        if (filtre == filtrePays->end())
+        {
+            return {};
+        }
+        if (candidats == nullptr || filtre->second.lire().size() < candidats->size())
+        {
+            candidats = &filtre->second.lire();
+        }
+    }
+
+    // Les égalités sur les champs indexés sont vérifiées avant le reste du prédicat: genre et pays partagent une
+    // ligne de cache, alors que l'année n'est lue que pour les films qui les satisfont
+    auto satisfait = [&predicat, &contraintes](const Film& film) {
+        return (!contraintes.genre || film.genre == *contraintes.genre) &&
+               (!contraintes.pays || film.pays == *contraintes.pays) && predicat(film);
+    };
+    std::vector<const Film*> films;
+    if (candidats != nullptr)
+    {
+        for (const Film* film : *candidats)
+        {
+            if (satisfait(*film))
+            {
+                films.push_back(film);
+            }
+        }
+        return films;
+    }
+    for (const std::shared_ptr<const Film>& film : films_.lire())
+    {
+        if (satisfait(*film))
+        {
+            films.push_back(film.get());
+        }
+    }
+    return films;
+}
+
 #endif // GESTIONNAIREFILMS_H
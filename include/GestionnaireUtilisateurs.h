@@ -5,29 +5,64 @@
 #ifndef GESTIONNAIREUTILISATEURS_H
 #define GESTIONNAIREUTILISATEURS_H
 
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "BilanRechargement.h"
+#include "RejetsChargement.h"
 #include "Utilisateur.h"
+#include "UtilisationMemoire.h"
 
-/// Classe qui gère les informations de tous les utilisateurs.
+class AnalyseurLogs;
+
+/// Classe qui gère les informations de tous les utilisateurs et qui conserve des filtres par pays et par âge pour
+/// les rechercher rapidement.
 class GestionnaireUtilisateurs
 {
 public:
+    // Fonctions membres spéciales
+    GestionnaireUtilisateurs() = default;
+    GestionnaireUtilisateurs(const GestionnaireUtilisateurs& other);
+    GestionnaireUtilisateurs(GestionnaireUtilisateurs&&) = default;
+    GestionnaireUtilisateurs& operator=(GestionnaireUtilisateurs other);
+
     // Surcharges d'opérateurs
     friend std::ostream& operator<<(std::ostream& outputStream,
                                     const GestionnaireUtilisateurs& gestionnaireUtilisateurs);
 
     // Opérations d'ajout et de suppression
-    bool chargerDepuisFichier(const std::string& nomFichier);
+    BilanChargement chargerDepuisFichier(const std::string& nomFichier,
+                                         const OptionsRejets& options = OptionsRejets());
+    BilanRechargement rechargerDepuisFichier(const std::string& nomFichier, AnalyseurLogs* analyseurLogs = nullptr);
     bool ajouterUtilisateur(const Utilisateur& utilisateur);
+    bool ajouterUtilisateur(Utilisateur&& utilisateur);
+    std::vector<bool> ajouterUtilisateurs(std::vector<Utilisateur> utilisateurs);
     bool supprimerUtilisateur(const std::string& idUtilisateur);
 
     // Getters
     std::size_t getNombreUtilisateurs() const;
+    std::vector<const Utilisateur*> getUtilisateurs() const;
     const Utilisateur* getUtilisateurParId(const std::string& id) const;
+    std::vector<const Utilisateur*> getUtilisateursParPays(Pays pays) const;
+    std::vector<const Utilisateur*> getUtilisateursEntreAges(int ageMin, int ageMax) const;
+    std::vector<const Utilisateur*> getUtilisateursParPaysEntreAges(Pays pays, int ageMin, int ageMax) const;
+    UtilisationMemoire getUtilisationMemoire() const;
 
 private:
-    std::unordered_map<std::string, Utilisateur> utilisateurs_;
+    void indexerUtilisateur(const Utilisateur* utilisateur);
+    void desindexerUtilisateur(const Utilisateur* utilisateur);
+
+    using FiltreAges = std::set<std::pair<int, const Utilisateur*>>;
+    std::pair<FiltreAges::const_iterator, FiltreAges::const_iterator> getIntervalleAges(int ageMin, int ageMax) const;
+
+    std::unordered_map<std::string, Utilisateur> utilisateurs_; // Les éléments d'une unordered_map ne sont pas
+                                                                // déplacés lors d'un rehash, les filtres restent valides
+
+    std::unordered_map<Pays, std::unordered_set<const Utilisateur*>> filtrePaysUtilisateurs_;
+    FiltreAges filtreAgeUtilisateurs_; // Trié par âge pour les requêtes par intervalle, puis par adresse pour que
+                                       // le retrait d'un utilisateur soit logarithmique
 };
 
 #endif // GESTIONNAIREUTILISATEURS_H
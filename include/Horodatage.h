@@ -0,0 +1,18 @@
+/// Conversions entre les timestamps des logs et des secondes depuis l'époque Unix.
+
+#ifndef HORODATAGE_H
+#define HORODATAGE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// Longueur d'un timestamp au format "AAAA-MM-JJTHH:MM:SSZ".
+constexpr std::size_t longueurTimestamp = 20;
+
+std::optional<std::int64_t> convertirTimestamp(const std::string& timestamp);
+std::string formaterTimestamp(std::int64_t secondes);
+void formaterTimestamp(std::int64_t secondes, char* destination);
+std::int64_t getJourTimestamp(std::int64_t secondes);
+
+#endif // HORODATAGE_H
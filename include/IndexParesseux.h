@@ -0,0 +1,130 @@
+/// Index secondaire construit à la première requête, puis maintenu à chaque modification.
+
+#ifndef INDEXPARESSEUX_H
+#define INDEXPARESSEUX_H
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CopieSurEcriture.h"
+#include "UtilisationMemoire.h"
+
+/// Index qui associe chaque catégorie aux éléments qui en font partie. Tant qu'aucune requête ne l'a lu, l'index
+/// n'existe pas et les modifications de son propriétaire l'ignorent; la première lecture le construit en entier à
+/// partir des données du propriétaire, après quoi chaque modification le maintient. Un index désactivé libère sa
+/// mémoire et n'est plus construit, jusqu'à ce qu'il soit réactivé.
+///
+/// Le propriétaire ne modifie l'index que depuis ses opérations non const, qui ne sont jamais concurrentes avec ses
+/// requêtes. La construction, elle, est faite par une requête const et peut donc être demandée par plusieurs threads:
+/// un seul la fait, les autres attendent qu'elle soit terminée.
+/// \tparam Categorie   Le type des catégories (doit pouvoir être haché par std::hash).
+/// \tparam Element     Le type des éléments indexés.
+template<typename Categorie, typename Element>
+class IndexParesseux
+{
+public:
+    using Filtre = std::unordered_map<Categorie, CopieSurEcriture<std::vector<Element>>>;
+
+    // Fonctions membres spéciales
+    IndexParesseux() = default;
+    IndexParesseux(const IndexParesseux& other)
+    {
+        std::lock_guard<std::mutex> verrou(other.mutex_);
+        filtre_ = other.filtre_;
+        estActif_ = other.estActif_;
+        estConstruit_.store(other.estConstruit_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    IndexParesseux(IndexParesseux&& other) noexcept { echanger(other); }
+
+    /// Opérateur d'assignation utilisant le copy-and-swap idiom.
+    /// \param other    L'index à partir duquel copier, ou déplacer, l'état et les catégories.
+    /// \return         Référence à l'objet actuel.
+    IndexParesseux& operator=(IndexParesseux other)
+    {
+        echanger(other);
+        return *this;
+    }
+
+    /// Retourne l'index, en le construisant d'abord s'il n'existe pas encore.
+    /// \param construire   Retourne l'index complet calculé à partir des données du propriétaire.
+    /// \return             Un pointeur vers l'index, ou nullptr si l'index est désactivé.
+    template<typename Construire>
+    const Filtre* lire(Construire&& construire) const
+    {
+        if (!estActif_)
+        {
+            return nullptr;
+        }
+        if (!estConstruit_.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> verrou(mutex_);
+            if (!estConstruit_.load(std::memory_order_relaxed))
+            {
+                filtre_ = construire();
+                estConstruit_.store(true, std::memory_order_release);
+            }
+        }
+        return &filtre_;
+    }
+
+    /// Retourne l'index à maintenir lors d'une modification des données du propriétaire.
+    /// \return Un pointeur vers l'index, ou nullptr s'il n'est pas construit et n'a donc rien à maintenir.
+    Filtre* modifier()
+    {
+        return estConstruit_.load(std::memory_order_relaxed) ? &filtre_ : nullptr;
+    }
+
+    /// Oublie l'index, par exemple lorsque toutes les données sont remplacées. Il sera reconstruit à la prochaine
+    /// lecture s'il est actif.
+    void reinitialiser()
+    {
+        Filtre().swap(filtre_);
+        estConstruit_.store(false, std::memory_order_relaxed);
+    }
+
+    /// Réactive l'index. Il est construit à la prochaine lecture.
+    void activer()
+    {
+        estActif_ = true;
+    }
+
+    /// Désactive l'index et libère sa mémoire. Les lectures retournent nullptr jusqu'à sa réactivation.
+    void desactiver()
+    {
+        reinitialiser();
+        estActif_ = false;
+    }
+
+    /// \return True si l'index est actif, construit ou non.
+    bool estActif() const { return estActif_; }
+
+    /// \return True si l'index est construit et maintenu à chaque modification.
+    bool estConstruit() const { return estConstruit_.load(std::memory_order_acquire); }
+
+    /// \return Les octets alloués sur le tas par l'index, nuls s'il n'est pas construit.
+    std::size_t getOctetsTas() const
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        return estConstruit_.load(std::memory_order_relaxed) ? octetsTas(filtre_) : 0;
+    }
+
+private:
+    /// Échange l'état et les catégories avec un autre index. Les deux index ne doivent pas être en construction.
+    void echanger(IndexParesseux& other) noexcept
+    {
+        filtre_.swap(other.filtre_);
+        std::swap(estActif_, other.estActif_);
+        bool estConstruit = estConstruit_.load(std::memory_order_relaxed);
+        estConstruit_.store(other.estConstruit_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.estConstruit_.store(estConstruit, std::memory_order_relaxed);
+    }
+
+    mutable std::mutex mutex_; // Sérialise la construction
+    mutable Filtre filtre_;
+    bool estActif_ = true;
+    mutable std::atomic<bool> estConstruit_{false};
+};
+
+#endif // INDEXPARESSEUX_H
@@ -0,0 +1,122 @@
+/// Ingestion concurrente de lignes de log avec compteurs de vues répartis.
+
+#ifndef INGESTEURCONCURRENT_H
+#define INGESTEURCONCURRENT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "FileBornee.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "LigneLog.h"
+
+/// Classe qui permet à plusieurs threads producteurs d'ajouter des lignes de log simultanément.
+/// Chaque producteur accumule ses lignes dans un lot local et le publie, sans verrou, dans sa propre file bornée
+/// (FileBornee) vers le thread de fusion, qui vide périodiquement les files dans l'analyseur de logs. Les compteurs
+/// de vues sont répartis en shards alignés sur une ligne de cache pour éviter le faux partage; les statistiques de
+/// vues y sont lues directement, sans verrou global, et comptent les lignes dès leur création.
+///
+/// Un lot est publié lorsqu'il est plein, lorsque l'intervalle de fusion s'est écoulé depuis sa première ligne
+/// (vérifié toutes les quelques lignes), par Producteur::publier() ou à la destruction du producteur. Les producteurs
+/// doivent être détruits avant terminer().
+/// Les gestionnaires de films et d'utilisateurs ne doivent pas être modifiés pendant l'ingestion, et l'analyseur
+/// de logs ne doit être consulté directement qu'après l'appel à terminer().
+class IngesteurConcurrent
+{
+    using Canal = FileBornee<std::vector<LigneLog>>; // Lots d'un producteur vers le thread de fusion
+
+public:
+    /// Poignée utilisée par un thread producteur pour soumettre ses lignes de log.
+    class Producteur
+    {
+    public:
+        Producteur(Producteur&& other) noexcept;
+        ~Producteur();
+
+        bool creerLigneLog(const std::string& timestamp, const std::string& idUtilisateur, const std::string& nomFilm);
+        void publier();
+
+    private:
+        friend class IngesteurConcurrent;
+        Producteur(IngesteurConcurrent& ingesteur, std::size_t indexShard, Canal& canal);
+
+        IngesteurConcurrent* ingesteur_;
+        std::size_t indexShard_;
+        Canal* canal_;
+        std::vector<LigneLog> lot_;
+        std::chrono::steady_clock::time_point debutLot_;
+    };
+
+    // Fonctions membres spéciales
+    IngesteurConcurrent(AnalyseurLogs& analyseurLogs,
+                        const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                        const GestionnaireFilms& gestionnaireFilms,
+                        std::size_t nombreShards = std::thread::hardware_concurrency(),
+                        std::chrono::milliseconds intervalleFusion = std::chrono::milliseconds(10));
+    IngesteurConcurrent(const IngesteurConcurrent&) = delete;
+    IngesteurConcurrent& operator=(const IngesteurConcurrent&) = delete;
+    ~IngesteurConcurrent();
+
+    // Opérations d'ingestion
+    Producteur creerProducteur();
+    void fusionner();
+    void terminer();
+
+    // Statistiques
+    int getNombreVuesFilm(const Film* film) const;
+    const Film* getFilmPlusPopulaire() const;
+    std::vector<std::pair<const Film*, int>> getNFilmsPlusPopulaires(std::size_t nombre) const;
+
+private:
+    static constexpr std::size_t tailleLigneCache = 64;
+    static constexpr std::size_t compteursParBloc = tailleLigneCache / sizeof(std::atomic<int>);
+    static constexpr std::size_t tailleLotProducteur = 256; // Lignes accumulées par un producteur avant publication
+    static constexpr std::size_t lignesEntreHorloges = 32;  // Lignes entre deux vérifications de l'âge du lot
+    static constexpr std::size_t capaciteCanal = 1024;      // Lots en attente avant que le producteur n'attende
+
+    /// Bloc de compteurs occupant exactement une ligne de cache.
+    struct alignas(tailleLigneCache) BlocCompteurs
+    {
+        std::atomic<int> valeurs[compteursParBloc];
+    };
+
+    /// Compteurs d'un shard, alignés pour que deux shards ne partagent jamais une ligne de cache.
+    struct alignas(tailleLigneCache) Shard
+    {
+        explicit Shard(std::size_t nombreBlocs);
+
+        std::vector<BlocCompteurs> compteurs;
+    };
+
+    void boucleFusion();
+    std::vector<int> calculerTotaux() const;
+
+    AnalyseurLogs& analyseurLogs_;
+    const GestionnaireUtilisateurs& gestionnaireUtilisateurs_;
+    const GestionnaireFilms& gestionnaireFilms_;
+
+    std::vector<const Film*> films_; // Index dense vers le film
+    std::unordered_map<const Film*, std::size_t> indexFilms_;
+    std::vector<int> vuesInitiales_; // Vues déjà présentes dans l'analyseur au démarrage
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<std::size_t> prochainShard_{0};
+
+    std::chrono::milliseconds intervalleFusion_;
+    std::mutex mutexFusion_; // Protège canaux_ et fait du thread qui fusionne le seul consommateur des files
+    std::vector<std::unique_ptr<Canal>> canaux_; // Un par producteur, retiré une fois fermé et vidé
+    std::condition_variable conditionFusion_;
+    bool arretDemande_ = false;
+    std::thread threadFusion_;
+};
+
+#endif // INGESTEURCONCURRENT_H
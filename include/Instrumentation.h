@@ -0,0 +1,121 @@
+/// Instrumentation des chemins critiques: minuteurs par phase et compteurs atomiques.
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/// Registre global des durées par phase et des compteurs. Les macros INSTRUMENTER_PHASE et INSTRUMENTER_COMPTEUR
+/// n'y écrivent que si le projet est compilé avec INSTRUMENTATION défini (make instrumentation=1); sinon elles ne
+/// génèrent aucun code et le rapport indique que l'instrumentation est inactive.
+class Instrumentation
+{
+public:
+    enum class Phase
+    {
+        ChargementFilms,
+        ChargementUtilisateurs,
+        ChargementLogs,
+        SuiviLogs,
+        LectureFichier,
+        AnalyseLignes,
+        ResolutionLogs,
+        IndexationFilms,
+        IndexationUtilisateurs,
+        InsertionLogs,
+        ComptageVues,
+        EcritureExport,
+        RequeteNombreVuesFilm,
+        RequeteNombreVuesFilmEntre,
+        RequeteFilmPlusPopulaire,
+        RequeteNFilmsPlusPopulaires,
+        RequeteNombreVuesUtilisateur,
+        RequeteFilmsVusUtilisateur,
+        RequeteNombreVuesGroupe,
+        RequeteNFilmsPlusPopulairesGroupe,
+        Nombre
+    };
+
+    enum class Compteur
+    {
+        LignesLues,
+        LignesRejetees,
+        UtilisateursIntrouvables,
+        FilmsIntrouvables,
+        OctetsTraites,
+        Nombre
+    };
+
+#ifdef INSTRUMENTATION
+    static constexpr bool estActive = true;
+#else
+    static constexpr bool estActive = false;
+#endif
+
+    static void ajouterDuree(Phase phase, std::chrono::nanoseconds duree);
+    static void incrementer(Compteur compteur, std::uint64_t valeur = 1);
+
+    static std::uint64_t getCompteur(Compteur compteur);
+    static std::uint64_t getNombreAppels(Phase phase);
+    static std::chrono::nanoseconds getDuree(Phase phase);
+
+    static void reinitialiser();
+    static void ecrireRapportJson(std::ostream& sortie);
+};
+
+/// Minuteur qui ajoute à une phase le temps écoulé entre sa construction et sa destruction.
+class MinuteurPortee
+{
+public:
+    explicit MinuteurPortee(Instrumentation::Phase phase)
+        : phase_(phase)
+        , debut_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~MinuteurPortee() { Instrumentation::ajouterDuree(phase_, std::chrono::steady_clock::now() - debut_); }
+
+    MinuteurPortee(const MinuteurPortee&) = delete;
+    MinuteurPortee& operator=(const MinuteurPortee&) = delete;
+
+private:
+    Instrumentation::Phase phase_;
+    std::chrono::steady_clock::time_point debut_;
+};
+
+#define INSTRUMENTATION_CONCATENER_(a, b) a##b
+#define INSTRUMENTATION_CONCATENER(a, b) INSTRUMENTATION_CONCATENER_(a, b)
+
+#ifdef INSTRUMENTATION
+/// Chronomètre le reste de la portée courante dans la phase donnée.
+#define INSTRUMENTER_PHASE(phase) \
+    MinuteurPortee INSTRUMENTATION_CONCATENER(minuteur, __LINE__)(Instrumentation::Phase::phase)
+/// Ajoute une valeur au compteur donné.
+#define INSTRUMENTER_COMPTEUR(compteur, valeur) \
+    Instrumentation::incrementer(Instrumentation::Compteur::compteur, static_cast<std::uint64_t>(valeur))
+#else
+#define INSTRUMENTER_PHASE(phase) static_cast<void>(0)
+#define INSTRUMENTER_COMPTEUR(compteur, valeur) static_cast<void>(0)
+#endif
+
+/// Lit une ligne d'un fichier de données en comptant le temps de lecture, les lignes et les octets lus.
+/// \param stream   Le stream à partir duquel lire.
+/// \param ligne    La ligne lue.
+/// \return         True si une ligne a été lue, false à la fin du stream.
+inline bool lireLigne(std::istream& stream, std::string& ligne)
+{
+    INSTRUMENTER_PHASE(LectureFichier);
+    if (!std::getline(stream, ligne))
+    {
+        return false;
+    }
+    INSTRUMENTER_COMPTEUR(LignesLues, 1);
+    INSTRUMENTER_COMPTEUR(OctetsTraites, ligne.size() + 1);
+    return true;
+}
+
+#endif // INSTRUMENTATION_H
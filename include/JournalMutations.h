@@ -0,0 +1,97 @@
+/// Journal des mutations des gestionnaires et points de contrôle, pour redémarrer sans recharger les fichiers texte.
+
+#ifndef JOURNALMUTATIONS_H
+#define JOURNALMUTATIONS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+
+/// Paramètres d'un journal de mutations.
+struct OptionsJournal
+{
+    std::size_t tailleGroupe = 256;                    // Mutations écrites ensemble, avec une seule synchronisation
+    std::size_t mutationsParPointControle = 1 << 20;   // 0 désactive les points de contrôle automatiques
+    bool synchroniser = true;                          // fdatasync après chaque groupe
+};
+
+/// Classe qui applique les mutations aux gestionnaires et à l'analyseur de logs, et les ajoute à un journal binaire
+/// en ajout seul. Chaque enregistrement porte sa longueur et une somme de contrôle; une fin d'enregistrement
+/// incomplète ou corrompue, laissée par un arrêt brutal, est ignorée puis tronquée à la récupération.
+///
+/// Les mutations sont écrites par groupes (group commit): elles s'accumulent dans un tampon qui est écrit en un seul
+/// appel, suivi d'une seule synchronisation, dès qu'il contient tailleGroupe mutations ou que valider() est appelé.
+/// Une mutation n'est donc durable qu'une fois son groupe validé. Seules les mutations réussies sont journalisées.
+/// Si un groupe ne peut pas être écrit, il reste en attente et le journal est tronqué à la fin du groupe précédent;
+/// les mutations suivantes sont refusées tant qu'un nouvel essai de validation n'a pas réussi.
+/// Supprimer un film ou un utilisateur retire aussi ses lignes de log de l'analyseur, à l'exécution comme au rejeu.
+///
+/// Un point de contrôle écrit l'état complet, sans les mutations annulées par la suite, dans point_controle.bin, puis
+/// commence un nouveau journal vide; le journal précédent est supprimé. Les deux fichiers portent un numéro de
+/// génération: la récupération charge le dernier point de contrôle puis ne rejoue que le journal de sa génération.
+/// Les vues archivées par la rétention de l'analyseur ne font pas partie du point de contrôle.
+class JournalMutations
+{
+public:
+    // Fonctions membres spéciales
+    JournalMutations(GestionnaireFilms& gestionnaireFilms,
+                     GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                     AnalyseurLogs& analyseurLogs,
+                     std::filesystem::path dossier,
+                     const OptionsJournal& options = OptionsJournal());
+    ~JournalMutations();
+    JournalMutations(const JournalMutations&) = delete;
+    JournalMutations& operator=(const JournalMutations&) = delete;
+
+    // Récupération et durabilité
+    bool recuperer();
+    bool valider();
+    bool creerPointControle();
+
+    // Mutations journalisées
+    bool ajouterFilm(const Film& film);
+    bool supprimerFilm(const std::string& nomFilm);
+    bool ajouterUtilisateur(const Utilisateur& utilisateur);
+    bool supprimerUtilisateur(const std::string& idUtilisateur);
+    bool creerLigneLog(const std::string& timestamp, const std::string& idUtilisateur, const std::string& nomFilm);
+
+    // Getters
+    std::uint64_t getGeneration() const;
+    std::size_t getNombreMutationsRejouees() const;
+    std::size_t getNombreGroupesEcrits() const;
+
+private:
+    std::filesystem::path getCheminJournal(std::uint64_t generation) const;
+    std::filesystem::path getCheminPointControle() const;
+    bool rejouer(const std::filesystem::path& chemin, bool estPointControle, std::uintmax_t& tailleValide);
+    bool appliquerSuppressionFilm(const std::string& nomFilm);
+    bool appliquerSuppressionUtilisateur(const std::string& idUtilisateur);
+    bool ouvrirJournal(bool tronquer);
+    void fermerJournal();
+    bool tronquerJournal();
+    bool accepterMutation();
+    bool journaliser();
+
+    GestionnaireFilms& gestionnaireFilms_;
+    GestionnaireUtilisateurs& gestionnaireUtilisateurs_;
+    AnalyseurLogs& analyseurLogs_;
+    std::filesystem::path dossier_;
+    OptionsJournal options_;
+
+    std::FILE* journal_ = nullptr;          // Journal ouvert en ajout, ou nullptr avant la récupération
+    std::uint64_t generation_ = 0;          // Génération du dernier point de contrôle et du journal ouvert
+    std::string tampon_;                    // Enregistrements du groupe en cours
+    std::uintmax_t tailleValidee_ = 0;      // Fin du dernier groupe écrit et synchronisé dans le journal ouvert
+    bool defaillant_ = false;               // Le dernier groupe n'a pas pu être écrit et reste dans le tampon
+    std::size_t nombreEnAttente_ = 0;       // Mutations dans le tampon
+    std::size_t mutationsDepuisPointControle_ = 0;
+    std::size_t nombreMutationsRejouees_ = 0;
+    std::size_t nombreGroupesEcrits_ = 0;
+};
+
+#endif // JOURNALMUTATIONS_H
@@ -0,0 +1,72 @@
+/// Stockage compressé en blocs des lignes de log triées.
+
+#ifndef LOGSCOMPRESSES_H
+#define LOGSCOMPRESSES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LigneLog.h"
+#include "UtilisationMemoire.h"
+
+/// Classe qui conserve des lignes de log triées dans des blocs compressés de tailleBloc lignes. Dans chaque bloc, les
+/// instants sont encodés par différences successives en varint, et les identifiants denses d'utilisateurs et de
+/// films sont empaquetés sur le nombre de bits qu'exige l'écart entre leur minimum et leur maximum. L'en-tête de
+/// chaque bloc conserve ces minimums et maximums: les requêtes sautent les blocs qui ne peuvent pas contenir de
+/// résultat et ne décodent que les colonnes dont elles ont besoin.
+///
+/// Les lignes dont le timestamp n'est pas au format canonique "AAAA-MM-JJTHH:MM:SSZ" sont conservées telles quelles
+/// à part, pour que decompresser() redonne exactement les lignes d'origine.
+class LogsCompresses
+{
+public:
+    static constexpr std::size_t tailleBloc = 128;
+
+    /// En-tête d'un bloc compressé.
+    struct EnteteBloc
+    {
+        std::int64_t secondesMin;
+        std::int64_t secondesMax;
+        std::uint32_t utilisateurMin;
+        std::uint32_t utilisateurMax;
+        std::uint32_t filmMin;
+        std::uint32_t filmMax;
+        std::uint64_t decalage;       // Position du bloc dans donnees_
+        std::uint16_t octetsSecondes; // Taille des différences d'instants, suivies des utilisateurs puis des films
+        std::uint8_t nombreLignes;
+        std::uint8_t bitsUtilisateur;
+        std::uint8_t bitsFilm;
+    };
+
+    // Constructeurs
+    LogsCompresses() = default;
+    explicit LogsCompresses(const std::vector<LigneLog>& logs);
+
+    // Getters
+    std::size_t getTaille() const;
+    std::size_t getNombreBlocs() const;
+    double getOctetsParLigne() const;
+    std::vector<LigneLog> decompresser() const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+    // Statistiques
+    int getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const;
+    int getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const;
+
+private:
+    void ajouterBloc(const std::int64_t* secondes,
+                     const std::uint32_t* utilisateurs,
+                     const std::uint32_t* films,
+                     std::size_t nombre);
+    void decoderSecondes(const EnteteBloc& bloc, std::int64_t* secondes) const;
+    void decoderUtilisateurs(const EnteteBloc& bloc, std::uint32_t* utilisateurs) const;
+    void decoderFilms(const EnteteBloc& bloc, std::uint32_t* films) const;
+
+    std::vector<EnteteBloc> blocs_;
+    std::vector<std::uint8_t> donnees_;
+    std::vector<const Utilisateur*> utilisateurs_; // Triés par adresse; l'identifiant dense est la position
+    std::vector<const Film*> films_;               // Triés par adresse; l'identifiant dense est la position
+    std::vector<LigneLog> lignesNonCompressees_; // Lignes au timestamp non canonique, dans leur ordre d'origine
+};
+
+#endif // LOGSCOMPRESSES_H
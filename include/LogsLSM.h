@@ -0,0 +1,84 @@
+/// Stockage des lignes de log optimisé pour l'écriture, pour les lignes qui arrivent dans le désordre.
+
+#ifndef LOGSLSM_H
+#define LOGSLSM_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Foncteurs.h"
+#include "LigneLog.h"
+#include "UtilisationMemoire.h"
+
+/// Classe qui conserve les lignes de log à la manière d'un arbre LSM (log-structured merge). Les insertions vont
+/// dans une petite table triée en mémoire (la memtable); lorsqu'elle est pleine, elle devient une séquence triée
+/// immuable. Les séquences sont classées par niveau selon leur taille: dès qu'un niveau compte facteurCompaction
+/// séquences, un thread d'arrière-plan les fusionne en une séquence du niveau suivant. Chaque ligne est donc
+/// fusionnée O(log n) fois, et une insertion coûte O(log n) amorti quelle que soit l'ancienneté de son timestamp,
+/// alors qu'une insertion triée dans un seul vecteur coûte O(n).
+///
+/// Les requêtes voient toujours l'union de la memtable et des séquences, dans l'ordre des timestamps; l'ordre des
+/// lignes de même timestamp n'est pas défini. Toutes les fonctions membres peuvent être appelées depuis plusieurs
+/// threads. Une copie reprend les lignes en une seule séquence et démarre son propre thread de compaction.
+///
+/// AnalyseurLogs y range les lignes qui arrivent en retard sur sa ligne la plus récente, au lieu de les insérer au
+/// milieu de son vecteur trié, et les y replie toutes d'une seule fusion lorsqu'il a besoin du vecteur complet.
+class LogsLSM
+{
+public:
+    static constexpr std::size_t tailleMemtableDefaut = 4096;
+    static constexpr std::size_t facteurCompactionDefaut = 4;
+
+    using Sequence = std::vector<LigneLog>;
+
+    // Fonctions membres spéciales
+    explicit LogsLSM(std::size_t tailleMemtable = tailleMemtableDefaut,
+                     std::size_t facteurCompaction = facteurCompactionDefaut);
+    ~LogsLSM();
+    LogsLSM(const LogsLSM& other);
+    LogsLSM& operator=(const LogsLSM& other);
+
+    // Opérations d'ajout de logs
+    void ajouterLigneLog(const LigneLog& ligneLog);
+    void vider();
+    void attendreCompactions();
+
+    // Getters
+    std::vector<LigneLog> getLogs() const;
+    std::size_t getTaille() const;
+    std::size_t getNombreLignesAvant(const std::string& timestamp) const;
+    std::size_t getNombreSequences() const;
+    std::size_t getNombreCompactions() const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+    // Statistiques
+    int getNombreVuesFilm(const Film* film) const;
+    int getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const;
+
+private:
+    std::size_t getNiveau(const Sequence& sequence) const;
+    void viderMemtable();
+    bool choisirCompaction(std::vector<std::shared_ptr<const Sequence>>& aFusionner) const;
+    void compacter();
+
+    std::size_t tailleMemtable_;
+    std::size_t facteurCompaction_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable conditionCompaction_; // Une compaction est possible ou l'arrêt est demandé
+    std::condition_variable conditionTerminee_;   // Une compaction vient de se terminer
+    std::multiset<LigneLog, ComparateurLog> memtable_;
+    std::vector<std::shared_ptr<const Sequence>> sequences_;
+    std::unordered_map<const Film*, int> vuesFilms_;
+    std::size_t nombreCompactions_ = 0;
+    bool compactionEnCours_ = false;
+    bool arreter_ = false;
+    std::thread threadCompaction_;
+};
+
+#endif // LOGSLSM_H
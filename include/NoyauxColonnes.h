@@ -0,0 +1,36 @@
+/// Noyaux de parcours vectorisés sur les colonnes des logs.
+
+#ifndef NOYAUXCOLONNES_H
+#define NOYAUXCOLONNES_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// Noyaux de comptage, de filtrage et d'histogramme sur des colonnes contiguës. Le jeu d'instructions est choisi à
+/// la compilation: AVX2 si le compilateur le cible (par exemple avec make native=1), SSE2 sinon sur x86-64, et une
+/// version scalaire ailleurs. Tous les noyaux donnent le même résultat, peu importe le jeu d'instructions.
+namespace NoyauxColonnes
+{
+    const char* getJeuInstructions();
+
+    std::size_t compterEgal(const std::uint32_t* valeurs, std::size_t taille, std::uint32_t cible);
+    std::size_t compterEgalDansIntervalle(const std::uint32_t* valeurs,
+                                          const std::int64_t* secondes,
+                                          std::size_t taille,
+                                          std::uint32_t cible,
+                                          std::int64_t debut,
+                                          std::int64_t fin);
+    std::size_t filtrerEgal(const std::uint32_t* valeurs,
+                            std::size_t taille,
+                            std::uint32_t cible,
+                            std::uint32_t* indices);
+    std::size_t compterDansMasque(const std::uint32_t* valeurs, std::size_t taille, const std::uint32_t* masque);
+    void histogramme(const std::uint32_t* valeurs, std::size_t taille, std::uint32_t* compteurs);
+    void histogrammeMasque(const std::uint32_t* cles,
+                           const std::uint32_t* valeurs,
+                           std::size_t taille,
+                           const std::uint32_t* masque,
+                           std::uint32_t* compteurs);
+} // namespace NoyauxColonnes
+
+#endif // NOYAUXCOLONNES_H
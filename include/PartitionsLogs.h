@@ -0,0 +1,70 @@
+/// Stockage des lignes de log partitionné par période.
+
+#ifndef PARTITIONSLOGS_H
+#define PARTITIONSLOGS_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LigneLog.h"
+#include "UtilisationMemoire.h"
+
+/// Durée couverte par chaque partition.
+enum class GranularitePartition
+{
+    Jour,
+    Mois
+};
+
+/// Classe qui répartit les lignes de log dans une partition par jour ou par mois. Chaque partition garde ses lignes
+/// triées et son propre nombre de vues par film. Une insertion ne déplace que les lignes de sa partition. Une requête
+/// sur un intervalle ne parcourt que les partitions qu'il chevauche et se contente de l'agrégat de celles qu'il
+/// couvre entièrement. Supprimer la plus ancienne partition ne touche pas aux autres.
+///
+/// AnalyseurLogs s'en sert comme d'un index secondaire, à côté de son vecteur trié qui reste le stockage principal:
+/// seules ses requêtes sur un intervalle en profitent, au prix d'une seconde copie des lignes.
+///
+/// Les lignes dont le timestamp n'est pas au format canonique "AAAA-MM-JJTHH:MM:SSZ" sont conservées à part, hors
+/// partition, et toujours parcourues. Elles sont retirées avec les partitions qui les précèdent dans l'ordre des
+/// timestamps.
+class PartitionsLogs
+{
+public:
+    /// Lignes et agrégats d'une partition.
+    struct Partition
+    {
+        std::vector<LigneLog> lignes; // Triées par timestamp
+        std::unordered_map<const Film*, int> vuesFilms;
+    };
+
+    // Constructeurs
+    explicit PartitionsLogs(GranularitePartition granularite = GranularitePartition::Mois);
+    PartitionsLogs(const std::vector<LigneLog>& logs, GranularitePartition granularite);
+
+    // Opérations d'ajout et de suppression
+    void ajouterLigneLog(const LigneLog& ligneLog);
+    void ajouterLignesLog(std::vector<LigneLog> lignesLog);
+    bool supprimerPlusAnciennePartition();
+    std::size_t supprimerPartitionsAvant(const std::string& timestamp);
+
+    // Getters
+    GranularitePartition getGranularite() const;
+    std::size_t getTaille() const;
+    std::size_t getNombrePartitions() const;
+    const std::map<std::string, Partition>& getPartitions() const;
+    std::string getCle(const std::string& timestamp) const;
+    UtilisationMemoire getUtilisationMemoire() const;
+
+    // Statistiques
+    int getNombreVuesFilm(const Film* film) const;
+    int getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const;
+
+private:
+    GranularitePartition granularite_;
+    std::map<std::string, Partition> partitions_; // Par préfixe "AAAA-MM-JJ" ou "AAAA-MM" du timestamp
+    std::vector<LigneLog> lignesHorsPartition_;   // Lignes au timestamp non canonique, triées par timestamp
+    std::size_t taille_ = 0;
+};
+
+#endif // PARTITIONSLOGS_H
@@ -0,0 +1,60 @@
+/// Chargement d'un fichier de logs par un pipeline d'étapes concurrentes.
+
+#ifndef PIPELINEINGESTION_H
+#define PIPELINEINGESTION_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "RejetsChargement.h"
+
+/// Classe qui charge un fichier de logs dans un analyseur en quatre étapes, chacune sur son propre thread:
+/// lecture des lignes, analyse syntaxique, résolution des utilisateurs et des films, puis indexation. Les étapes
+/// s'échangent des lots de lignes par des FileBornee, ce qui fait chevaucher les attentes d'entrée-sortie et le
+/// travail de calcul; une étape plus lente que les autres bloque les précédentes lorsque sa file d'entrée est pleine.
+/// L'indexation trie chaque lot dès son arrivée et le fusionne avec les séquences déjà triées, de tailles croissantes.
+/// Seule la fusion finale, qui réunit les dernières séquences et les transmet à l'analyseur, attend la fin de la
+/// lecture; elle est mesurée comme une cinquième étape.
+///
+/// Les gestionnaires de films et d'utilisateurs ne doivent pas être modifiés pendant le chargement.
+class PipelineIngestion
+{
+public:
+    /// Mesures d'une étape pour le dernier chargement.
+    struct StatistiquesEtape
+    {
+        std::string nom;
+        std::size_t nombreElements = 0;
+        std::chrono::nanoseconds dureeTravail{0};
+        std::chrono::nanoseconds dureeAttenteEntree{0}; // File d'entrée vide
+        std::chrono::nanoseconds dureeAttenteSortie{0}; // File de sortie pleine (contre-pression)
+
+        double getDebit() const;
+    };
+
+    PipelineIngestion(AnalyseurLogs& analyseurLogs,
+                      const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                      const GestionnaireFilms& gestionnaireFilms,
+                      std::size_t tailleLot = 4096,
+                      std::size_t capaciteFiles = 16);
+
+    BilanChargement chargerDepuisFichier(const std::string& nomFichier, const OptionsRejets& options = OptionsRejets());
+
+    const std::vector<StatistiquesEtape>& getStatistiques() const;
+    friend std::ostream& operator<<(std::ostream& outputStream, const PipelineIngestion& pipelineIngestion);
+
+private:
+    AnalyseurLogs& analyseurLogs_;
+    const GestionnaireUtilisateurs& gestionnaireUtilisateurs_;
+    const GestionnaireFilms& gestionnaireFilms_;
+    std::size_t tailleLot_;
+    std::size_t capaciteFiles_;
+
+    std::vector<StatistiquesEtape> statistiques_;
+};
+
+#endif // PIPELINEINGESTION_H
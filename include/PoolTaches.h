@@ -0,0 +1,163 @@
+/// Ordonnanceur de tâches à vol de travail partagé par les chargements et les requêtes d'agrégation.
+
+#ifndef POOLTACHES_H
+#define POOLTACHES_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Pool d'un nombre fixe de threads travailleurs, chacun avec sa propre file de tâches. Un travailleur exécute
+/// d'abord ses propres tâches, les plus récentes en premier pour profiter de la cache, puis vole les plus anciennes
+/// des autres travailleurs lorsqu'il n'a plus rien à faire. Le thread qui attend la fin d'un parallelFor exécute
+/// lui aussi des tâches plutôt que de bloquer, ce qui permet d'imbriquer les appels sans interblocage.
+class PoolTaches
+{
+public:
+    explicit PoolTaches(std::size_t nombreTravailleurs = std::thread::hardware_concurrency(),
+                        bool epinglerTravailleurs = false);
+    PoolTaches(const PoolTaches&) = delete;
+    PoolTaches& operator=(const PoolTaches&) = delete;
+    ~PoolTaches();
+
+    static PoolTaches& getPoolGlobal();
+
+    void soumettre(std::function<void()> tache);
+    std::size_t getNombreTravailleurs() const;
+
+    /// Appelle fonction(debutBloc, finBloc) sur des blocs consécutifs couvrant [debut, fin), en parallèle, et
+    /// retourne lorsque tous les blocs sont terminés. Une exception lancée par un bloc est relancée ici.
+    /// \param debut        Le début de l'intervalle.
+    /// \param fin          La fin (exclue) de l'intervalle.
+    /// \param tailleGrain  La taille d'un bloc; 0 choisit environ quatre blocs par travailleur.
+    /// \param fonction     La fonction à appeler sur chaque bloc.
+    template<typename Fonction>
+    void parallelFor(std::size_t debut, std::size_t fin, std::size_t tailleGrain, Fonction&& fonction)
+    {
+        if (debut >= fin)
+        {
+            return;
+        }
+        tailleGrain = getTailleGrain(fin - debut, tailleGrain);
+        std::size_t nombreBlocs = (fin - debut + tailleGrain - 1) / tailleGrain;
+        if (nombreBlocs == 1)
+        {
+            fonction(debut, fin);
+            return;
+        }
+
+        Groupe groupe(nombreBlocs);
+        auto executerBloc = [&groupe, &fonction, debut, fin, tailleGrain](std::size_t bloc) {
+            std::size_t debutBloc = debut + bloc * tailleGrain;
+            try
+            {
+                fonction(debutBloc, std::min(fin, debutBloc + tailleGrain));
+            }
+            catch (...)
+            {
+                groupe.conserverErreur(std::current_exception());
+            }
+            groupe.blocsRestants.fetch_sub(1, std::memory_order_acq_rel);
+        };
+        for (std::size_t bloc = 1; bloc < nombreBlocs; bloc++)
+        {
+            soumettre([&executerBloc, bloc] { executerBloc(bloc); });
+        }
+        executerBloc(0);
+        attendre(groupe);
+    }
+
+    /// Réduit [debut, fin) en parallèle: fonction(debutBloc, finBloc) calcule le résultat partiel d'un bloc, puis
+    /// combiner(a, b) combine les résultats partiels dans l'ordre des blocs.
+    /// \param debut            Le début de l'intervalle.
+    /// \param fin              La fin (exclue) de l'intervalle.
+    /// \param tailleGrain      La taille d'un bloc; 0 choisit environ quatre blocs par travailleur.
+    /// \param valeurInitiale   La valeur neutre de la combinaison.
+    /// \param fonction         La fonction qui calcule le résultat partiel d'un bloc.
+    /// \param combiner         La fonction qui combine deux résultats.
+    /// \return                 La combinaison de la valeur initiale et de tous les résultats partiels.
+    template<typename T, typename Fonction, typename Combinaison>
+    T parallelReduce(std::size_t debut,
+                     std::size_t fin,
+                     std::size_t tailleGrain,
+                     T valeurInitiale,
+                     Fonction&& fonction,
+                     Combinaison&& combiner)
+    {
+        if (debut >= fin)
+        {
+            return valeurInitiale;
+        }
+        tailleGrain = getTailleGrain(fin - debut, tailleGrain);
+        std::size_t nombreBlocs = (fin - debut + tailleGrain - 1) / tailleGrain;
+        std::vector<T> partiels(nombreBlocs, valeurInitiale);
+        parallelFor(0, nombreBlocs, 1, [&](std::size_t premierBloc, std::size_t finBlocs) {
+            for (std::size_t bloc = premierBloc; bloc < finBlocs; bloc++)
+            {
+                std::size_t debutBloc = debut + bloc * tailleGrain;
+                partiels[bloc] = fonction(debutBloc, std::min(fin, debutBloc + tailleGrain));
+            }
+        });
+        T resultat = std::move(valeurInitiale);
+        for (T& partiel : partiels)
+        {
+            resultat = combiner(std::move(resultat), std::move(partiel));
+        }
+        return resultat;
+    }
+
+private:
+    /// File de tâches d'un travailleur, alignée pour que deux travailleurs ne partagent pas une ligne de cache.
+    struct alignas(64) Travailleur
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> taches;
+    };
+
+    /// Suivi des blocs d'un même parallelFor et de la première exception lancée par l'un d'eux.
+    struct Groupe
+    {
+        explicit Groupe(std::size_t nombreBlocs)
+            : blocsRestants(nombreBlocs)
+        {
+        }
+
+        void conserverErreur(std::exception_ptr nouvelleErreur)
+        {
+            std::lock_guard<std::mutex> verrou(mutexErreur);
+            if (!erreur)
+            {
+                erreur = std::move(nouvelleErreur);
+            }
+        }
+
+        std::atomic<std::size_t> blocsRestants;
+        std::mutex mutexErreur;
+        std::exception_ptr erreur;
+    };
+
+    std::size_t getTailleGrain(std::size_t nombreElements, std::size_t tailleGrain) const;
+    bool executerUneTache(std::size_t indexDepart);
+    void attendre(Groupe& groupe);
+    void boucleTravailleur(std::size_t index);
+
+    std::vector<std::unique_ptr<Travailleur>> travailleurs_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutexAttente_;
+    std::condition_variable conditionAttente_;
+    std::atomic<std::size_t> nombreTachesEnAttente_{0};
+    std::atomic<std::size_t> prochainTravailleur_{0};
+    bool arretDemande_ = false;
+};
+
+#endif // POOLTACHES_H
@@ -0,0 +1,184 @@
+/// Prédicats sur les films, composés à la compilation en un seul prédicat.
+
+#ifndef PREDICATSFILMS_H
+#define PREDICATSFILMS_H
+
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "Film.h"
+
+/// Prédicats élémentaires sur les films et opérateurs &&, || et ! qui les combinent. Une expression comme
+/// annee(1990, 2000) && genre(Film::Genre::Horreur) && pays(Pays::France) construit un seul objet dont le type décrit
+/// toute l'expression: son évaluation est entièrement inlinable et ne crée aucun vecteur intermédiaire. Les foncteurs
+/// existants, comme EstDansIntervalleDatesFilm, s'y intègrent avec selon().
+///
+/// Chaque prédicat indique aussi les égalités qu'il impose sur les champs indexés par GestionnaireFilms, pour que
+/// getFilmsSelon ne parcoure que le plus petit filtre correspondant.
+namespace PredicatsFilms
+{
+    /// Valeurs de champs indexés que tout film satisfaisant un prédicat doit avoir.
+    struct ContraintesIndex
+    {
+        std::optional<Film::Genre> genre;
+        std::optional<Pays> pays;
+    };
+
+    /// Classe de base des prédicats, qui active les opérateurs de composition pour les classes qui en héritent.
+    /// \tparam Derive  La classe du prédicat.
+    template<typename Derive>
+    struct Predicat
+    {
+    };
+
+    template<typename T>
+    constexpr bool estPredicat = std::is_base_of_v<Predicat<T>, T>;
+
+    /// Vrai pour les films sortis entre deux années, incluses.
+    class EstSortiEntre : public Predicat<EstSortiEntre>
+    {
+    public:
+        EstSortiEntre(int anneeDebut, int anneeFin) : anneeDebut_(anneeDebut), anneeFin_(anneeFin) {}
+
+        bool operator()(const Film& film) const { return film.annee >= anneeDebut_ && film.annee <= anneeFin_; }
+        void ajouterContraintes(ContraintesIndex&) const {}
+
+    private:
+        int anneeDebut_;
+        int anneeFin_;
+    };
+
+    /// Vrai pour les films d'un genre.
+    class EstDeGenre : public Predicat<EstDeGenre>
+    {
+    public:
+        explicit EstDeGenre(Film::Genre genre) : genre_(genre) {}
+
+        bool operator()(const Film& film) const { return film.genre == genre_; }
+        void ajouterContraintes(ContraintesIndex& contraintes) const { contraintes.genre = genre_; }
+
+    private:
+        Film::Genre genre_;
+    };
+
+    /// Vrai pour les films d'un pays.
+    class EstDuPays : public Predicat<EstDuPays>
+    {
+    public:
+        explicit EstDuPays(Pays pays) : pays_(pays) {}
+
+        bool operator()(const Film& film) const { return film.pays == pays_; }
+        void ajouterContraintes(ContraintesIndex& contraintes) const { contraintes.pays = pays_; }
+
+    private:
+        Pays pays_;
+    };
+
+    /// Vrai pour les films d'un réalisateur.
+    class EstDuRealisateur : public Predicat<EstDuRealisateur>
+    {
+    public:
+        explicit EstDuRealisateur(std::string realisateur) : realisateur_(std::move(realisateur)) {}
+
+        bool operator()(const Film& film) const { return film.realisateur == realisateur_; }
+        void ajouterContraintes(ContraintesIndex&) const {}
+
+    private:
+        std::string realisateur_;
+    };
+
+    /// Adapte un foncteur qui prend un pointeur vers un film, comme ceux de Foncteurs.h.
+    /// \tparam Foncteur    Le type du foncteur, dont l'opérateur () peut ne pas être const.
+    template<typename Foncteur>
+    class Selon : public Predicat<Selon<Foncteur>>
+    {
+    public:
+        explicit Selon(Foncteur foncteur) : foncteur_(std::move(foncteur)) {}
+
+        bool operator()(const Film& film) const { return foncteur_(&film); }
+        void ajouterContraintes(ContraintesIndex&) const {}
+
+    private:
+        mutable Foncteur foncteur_;
+    };
+
+    /// Conjonction de deux prédicats. Les contraintes des deux côtés s'appliquent.
+    template<typename Gauche, typename Droite>
+    class Et : public Predicat<Et<Gauche, Droite>>
+    {
+    public:
+        Et(Gauche gauche, Droite droite) : gauche_(std::move(gauche)), droite_(std::move(droite)) {}
+
+        bool operator()(const Film& film) const { return gauche_(film) && droite_(film); }
+        void ajouterContraintes(ContraintesIndex& contraintes) const
+        {
+            gauche_.ajouterContraintes(contraintes);
+            droite_.ajouterContraintes(contraintes);
+        }
+
+    private:
+        Gauche gauche_;
+        Droite droite_;
+    };
+
+    /// Disjonction de deux prédicats. Aucune contrainte n'est commune à tous les films qui la satisfont.
+    template<typename Gauche, typename Droite>
+    class Ou : public Predicat<Ou<Gauche, Droite>>
+    {
+    public:
+        Ou(Gauche gauche, Droite droite) : gauche_(std::move(gauche)), droite_(std::move(droite)) {}
+
+        bool operator()(const Film& film) const { return gauche_(film) || droite_(film); }
+        void ajouterContraintes(ContraintesIndex&) const {}
+
+    private:
+        Gauche gauche_;
+        Droite droite_;
+    };
+
+    /// Négation d'un prédicat.
+    template<typename Operande>
+    class Non : public Predicat<Non<Operande>>
+    {
+    public:
+        explicit Non(Operande operande) : operande_(std::move(operande)) {}
+
+        bool operator()(const Film& film) const { return !operande_(film); }
+        void ajouterContraintes(ContraintesIndex&) const {}
+
+    private:
+        Operande operande_;
+    };
+
+    inline EstSortiEntre annee(int anneeDebut, int anneeFin) { return EstSortiEntre(anneeDebut, anneeFin); }
+    inline EstDeGenre genre(Film::Genre genre) { return EstDeGenre(genre); }
+    inline EstDuPays pays(Pays pays) { return EstDuPays(pays); }
+    inline EstDuRealisateur realisateur(std::string realisateur) { return EstDuRealisateur(std::move(realisateur)); }
+
+    template<typename Foncteur>
+    Selon<Foncteur> selon(Foncteur foncteur)
+    {
+        return Selon<Foncteur>(std::move(foncteur));
+    }
+
+    template<typename Gauche, typename Droite, typename = std::enable_if_t<estPredicat<Gauche> && estPredicat<Droite>>>
+    Et<Gauche, Droite> operator&&(Gauche gauche, Droite droite)
+    {
+        return Et<Gauche, Droite>(std::move(gauche), std::move(droite));
+    }
+
+    template<typename Gauche, typename Droite, typename = std::enable_if_t<estPredicat<Gauche> && estPredicat<Droite>>>
+    Ou<Gauche, Droite> operator||(Gauche gauche, Droite droite)
+    {
+        return Ou<Gauche, Droite>(std::move(gauche), std::move(droite));
+    }
+
+    template<typename Operande, typename = std::enable_if_t<estPredicat<Operande>>>
+    Non<Operande> operator!(Operande operande)
+    {
+        return Non<Operande>(std::move(operande));
+    }
+} // namespace PredicatsFilms
+
+#endif // PREDICATSFILMS_H
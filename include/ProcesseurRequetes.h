@@ -0,0 +1,42 @@
+/// Protocole texte compact du serveur de requêtes.
+
+#ifndef PROCESSEURREQUETES_H
+#define PROCESSEURREQUETES_H
+
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+
+/// Classe qui répond aux requêtes du serveur à partir des gestionnaires et de l'analyseur de logs déjà chargés.
+///
+/// Chaque requête et chaque réponse tiennent sur une ligne. Les noms de films sont entre guillemets, comme dans les
+/// fichiers de données. Une réponse commence par OK suivi du résultat, ou par ERR suivi d'un message.
+///   FILM "nom"                    -> OK "nom" genre pays "réalisateur" année
+///   GENRE genre                   -> OK nombre "nom"...
+///   PAYS pays                     -> OK nombre "nom"...
+///   ANNEES début fin              -> OK nombre "nom"...
+///   TOP n                         -> OK nombre "nom" vues...
+///   VUES_FILM "nom"               -> OK vues
+///   VUES_UTILISATEUR id           -> OK vues
+///   FILMS_UTILISATEUR id          -> OK nombre "nom"...
+///   LOG timestamp id "nom"        -> OK
+class ProcesseurRequetes
+{
+public:
+    ProcesseurRequetes(GestionnaireFilms& gestionnaireFilms,
+                       GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                       AnalyseurLogs& analyseurLogs);
+
+    void traiter(const std::string& requete, std::string& reponse);
+
+private:
+    static void ecrireFilms(const std::vector<const Film*>& films, std::string& reponse);
+
+    GestionnaireFilms& gestionnaireFilms_;
+    GestionnaireUtilisateurs& gestionnaireUtilisateurs_;
+    AnalyseurLogs& analyseurLogs_;
+};
+
+#endif // PROCESSEURREQUETES_H
@@ -40,6 +40,21 @@ public:
     template<typename Deleter>
     RawPointerBackInserter<Container>& operator=(uniquePointerType<Deleter>&&) = delete;
 
+    /// Insère le pointeur brut conservé par le std::shared_ptr dans le conteneur en appelant sa fonction push_back.
+    /// \param value    Le std::shared_ptr partageant la valeur à insérer à l'arrière du conteneur.
+    /// \return         Une référence à l'itérateur.
+    template<typename T>
+    RawPointerBackInserter<Container>& operator=(const std::shared_ptr<T>& value)
+    {
+        conteneur_->push_back(value.get());
+        return *this;
+    }
+
+    /// Surcharge supprimée pour empêcher des pointeurs bruts vers de la mémoire désallouée.
+    /// \return Une référence à l'itérateur.
+    template<typename T>
+    RawPointerBackInserter<Container>& operator=(std::shared_ptr<T>&&) = delete;
+
     /// No-op.
     /// \return Une référence à l'itérateur.
     RawPointerBackInserter<Container>& operator*() { return *this; }
@@ -0,0 +1,92 @@
+/// Collecte des lignes rejetées lors du chargement d'un fichier et bilan du chargement.
+
+#ifndef REJETSCHARGEMENT_H
+#define REJETSCHARGEMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/// Raison pour laquelle une ligne d'un fichier n'a pas été chargée.
+enum class RaisonRejet
+{
+    LigneMalFormee,         // La ligne n'a pas pu être interprétée
+    UtilisateurIntrouvable, // La ligne de log référence un utilisateur inconnu
+    FilmIntrouvable,        // La ligne de log référence un film inconnu
+    Nombre
+};
+
+constexpr std::size_t nombreRaisonsRejet = static_cast<std::size_t>(RaisonRejet::Nombre);
+
+/// Paramètres du traitement des lignes rejetées d'un chargement.
+struct OptionsRejets
+{
+    std::filesystem::path fichierQuarantaine; // Reçoit chaque ligne rejetée précédée de sa raison, si non vide
+    std::size_t nombreMessagesConsole = 10;   // Lignes rejetées affichées sur std::cerr, les autres sont résumées
+    bool ajouterQuarantaine = false;          // Ajoute à la fin du fichier de quarantaine plutôt que de le recréer
+};
+
+/// Bilan d'un chargement depuis un fichier.
+struct BilanChargement
+{
+    bool succes = false; // Le fichier a été ouvert et toutes ses lignes ont été interprétées
+    std::size_t nombreLignesChargees = 0;
+    std::array<std::size_t, nombreRaisonsRejet> nombreRejets{}; // Indexé par RaisonRejet
+
+    /// \param raison   La raison de rejet.
+    /// \return         Le nombre de lignes rejetées pour cette raison.
+    std::size_t getNombreRejets(RaisonRejet raison) const { return nombreRejets[static_cast<std::size_t>(raison)]; }
+
+    /// \return Le nombre de lignes rejetées, toutes raisons confondues.
+    std::size_t getNombreRejets() const
+    {
+        std::size_t total = 0;
+        for (std::size_t nombre : nombreRejets)
+        {
+            total += nombre;
+        }
+        return total;
+    }
+
+    explicit operator bool() const { return succes; }
+};
+
+/// Canal par lequel un chargement signale ses lignes rejetées. Chaque rejet est compté selon sa raison; seuls les
+/// premiers sont affichés sur std::cerr, et un seul message résume les autres à la fin du chargement, pour qu'un
+/// fichier corrompu ne se charge pas au rythme des écritures sur la console. Les lignes rejetées peuvent aussi être
+/// conservées dans un fichier de quarantaine, écrit par grands blocs, une ligne par rejet: le code de la raison, une
+/// tabulation, puis la ligne telle qu'elle a été lue.
+class CollecteurRejets
+{
+public:
+    CollecteurRejets(std::string source, const OptionsRejets& options);
+    ~CollecteurRejets();
+    CollecteurRejets(const CollecteurRejets&) = delete;
+    CollecteurRejets& operator=(const CollecteurRejets&) = delete;
+
+    void rejeter(RaisonRejet raison, std::string_view ligne);
+    std::array<std::size_t, nombreRaisonsRejet> terminer();
+
+    static std::string_view getCode(RaisonRejet raison);
+
+private:
+    void vider();
+    void fermer();
+
+    static constexpr std::size_t octetsTampon = std::size_t(1) << 16;
+
+    std::string source_; // Préfixe des messages, comme "GestionnaireFilms"
+    std::size_t nombreMessagesConsole_;
+    std::array<std::size_t, nombreRaisonsRejet> nombreRejets_{};
+    std::size_t nombreMessagesAffiches_ = 0;
+
+    std::filesystem::path cheminQuarantaine_;
+    std::FILE* quarantaine_ = nullptr;
+    std::string tampon_;
+    bool erreurQuarantaine_ = false;
+};
+
+#endif // REJETSCHARGEMENT_H
@@ -0,0 +1,84 @@
+/// Suivi d'un fichier de logs qui grossit en continu, à la manière de tail -F.
+
+#ifndef SUIVIFICHIERLOGS_H
+#define SUIVIFICHIERLOGS_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "RejetsChargement.h"
+
+/// Classe qui applique à un analyseur de logs les lignes ajoutées à la fin d'un fichier depuis le dernier appel à
+/// rattraper(), sans relire le début du fichier. La position de la fin de la dernière ligne complète est conservée;
+/// une ligne finale encore incomplète reste en attente jusqu'à ce que son saut de ligne soit écrit.
+///
+/// La rotation du fichier (renommé puis recréé) est détectée en comparant son inode à celui du fichier ouvert: les
+/// lignes restantes de l'ancien fichier sont lues, y compris une dernière ligne sans saut de ligne, puis le suivi
+/// reprend au début du nouveau. Un fichier tronqué sur place, dont la taille devient inférieure à la position lue,
+/// est relu depuis le début: la ligne incomplète lue avant la troncature a disparu du fichier et est abandonnée. Les
+/// lignes déjà appliquées restent dans l'analyseur.
+///
+/// Sous Linux, inotify signale les modifications du dossier du fichier: attendre() ou un poll() sur getDescripteur()
+/// réveille l'appelant dès qu'une ligne est écrite. Ailleurs, ou si inotify n'est pas disponible, getDescripteur()
+/// vaut -1 et attendre() se contente d'attendre le délai donné: l'appelant doit alors sonder le fichier en appelant
+/// rattraper() à intervalles réguliers.
+/// L'analyseur n'est modifié que dans rattraper(), sur le thread de l'appelant.
+///
+/// Les lignes rejetées sont signalées comme par AnalyseurLogs::chargerDepuisFichier, avec un résumé par rattrapage;
+/// le fichier de quarantaine est recréé au premier rattrapage puis complété par les suivants.
+class SuiviFichierLogs
+{
+public:
+    // Fonctions membres spéciales
+    SuiviFichierLogs(AnalyseurLogs& analyseurLogs,
+                     const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                     const GestionnaireFilms& gestionnaireFilms,
+                     std::string nomFichier,
+                     const OptionsRejets& options = OptionsRejets());
+    ~SuiviFichierLogs();
+    SuiviFichierLogs(const SuiviFichierLogs&) = delete;
+    SuiviFichierLogs& operator=(const SuiviFichierLogs&) = delete;
+
+    // Opérations de suivi
+    BilanChargement rattraper();
+    bool attendre(std::chrono::milliseconds delai);
+
+    // Getters
+    int getDescripteur() const;
+    std::uint64_t getPosition() const;
+    std::size_t getNombreLignesAppliquees() const;
+    std::size_t getNombreRotations() const;
+
+private:
+    /// Changement du fichier suivi depuis la dernière lecture.
+    enum class Changement
+    {
+        Aucun,
+        Rotation,  // Le chemin désigne un autre fichier
+        Troncature // Le même fichier est plus court que ce qui en a été lu
+    };
+
+    bool ouvrir();
+    bool lireNouvellesLignes(bool dernierPassage, CollecteurRejets& rejets);
+    Changement detecterChangement() const;
+
+    AnalyseurLogs& analyseurLogs_;
+    const GestionnaireUtilisateurs& gestionnaireUtilisateurs_;
+    const GestionnaireFilms& gestionnaireFilms_;
+    std::string nomFichier_;
+    OptionsRejets optionsRejets_;
+
+    std::ifstream fichier_;
+    std::uint64_t identiteFichier_ = 0; // Inode du fichier ouvert
+    std::uint64_t position_ = 0;        // Octet suivant la dernière ligne complète
+    std::string ligneIncomplete_;       // Octets lus après position_, sans saut de ligne
+    std::size_t nombreLignesAppliquees_ = 0;
+    std::size_t nombreRotations_ = 0;
+    int descripteurInotify_ = -1;
+};
+
+#endif // SUIVIFICHIERLOGS_H
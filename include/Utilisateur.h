@@ -5,6 +5,7 @@
 #ifndef UTILISATEUR_H
 #define UTILISATEUR_H
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include "Pays.h"
@@ -18,6 +19,7 @@ struct Utilisateur
     Pays pays;
 };
 
+std::uint64_t getEmpreinte(const Utilisateur& utilisateur);
 std::ostream& operator<<(std::ostream& outputStream, const Utilisateur& utilisateur);
 
 #endif // UTILISATEUR_H
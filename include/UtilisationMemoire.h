@@ -0,0 +1,146 @@
+/// Comptabilité des octets alloués sur le tas par les structures de données des gestionnaires.
+
+#ifndef UTILISATIONMEMOIRE_H
+#define UTILISATIONMEMOIRE_H
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "CopieSurEcriture.h"
+#include "Film.h"
+#include "LigneLog.h"
+#include "Utilisateur.h"
+
+/// Rapport des octets alloués sur le tas par chaque membre d'une classe.
+struct UtilisationMemoire
+{
+    void ajouter(std::string membre, std::size_t octets);
+    std::size_t getOctets(const std::string& membre) const;
+    std::size_t getTotal() const;
+
+    std::vector<std::pair<std::string, std::size_t>> membres;
+};
+
+std::ostream& operator<<(std::ostream& outputStream, const UtilisationMemoire& utilisationMemoire);
+
+// Les fonctions octetsTas calculent, à partir des capacités des conteneurs, les octets demandés à l'allocateur
+// (sans la surcharge propre à malloc). La taille des noeuds suit la disposition de libstdc++: un pointeur vers le
+// noeud suivant et, pour les clés dont le hachage n'est pas trivial, le hash en cache dans les tables de hachage;
+// trois pointeurs et une couleur dans les arbres rouge-noir. Les pointeurs bruts ne possèdent pas leur cible et ne
+// comptent que pour leur propre taille.
+
+std::size_t octetsTas(const std::string& chaine);
+std::size_t octetsTas(const Film& film);
+std::size_t octetsTas(const Utilisateur& utilisateur);
+std::size_t octetsTas(const LigneLog& ligneLog);
+template<typename T>
+std::size_t octetsTas(const T& valeur);
+template<typename T1, typename T2>
+std::size_t octetsTas(const std::pair<T1, T2>& paire);
+template<typename T>
+std::size_t octetsTas(const std::vector<T>& vecteur);
+template<typename T>
+std::size_t octetsTas(const std::shared_ptr<T>& pointeur);
+template<typename T>
+std::size_t octetsTas(const CopieSurEcriture<T>& valeur);
+template<typename K, typename V, typename H, typename E, typename A>
+std::size_t octetsTas(const std::unordered_map<K, V, H, E, A>& map);
+template<typename K, typename H, typename E, typename A>
+std::size_t octetsTas(const std::unordered_set<K, H, E, A>& set);
+template<typename K, typename C, typename A>
+std::size_t octetsTas(const std::set<K, C, A>& set);
+
+/// Taille d'un noeud de table de hachage contenant une valeur de type T avec une clé de type K.
+template<typename K, typename T>
+constexpr std::size_t tailleNoeudHachage =
+    sizeof(void*) + sizeof(T) + (std::is_scalar_v<K> ? 0 : sizeof(std::size_t));
+
+/// Taille d'un noeud d'arbre rouge-noir contenant une valeur de type T.
+template<typename T>
+constexpr std::size_t tailleNoeudArbre = 3 * sizeof(void*) + sizeof(void*) + sizeof(T);
+
+/// Taille du bloc de contrôle de std::make_shared, qui précède l'objet dans la même allocation.
+constexpr std::size_t tailleBlocControle = 2 * sizeof(int) + sizeof(void*);
+
+/// Les types sans allocation (entiers, enums, pointeurs bruts) n'occupent pas le tas.
+template<typename T>
+std::size_t octetsTas(const T&)
+{
+    static_assert(std::is_scalar_v<T>, "octetsTas doit être surchargé pour ce type");
+    return 0;
+}
+
+template<typename T1, typename T2>
+std::size_t octetsTas(const std::pair<T1, T2>& paire)
+{
+    return octetsTas(paire.first) + octetsTas(paire.second);
+}
+
+template<typename T>
+std::size_t octetsTas(const std::vector<T>& vecteur)
+{
+    std::size_t octets = vecteur.capacity() * sizeof(T);
+    for (const T& element : vecteur)
+    {
+        octets += octetsTas(element);
+    }
+    return octets;
+}
+
+/// Un pointeur partagé est compté comme s'il avait été créé par std::make_shared. Une cible partagée par plusieurs
+/// pointeurs est comptée une fois par pointeur.
+template<typename T>
+std::size_t octetsTas(const std::shared_ptr<T>& pointeur)
+{
+    return pointeur ? tailleBlocControle + sizeof(T) + octetsTas(*pointeur) : 0;
+}
+
+/// Une valeur partagée entre plusieurs copies est comptée une fois par copie.
+template<typename T>
+std::size_t octetsTas(const CopieSurEcriture<T>& valeur)
+{
+    return valeur.estAlloue() ? tailleBlocControle + sizeof(T) + octetsTas(valeur.lire()) : 0;
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+std::size_t octetsTas(const std::unordered_map<K, V, H, E, A>& map)
+{
+    using Valeur = typename std::unordered_map<K, V, H, E, A>::value_type;
+    std::size_t octets = map.bucket_count() * sizeof(void*) + map.size() * tailleNoeudHachage<K, Valeur>;
+    for (const Valeur& element : map)
+    {
+        octets += octetsTas(element.first) + octetsTas(element.second);
+    }
+    return octets;
+}
+
+template<typename K, typename H, typename E, typename A>
+std::size_t octetsTas(const std::unordered_set<K, H, E, A>& set)
+{
+    std::size_t octets = set.bucket_count() * sizeof(void*) + set.size() * tailleNoeudHachage<K, K>;
+    for (const K& element : set)
+    {
+        octets += octetsTas(element);
+    }
+    return octets;
+}
+
+template<typename K, typename C, typename A>
+std::size_t octetsTas(const std::set<K, C, A>& set)
+{
+    std::size_t octets = set.size() * tailleNoeudArbre<K>;
+    for (const K& element : set)
+    {
+        octets += octetsTas(element);
+    }
+    return octets;
+}
+
+#endif // UTILISATIONMEMOIRE_H
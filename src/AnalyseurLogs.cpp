@@ -4,55 +4,236 @@
 
 #include "AnalyseurLogs.h"
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <unordered_set>
 #include "Foncteurs.h"
+#include "Horodatage.h"
+#include "Instrumentation.h"
+#include "NoyauxColonnes.h"
+#include "PoolTaches.h"
 
-/// Ajoute les lignes de log en ordre chronologique à partir d'un fichier de logs.
+namespace
+{
+    // Nombre d'éléments par tâche des parcours parallèles; en deçà, le parcours reste séquentiel
+    constexpr std::size_t tailleGrainColonnes = 1 << 18;
+    constexpr std::size_t tailleGrainAlveoles = 1 << 14;
+    constexpr std::size_t tailleTamponIndices = 4096; // Positions filtrées à la fois, dans un tampon sur la pile
+    constexpr std::size_t tailleLotRetention = 4096;  // Lignes expirées au minimum avant un retrait automatique
+
+    /// Retourne le nombre de lignes expirées à partir duquel la rétention les retire automatiquement. Chaque retrait
+    /// reconstruit les colonnes; attendre qu'un huitième des logs ait expiré amortit cette reconstruction.
+    /// \param taille   Le nombre de lignes conservées.
+    /// \return         Le nombre minimum de lignes à retirer.
+    std::size_t getLotRetention(std::size_t taille)
+    {
+        return std::max(tailleLotRetention, taille / 8);
+    }
+
+    /// Retourne le nombre de lignes en retard d'un lot à partir duquel elles sont fusionnées directement dans les
+    /// logs. En deçà, la fusion en O(N) coûterait plus que leurs insertions dans l'arbre LSM des retards.
+    /// \param taille   Le nombre de lignes des logs.
+    /// \return         Le nombre de lignes en retard à partir duquel le lot est fusionné.
+    std::size_t getLotRetards(std::size_t taille)
+    {
+        return taille / 8;
+    }
+
+    using VuesFilms = std::unordered_map<const Film*, int>;
+    using Histogramme = std::vector<std::uint32_t>;
+
+    /// \param vues    Des vues par film.
+    /// \return        La somme des vues de tous les films.
+    int sommerVues(const VuesFilms& vues)
+    {
+        int somme = 0;
+        for (const auto& [film, nombreVues] : vues)
+        {
+            somme += nombreVues;
+        }
+        return somme;
+    }
+
+    bool aPlusDeVues(const std::pair<const Film*, int>& film1, const std::pair<const Film*, int>& film2)
+    {
+        return film1.second > film2.second;
+    }
+
+    /// Extrait les n films ayant le plus de vues d'une map de vues par film. Les alvéoles de la map sont réparties
+    /// entre les tâches du pool; chaque tâche garde ses n meilleurs films, puis ces candidats sont fusionnés.
+    /// \param vuesFilms    La map associant chaque film à son nombre de vues.
+    /// \param nombre       Le nombre de films à retourner.
+    /// \return             Le vecteur des films les plus populaires, en ordre décroissant de vues.
+    std::vector<std::pair<const Film*, int>> extraireNFilmsPlusPopulaires(const VuesFilms& vuesFilms,
+                                                                          std::size_t nombre)
+    {
+        using Candidats = std::vector<std::pair<const Film*, int>>;
+        Candidats candidats = PoolTaches::getPoolGlobal().parallelReduce(
+            0,
+            vuesFilms.bucket_count(),
+            tailleGrainAlveoles,
+            Candidats(),
+            [&](std::size_t debut, std::size_t fin) {
+                Candidats meilleurs;
+                for (std::size_t alveole = debut; alveole < fin; alveole++)
+                {
+                    meilleurs.insert(meilleurs.end(), vuesFilms.begin(alveole), vuesFilms.end(alveole));
+                }
+                if (meilleurs.size() > nombre)
+                {
+                    auto milieu = meilleurs.begin() + static_cast<std::ptrdiff_t>(nombre);
+                    std::nth_element(meilleurs.begin(), milieu, meilleurs.end(), aPlusDeVues);
+                    meilleurs.erase(milieu, meilleurs.end());
+                }
+                return meilleurs;
+            },
+            [](Candidats total, Candidats partiel) {
+                total.insert(total.end(), partiel.begin(), partiel.end());
+                return total;
+            });
+
+        Candidats nFilmsPlusPopulaires(std::min(candidats.size(), nombre));
+        std::partial_sort_copy(candidats.begin(), candidats.end(), nFilmsPlusPopulaires.begin(), nFilmsPlusPopulaires.end(), aPlusDeVues);
+        return nFilmsPlusPopulaires;
+    }
+
+    /// Extrait les n films ayant le plus de vues d'un histogramme indexé par identifiant de film des colonnes.
+    /// \param vues         Le nombre de vues de chaque film, indexé par identifiant.
+    /// \param colonnes     Les colonnes qui associent chaque identifiant à son film.
+    /// \param nombre       Le nombre de films à retourner.
+    /// \return             Le vecteur des films les plus populaires, en ordre décroissant de vues.
+    std::vector<std::pair<const Film*, int>> extraireNFilmsPlusPopulaires(const Histogramme& vues,
+                                                                          const ColonnesLogs& colonnes,
+                                                                          std::size_t nombre)
+    {
+        std::vector<std::pair<const Film*, int>> candidats;
+        for (std::uint32_t idFilm = 0; idFilm < vues.size(); idFilm++)
+        {
+            if (vues[idFilm] != 0)
+            {
+                candidats.emplace_back(colonnes.getFilm(idFilm), static_cast<int>(vues[idFilm]));
+            }
+        }
+        if (candidats.size() > nombre)
+        {
+            auto milieu = candidats.begin() + static_cast<std::ptrdiff_t>(nombre);
+            std::nth_element(candidats.begin(), milieu, candidats.end(), aPlusDeVues);
+            candidats.erase(milieu, candidats.end());
+        }
+        std::sort(candidats.begin(), candidats.end(), aPlusDeVues);
+        return candidats;
+    }
+} // namespace
+
+/// Interprète une ligne au format du fichier de logs: timestamp, identifiant de l'utilisateur et nom du film entre
+/// guillemets.
+/// \param ligne        La ligne à interpréter.
+/// \param entreeLog    L'entrée dans laquelle écrire les champs lus.
+/// \return             True si la ligne est bien formée, false sinon.
+bool AnalyseurLogs::analyserLigne(const std::string& ligne, EntreeLog& entreeLog)
+{
+    std::istringstream stream(ligne);
+    return static_cast<bool>(stream >> entreeLog.timestamp >> entreeLog.idUtilisateur >>
+                             std::quoted(entreeLog.nomFilm));
+}
+
+/// Reconstruit la ligne du fichier de logs d'une entrée, le nom du film entre guillemets comme avec std::quoted.
+/// \param entreeLog    L'entrée à formater.
+/// \return             La ligne, sans fin de ligne.
+std::string AnalyseurLogs::formaterLigne(const EntreeLog& entreeLog)
+{
+    std::string ligne;
+    ligne.reserve(entreeLog.timestamp.size() + entreeLog.idUtilisateur.size() + entreeLog.nomFilm.size() + 4);
+    ligne.append(entreeLog.timestamp).append(1, ' ').append(entreeLog.idUtilisateur).append(" \"");
+    for (char caractere : entreeLog.nomFilm)
+    {
+        if (caractere == '"' || caractere == '\\')
+        {
+            ligne.push_back('\\');
+        }
+        ligne.push_back(caractere);
+    }
+    ligne.push_back('"');
+    return ligne;
+}
+
+/// Remplace les lignes de log par celles d'un fichier de logs, en ordre chronologique. La configuration de l'analyseur
+/// est conservée et sa rétention est appliquée à la fin du chargement.
 /// \param nomFichier               Le fichier à partir duquel lire les logs.
 /// \param gestionnaireUtilisateurs Référence au gestionnaire des utilisateurs pour lier un utilisateur à un log.
 /// \param gestionnaireFilms        Référence au gestionnaire des films pour pour lier un film à un log.
-/// \return                         True si tout le chargement s'est effectué avec succès, false sinon.
-bool AnalyseurLogs::chargerDepuisFichier(const std::string& nomFichier,
-                                         GestionnaireUtilisateurs& gestionnaireUtilisateurs,
-                                         GestionnaireFilms& gestionnaireFilms)
+/// \param options                  Le traitement des lignes mal formées et de celles dont l'utilisateur ou le film
+///                                 est introuvable.
+/// \return                         Le nombre de lignes chargées et de lignes rejetées, et le succès si le fichier a
+///                                 été ouvert et que toutes ses lignes ont été interprétées. Une ligne bien formée
+///                                 dont l'utilisateur ou le film est introuvable est rejetée sans faire échouer le
+///                                 chargement.
+BilanChargement AnalyseurLogs::chargerDepuisFichier(const std::string& nomFichier,
+                                                    GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                                    GestionnaireFilms& gestionnaireFilms,
+                                                    const OptionsRejets& options)
 {
+    INSTRUMENTER_PHASE(ChargementLogs);
+    BilanChargement bilan;
     std::ifstream fichier(nomFichier);
     if (fichier)
     {
-        logs_.clear();
-        vuesFilms_.clear();
+        vider();
 
-        bool succesParsing = true;
+        CollecteurRejets rejets("AnalyseurLogs", options);
+        bilan.succes = true;
 
+        std::vector<EntreeLog> entreesLog;
         std::string ligne;
-        while (std::getline(fichier, ligne))
+        while (lireLigne(fichier, ligne))
         {
-            std::istringstream stream(ligne);
-
-            std::string timestamp;
-            std::string idUtilisateur;
-            std::string nomFilm;
-
-            if (stream >> timestamp >> idUtilisateur >> std::quoted(nomFilm))
+            INSTRUMENTER_PHASE(AnalyseLignes);
+            EntreeLog entreeLog;
+            if (analyserLigne(ligne, entreeLog))
             {
-                // TODO: Uncomment une fois que la fonction creerLigneLog est écrite
-                creerLigneLog(timestamp, idUtilisateur, nomFilm, gestionnaireUtilisateurs, gestionnaireFilms);
+                entreesLog.push_back(std::move(entreeLog));
             }
             else
             {
-                std::cerr << "Erreur AnalyseurLogs: la ligne " << ligne
-                          << " n'a pas pu être interprétée correctement\n";
-                succesParsing = false;
+                INSTRUMENTER_COMPTEUR(LignesRejetees, 1);
+                rejets.rejeter(RaisonRejet::LigneMalFormee, ligne);
+                bilan.succes = false;
             }
         }
-        return succesParsing;
+        std::vector<bool> resultats =
+            creerLignesLog(std::move(entreesLog), gestionnaireUtilisateurs, gestionnaireFilms, &rejets);
+        bilan.nombreLignesChargees = static_cast<std::size_t>(std::count(resultats.begin(), resultats.end(), true));
+        bilan.nombreRejets = rejets.terminer();
+        appliquerRetention();
+        return bilan;
     }
     std::cerr << "Erreur AnalyseurLogs: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
-    return false;
+    return bilan;
+}
+
+/// Retire toutes les lignes de log et les agrégats de l'historique, avant un nouveau chargement. La configuration de
+/// l'analyseur est conservée: durée de rétention, capacité des caches et granularité des partitions.
+void AnalyseurLogs::vider()
+{
+    logs_.clear();
+    if (retards_)
+    {
+        retards_->vider();
+    }
+    vuesFilms_.clear();
+    colonnes_.vider();
+    if (partitions_)
+    {
+        partitions_.emplace(partitions_->getGranularite());
+    }
+    vuesArchiveesUtilisateurs_.clear();
+    nombreLignesArchivees_ = 0;
+    cacheClassements_.vider();
+    cacheFilmsVus_.vider();
 }
 
 /// Cree une ligne log et l'ajoute au vecteur de logs
@@ -66,28 +247,288 @@ bool AnalyseurLogs::creerLigneLog(const std::string& timestamp, const std::strin
                        GestionnaireUtilisateurs& gestionnaireUtilisateurs, GestionnaireFilms& gestionnaireFilms)
 {
     LigneLog ligneLog{timestamp, gestionnaireUtilisateurs.getUtilisateurParId(idUtilisateur), gestionnaireFilms.getFilmParNom(nomFilm)};
+    INSTRUMENTER_COMPTEUR(UtilisateursIntrouvables, ligneLog.utilisateur == nullptr);
+    INSTRUMENTER_COMPTEUR(FilmsIntrouvables, ligneLog.film == nullptr);
     if(ligneLog.film == nullptr || ligneLog.utilisateur == nullptr)
     {
         return false;
     }
     ajouterLigneLog(ligneLog);
+    return true;
+}
 
-    return std::binary_search(logs_.begin(), logs_.end(), ligneLog, ComparateurLog());
+/// Crée un lot de lignes de log et les ajoute au vecteur de logs en une seule fusion.
+/// \param entreesLog               Les entrées brutes à résoudre, déplacées dans les lignes de log
+/// \param gestionnaireUtilisateurs Référence au gestionnaire des utilisateurs
+/// \param gestionnaireFilms        Référence au gestionnaire de films
+/// \param rejets                   Le collecteur auquel signaler les entrées dont l'utilisateur ou le film est
+///                                 introuvable, ou nullptr pour les ignorer
+/// \return                         Pour chaque entrée, true si la ligne a été créée, false si l'utilisateur ou le
+///                                 film est introuvable
+std::vector<bool> AnalyseurLogs::creerLignesLog(std::vector<EntreeLog> entreesLog,
+                                                const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                                const GestionnaireFilms& gestionnaireFilms,
+                                                CollecteurRejets* rejets)
+{
+    std::vector<bool> resultats;
+    resultats.reserve(entreesLog.size());
+    std::vector<LigneLog> lignesLog;
+    lignesLog.reserve(entreesLog.size());
+    {
+        INSTRUMENTER_PHASE(ResolutionLogs);
+        for (EntreeLog& entreeLog : entreesLog)
+        {
+            const Utilisateur* utilisateur = gestionnaireUtilisateurs.getUtilisateurParId(entreeLog.idUtilisateur);
+            const Film* film = gestionnaireFilms.getFilmParNom(entreeLog.nomFilm);
+            INSTRUMENTER_COMPTEUR(UtilisateursIntrouvables, utilisateur == nullptr);
+            INSTRUMENTER_COMPTEUR(FilmsIntrouvables, film == nullptr);
+            resultats.push_back(utilisateur != nullptr && film != nullptr);
+            if (resultats.back())
+            {
+                lignesLog.push_back(LigneLog{std::move(entreeLog.timestamp), utilisateur, film});
+            }
+            else if (rejets != nullptr)
+            {
+                rejets->rejeter(utilisateur == nullptr ? RaisonRejet::UtilisateurIntrouvable
+                                                       : RaisonRejet::FilmIntrouvable,
+                                formaterLigne(entreeLog));
+            }
+        }
+    }
+    ajouterLignesLog(std::move(lignesLog));
+    return resultats;
 }
 
-/// Ajoute une ligne log passe en parametre au vecteur de logs
+/// Ajoute une ligne log passe en parametre au vecteur de logs. Une ligne plus ancienne que la plus récente des logs
+/// irait au milieu du vecteur: elle attend dans retards_, en O(log n), le prochain repli.
 /// \param ligneLog     La ligne log a ajouter
 void AnalyseurLogs::ajouterLigneLog(const LigneLog& ligneLog)
 {
-    auto position = std::lower_bound(logs_.begin(), logs_.end(), ligneLog, ComparateurLog());
-    logs_.emplace(position, ligneLog);
+    INSTRUMENTER_PHASE(InsertionLogs);
+    if (logs_.empty() || !ComparateurLog()(ligneLog, logs_.back()))
+    {
+        logs_.push_back(ligneLog);
+    }
+    else
+    {
+        getRetards().ajouterLigneLog(ligneLog);
+    }
     vuesFilms_[ligneLog.film]++;
+    colonnes_.ajouter(ligneLog);
+    if (partitions_)
+    {
+        partitions_->ajouterLigneLog(ligneLog);
+    }
+    invaliderFilmsVus(&ligneLog, &ligneLog + 1);
+    invaliderClassements(&ligneLog, &ligneLog + 1);
+    retirerLignesExpirees(getLotRetention(logs_.size()));
+}
+
+/// Ajoute un lot de lignes de log en une seule fusion plutôt qu'une insertion triée par ligne.
+/// Le lot est trié, s'il ne l'est pas déjà, puis fusionné avec les logs existants, ce qui coûte O(N + k log k) au
+/// lieu de O(N * k). Les lignes qui suivent la plus récente des logs sont simplement ajoutées à la fin; si celles qui
+/// la précèdent sont peu nombreuses, elles attendent dans retards_ plutôt que de payer la fusion.
+/// \param lignesLog    Les lignes de log à ajouter, dans n'importe quel ordre.
+void AnalyseurLogs::ajouterLignesLog(std::vector<LigneLog> lignesLog)
+{
+    INSTRUMENTER_PHASE(InsertionLogs);
+    if (!std::is_sorted(lignesLog.begin(), lignesLog.end(), ComparateurLog()))
+    {
+        std::stable_sort(lignesLog.begin(), lignesLog.end(), ComparateurLog());
+    }
+    {
+        INSTRUMENTER_PHASE(ComptageVues);
+        colonnes_.reserver(lignesLog.size());
+        for (const LigneLog& ligneLog : lignesLog)
+        {
+            vuesFilms_[ligneLog.film]++;
+            colonnes_.ajouter(ligneLog);
+        }
+    }
+    invaliderFilmsVus(lignesLog.data(), lignesLog.data() + lignesLog.size());
+    invaliderClassements(lignesLog.data(), lignesLog.data() + lignesLog.size());
+    if (partitions_)
+    {
+        partitions_->ajouterLignesLog(lignesLog);
+    }
+
+    // Les lignes qui précèdent la plus récente des logs forment un préfixe du lot trié
+    auto finRetards = lignesLog.begin();
+    if (!logs_.empty())
+    {
+        finRetards = std::lower_bound(lignesLog.begin(), lignesLog.end(), logs_.back(), ComparateurLog());
+    }
+    auto nombreRetards = static_cast<std::size_t>(finRetards - lignesLog.begin());
+    if (nombreRetards > 0 && nombreRetards < getLotRetards(logs_.size()))
+    {
+        for (auto ligneLog = lignesLog.begin(); ligneLog != finRetards; ++ligneLog)
+        {
+            getRetards().ajouterLigneLog(*ligneLog);
+        }
+        logs_.insert(logs_.end(), std::make_move_iterator(finRetards), std::make_move_iterator(lignesLog.end()));
+    }
+    else
+    {
+        if (nombreRetards > 0)
+        {
+            replierRetards();
+        }
+        auto tailleInitiale = static_cast<std::ptrdiff_t>(logs_.size());
+        logs_.insert(logs_.end(), std::make_move_iterator(lignesLog.begin()), std::make_move_iterator(lignesLog.end()));
+        std::inplace_merge(logs_.begin(), logs_.begin() + tailleInitiale, logs_.end(), ComparateurLog());
+    }
+    retirerLignesExpirees(getLotRetention(logs_.size()));
+}
+
+/// Retire en un seul parcours les lignes de log de films qui vont être supprimés, ainsi que leurs vues archivées,
+/// pour que l'analyseur ne garde aucun pointeur vers eux. Leurs vues sont décomptées de celles des utilisateurs.
+/// \param films    Les films qui vont être supprimés.
+/// \return         Le nombre de lignes retirées.
+std::size_t AnalyseurLogs::retirerLignesFilms(const std::vector<const Film*>& films)
+{
+    for (const Film* film : films)
+    {
+        vuesFilms_.erase(film);
+    }
+    for (auto vuesArchivees = vuesArchiveesUtilisateurs_.begin(); vuesArchivees != vuesArchiveesUtilisateurs_.end();)
+    {
+        for (const Film* film : films)
+        {
+            vuesArchivees->second.erase(film);
+        }
+        vuesArchivees = vuesArchivees->second.empty() ? vuesArchiveesUtilisateurs_.erase(vuesArchivees)
+                                                      : std::next(vuesArchivees);
+    }
+    return retirerLignes(std::unordered_set<const Film*>(films.begin(), films.end()), {});
+}
+
+/// Retire en un seul parcours les lignes de log d'utilisateurs qui vont être supprimés, ainsi que leurs vues
+/// archivées, pour que l'analyseur ne garde aucun pointeur vers eux. Leurs vues, archivées comprises, sont
+/// décomptées de celles des films.
+/// \param utilisateurs     Les utilisateurs qui vont être supprimés.
+/// \return                 Le nombre de lignes retirées.
+std::size_t AnalyseurLogs::retirerLignesUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs)
+{
+    for (const Utilisateur* utilisateur : utilisateurs)
+    {
+        auto vuesArchivees = vuesArchiveesUtilisateurs_.find(utilisateur);
+        if (vuesArchivees == vuesArchiveesUtilisateurs_.end())
+        {
+            continue;
+        }
+        for (const auto& [film, nombreVues] : vuesArchivees->second)
+        {
+            auto vues = vuesFilms_.find(film);
+            if (vues != vuesFilms_.end() && (vues->second -= nombreVues) <= 0)
+            {
+                vuesFilms_.erase(vues);
+            }
+        }
+        vuesArchiveesUtilisateurs_.erase(vuesArchivees);
+    }
+    return retirerLignes({}, std::unordered_set<const Utilisateur*>(utilisateurs.begin(), utilisateurs.end()));
+}
+
+/// Fait désigner aux lignes de log et aux agrégats les films qui en remplacent d'autres, par exemple après un
+/// rechargement des films qui n'a pas pu les modifier sur place. Les anciens films doivent encore être en vie.
+/// \param remplacements    Chaque ancien film associé au film qui le remplace.
+void AnalyseurLogs::remplacerFilms(const std::unordered_map<const Film*, const Film*>& remplacements)
+{
+    replierRetards();
+    for (LigneLog& ligneLog : logs_)
+    {
+        auto remplacement = remplacements.find(ligneLog.film);
+        if (remplacement != remplacements.end())
+        {
+            ligneLog.film = remplacement->second;
+        }
+    }
+    for (const auto& [ancien, nouveau] : remplacements)
+    {
+        auto vues = vuesFilms_.find(ancien);
+        if (vues != vuesFilms_.end())
+        {
+            int nombreVues = vues->second;
+            vuesFilms_.erase(vues);
+            vuesFilms_[nouveau] += nombreVues;
+        }
+    }
+    for (auto& [utilisateur, vuesArchivees] : vuesArchiveesUtilisateurs_)
+    {
+        VuesFilms vuesRemplacees;
+        vuesRemplacees.reserve(vuesArchivees.size());
+        for (const auto& [film, nombreVues] : vuesArchivees)
+        {
+            auto remplacement = remplacements.find(film);
+            vuesRemplacees[remplacement != remplacements.end() ? remplacement->second : film] += nombreVues;
+        }
+        vuesArchivees = std::move(vuesRemplacees);
+    }
+    reconstruireColonnes();
+    if (partitions_)
+    {
+        partitions_.emplace(logs_, partitions_->getGranularite());
+    }
+    cacheClassements_.vider();
+    cacheFilmsVus_.vider();
+}
+
+/// Définit la durée pendant laquelle les lignes de log sont conservées, comptée depuis la ligne la plus récente. Les
+/// lignes expirées sont retirées par lots lors des ajouts suivants, ou tout de suite par appliquerRetention().
+/// \param duree    La durée de rétention, ou std::nullopt pour conserver toutes les lignes.
+void AnalyseurLogs::definirRetention(std::optional<std::chrono::seconds> duree)
+{
+    secondesRetention_.reset();
+    if (duree)
+    {
+        secondesRetention_ = std::max<std::int64_t>(duree->count(), 0);
+    }
+}
+
+/// Retire toutes les lignes expirées sans attendre qu'elles forment un lot.
+/// \return         Le nombre de lignes retirées.
+std::size_t AnalyseurLogs::appliquerRetention()
+{
+    return retirerLignesExpirees(1);
+}
+
+/// \return Le nombre de lignes retirées par la rétention et repliées dans les agrégats depuis le chargement.
+std::size_t AnalyseurLogs::getNombreLignesArchivees() const
+{
+    return nombreLignesArchivees_;
+}
+
+/// Répartit les lignes conservées en partitions par période, tenues à jour par les ajouts et la rétention suivants.
+/// Les partitions copient les lignes de logs_ pour accélérer getNombreVuesFilmEntre et ne servent qu'à cette requête.
+/// \param granularite  La durée couverte par chaque partition, ou std::nullopt pour ne plus partitionner les lignes.
+void AnalyseurLogs::definirPartitionnement(std::optional<GranularitePartition> granularite)
+{
+    partitions_.reset();
+    if (granularite)
+    {
+        replierRetards();
+        partitions_.emplace(logs_, *granularite);
+    }
+}
+
+/// \return Les partitions des lignes conservées, ou std::nullopt si elles ne sont pas partitionnées.
+const std::optional<PartitionsLogs>& AnalyseurLogs::getPartitions() const
+{
+    return partitions_;
+}
+
+/// \return Les lignes de log conservées, triées par timestamp, lignes en retard repliées comprises.
+const std::vector<LigneLog>& AnalyseurLogs::getLogs() const
+{
+    replierRetards();
+    return logs_;
 }
 
 /// Retourne le nombre de vues d'un film passe en parametre
 /// \param film     Le film dont on veut le nombre de vues
 int AnalyseurLogs::getNombreVuesFilm(const Film* film) const
 {
+    INSTRUMENTER_PHASE(RequeteNombreVuesFilm);
     if(vuesFilms_.find(film) == vuesFilms_.end())
     {
         return 0;
@@ -95,11 +536,44 @@ int AnalyseurLogs::getNombreVuesFilm(const Film* film) const
     return vuesFilms_.at(film);
 }
 
+/// Retourne le nombre de vues d'un film dans un intervalle de temps. Seules les partitions qui chevauchent
+/// l'intervalle sont lues si les lignes sont partitionnées, sinon seules les colonnes des films et des instants sont
+/// parcourues.
+/// \param film     Le film dont on veut le nombre de vues
+/// \param debut    Le timestamp du début (inclus) de l'intervalle
+/// \param fin      Le timestamp de la fin (exclue) de l'intervalle
+/// \return         Le nombre de vues dans l'intervalle, ou 0 si un des timestamps est mal formé
+int AnalyseurLogs::getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const
+{
+    INSTRUMENTER_PHASE(RequeteNombreVuesFilmEntre);
+    if (partitions_)
+    {
+        return partitions_->getNombreVuesFilmEntre(film, debut, fin);
+    }
+    std::optional<std::int64_t> secondesDebut = convertirTimestamp(debut);
+    std::optional<std::int64_t> secondesFin = convertirTimestamp(fin);
+    std::uint32_t idFilm = colonnes_.getIdFilm(film);
+    if (!secondesDebut || !secondesFin || idFilm == ColonnesLogs::idAbsent)
+    {
+        return 0;
+    }
+    const std::uint32_t* films = colonnes_.getFilms();
+    const std::int64_t* secondes = colonnes_.getSecondes();
+    return PoolTaches::getPoolGlobal().parallelReduce(
+        0, colonnes_.getTaille(), tailleGrainColonnes, 0,
+        [=](std::size_t debutBloc, std::size_t finBloc) {
+            return static_cast<int>(NoyauxColonnes::compterEgalDansIntervalle(
+                films + debutBloc, secondes + debutBloc, finBloc - debutBloc, idFilm, *secondesDebut, *secondesFin));
+        },
+        std::plus<int>());
+}
+
 /// Retourne le film le plus populaires du vecteur de vues films.
 /// \return         Un pointeur vers le film le plus populaire ou nullptr si il n'y a aucun film
 const Film* AnalyseurLogs::getFilmPlusPopulaire() const
 {
-    if(logs_.size() == 0)
+    INSTRUMENTER_PHASE(RequeteFilmPlusPopulaire);
+    if(vuesFilms_.empty())
     {
         return nullptr;
     }
@@ -111,38 +585,383 @@ const Film* AnalyseurLogs::getFilmPlusPopulaire() const
 /// \return            Le vecteur contenant les films les plus populaires
 std::vector<std::pair<const Film*, int>> AnalyseurLogs::getNFilmsPlusPopulaires(std::size_t nombre) const
 {
-    std::vector<std::pair<const Film*, int>>nFilmsPlusPopulaires(std::min(vuesFilms_.size(), nombre));
-    std::partial_sort_copy(vuesFilms_.begin(), vuesFilms_.end(), nFilmsPlusPopulaires.begin(), nFilmsPlusPopulaires.end(),
-        [](const std::pair<const Film*, int>& film1, const std::pair<const Film*, int>& film2) {return film1.second > film2.second;});
-    return nFilmsPlusPopulaires;
+    INSTRUMENTER_PHASE(RequeteNFilmsPlusPopulaires);
+    std::optional<Classement> classementConserve = cacheClassements_.trouver(nombre);
+    if (classementConserve)
+    {
+        return std::move(*classementConserve);
+    }
+    Classement classement = extraireNFilmsPlusPopulaires(vuesFilms_, nombre);
+    cacheClassements_.inserer(nombre, classement);
+    return classement;
 }
 
-/// Retourne le nombre de vues total pour un utilisateur
+/// Retourne le nombre de vues total pour un utilisateur, lignes archivées par la rétention comprises
 /// \param utilisateur      L'utilisateur dont on veut savoirlenombre de vues
 /// \return                 un int contenant le nombre de vues pour l'utilisateur
 int AnalyseurLogs::getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const
 {
-    return static_cast<int>(std::count_if(logs_.begin(), logs_.end(), [&utilisateur](const LigneLog& ligneLog){return ligneLog.utilisateur == utilisateur;}));
+    INSTRUMENTER_PHASE(RequeteNombreVuesUtilisateur);
+    auto vuesArchivees = vuesArchiveesUtilisateurs_.find(utilisateur);
+    int nombreVuesArchivees = vuesArchivees != vuesArchiveesUtilisateurs_.end() ? sommerVues(vuesArchivees->second) : 0;
+    std::uint32_t idUtilisateur = colonnes_.getIdUtilisateur(utilisateur);
+    if (idUtilisateur == ColonnesLogs::idAbsent)
+    {
+        return nombreVuesArchivees;
+    }
+    const std::uint32_t* utilisateurs = colonnes_.getUtilisateurs();
+    return nombreVuesArchivees + PoolTaches::getPoolGlobal().parallelReduce(
+        0, colonnes_.getTaille(), tailleGrainColonnes, 0,
+        [utilisateurs, idUtilisateur](std::size_t debut, std::size_t fin) {
+            return static_cast<int>(NoyauxColonnes::compterEgal(utilisateurs + debut, fin - debut, idUtilisateur));
+        },
+        std::plus<int>());
 }
 
-/// Retourne un vecteur contenangt les films vus par l'utilisateur passe en parametres
+/// Retourne un vecteur contenangt les films vus par l'utilisateur passe en parametres, parmi les lignes conservées
 /// \param utilisateur      L'utilisateur dont on veut avoir les films vus.
 /// \return                 Un vecteur contenant les films vus par l'utilisateur passe en parametres 
 std::vector<const Film*> AnalyseurLogs::getFilmsVusParUtilisateur(const Utilisateur* utilisateur) const
 {
-    std::unordered_set<const Film*> filmsVus;
-    for (const LigneLog& i : logs_)
+    INSTRUMENTER_PHASE(RequeteFilmsVusUtilisateur);
+    std::uint32_t idUtilisateur = colonnes_.getIdUtilisateur(utilisateur);
+    if (idUtilisateur == ColonnesLogs::idAbsent)
+    {
+        return {};
+    }
+    std::optional<std::vector<const Film*>> filmsVusConserves = cacheFilmsVus_.trouver(utilisateur);
+    if (filmsVusConserves)
+    {
+        return std::move(*filmsVusConserves);
+    }
+
+    // Chaque bloc filtre les lignes de l'utilisateur, puis remplace leurs positions par les films vus
+    const std::uint32_t* utilisateurs = colonnes_.getUtilisateurs();
+    const std::uint32_t* films = colonnes_.getFilms();
+    std::vector<std::uint32_t> idsFilmsVus = PoolTaches::getPoolGlobal().parallelReduce(
+        0, colonnes_.getTaille(), tailleGrainColonnes, std::vector<std::uint32_t>(),
+        [utilisateurs, films, idUtilisateur](std::size_t debut, std::size_t fin) {
+            std::vector<std::uint32_t> idsFilms;
+            std::array<std::uint32_t, tailleTamponIndices> indices;
+            for (std::size_t debutTampon = debut; debutTampon < fin; debutTampon += tailleTamponIndices)
+            {
+                std::size_t taille = std::min(tailleTamponIndices, fin - debutTampon);
+                std::size_t nombre =
+                    NoyauxColonnes::filtrerEgal(utilisateurs + debutTampon, taille, idUtilisateur, indices.data());
+                for (std::size_t i = 0; i < nombre; i++)
+                {
+                    idsFilms.push_back(films[debutTampon + indices[i]]);
+                }
+            }
+            return idsFilms;
+        },
+        [](std::vector<std::uint32_t> total, const std::vector<std::uint32_t>& partiel) {
+            total.insert(total.end(), partiel.begin(), partiel.end());
+            return total;
+        });
+
+    std::vector<bool> dejaVus(colonnes_.getNombreFilms(), false);
+    std::vector<const Film*> filmsVus;
+    for (std::uint32_t idFilm : idsFilmsVus)
+    {
+        if (!dejaVus[idFilm])
+        {
+            dejaVus[idFilm] = true;
+            filmsVus.push_back(colonnes_.getFilm(idFilm));
+        }
+    }
+    cacheFilmsVus_.inserer(utilisateur, filmsVus);
+    return filmsVus;
+}
+
+/// Retourne le nombre de vues total pour un groupe d'utilisateurs, par exemple le résultat d'une requête sur les
+/// filtres de GestionnaireUtilisateurs. Les lignes archivées par la rétention sont comprises.
+/// \param utilisateurs     Les utilisateurs dont on veut additionner les vues
+/// \return                 Le nombre de vues total du groupe
+int AnalyseurLogs::getNombreVuesPourUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const
+{
+    INSTRUMENTER_PHASE(RequeteNombreVuesGroupe);
+    int nombreVuesArchivees = 0;
+    if (!vuesArchiveesUtilisateurs_.empty())
     {
-        if(utilisateur == i.utilisateur)
+        // Comme pour le masque, un utilisateur répété n'est compté qu'une fois
+        std::vector<const Utilisateur*> distincts = utilisateurs;
+        std::sort(distincts.begin(), distincts.end());
+        distincts.erase(std::unique(distincts.begin(), distincts.end()), distincts.end());
+        for (const Utilisateur* utilisateur : distincts)
         {
-            filmsVus.insert(i.film);
+            auto vuesArchivees = vuesArchiveesUtilisateurs_.find(utilisateur);
+            if (vuesArchivees != vuesArchiveesUtilisateurs_.end())
+            {
+                nombreVuesArchivees += sommerVues(vuesArchivees->second);
+            }
         }
     }
-    // std::copy_if(logs_.begin(), logs_.end(), filmsVus,[&utilisateur](LigneLog& ligneLog){return ligneLog.utilisateur == utilisateur;};
-    std::vector<const Film*> films;
-    std::copy(filmsVus.begin(), filmsVus.end(), std::back_inserter(films));
 
-    return films;
+    std::vector<std::uint32_t> masque = colonnes_.getMasqueUtilisateurs(utilisateurs);
+    const std::uint32_t* idsUtilisateurs = colonnes_.getUtilisateurs();
+    return nombreVuesArchivees + PoolTaches::getPoolGlobal().parallelReduce(
+        0, colonnes_.getTaille(), tailleGrainColonnes, 0,
+        [idsUtilisateurs, &masque](std::size_t debut, std::size_t fin) {
+            return static_cast<int>(
+                NoyauxColonnes::compterDansMasque(idsUtilisateurs + debut, fin - debut, masque.data()));
+        },
+        std::plus<int>());
+}
+
+/// Retourne les n films les plus populaires auprès d'un groupe d'utilisateurs, par exemple le résultat d'une
+/// requête sur les filtres de GestionnaireUtilisateurs. Seules les lignes conservées par la rétention sont comptées.
+/// \param nombre           Le nombre de films a retourner
+/// \param utilisateurs     Les utilisateurs dont on compte les vues
+/// \return                 Le vecteur contenant les films les plus populaires auprès du groupe
+std::vector<std::pair<const Film*, int>> AnalyseurLogs::getNFilmsPlusPopulairesPourUtilisateurs(
+    std::size_t nombre, const std::vector<const Utilisateur*>& utilisateurs) const
+{
+    INSTRUMENTER_PHASE(RequeteNFilmsPlusPopulairesGroupe);
+    std::vector<std::uint32_t> masque = colonnes_.getMasqueUtilisateurs(utilisateurs);
+    const std::uint32_t* idsUtilisateurs = colonnes_.getUtilisateurs();
+    const std::uint32_t* idsFilms = colonnes_.getFilms();
+    std::size_t nombreFilms = colonnes_.getNombreFilms();
+
+    // Chaque bloc remplit son propre histogramme; un bloc d'au moins quatre lignes par film amortit son allocation
+    Histogramme vues = PoolTaches::getPoolGlobal().parallelReduce(
+        0, colonnes_.getTaille(), std::max(tailleGrainColonnes, 4 * nombreFilms), Histogramme(nombreFilms, 0),
+        [idsUtilisateurs, idsFilms, nombreFilms, &masque](std::size_t debut, std::size_t fin) {
+            Histogramme vuesBloc(nombreFilms, 0);
+            NoyauxColonnes::histogrammeMasque(
+                idsUtilisateurs + debut, idsFilms + debut, fin - debut, masque.data(), vuesBloc.data());
+            return vuesBloc;
+        },
+        [](Histogramme total, const Histogramme& partiel) {
+            std::transform(total.begin(), total.end(), partiel.begin(), total.begin(), std::plus<std::uint32_t>());
+            return total;
+        });
+    return extraireNFilmsPlusPopulaires(vues, colonnes_, nombre);
+}
+
+/// Retourne les octets alloués sur le tas par chaque membre. Les timestamps sont comptés à part du vecteur de logs
+/// pour distinguer le coût des chaînes de celui des lignes elles-mêmes.
+/// \return                 Le rapport d'utilisation mémoire
+UtilisationMemoire AnalyseurLogs::getUtilisationMemoire() const
+{
+    std::size_t octetsTimestamps = 0;
+    for (const LigneLog& ligneLog : logs_)
+    {
+        octetsTimestamps += octetsTas(ligneLog.timestamp);
+    }
+
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("logs_", logs_.capacity() * sizeof(LigneLog));
+    utilisationMemoire.ajouter("logs_.timestamp", octetsTimestamps);
+    utilisationMemoire.ajouter("vuesFilms_", octetsTas(vuesFilms_));
+    utilisationMemoire.ajouter("colonnes_", colonnes_.getUtilisationMemoire().getTotal());
+    utilisationMemoire.ajouter("partitions_", partitions_ ? partitions_->getUtilisationMemoire().getTotal() : 0);
+    utilisationMemoire.ajouter("retards_", retards_ ? retards_->getUtilisationMemoire().getTotal() : 0);
+    utilisationMemoire.ajouter("vuesArchiveesUtilisateurs_", octetsTas(vuesArchiveesUtilisateurs_));
+    utilisationMemoire.ajouter("cachesRequetes_", cacheClassements_.getOctetsTas() + cacheFilmsVus_.getOctetsTas());
+    return utilisationMemoire;
+}
+
+/// Change le nombre maximal de films vus par utilisateur conservés par le cache des requêtes. Le cache des
+/// classements garde sa capacité, plus petite parce que chaque ligne ajoutée en parcourt les entrées, sauf pour 0.
+/// \param capacite     Le nombre maximal de résultats; 0 désactive les deux caches.
+void AnalyseurLogs::definirCapaciteCache(std::size_t capacite)
+{
+    cacheClassements_.definirCapacite(std::min(capacite, capaciteCacheClassements));
+    cacheFilmsVus_.definirCapacite(capacite);
+}
+
+/// \return Les succès, défauts, invalidations et évictions cumulés des caches des requêtes.
+StatistiquesCache AnalyseurLogs::getStatistiquesCache() const
+{
+    StatistiquesCache statistiques = cacheClassements_.getStatistiques();
+    statistiques += cacheFilmsVus_.getStatistiques();
+    return statistiques;
+}
+
+/// Compresse les logs en blocs pour les conserver à moindre coût, par exemple pour archiver un long historique.
+/// \return                 Les logs compressés, qui se décompressent en une copie exacte de logs_
+LogsCompresses AnalyseurLogs::compresserLogs() const
+{
+    replierRetards();
+    return LogsCompresses(logs_);
+}
+
+/// Reconstruit les colonnes à partir de logs_. Les colonnes sont dans l'ordre d'ajout et ne retirent pas de ligne sur
+/// place: les opérations qui retirent ou modifient des lignes de logs_ les reconstruisent avec cette méthode, après
+/// avoir replié les lignes en retard.
+void AnalyseurLogs::reconstruireColonnes()
+{
+    colonnes_.vider();
+    colonnes_.reserver(logs_.size());
+    for (const LigneLog& ligneLog : logs_)
+    {
+        colonnes_.ajouter(ligneLog);
+    }
+}
+
+/// Retire de logs_ les lignes plus anciennes que la durée de rétention, comptée depuis la ligne la plus récente, si
+/// elles sont au moins nombreMinimum. Les lignes expirées forment un préfixe des logs triés et sont retirées d'un
+/// seul coup; leurs vues restent dans vuesFilms_ et sont ajoutées à vuesArchiveesUtilisateurs_, par utilisateur et
+/// par film pour pouvoir les décompter si l'un ou l'autre est supprimé. Si les lignes sont
+/// partitionnées, seules les partitions entièrement expirées sont retirées, chacune d'un bloc.
+/// \param nombreMinimum    Le nombre de lignes expirées en deçà duquel rien n'est retiré.
+/// \return                 Le nombre de lignes retirées.
+std::size_t AnalyseurLogs::retirerLignesExpirees(std::size_t nombreMinimum)
+{
+    if (!secondesRetention_ || logs_.empty())
+    {
+        return 0;
+    }
+    std::optional<std::int64_t> secondesPlusRecente = convertirTimestamp(logs_.back().timestamp);
+    if (!secondesPlusRecente)
+    {
+        return 0;
+    }
+    // Les timestamps canoniques se comparent comme les instants qu'ils représentent
+    std::string timestampLimite = formaterTimestamp(*secondesPlusRecente - *secondesRetention_);
+    // Avec des partitions, la limite recule au début de sa période, dont la clé précède toutes les lignes
+    LigneLog limite{partitions_ ? partitions_->getCle(timestampLimite) : timestampLimite, nullptr, nullptr};
+    auto finExpirees = std::lower_bound(logs_.begin(), logs_.end(), limite, ComparateurLog());
+    auto nombreExpirees = static_cast<std::size_t>(finExpirees - logs_.begin());
+    // Les lignes en retard ne sont repliées que si la rétention en retire effectivement assez
+    std::size_t nombreRetardsExpires = 0;
+    if (retards_ && nombreExpirees + retards_->getTaille() >= nombreMinimum)
+    {
+        nombreRetardsExpires = retards_->getNombreLignesAvant(limite.timestamp);
+    }
+    if (nombreExpirees + nombreRetardsExpires == 0 || nombreExpirees + nombreRetardsExpires < nombreMinimum)
+    {
+        return 0;
+    }
+    if (nombreRetardsExpires > 0)
+    {
+        replierRetards();
+        finExpirees = std::lower_bound(logs_.begin(), logs_.end(), limite, ComparateurLog());
+        nombreExpirees = static_cast<std::size_t>(finExpirees - logs_.begin());
+    }
+
+    for (auto ligneLog = logs_.begin(); ligneLog != finExpirees; ++ligneLog)
+    {
+        vuesArchiveesUtilisateurs_[ligneLog->utilisateur][ligneLog->film]++;
+    }
+    invaliderFilmsVus(logs_.data(), logs_.data() + nombreExpirees);
+    logs_.erase(logs_.begin(), finExpirees);
+    if (partitions_)
+    {
+        partitions_->supprimerPartitionsAvant(timestampLimite);
+    }
+    nombreLignesArchivees_ += nombreExpirees;
+
+    // Les colonnes sont dans l'ordre d'ajout plutôt que celui des timestamps: elles sont reconstruites
+    reconstruireColonnes();
+    return nombreExpirees;
+}
+
+/// \return Les lignes en retard, créées au premier besoin parce que leur arbre LSM démarre un thread de compaction.
+LogsLSM& AnalyseurLogs::getRetards()
+{
+    if (!retards_)
+    {
+        retards_.emplace();
+    }
+    return *retards_;
+}
+
+/// Fusionne les lignes en retard dans logs_, en une seule passe, et vide retards_. Les colonnes, les partitions et
+/// les agrégats les comptent déjà et ne changent pas.
+void AnalyseurLogs::replierRetards() const
+{
+    if (!retards_ || retards_->getTaille() == 0)
+    {
+        return;
+    }
+    std::vector<LigneLog> retards = retards_->getLogs();
+    retards_->vider();
+    auto tailleInitiale = static_cast<std::ptrdiff_t>(logs_.size());
+    logs_.insert(logs_.end(), std::make_move_iterator(retards.begin()), std::make_move_iterator(retards.end()));
+    std::inplace_merge(logs_.begin(), logs_.begin() + tailleInitiale, logs_.end(), ComparateurLog());
+}
+
+/// Retire de logs_ les lignes de certains films ou utilisateurs, en conservant l'ordre des autres, et décompte leurs
+/// vues de vuesFilms_. Les colonnes et les partitions sont reconstruites, et les caches, qui peuvent référencer ces
+/// films ou ces utilisateurs, sont vidés.
+/// \param films        Les films dont les lignes sont retirées.
+/// \param utilisateurs Les utilisateurs dont les lignes sont retirées.
+/// \return             Le nombre de lignes retirées.
+std::size_t AnalyseurLogs::retirerLignes(const std::unordered_set<const Film*>& films,
+                                         const std::unordered_set<const Utilisateur*>& utilisateurs)
+{
+    replierRetards();
+    auto estRetiree = [&films, &utilisateurs](const LigneLog& ligneLog) {
+        return films.count(ligneLog.film) != 0 || utilisateurs.count(ligneLog.utilisateur) != 0;
+    };
+    for (const LigneLog& ligneLog : logs_)
+    {
+        auto vues = estRetiree(ligneLog) ? vuesFilms_.find(ligneLog.film) : vuesFilms_.end();
+        if (vues != vuesFilms_.end() && --vues->second == 0)
+        {
+            vuesFilms_.erase(vues);
+        }
+    }
+    auto finConservees = std::remove_if(logs_.begin(), logs_.end(), estRetiree);
+    auto nombreRetirees = static_cast<std::size_t>(logs_.end() - finConservees);
+    logs_.erase(finConservees, logs_.end());
+    if (nombreRetirees > 0)
+    {
+        reconstruireColonnes();
+        if (partitions_)
+        {
+            partitions_.emplace(logs_, partitions_->getGranularite());
+        }
+    }
+    cacheClassements_.vider();
+    cacheFilmsVus_.vider();
+    return nombreRetirees;
 }
 
+/// Retire du cache les films vus des utilisateurs de lignes ajoutées ou retirées.
+/// \param debut    La première ligne.
+/// \param fin      La position qui suit la dernière ligne.
+void AnalyseurLogs::invaliderFilmsVus(const LigneLog* debut, const LigneLog* fin)
+{
+    if (debut == fin || cacheFilmsVus_.estVide())
+    {
+        return;
+    }
+    if (fin - debut == 1)
+    {
+        cacheFilmsVus_.retirer(debut->utilisateur);
+        return;
+    }
+    std::unordered_set<const Utilisateur*> utilisateurs;
+    for (const LigneLog* ligneLog = debut; ligneLog != fin; ++ligneLog)
+    {
+        utilisateurs.insert(ligneLog->utilisateur);
+    }
+    cacheFilmsVus_.retirerSi([&utilisateurs](const Utilisateur* utilisateur, const std::vector<const Film*>&) {
+        return utilisateurs.count(utilisateur) != 0;
+    });
+}
 
+/// Retire du cache les classements que des lignes ajoutées peuvent avoir changés: ceux qui comptent moins de films
+/// que demandé, et ceux dont le dernier film n'a pas plus de vues qu'un film des lignes. Un film qui reste sous le
+/// dernier film d'un classement n'en faisait pas partie et n'en fait toujours pas partie. Les vues des lignes doivent
+/// déjà être comptées dans vuesFilms_.
+/// \param debut    La première ligne ajoutée.
+/// \param fin      La position qui suit la dernière ligne ajoutée.
+void AnalyseurLogs::invaliderClassements(const LigneLog* debut, const LigneLog* fin)
+{
+    if (debut == fin || cacheClassements_.estVide())
+    {
+        return;
+    }
+    int vuesMaximum = 0;
+    for (const LigneLog* ligneLog = debut; ligneLog != fin; ++ligneLog)
+    {
+        vuesMaximum = std::max(vuesMaximum, vuesFilms_.find(ligneLog->film)->second);
+    }
+    cacheClassements_.retirerSi([vuesMaximum](std::size_t nombre, const Classement& classement) {
+        return classement.size() < nombre || (!classement.empty() && vuesMaximum >= classement.back().second);
+    });
+}
@@ -0,0 +1,683 @@
+/// Analyseur de logs hors mémoire, pour les fichiers de logs plus gros que la mémoire disponible.
+
+#include "AnalyseurLogsExterne.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <unordered_set>
+#include "AnalyseurLogs.h"
+#include "ColonnesLogs.h"
+#include "Horodatage.h"
+#include "Instrumentation.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using EnregistrementLog = AnalyseurLogsExterne::EnregistrementLog;
+
+    // Tampon minimal par séquence lue pendant une fusion; il borne le nombre de séquences fusionnées à la fois
+    constexpr std::size_t octetsTamponFusionMinimum = 64 * 1024;
+    constexpr std::size_t enregistrementsParSegment = 1 << 20; // 16 Mio par segment
+
+    /// \return Le nombre d'enregistrements qui tiennent dans un nombre d'octets, au moins 1.
+    std::size_t getCapacite(std::size_t octets)
+    {
+        return std::max<std::size_t>(octets / sizeof(EnregistrementLog), 1);
+    }
+
+    /// Lecteur tamponné d'une séquence triée d'enregistrements.
+    class LecteurSequence
+    {
+    public:
+        LecteurSequence(const std::filesystem::path& chemin, std::size_t capacite)
+            : fichier_(chemin, std::ios::binary)
+            , tampon_(capacite)
+        {
+            remplir();
+        }
+
+        bool estTermine() const { return position_ >= taille_; }
+        const EnregistrementLog& getCourant() const { return tampon_[position_]; }
+
+        void avancer()
+        {
+            if (++position_ >= taille_)
+            {
+                remplir();
+            }
+        }
+
+    private:
+        void remplir()
+        {
+            fichier_.read(reinterpret_cast<char*>(tampon_.data()),
+                          static_cast<std::streamsize>(tampon_.size() * sizeof(EnregistrementLog)));
+            taille_ = static_cast<std::size_t>(fichier_.gcount()) / sizeof(EnregistrementLog);
+            position_ = 0;
+        }
+
+        std::ifstream fichier_;
+        std::vector<EnregistrementLog> tampon_;
+        std::size_t position_ = 0;
+        std::size_t taille_ = 0;
+    };
+
+    /// Écrivain tamponné d'une séquence d'enregistrements.
+    class EcrivainSequence
+    {
+    public:
+        EcrivainSequence(const std::filesystem::path& chemin, std::size_t capacite)
+            : fichier_(chemin, std::ios::binary | std::ios::trunc)
+        {
+            tampon_.reserve(capacite);
+        }
+
+        void ajouter(const EnregistrementLog& enregistrement)
+        {
+            tampon_.push_back(enregistrement);
+            if (tampon_.size() == tampon_.capacity())
+            {
+                vider();
+            }
+        }
+
+        /// \return True si toutes les écritures ont réussi, false sinon.
+        bool vider()
+        {
+            fichier_.write(reinterpret_cast<const char*>(tampon_.data()),
+                           static_cast<std::streamsize>(tampon_.size() * sizeof(EnregistrementLog)));
+            tampon_.clear();
+            fichier_.flush();
+            return static_cast<bool>(fichier_);
+        }
+
+    private:
+        std::ofstream fichier_;
+        std::vector<EnregistrementLog> tampon_;
+    };
+
+    /// Fusionne des séquences triées et passe leurs enregistrements, dans l'ordre, à une fonction. À instant égal,
+    /// les enregistrements gardent l'ordre des séquences, qui est celui du fichier de logs.
+    /// \param sequences    Les séquences à fusionner.
+    /// \param octetsTampon La mémoire à répartir entre les tampons de lecture.
+    /// \param sortie       La fonction appelée sur chaque enregistrement.
+    template<typename Fonction>
+    void fusionnerSequences(const std::vector<std::filesystem::path>& sequences,
+                            std::size_t octetsTampon,
+                            Fonction&& sortie)
+    {
+        std::vector<LecteurSequence> lecteurs;
+        lecteurs.reserve(sequences.size());
+        for (const std::filesystem::path& sequence : sequences)
+        {
+            lecteurs.emplace_back(sequence, getCapacite(octetsTampon / sequences.size()));
+        }
+
+        using Tete = std::pair<std::int64_t, std::size_t>; // Instant et index du lecteur
+        std::priority_queue<Tete, std::vector<Tete>, std::greater<Tete>> tetes;
+        for (std::size_t i = 0; i < lecteurs.size(); i++)
+        {
+            if (!lecteurs[i].estTermine())
+            {
+                tetes.emplace(lecteurs[i].getCourant().secondes, i);
+            }
+        }
+        while (!tetes.empty())
+        {
+            std::size_t i = tetes.top().second;
+            tetes.pop();
+            sortie(lecteurs[i].getCourant());
+            lecteurs[i].avancer();
+            if (!lecteurs[i].estTermine())
+            {
+                tetes.emplace(lecteurs[i].getCourant().secondes, i);
+            }
+        }
+    }
+
+    /// Extrait les n films ayant le plus de vues d'un tableau de vues indexé par identifiant de film.
+    std::vector<std::pair<const Film*, int>> extraireNFilmsPlusPopulaires(const std::vector<int>& vues,
+                                                                          const std::vector<const Film*>& films,
+                                                                          std::size_t nombre)
+    {
+        auto aPlusDeVues = [](const std::pair<const Film*, int>& film1, const std::pair<const Film*, int>& film2) {
+            return film1.second > film2.second;
+        };
+        std::vector<std::pair<const Film*, int>> candidats;
+        for (std::size_t idFilm = 0; idFilm < vues.size(); idFilm++)
+        {
+            if (vues[idFilm] != 0)
+            {
+                candidats.emplace_back(films[idFilm], vues[idFilm]);
+            }
+        }
+        if (candidats.size() > nombre)
+        {
+            auto milieu = candidats.begin() + static_cast<std::ptrdiff_t>(nombre);
+            std::nth_element(candidats.begin(), milieu, candidats.end(), aPlusDeVues);
+            candidats.erase(milieu, candidats.end());
+        }
+        std::sort(candidats.begin(), candidats.end(), aPlusDeVues);
+        return candidats;
+    }
+} // namespace
+
+/// Segment immuable d'enregistrements triés, projeté en mémoire en lecture seule. Le fichier est supprimé avec le
+/// segment. Sans mmap, ou si la projection a échoué, le segment est lu par morceaux.
+class AnalyseurLogsExterne::Segment
+{
+public:
+    Segment(std::filesystem::path chemin, std::size_t nombre, std::int64_t secondesMin, std::int64_t secondesMax)
+        : chemin_(std::move(chemin))
+        , nombre_(nombre)
+        , secondesMin_(secondesMin)
+        , secondesMax_(secondesMax)
+    {
+    }
+
+    ~Segment()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (projection_ != nullptr)
+        {
+            munmap(projection_, nombre_ * sizeof(EnregistrementLog));
+        }
+#endif
+        std::error_code erreur;
+        std::filesystem::remove(chemin_, erreur);
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    /// Projette le fichier en mémoire. En cas d'échec, le segment reste utilisable par lectures successives.
+    /// \return True si la projection a réussi ou n'est pas disponible sur cette plateforme, false sinon.
+    bool projeter()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        int descripteur = open(chemin_.c_str(), O_RDONLY);
+        if (descripteur < 0)
+        {
+            return false;
+        }
+        void* projection = mmap(nullptr, nombre_ * sizeof(EnregistrementLog), PROT_READ, MAP_PRIVATE, descripteur, 0);
+        close(descripteur);
+        if (projection == MAP_FAILED)
+        {
+            return false;
+        }
+        projection_ = projection;
+        madvise(projection_, nombre_ * sizeof(EnregistrementLog), MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    std::size_t getNombre() const { return nombre_; }
+    std::int64_t getSecondesMin() const { return secondesMin_; }
+    std::int64_t getSecondesMax() const { return secondesMax_; }
+
+    /// Appelle fonction(enregistrements, nombre) sur des morceaux consécutifs et triés du segment.
+    /// \param tailleMorceau    Le nombre d'enregistrements lus à la fois lorsque le segment n'est pas projeté.
+    /// \param fonction         La fonction à appeler sur chaque morceau.
+    template<typename Fonction>
+    void parcourir(std::size_t tailleMorceau, Fonction&& fonction) const
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (projection_ != nullptr)
+        {
+            fonction(static_cast<const EnregistrementLog*>(projection_), nombre_);
+            return;
+        }
+#endif
+        std::ifstream fichier(chemin_, std::ios::binary);
+        std::vector<EnregistrementLog> morceau(tailleMorceau);
+        while (fichier)
+        {
+            fichier.read(reinterpret_cast<char*>(morceau.data()),
+                         static_cast<std::streamsize>(morceau.size() * sizeof(EnregistrementLog)));
+            std::size_t nombre = static_cast<std::size_t>(fichier.gcount()) / sizeof(EnregistrementLog);
+            if (nombre > 0)
+            {
+                fonction(morceau.data(), nombre);
+            }
+        }
+    }
+
+private:
+    std::filesystem::path chemin_;
+    std::size_t nombre_;
+    std::int64_t secondesMin_;
+    std::int64_t secondesMax_;
+#if defined(__unix__) || defined(__APPLE__)
+    void* projection_ = nullptr;
+#endif
+};
+
+/// Constructeur qui fixe le dossier des fichiers temporaires et le budget mémoire.
+/// \param dossierTravail   Le dossier dans lequel écrire les séquences et les segments; il est créé au besoin.
+/// \param budgetMemoire    Les octets utilisables par le tri et la fusion, en plus des agrégats résidents.
+AnalyseurLogsExterne::AnalyseurLogsExterne(std::filesystem::path dossierTravail, std::size_t budgetMemoire)
+    : dossierTravail_(std::move(dossierTravail))
+    , budgetMemoire_(budgetMemoire)
+{
+}
+
+/// Destructeur qui libère les projections et supprime les fichiers des segments.
+AnalyseurLogsExterne::~AnalyseurLogsExterne() = default;
+
+/// Charge un fichier de logs: les lignes sont triées par tranches du budget mémoire, écrites en séquences puis
+/// fusionnées en segments. Les lignes rejetées sont signalées comme par AnalyseurLogs::chargerDepuisFichier.
+/// \param nomFichier               Le fichier à partir duquel lire les logs.
+/// \param gestionnaireUtilisateurs Le gestionnaire des utilisateurs pour lier un utilisateur à un log.
+/// \param gestionnaireFilms        Le gestionnaire des films pour lier un film à un log.
+/// \param options                  Le traitement des lignes mal formées et de celles dont l'utilisateur ou le film
+///                                 est introuvable.
+/// \return                         Le nombre de lignes chargées et de lignes rejetées, et le succès si le fichier a
+///                                 été ouvert, que toutes ses lignes ont été interprétées et que les fichiers de
+///                                 travail ont été écrits.
+BilanChargement AnalyseurLogsExterne::chargerDepuisFichier(const std::string& nomFichier,
+                                                           const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                                           const GestionnaireFilms& gestionnaireFilms,
+                                                           const OptionsRejets& options)
+{
+    INSTRUMENTER_PHASE(ChargementLogs);
+    BilanChargement bilan;
+    std::ifstream fichier(nomFichier);
+    if (!fichier)
+    {
+        std::cerr << "Erreur AnalyseurLogsExterne: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+        return bilan;
+    }
+    vider();
+    CollecteurRejets rejets("AnalyseurLogsExterne", options);
+    std::error_code erreur;
+    std::filesystem::create_directories(dossierTravail_, erreur);
+
+    bool succesParsing = true;
+    bool succesEcriture = true;
+    std::vector<EnregistrementLog> tampon;
+    tampon.reserve(getCapacite(budgetMemoire_));
+    std::vector<std::filesystem::path> sequences;
+    std::string ligne;
+    AnalyseurLogs::EntreeLog entreeLog;
+    while (lireLigne(fichier, ligne))
+    {
+        if (!AnalyseurLogs::analyserLigne(ligne, entreeLog))
+        {
+            rejets.rejeter(RaisonRejet::LigneMalFormee, ligne);
+            succesParsing = false;
+            continue;
+        }
+        const Utilisateur* utilisateur = gestionnaireUtilisateurs.getUtilisateurParId(entreeLog.idUtilisateur);
+        const Film* film = gestionnaireFilms.getFilmParNom(entreeLog.nomFilm);
+        if (utilisateur == nullptr || film == nullptr)
+        {
+            rejets.rejeter(utilisateur == nullptr ? RaisonRejet::UtilisateurIntrouvable : RaisonRejet::FilmIntrouvable,
+                           ligne);
+            continue;
+        }
+
+        auto idUtilisateur = idsUtilisateurs_.emplace(utilisateur, static_cast<std::uint32_t>(utilisateurs_.size()));
+        if (idUtilisateur.second)
+        {
+            utilisateurs_.push_back(utilisateur);
+            vuesUtilisateurs_.push_back(0);
+        }
+        auto idFilm = idsFilms_.emplace(film, static_cast<std::uint32_t>(films_.size()));
+        if (idFilm.second)
+        {
+            films_.push_back(film);
+            vuesFilms_.push_back(0);
+        }
+        vuesUtilisateurs_[idUtilisateur.first->second]++;
+        vuesFilms_[idFilm.first->second]++;
+
+        std::int64_t secondes = convertirTimestamp(entreeLog.timestamp).value_or(ColonnesLogs::secondesInvalides);
+        tampon.push_back(EnregistrementLog{secondes, idUtilisateur.first->second, idFilm.first->second});
+        bilan.nombreLignesChargees++;
+        if (tampon.size() == tampon.capacity())
+        {
+            succesEcriture &= ecrireSequence(tampon, sequences);
+        }
+    }
+    if (!tampon.empty())
+    {
+        succesEcriture &= ecrireSequence(tampon, sequences);
+    }
+    tampon.shrink_to_fit();
+    nombreSequences_ = sequences.size();
+
+    succesEcriture &= fusionner(std::move(sequences));
+    if (!succesEcriture)
+    {
+        std::cerr << "Erreur AnalyseurLogsExterne: les fichiers de travail n'ont pas pu être écrits dans "
+                  << dossierTravail_.string() << '\n';
+    }
+    bilan.succes = succesParsing && succesEcriture;
+    bilan.nombreRejets = rejets.terminer();
+    return bilan;
+}
+
+/// Retourne le nombre de vues d'un film, conservé en mémoire.
+/// \param film     Le film dont on veut le nombre de vues
+/// \return         Le nombre de vues du film
+int AnalyseurLogsExterne::getNombreVuesFilm(const Film* film) const
+{
+    std::uint32_t idFilm = getIdFilm(film);
+    return idFilm == ColonnesLogs::idAbsent ? 0 : vuesFilms_[idFilm];
+}
+
+/// Retourne le nombre de vues d'un film dans un intervalle de temps. Les segments hors de l'intervalle ne sont pas
+/// lus, et l'intervalle est trouvé par recherche binaire dans les autres puisque leurs instants sont triés.
+/// \param film     Le film dont on veut le nombre de vues
+/// \param debut    Le timestamp du début (inclus) de l'intervalle
+/// \param fin      Le timestamp de la fin (exclue) de l'intervalle
+/// \return         Le nombre de vues dans l'intervalle, ou 0 si un des timestamps est mal formé
+int AnalyseurLogsExterne::getNombreVuesFilmEntre(const Film* film,
+                                                 const std::string& debut,
+                                                 const std::string& fin) const
+{
+    std::optional<std::int64_t> secondesDebut = convertirTimestamp(debut);
+    std::optional<std::int64_t> secondesFin = convertirTimestamp(fin);
+    std::uint32_t idFilm = getIdFilm(film);
+    if (!secondesDebut || !secondesFin || idFilm == ColonnesLogs::idAbsent)
+    {
+        return 0;
+    }
+
+    auto avant = [](const EnregistrementLog& enregistrement, std::int64_t secondes) {
+        return enregistrement.secondes < secondes;
+    };
+    int nombreVues = 0;
+    auto compterMorceau = [&](const EnregistrementLog* enregistrements, std::size_t nombre) {
+        const EnregistrementLog* dernier = enregistrements + nombre;
+        const EnregistrementLog* premier = std::lower_bound(enregistrements, dernier, *secondesDebut, avant);
+        dernier = std::lower_bound(premier, dernier, *secondesFin, avant);
+        nombreVues += static_cast<int>(std::count_if(premier, dernier, [idFilm](const EnregistrementLog& ligne) {
+            return ligne.film == idFilm;
+        }));
+    };
+    for (const std::unique_ptr<Segment>& segment : segments_)
+    {
+        if (segment->getSecondesMax() >= *secondesDebut && segment->getSecondesMin() < *secondesFin)
+        {
+            segment->parcourir(getCapacite(budgetMemoire_), compterMorceau);
+        }
+    }
+    return nombreVues;
+}
+
+/// Retourne le film le plus populaire, à partir des vues conservées en mémoire.
+/// \return         Un pointeur vers le film le plus populaire ou nullptr si il n'y a aucun film
+const Film* AnalyseurLogsExterne::getFilmPlusPopulaire() const
+{
+    if (vuesFilms_.empty())
+    {
+        return nullptr;
+    }
+    auto plusVu = std::max_element(vuesFilms_.begin(), vuesFilms_.end());
+    return films_[static_cast<std::size_t>(plusVu - vuesFilms_.begin())];
+}
+
+/// Retourne les n films les plus populaires, à partir des vues conservées en mémoire.
+/// \param nombre      Le nombre de films a retourner
+/// \return            Le vecteur contenant les films les plus populaires
+std::vector<std::pair<const Film*, int>> AnalyseurLogsExterne::getNFilmsPlusPopulaires(std::size_t nombre) const
+{
+    return extraireNFilmsPlusPopulaires(vuesFilms_, films_, nombre);
+}
+
+/// Retourne le nombre de vues total pour un utilisateur, conservé en mémoire.
+/// \param utilisateur      L'utilisateur dont on veut savoir le nombre de vues
+/// \return                 Le nombre de vues de l'utilisateur
+int AnalyseurLogsExterne::getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const
+{
+    std::uint32_t idUtilisateur = getIdUtilisateur(utilisateur);
+    return idUtilisateur == ColonnesLogs::idAbsent ? 0 : vuesUtilisateurs_[idUtilisateur];
+}
+
+/// Retourne les films vus par un utilisateur en parcourant tous les segments.
+/// \param utilisateur      L'utilisateur dont on veut avoir les films vus.
+/// \return                 Les films vus par l'utilisateur, dans l'ordre de leur première vue
+std::vector<const Film*> AnalyseurLogsExterne::getFilmsVusParUtilisateur(const Utilisateur* utilisateur) const
+{
+    std::uint32_t idUtilisateur = getIdUtilisateur(utilisateur);
+    std::vector<const Film*> filmsVus;
+    if (idUtilisateur == ColonnesLogs::idAbsent)
+    {
+        return filmsVus;
+    }
+    std::vector<bool> dejaVus(films_.size(), false);
+    auto parcourirMorceau = [&](const EnregistrementLog* enregistrements, std::size_t nombre) {
+        for (std::size_t i = 0; i < nombre; i++)
+        {
+            if (enregistrements[i].utilisateur == idUtilisateur && !dejaVus[enregistrements[i].film])
+            {
+                dejaVus[enregistrements[i].film] = true;
+                filmsVus.push_back(films_[enregistrements[i].film]);
+            }
+        }
+    };
+    for (const std::unique_ptr<Segment>& segment : segments_)
+    {
+        segment->parcourir(getCapacite(budgetMemoire_), parcourirMorceau);
+    }
+    return filmsVus;
+}
+
+/// Retourne le nombre de vues total pour un groupe d'utilisateurs, à partir des vues conservées en mémoire.
+/// \param utilisateurs     Les utilisateurs dont on veut additionner les vues
+/// \return                 Le nombre de vues total du groupe
+int AnalyseurLogsExterne::getNombreVuesPourUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const
+{
+    std::unordered_set<const Utilisateur*> audience(utilisateurs.begin(), utilisateurs.end());
+    int nombreVues = 0;
+    for (const Utilisateur* utilisateur : audience)
+    {
+        nombreVues += getNombreVuesPourUtilisateur(utilisateur);
+    }
+    return nombreVues;
+}
+
+/// Retourne les n films les plus populaires auprès d'un groupe d'utilisateurs en parcourant tous les segments.
+/// \param nombre           Le nombre de films a retourner
+/// \param utilisateurs     Les utilisateurs dont on compte les vues
+/// \return                 Le vecteur contenant les films les plus populaires auprès du groupe
+std::vector<std::pair<const Film*, int>> AnalyseurLogsExterne::getNFilmsPlusPopulairesPourUtilisateurs(
+    std::size_t nombre, const std::vector<const Utilisateur*>& utilisateurs) const
+{
+    std::vector<int> masque(utilisateurs_.size(), 0);
+    for (const Utilisateur* utilisateur : utilisateurs)
+    {
+        std::uint32_t idUtilisateur = getIdUtilisateur(utilisateur);
+        if (idUtilisateur != ColonnesLogs::idAbsent)
+        {
+            masque[idUtilisateur] = 1;
+        }
+    }
+    std::vector<int> vues(films_.size(), 0);
+    auto compterMorceau = [&](const EnregistrementLog* enregistrements, std::size_t nombreEnregistrements) {
+        for (std::size_t i = 0; i < nombreEnregistrements; i++)
+        {
+            vues[enregistrements[i].film] += masque[enregistrements[i].utilisateur];
+        }
+    };
+    for (const std::unique_ptr<Segment>& segment : segments_)
+    {
+        segment->parcourir(getCapacite(budgetMemoire_), compterMorceau);
+    }
+    return extraireNFilmsPlusPopulaires(vues, films_, nombre);
+}
+
+/// \return Le nombre de lignes de log chargées.
+std::size_t AnalyseurLogsExterne::getNombreLignes() const
+{
+    std::size_t nombreLignes = 0;
+    for (const std::unique_ptr<Segment>& segment : segments_)
+    {
+        nombreLignes += segment->getNombre();
+    }
+    return nombreLignes;
+}
+
+/// \return Le nombre de séquences triées écrites pendant le dernier chargement.
+std::size_t AnalyseurLogsExterne::getNombreSequences() const
+{
+    return nombreSequences_;
+}
+
+/// \return Le nombre de passes de fusion du dernier chargement, y compris la passe qui écrit les segments.
+std::size_t AnalyseurLogsExterne::getNombrePassesFusion() const
+{
+    return nombrePassesFusion_;
+}
+
+/// \return Le nombre de segments projetés.
+std::size_t AnalyseurLogsExterne::getNombreSegments() const
+{
+    return segments_.size();
+}
+
+/// Retourne les octets résidents sur le tas, c'est-à-dire les agrégats et les dictionnaires d'identifiants. Les
+/// segments projetés ne sont pas comptés: leurs pages appartiennent au cache de fichiers du système.
+/// \return                 Le rapport d'utilisation mémoire
+UtilisationMemoire AnalyseurLogsExterne::getUtilisationMemoire() const
+{
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("segments_", segments_.capacity() * sizeof(std::unique_ptr<Segment>) +
+                                                segments_.size() * sizeof(Segment));
+    utilisationMemoire.ajouter("films_", octetsTas(films_));
+    utilisationMemoire.ajouter("utilisateurs_", octetsTas(utilisateurs_));
+    utilisationMemoire.ajouter("idsFilms_", octetsTas(idsFilms_));
+    utilisationMemoire.ajouter("idsUtilisateurs_", octetsTas(idsUtilisateurs_));
+    utilisationMemoire.ajouter("vuesFilms_", octetsTas(vuesFilms_));
+    utilisationMemoire.ajouter("vuesUtilisateurs_", octetsTas(vuesUtilisateurs_));
+    return utilisationMemoire;
+}
+
+/// Oublie les logs chargés et supprime leurs segments.
+void AnalyseurLogsExterne::vider()
+{
+    segments_.clear();
+    nombreSequences_ = 0;
+    nombrePassesFusion_ = 0;
+    films_.clear();
+    utilisateurs_.clear();
+    idsFilms_.clear();
+    idsUtilisateurs_.clear();
+    vuesFilms_.clear();
+    vuesUtilisateurs_.clear();
+}
+
+/// Trie le tampon par instant, l'écrit dans une nouvelle séquence et le vide.
+/// \param tampon       Les enregistrements à écrire.
+/// \param sequences    Les séquences déjà écrites, auxquelles ajouter la nouvelle.
+/// \return             True si l'écriture a réussi, false sinon.
+bool AnalyseurLogsExterne::ecrireSequence(std::vector<EnregistrementLog>& tampon,
+                                          std::vector<std::filesystem::path>& sequences)
+{
+    std::stable_sort(tampon.begin(), tampon.end(), [](const EnregistrementLog& e1, const EnregistrementLog& e2) {
+        return e1.secondes < e2.secondes;
+    });
+    sequences.push_back(dossierTravail_ / ("sequence_0_" + std::to_string(sequences.size()) + ".bin"));
+    std::ofstream fichier(sequences.back(), std::ios::binary | std::ios::trunc);
+    fichier.write(reinterpret_cast<const char*>(tampon.data()),
+                  static_cast<std::streamsize>(tampon.size() * sizeof(EnregistrementLog)));
+    tampon.clear();
+    return static_cast<bool>(fichier);
+}
+
+/// Fusionne les séquences en segments. Si elles sont trop nombreuses pour que chacune ait un tampon d'au moins
+/// octetsTamponFusionMinimum dans le budget, elles sont d'abord fusionnées par groupes, en plusieurs passes.
+/// \param sequences    Les séquences triées à fusionner, supprimées une fois fusionnées.
+/// \return             True si toutes les écritures et projections ont réussi, false sinon.
+bool AnalyseurLogsExterne::fusionner(std::vector<std::filesystem::path> sequences)
+{
+    bool succes = true;
+    std::error_code erreur;
+    std::size_t largeurFusion = std::max<std::size_t>(budgetMemoire_ / octetsTamponFusionMinimum, 3) - 1;
+    std::size_t octetsTampon = budgetMemoire_ / 2; // Lecture et écriture se partagent le budget
+
+    while (sequences.size() > largeurFusion)
+    {
+        nombrePassesFusion_++;
+        std::vector<std::filesystem::path> sequencesFusionnees;
+        for (std::size_t debut = 0; debut < sequences.size(); debut += largeurFusion)
+        {
+            std::vector<std::filesystem::path> groupe(
+                sequences.begin() + static_cast<std::ptrdiff_t>(debut),
+                sequences.begin() + static_cast<std::ptrdiff_t>(std::min(sequences.size(), debut + largeurFusion)));
+            sequencesFusionnees.push_back(dossierTravail_ / ("sequence_" + std::to_string(nombrePassesFusion_) + "_" +
+                                                             std::to_string(sequencesFusionnees.size()) + ".bin"));
+            EcrivainSequence ecrivain(sequencesFusionnees.back(), getCapacite(octetsTampon));
+            fusionnerSequences(groupe, octetsTampon, [&ecrivain](const EnregistrementLog& enregistrement) {
+                ecrivain.ajouter(enregistrement);
+            });
+            succes &= ecrivain.vider();
+            for (const std::filesystem::path& sequence : groupe)
+            {
+                std::filesystem::remove(sequence, erreur);
+            }
+        }
+        sequences = std::move(sequencesFusionnees);
+    }
+
+    // Dernière passe: les enregistrements fusionnés sont découpés en segments d'au plus enregistrementsParSegment
+    nombrePassesFusion_++;
+    std::optional<EcrivainSequence> ecrivain;
+    std::filesystem::path cheminSegment;
+    std::size_t nombre = 0;
+    std::int64_t secondesMin = 0;
+    auto terminerSegment = [&](std::int64_t secondesMax) {
+        succes &= ecrivain->vider();
+        ecrivain.reset();
+        segments_.push_back(std::make_unique<Segment>(cheminSegment, nombre, secondesMin, secondesMax));
+        segments_.back()->projeter(); // Un segment non projeté reste lisible par morceaux
+        nombre = 0;
+    };
+    std::int64_t secondesPrecedentes = 0;
+    fusionnerSequences(sequences, octetsTampon, [&](const EnregistrementLog& enregistrement) {
+        if (!ecrivain)
+        {
+            cheminSegment = dossierTravail_ / ("segment_" + std::to_string(segments_.size()) + ".bin");
+            ecrivain.emplace(cheminSegment, std::min(getCapacite(octetsTampon), enregistrementsParSegment));
+            secondesMin = enregistrement.secondes;
+        }
+        ecrivain->ajouter(enregistrement);
+        secondesPrecedentes = enregistrement.secondes;
+        if (++nombre == enregistrementsParSegment)
+        {
+            terminerSegment(secondesPrecedentes);
+        }
+    });
+    if (ecrivain)
+    {
+        terminerSegment(secondesPrecedentes);
+    }
+    for (const std::filesystem::path& sequence : sequences)
+    {
+        std::filesystem::remove(sequence, erreur);
+    }
+    return succes;
+}
+
+/// \return L'identifiant dense d'un film, ou ColonnesLogs::idAbsent si aucune ligne ne le contient.
+std::uint32_t AnalyseurLogsExterne::getIdFilm(const Film* film) const
+{
+    auto it = idsFilms_.find(film);
+    return it != idsFilms_.end() ? it->second : ColonnesLogs::idAbsent;
+}
+
+/// \return L'identifiant dense d'un utilisateur, ou ColonnesLogs::idAbsent si aucune ligne ne le contient.
+std::uint32_t AnalyseurLogsExterne::getIdUtilisateur(const Utilisateur* utilisateur) const
+{
+    auto it = idsUtilisateurs_.find(utilisateur);
+    return it != idsUtilisateurs_.end() ? it->second : ColonnesLogs::idAbsent;
+}
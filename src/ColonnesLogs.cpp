@@ -0,0 +1,133 @@
+/// Stockage en colonnes des lignes de log.
+
+#include "ColonnesLogs.h"
+#include "Horodatage.h"
+
+/// Ajoute une ligne à la fin des colonnes. L'utilisateur et le film reçoivent un identifiant dense la première fois
+/// qu'ils sont vus; un timestamp mal formé est conservé comme secondesInvalides.
+/// \param ligneLog     La ligne de log à ajouter.
+void ColonnesLogs::ajouter(const LigneLog& ligneLog)
+{
+    auto utilisateur =
+        idsUtilisateurs_.emplace(ligneLog.utilisateur, static_cast<std::uint32_t>(idsUtilisateurs_.size())).first;
+    auto [film, filmInsere] = idsFilms_.emplace(ligneLog.film, static_cast<std::uint32_t>(filmsParId_.size()));
+    if (filmInsere)
+    {
+        filmsParId_.push_back(ligneLog.film);
+    }
+
+    secondes_.push_back(convertirTimestamp(ligneLog.timestamp).value_or(secondesInvalides));
+    utilisateurs_.push_back(utilisateur->second);
+    films_.push_back(film->second);
+}
+
+/// Réserve la place de lignes supplémentaires dans chaque colonne.
+/// \param nombreLignes     Le nombre de lignes qui seront ajoutées.
+void ColonnesLogs::reserver(std::size_t nombreLignes)
+{
+    secondes_.reserve(secondes_.size() + nombreLignes);
+    utilisateurs_.reserve(utilisateurs_.size() + nombreLignes);
+    films_.reserve(films_.size() + nombreLignes);
+}
+
+/// Retire toutes les lignes et oublie les identifiants attribués.
+void ColonnesLogs::vider()
+{
+    secondes_.clear();
+    utilisateurs_.clear();
+    films_.clear();
+    idsUtilisateurs_.clear();
+    idsFilms_.clear();
+    filmsParId_.clear();
+}
+
+/// \return Le nombre de lignes.
+std::size_t ColonnesLogs::getTaille() const
+{
+    return films_.size();
+}
+
+/// Retourne l'identifiant dense d'un utilisateur.
+/// \param utilisateur  L'utilisateur recherché.
+/// \return             Son identifiant, ou idAbsent si aucune ligne ne le contient.
+std::uint32_t ColonnesLogs::getIdUtilisateur(const Utilisateur* utilisateur) const
+{
+    auto it = idsUtilisateurs_.find(utilisateur);
+    return it != idsUtilisateurs_.end() ? it->second : idAbsent;
+}
+
+/// Retourne l'identifiant dense d'un film.
+/// \param film     Le film recherché.
+/// \return         Son identifiant, ou idAbsent si aucune ligne ne le contient.
+std::uint32_t ColonnesLogs::getIdFilm(const Film* film) const
+{
+    auto it = idsFilms_.find(film);
+    return it != idsFilms_.end() ? it->second : idAbsent;
+}
+
+/// \return Le nombre d'utilisateurs distincts, qui borne les identifiants d'utilisateurs.
+std::size_t ColonnesLogs::getNombreUtilisateurs() const
+{
+    return idsUtilisateurs_.size();
+}
+
+/// \return Le nombre de films distincts, qui borne les identifiants de films.
+std::size_t ColonnesLogs::getNombreFilms() const
+{
+    return filmsParId_.size();
+}
+
+/// \param idFilm   L'identifiant dense d'un film, inférieur à getNombreFilms().
+/// \return         Le film correspondant.
+const Film* ColonnesLogs::getFilm(std::uint32_t idFilm) const
+{
+    return filmsParId_[idFilm];
+}
+
+/// \return La colonne des instants en secondes depuis l'époque Unix, de getTaille() éléments.
+const std::int64_t* ColonnesLogs::getSecondes() const
+{
+    return secondes_.data();
+}
+
+/// \return La colonne des identifiants d'utilisateurs, de getTaille() éléments.
+const std::uint32_t* ColonnesLogs::getUtilisateurs() const
+{
+    return utilisateurs_.data();
+}
+
+/// \return La colonne des identifiants de films, de getTaille() éléments.
+const std::uint32_t* ColonnesLogs::getFilms() const
+{
+    return films_.data();
+}
+
+/// Construit le masque d'un groupe d'utilisateurs pour les noyaux compterDansMasque et histogrammeMasque.
+/// \param utilisateurs     Les utilisateurs du groupe; ceux qui n'apparaissent dans aucune ligne sont ignorés.
+/// \return                 Le masque indexé par identifiant d'utilisateur, qui vaut 1 pour les membres du groupe.
+std::vector<std::uint32_t> ColonnesLogs::getMasqueUtilisateurs(const std::vector<const Utilisateur*>& utilisateurs) const
+{
+    std::vector<std::uint32_t> masque(idsUtilisateurs_.size(), 0);
+    for (const Utilisateur* utilisateur : utilisateurs)
+    {
+        std::uint32_t id = getIdUtilisateur(utilisateur);
+        if (id != idAbsent)
+        {
+            masque[id] = 1;
+        }
+    }
+    return masque;
+}
+
+/// \return Le rapport des octets alloués sur le tas par chaque colonne et chaque dictionnaire d'identifiants.
+UtilisationMemoire ColonnesLogs::getUtilisationMemoire() const
+{
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("secondes_", octetsTas(secondes_));
+    utilisationMemoire.ajouter("utilisateurs_", octetsTas(utilisateurs_));
+    utilisationMemoire.ajouter("films_", octetsTas(films_));
+    utilisationMemoire.ajouter("idsUtilisateurs_", octetsTas(idsUtilisateurs_));
+    utilisationMemoire.ajouter("idsFilms_", octetsTas(idsFilms_));
+    utilisationMemoire.ajouter("filmsParId_", octetsTas(filmsParId_));
+    return utilisationMemoire;
+}
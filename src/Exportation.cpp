@@ -0,0 +1,572 @@
+/// Export en flux des films, des utilisateurs, des logs et des vues par film aux formats CSV, JSON et NDJSON.
+
+#include "Exportation.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Instrumentation.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t nombreGenres = 9;
+    constexpr std::size_t nombrePays = 9;
+#if defined(IOV_MAX)
+    constexpr std::size_t segmentsParEcriture = IOV_MAX;
+#else
+    constexpr std::size_t segmentsParEcriture = 16; // Minimum garanti par POSIX
+#endif
+
+    /// Table des octets à échapper dans un format, pour tester chaque octet d'un champ par un seul accès.
+    struct CaracteresAEchapper
+    {
+        constexpr explicit CaracteresAEchapper(FormatExport format) : estAEchapper()
+        {
+            for (int octet = 0; octet < 256; ++octet)
+            {
+                estAEchapper[octet] = format == FormatExport::Csv
+                                          ? octet == ',' || octet == '"' || octet == '\r' || octet == '\n'
+                                          : octet == '"' || octet == '\\' || octet < 0x20;
+            }
+        }
+
+        bool estAEchapper[256];
+    };
+
+    constexpr CaracteresAEchapper caracteresCsv(FormatExport::Csv);
+    constexpr CaracteresAEchapper caracteresJson(FormatExport::Json);
+
+    /// Indique si un texte doit être échappé pour être écrit dans un format, ou s'il peut être écrit tel quel entre
+    /// les guillemets du JSON ou sans guillemets en CSV.
+    /// \param texte    Le texte du champ.
+    /// \param format   Le format du fichier.
+    /// \return         True si le texte contient un caractère à échapper.
+    bool doitEchapper(std::string_view texte, FormatExport format)
+    {
+        const bool* estAEchapper =
+            format == FormatExport::Csv ? caracteresCsv.estAEchapper : caracteresJson.estAEchapper;
+        return std::any_of(texte.begin(), texte.end(), [estAEchapper](char caractere) {
+            return estAEchapper[static_cast<unsigned char>(caractere)];
+        });
+    }
+
+    /// Ajoute un champ texte échappé selon son format: entre guillemets en JSON, et entre guillemets en CSV seulement
+    /// s'il contient un séparateur, un guillemet ou une fin de ligne.
+    /// \param sortie   La chaîne à laquelle ajouter le champ.
+    /// \param texte    Le texte du champ.
+    /// \param format   Le format du fichier.
+    void ajouterEchappe(std::string& sortie, std::string_view texte, FormatExport format)
+    {
+        if (format == FormatExport::Csv)
+        {
+            if (!doitEchapper(texte, format))
+            {
+                sortie.append(texte.data(), texte.size());
+                return;
+            }
+            sortie.push_back('"');
+            for (char caractere : texte)
+            {
+                if (caractere == '"')
+                {
+                    sortie.push_back('"');
+                }
+                sortie.push_back(caractere);
+            }
+            sortie.push_back('"');
+            return;
+        }
+
+        static constexpr char chiffresHexadecimaux[] = "0123456789abcdef";
+        sortie.push_back('"');
+        for (char caractere : texte)
+        {
+            unsigned char octet = static_cast<unsigned char>(caractere);
+            if (caractere == '"' || caractere == '\\')
+            {
+                sortie.push_back('\\');
+                sortie.push_back(caractere);
+            }
+            else if (caractere == '\n')
+            {
+                sortie.append("\\n");
+            }
+            else if (caractere == '\r')
+            {
+                sortie.append("\\r");
+            }
+            else if (caractere == '\t')
+            {
+                sortie.append("\\t");
+            }
+            else if (octet < 0x20)
+            {
+                sortie.append("\\u00");
+                sortie.push_back(chiffresHexadecimaux[octet >> 4]);
+                sortie.push_back(chiffresHexadecimaux[octet & 0xF]);
+            }
+            else
+            {
+                sortie.push_back(caractere);
+            }
+        }
+        sortie.push_back('"');
+    }
+
+    /// Tampon d'écriture d'un fichier exporté. Le texte formaté s'accumule dans le tampon, alors que les longs champs
+    /// sans caractère à échapper sont seulement référencés. Lorsque le tampon est plein, ses parties et les champs
+    /// référencés sont écrits dans l'ordre par un seul appel à writev.
+    class TamponExport
+    {
+    public:
+        TamponExport(const std::filesystem::path& chemin, const OptionsExport& options)
+            : fichier_(std::fopen(chemin.string().c_str(), "wb"))
+            , options_(options)
+        {
+            tampon_.reserve(options_.octetsTampon + 4096);
+        }
+
+        ~TamponExport()
+        {
+            if (fichier_ != nullptr)
+            {
+                std::fclose(fichier_);
+            }
+        }
+
+        TamponExport(const TamponExport&) = delete;
+        TamponExport& operator=(const TamponExport&) = delete;
+
+        bool estOuvert() const { return fichier_ != nullptr; }
+
+        void ajouter(char caractere) { tampon_.push_back(caractere); }
+        void ajouter(std::string_view texte) { tampon_.append(texte.data(), texte.size()); }
+
+        template<typename Entier>
+        void ajouterEntier(Entier valeur)
+        {
+            char chiffres[24];
+            auto [fin, erreur] = std::to_chars(chiffres, chiffres + sizeof(chiffres), valeur);
+            (void)erreur;
+            tampon_.append(chiffres, static_cast<std::size_t>(fin - chiffres));
+        }
+
+        /// Ajoute un champ texte. Un long champ qui n'a pas à être échappé est référencé plutôt que copié: il doit
+        /// rester en mémoire jusqu'à la fin de l'export.
+        /// \param texte    Le texte du champ.
+        /// \param format   Le format du fichier.
+        void ajouterChaine(std::string_view texte, FormatExport format)
+        {
+            if (doitEchapper(texte, format))
+            {
+                ajouterEchappe(tampon_, texte, format);
+                return;
+            }
+            if (texte.size() < options_.octetsReference)
+            {
+                if (format != FormatExport::Csv)
+                {
+                    tampon_.push_back('"');
+                }
+                tampon_.append(texte.data(), texte.size());
+                if (format != FormatExport::Csv)
+                {
+                    tampon_.push_back('"');
+                }
+                return;
+            }
+            if (format != FormatExport::Csv)
+            {
+                tampon_.push_back('"');
+            }
+            fermerSegment();
+            segments_.push_back(Segment{texte.data(), 0, texte.size()});
+            if (format != FormatExport::Csv)
+            {
+                tampon_.push_back('"');
+            }
+            if (segments_.size() + 2 >= segmentsParEcriture)
+            {
+                ecrire();
+            }
+        }
+
+        /// Termine un enregistrement et écrit le tampon s'il est plein.
+        void finEnregistrement()
+        {
+            nombreEnregistrements_++;
+            if (tampon_.size() >= options_.octetsTampon)
+            {
+                ecrire();
+            }
+        }
+
+        /// Écrit le reste du tampon et ferme le fichier.
+        /// \return Le bilan de l'export.
+        BilanExport terminer()
+        {
+            ecrire();
+            BilanExport bilan;
+            bool estFerme = std::fclose(fichier_) == 0;
+            fichier_ = nullptr;
+            bilan.succes = !erreur_ && estFerme;
+            bilan.nombreEnregistrements = nombreEnregistrements_;
+            bilan.nombreOctets = nombreOctets_;
+            bilan.nombreEcritures = nombreEcritures_;
+            return bilan;
+        }
+
+    private:
+        /// Partie du fichier à écrire: une plage du tampon, ou un champ référencé si reference n'est pas nullptr.
+        struct Segment
+        {
+            const char* reference;
+            std::size_t debut;
+            std::size_t taille;
+        };
+
+        /// Ajoute aux segments la plage du tampon remplie depuis le dernier segment.
+        void fermerSegment()
+        {
+            if (tampon_.size() > debutSegment_)
+            {
+                segments_.push_back(Segment{nullptr, debutSegment_, tampon_.size() - debutSegment_});
+                debutSegment_ = tampon_.size();
+            }
+        }
+
+        /// Écrit tous les segments, puis vide le tampon.
+        void ecrire()
+        {
+            INSTRUMENTER_PHASE(EcritureExport);
+            fermerSegment();
+            for (const Segment& segment : segments_)
+            {
+                nombreOctets_ += segment.taille;
+            }
+#if defined(__unix__) || defined(__APPLE__)
+            std::vector<iovec> vecteurs;
+            vecteurs.reserve(segments_.size());
+            for (const Segment& segment : segments_)
+            {
+                const char* debut = segment.reference != nullptr ? segment.reference : tampon_.data() + segment.debut;
+                vecteurs.push_back(iovec{const_cast<char*>(debut), segment.taille});
+            }
+            std::size_t premier = 0;
+            while (!erreur_ && premier < vecteurs.size())
+            {
+                int nombre = static_cast<int>(std::min(segmentsParEcriture, vecteurs.size() - premier));
+                ssize_t ecrits = writev(fileno(fichier_), vecteurs.data() + premier, nombre);
+                nombreEcritures_++;
+                if (ecrits < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (ecrits <= 0)
+                {
+                    erreur_ = true;
+                    break;
+                }
+                // Une écriture partielle reprend au premier octet non écrit
+                std::size_t reste = static_cast<std::size_t>(ecrits);
+                while (premier < vecteurs.size() && reste >= vecteurs[premier].iov_len)
+                {
+                    reste -= vecteurs[premier].iov_len;
+                    premier++;
+                }
+                if (reste > 0)
+                {
+                    vecteurs[premier].iov_base = static_cast<char*>(vecteurs[premier].iov_base) + reste;
+                    vecteurs[premier].iov_len -= reste;
+                }
+            }
+#else
+            for (const Segment& segment : segments_)
+            {
+                const char* debut = segment.reference != nullptr ? segment.reference : tampon_.data() + segment.debut;
+                erreur_ = erreur_ || std::fwrite(debut, 1, segment.taille, fichier_) != segment.taille;
+                nombreEcritures_++;
+            }
+#endif
+            tampon_.clear();
+            segments_.clear();
+            debutSegment_ = 0;
+        }
+
+        std::FILE* fichier_;
+        OptionsExport options_;
+        std::string tampon_;
+        std::vector<Segment> segments_; // Parties prêtes à écrire, dans l'ordre du fichier
+        std::size_t debutSegment_ = 0;  // Début de la plage du tampon qui n'est pas encore dans les segments
+        bool erreur_ = false;
+        std::size_t nombreEnregistrements_ = 0;
+        std::size_t nombreOctets_ = 0;
+        std::size_t nombreEcritures_ = 0;
+    };
+
+    /// Écrit des enregistrements dans un format, un champ à la fois, en ajoutant l'en-tête CSV, les clés JSON et les
+    /// séparateurs.
+    class EcrivainEnregistrements
+    {
+    public:
+        EcrivainEnregistrements(TamponExport& tampon,
+                                FormatExport format,
+                                std::initializer_list<std::string_view> champs)
+            : tampon_(tampon)
+            , format_(format)
+        {
+            for (std::string_view champ : champs)
+            {
+                if (format_ == FormatExport::Csv)
+                {
+                    separer();
+                    tampon_.ajouterChaine(champ, format_);
+                }
+                else
+                {
+                    std::string cle;
+                    ajouterEchappe(cle, champ, format_);
+                    cles_.push_back(cle + ':');
+                }
+            }
+            tampon_.ajouter(format_ == FormatExport::Csv ? "\n" : format_ == FormatExport::Json ? "[" : "");
+            indexChamp_ = 0;
+        }
+
+        void debutEnregistrement()
+        {
+            indexChamp_ = 0;
+            if (format_ == FormatExport::Json)
+            {
+                tampon_.ajouter(estPremier_ ? "\n" : ",\n");
+            }
+            if (format_ != FormatExport::Csv)
+            {
+                tampon_.ajouter('{');
+            }
+            estPremier_ = false;
+        }
+
+        void champ(std::string_view texte)
+        {
+            separer();
+            tampon_.ajouterChaine(texte, format_);
+        }
+
+        /// Ajoute un champ déjà échappé pour le format, comme un nom de genre ou de pays précalculé.
+        void champFormate(std::string_view texte)
+        {
+            separer();
+            tampon_.ajouter(texte);
+        }
+
+        template<typename Entier>
+        void champEntier(Entier valeur)
+        {
+            separer();
+            tampon_.ajouterEntier(valeur);
+        }
+
+        void finEnregistrement()
+        {
+            tampon_.ajouter(format_ == FormatExport::Csv ? "\n" : format_ == FormatExport::Json ? "}" : "}\n");
+            tampon_.finEnregistrement();
+        }
+
+        void terminer()
+        {
+            if (format_ == FormatExport::Json)
+            {
+                tampon_.ajouter(estPremier_ ? "]\n" : "\n]\n");
+            }
+        }
+
+    private:
+        void separer()
+        {
+            if (indexChamp_ > 0)
+            {
+                tampon_.ajouter(',');
+            }
+            if (format_ != FormatExport::Csv)
+            {
+                tampon_.ajouter(cles_[indexChamp_]);
+            }
+            indexChamp_++;
+        }
+
+        TamponExport& tampon_;
+        FormatExport format_;
+        std::vector<std::string> cles_; // Clés JSON échappées, suivies du deux-points
+        std::size_t indexChamp_ = 0;
+        bool estPremier_ = true;
+    };
+
+    /// Échappe une fois pour toutes les noms des valeurs d'une énumération. Une valeur hors de l'énumération reçoit
+    /// le nom de la dernière entrée, celui que donne getNom pour une valeur invalide.
+    /// \param format   Le format du fichier.
+    /// \param getNom   La fonction qui retourne le nom d'une valeur, comme getGenreString.
+    /// \return         Les noms échappés des valeurs 0 à N - 1, suivis du nom d'une valeur invalide.
+    template<typename Enumeration, std::size_t N, typename GetNom>
+    std::array<std::string, N + 1> formaterNoms(FormatExport format, GetNom getNom)
+    {
+        std::array<std::string, N + 1> noms;
+        for (std::size_t i = 0; i <= N; i++)
+        {
+            ajouterEchappe(noms[i], getNom(static_cast<Enumeration>(i)), format);
+        }
+        return noms;
+    }
+
+    /// Retourne le nom échappé d'une valeur d'énumération.
+    template<typename Enumeration, std::size_t N>
+    const std::string& getNomFormate(const std::array<std::string, N>& noms, Enumeration valeur)
+    {
+        return noms[std::min(static_cast<std::size_t>(valeur), N - 1)];
+    }
+
+    /// Écrit un fichier complet: l'en-tête du format, un enregistrement par élément, puis la fin du format.
+    /// \param chemin       Le fichier à écrire.
+    /// \param format       Le format du fichier.
+    /// \param options      Les paramètres de l'export.
+    /// \param champs       Les noms des champs de chaque enregistrement.
+    /// \param elements     Les éléments à exporter.
+    /// \param ecrireChamps Écrit les champs d'un élément avec l'écrivain d'enregistrements.
+    /// \return             Le bilan de l'export.
+    template<typename Elements, typename EcrireChamps>
+    BilanExport exporter(const std::filesystem::path& chemin,
+                         FormatExport format,
+                         const OptionsExport& options,
+                         std::initializer_list<std::string_view> champs,
+                         const Elements& elements,
+                         EcrireChamps ecrireChamps)
+    {
+        TamponExport tampon(chemin, options);
+        if (!tampon.estOuvert())
+        {
+            std::cerr << "Erreur Exportation: le fichier " << chemin.string() << " n'a pas pu être ouvert\n";
+            return BilanExport();
+        }
+        EcrivainEnregistrements ecrivain(tampon, format, champs);
+        for (const auto& element : elements)
+        {
+            ecrivain.debutEnregistrement();
+            ecrireChamps(ecrivain, element);
+            ecrivain.finEnregistrement();
+        }
+        ecrivain.terminer();
+        return tampon.terminer();
+    }
+} // namespace
+
+/// Exporte tous les films, dans leur ordre d'ajout, avec les champs nom, genre, pays, realisateur et annee.
+/// \param gestionnaireFilms    Le gestionnaire dont exporter les films.
+/// \param chemin               Le fichier à écrire, remplacé s'il existe.
+/// \param format               Le format du fichier.
+/// \param options              Les paramètres de l'export.
+/// \return                     Le bilan de l'export.
+BilanExport Exportation::exporterFilms(const GestionnaireFilms& gestionnaireFilms,
+                                       const std::filesystem::path& chemin,
+                                       FormatExport format,
+                                       const OptionsExport& options)
+{
+    std::array<std::string, nombreGenres + 1> genres = formaterNoms<Film::Genre, nombreGenres>(format, getGenreString);
+    std::array<std::string, nombrePays + 1> pays = formaterNoms<Pays, nombrePays>(format, getPaysString);
+    return exporter(chemin,
+                    format,
+                    options,
+                    {"nom", "genre", "pays", "realisateur", "annee"},
+                    gestionnaireFilms.getFilms(),
+                    [&genres, &pays](EcrivainEnregistrements& ecrivain, const Film* film) {
+                        ecrivain.champ(film->nom);
+                        ecrivain.champFormate(getNomFormate(genres, film->genre));
+                        ecrivain.champFormate(getNomFormate(pays, film->pays));
+                        ecrivain.champ(film->realisateur);
+                        ecrivain.champEntier(film->annee);
+                    });
+}
+
+/// Exporte tous les utilisateurs avec les champs id, nom, age et pays.
+/// \param gestionnaireUtilisateurs Le gestionnaire dont exporter les utilisateurs.
+/// \param chemin                   Le fichier à écrire, remplacé s'il existe.
+/// \param format                   Le format du fichier.
+/// \param options                  Les paramètres de l'export.
+/// \return                         Le bilan de l'export.
+BilanExport Exportation::exporterUtilisateurs(const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                              const std::filesystem::path& chemin,
+                                              FormatExport format,
+                                              const OptionsExport& options)
+{
+    std::array<std::string, nombrePays + 1> pays = formaterNoms<Pays, nombrePays>(format, getPaysString);
+    return exporter(chemin,
+                    format,
+                    options,
+                    {"id", "nom", "age", "pays"},
+                    gestionnaireUtilisateurs.getUtilisateurs(),
+                    [&pays](EcrivainEnregistrements& ecrivain, const Utilisateur* utilisateur) {
+                        ecrivain.champ(utilisateur->id);
+                        ecrivain.champ(utilisateur->nom);
+                        ecrivain.champEntier(utilisateur->age);
+                        ecrivain.champFormate(getNomFormate(pays, utilisateur->pays));
+                    });
+}
+
+/// Exporte les lignes de log conservées, dans leur ordre chronologique, avec les champs timestamp, utilisateur
+/// (l'identifiant) et film (le nom). Les lignes archivées par la rétention ne sont pas exportées.
+/// \param analyseurLogs    L'analyseur dont exporter les logs.
+/// \param chemin           Le fichier à écrire, remplacé s'il existe.
+/// \param format           Le format du fichier.
+/// \param options          Les paramètres de l'export.
+/// \return                 Le bilan de l'export.
+BilanExport Exportation::exporterLogs(const AnalyseurLogs& analyseurLogs,
+                                      const std::filesystem::path& chemin,
+                                      FormatExport format,
+                                      const OptionsExport& options)
+{
+    return exporter(chemin,
+                    format,
+                    options,
+                    {"timestamp", "utilisateur", "film"},
+                    analyseurLogs.getLogs(),
+                    [](EcrivainEnregistrements& ecrivain, const LigneLog& ligneLog) {
+                        ecrivain.champ(ligneLog.timestamp);
+                        ecrivain.champ(ligneLog.utilisateur->id);
+                        ecrivain.champ(ligneLog.film->nom);
+                    });
+}
+
+/// Exporte le nombre de vues de chaque film du gestionnaire, y compris ceux qui n'ont jamais été vus, avec les champs
+/// film et vues.
+/// \param analyseurLogs        L'analyseur qui compte les vues.
+/// \param gestionnaireFilms    Le gestionnaire des films à exporter.
+/// \param chemin               Le fichier à écrire, remplacé s'il existe.
+/// \param format               Le format du fichier.
+/// \param options              Les paramètres de l'export.
+/// \return                     Le bilan de l'export.
+BilanExport Exportation::exporterVuesFilms(const AnalyseurLogs& analyseurLogs,
+                                           const GestionnaireFilms& gestionnaireFilms,
+                                           const std::filesystem::path& chemin,
+                                           FormatExport format,
+                                           const OptionsExport& options)
+{
+    return exporter(chemin,
+                    format,
+                    options,
+                    {"film", "vues"},
+                    gestionnaireFilms.getFilms(),
+                    [&analyseurLogs](EcrivainEnregistrements& ecrivain, const Film* film) {
+                        ecrivain.champ(film->nom);
+                        ecrivain.champEntier(analyseurLogs.getNombreVuesFilm(film));
+                    });
+}
@@ -4,6 +4,7 @@
 
 #include "Film.h"
 #include <unordered_map>
+#include "Empreinte.h"
 
 /// Convertit la valeur du enum Film::Genre en string.
 /// \param genre    Le genre à convertir.
@@ -30,6 +31,20 @@ std::string getGenreString(Film::Genre genre)
     return "Erreur";
 }
 
+/// Calcule l'empreinte du contenu d'un film, pour reconnaître un film modifié lors d'un rechargement.
+/// \param film     Le film dont on veut l'empreinte.
+/// \return         L'empreinte de tous les champs du film.
+std::uint64_t getEmpreinte(const Film& film)
+{
+    Empreinte empreinte;
+    empreinte.ajouter(film.nom);
+    empreinte.ajouter(static_cast<std::int64_t>(film.genre));
+    empreinte.ajouter(static_cast<std::int64_t>(film.pays));
+    empreinte.ajouter(film.realisateur);
+    empreinte.ajouter(film.annee);
+    return empreinte.getValeur();
+}
+
 /// Affiche les informations d'un film à la sortie du stream donné.
 /// \param outputStream Le stream auquel écrire les informations du film.
 /// \param film         Le film à afficher au stream.
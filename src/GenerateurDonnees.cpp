@@ -0,0 +1,302 @@
+/// Générateur déterministe de jeux de données aux formats de films.txt, utilisateurs.txt et logs.txt.
+
+#include "GenerateurDonnees.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <numeric>
+#include "Horodatage.h"
+
+namespace
+{
+    constexpr std::size_t tailleTamponSortie = 1 << 20;
+    constexpr std::uint64_t nombreGenres = 9;
+    constexpr std::uint64_t nombrePays = 9;
+
+    /// Générateur pseudo-aléatoire splitmix64, choisi pour produire la même suite sur toutes les plateformes.
+    class GenerateurAleatoire
+    {
+    public:
+        explicit GenerateurAleatoire(std::uint64_t graine)
+            : etat_(graine)
+        {
+        }
+
+        std::uint64_t suivant()
+        {
+            std::uint64_t z = (etat_ += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        /// \return Un entier dans [0, borne).
+        std::uint64_t entier(std::uint64_t borne) { return borne == 0 ? 0 : suivant() % borne; }
+
+        /// \return Un réel dans [0, 1).
+        double reel() { return static_cast<double>(suivant() >> 11) * 0x1.0p-53; }
+
+    private:
+        std::uint64_t etat_;
+    };
+
+    /// Échantillonneur de la loi de Zipf sur {1, ..., n} par rejet-inversion (Hörmann et Derflinger, 1996).
+    /// Il utilise une mémoire constante, peu importe n, contrairement à une table de fonction de répartition.
+    class EchantillonneurZipf
+    {
+    public:
+        EchantillonneurZipf(std::uint64_t nombre, double exposant)
+            : nombre_(static_cast<double>(nombre))
+            , exposant_(exposant)
+            , hIntegraleX1_(hIntegrale(1.5) - 1.0)
+            , hIntegraleN_(hIntegrale(nombre_ + 0.5))
+            , s_(2.0 - hIntegraleInverse(hIntegrale(2.5) - h(2.0)))
+        {
+        }
+
+        /// \return Un rang dans [1, n], le rang 1 étant le plus probable.
+        std::uint64_t echantillonner(GenerateurAleatoire& aleatoire) const
+        {
+            while (true)
+            {
+                double u = hIntegraleN_ + aleatoire.reel() * (hIntegraleX1_ - hIntegraleN_);
+                double x = hIntegraleInverse(u);
+                double k = std::floor(x + 0.5);
+                if (k < 1.0)
+                {
+                    k = 1.0;
+                }
+                else if (k > nombre_)
+                {
+                    k = nombre_;
+                }
+                if (k - x <= s_ || u >= hIntegrale(k + 0.5) - h(k))
+                {
+                    return static_cast<std::uint64_t>(k);
+                }
+            }
+        }
+
+    private:
+        double h(double x) const { return std::exp(-exposant_ * std::log(x)); }
+
+        double hIntegrale(double x) const
+        {
+            double logX = std::log(x);
+            return auxiliaire2((1.0 - exposant_) * logX) * logX;
+        }
+
+        double hIntegraleInverse(double x) const
+        {
+            double t = x * (1.0 - exposant_);
+            if (t < -1.0)
+            {
+                t = -1.0;
+            }
+            return std::exp(auxiliaire1(t) * x);
+        }
+
+        /// \return log(1 + x) / x, calculé de façon stable près de 0.
+        static double auxiliaire1(double x)
+        {
+            return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+
+        /// \return (exp(x) - 1) / x, calculé de façon stable près de 0.
+        static double auxiliaire2(double x)
+        {
+            return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+        }
+
+        double nombre_;
+        double exposant_;
+        double hIntegraleX1_;
+        double hIntegraleN_;
+        double s_;
+    };
+
+    /// Tampon d'écriture qui accumule les lignes et les envoie au stream par gros blocs.
+    class TamponSortie
+    {
+    public:
+        explicit TamponSortie(std::ostream& sortie)
+            : sortie_(sortie)
+        {
+            tampon_.reserve(tailleTamponSortie + 4096);
+        }
+
+        ~TamponSortie() { vider(); }
+
+        void ajouter(char caractere) { tampon_.push_back(caractere); }
+        void ajouter(const std::string& texte) { tampon_.append(texte); }
+        void ajouter(const char* texte, std::size_t taille) { tampon_.append(texte, taille); }
+
+        void ajouterEntier(std::uint64_t valeur)
+        {
+            char chiffres[20];
+            auto [fin, erreur] = std::to_chars(chiffres, chiffres + sizeof(chiffres), valeur);
+            (void)erreur;
+            tampon_.append(chiffres, static_cast<std::size_t>(fin - chiffres));
+        }
+
+        /// Termine une ligne et vide le tampon s'il est plein.
+        void finLigne()
+        {
+            tampon_.push_back('\n');
+            if (tampon_.size() >= tailleTamponSortie)
+            {
+                vider();
+            }
+        }
+
+        void vider()
+        {
+            sortie_.write(tampon_.data(), static_cast<std::streamsize>(tampon_.size()));
+            tampon_.clear();
+        }
+
+    private:
+        std::ostream& sortie_;
+        std::string tampon_;
+    };
+} // namespace
+
+/// Constructeur qui conserve les paramètres du jeu de données.
+/// \param options  Les paramètres du jeu de données à générer.
+GenerateurDonnees::GenerateurDonnees(const OptionsGenerateur& options)
+    : options_(options)
+{
+}
+
+/// Écrit tous les films, une ligne par film, au format de films.txt.
+/// \param sortie   Le stream dans lequel écrire.
+void GenerateurDonnees::ecrireFilms(std::ostream& sortie) const
+{
+    GenerateurAleatoire aleatoire(options_.graine ^ 0x46494C4D53ull);
+    TamponSortie tampon(sortie);
+    for (std::uint64_t i = 0; i < options_.nombreFilms; i++)
+    {
+        tampon.ajouter('"');
+        tampon.ajouter(getNomFilm(i));
+        tampon.ajouter("\" ", 2);
+        tampon.ajouterEntier(aleatoire.entier(nombreGenres));
+        if (aleatoire.reel() < options_.tauxLignesInvalides)
+        {
+            tampon.finLigne(); // Ligne tronquée après le genre
+            continue;
+        }
+        tampon.ajouter(' ');
+        tampon.ajouterEntier(aleatoire.entier(nombrePays));
+        tampon.ajouter(" \"Réalisateur ");
+        tampon.ajouterEntier(aleatoire.entier(options_.nombreFilms / 4 + 1));
+        tampon.ajouter("\" ", 2);
+        tampon.ajouterEntier(1920 + aleatoire.entier(101));
+        tampon.finLigne();
+    }
+}
+
+/// Écrit tous les utilisateurs, une ligne par utilisateur, au format de utilisateurs.txt.
+/// \param sortie   Le stream dans lequel écrire.
+void GenerateurDonnees::ecrireUtilisateurs(std::ostream& sortie) const
+{
+    GenerateurAleatoire aleatoire(options_.graine ^ 0x5553455253ull);
+    TamponSortie tampon(sortie);
+    for (std::uint64_t i = 0; i < options_.nombreUtilisateurs; i++)
+    {
+        tampon.ajouter(getIdUtilisateur(i));
+        tampon.ajouter(" \"Utilisateur ");
+        tampon.ajouterEntier(i);
+        tampon.ajouter("\" ", 2);
+        if (aleatoire.reel() < options_.tauxLignesInvalides)
+        {
+            tampon.ajouter("inconnu ", 8); // Âge non numérique
+        }
+        else
+        {
+            tampon.ajouterEntier(1 + aleatoire.entier(100));
+            tampon.ajouter(' ');
+        }
+        tampon.ajouterEntier(aleatoire.entier(nombrePays));
+        tampon.finLigne();
+    }
+}
+
+/// Écrit toutes les lignes de log au format de logs.txt. La popularité des films suit une loi de Zipf et les
+/// utilisateurs sont choisis uniformément.
+/// \param sortie   Le stream dans lequel écrire.
+void GenerateurDonnees::ecrireLogs(std::ostream& sortie) const
+{
+    GenerateurAleatoire aleatoire(options_.graine ^ 0x4C4F4753ull);
+    TamponSortie tampon(sortie);
+    EchantillonneurZipf zipf(std::max<std::uint64_t>(options_.nombreFilms, 1), options_.exposantZipf);
+
+    // Permutation des rangs de popularité pour que les films populaires ne soient pas simplement les premiers
+    std::uint64_t multiplicateur = options_.nombreFilms > 1 ? 2654435761ull % options_.nombreFilms : 1;
+    while (options_.nombreFilms > 1 && std::gcd(multiplicateur, options_.nombreFilms) != 1)
+    {
+        multiplicateur++;
+    }
+
+    std::uint64_t nombreLignes = std::max<std::uint64_t>(options_.nombreLignesLog, 1);
+    char timestamp[longueurTimestamp];
+    for (std::uint64_t i = 0; i < options_.nombreLignesLog; i++)
+    {
+        std::int64_t decalage = 0;
+        switch (options_.ordre)
+        {
+            case OrdreTimestamps::Trie:
+                decalage = static_cast<std::int64_t>(static_cast<double>(i) / static_cast<double>(nombreLignes) *
+                                                     static_cast<double>(options_.dureeTimestamps));
+                break;
+            case OrdreTimestamps::Melange:
+                decalage =
+                    static_cast<std::int64_t>(aleatoire.entier(static_cast<std::uint64_t>(options_.dureeTimestamps)));
+                break;
+            case OrdreTimestamps::PresqueTrie:
+                decalage = static_cast<std::int64_t>(static_cast<double>(i) / static_cast<double>(nombreLignes) *
+                                                     static_cast<double>(options_.dureeTimestamps));
+                if (aleatoire.reel() < options_.tauxDesordre)
+                {
+                    decalage -= static_cast<std::int64_t>(aleatoire.entier(86400)); // Jusqu'à un jour de retard
+                    decalage = std::max<std::int64_t>(decalage, 0);
+                }
+                break;
+        }
+        formaterTimestamp(options_.debutTimestamps + decalage, timestamp);
+        tampon.ajouter(timestamp, longueurTimestamp);
+        tampon.ajouter(' ');
+        tampon.ajouter(getIdUtilisateur(aleatoire.entier(options_.nombreUtilisateurs)));
+
+        std::uint64_t film = options_.exposantZipf > 0.0 ? zipf.echantillonner(aleatoire) - 1
+                                                          : aleatoire.entier(options_.nombreFilms);
+        if (options_.nombreFilms > 1)
+        {
+            film = film * multiplicateur % options_.nombreFilms;
+        }
+        if (aleatoire.reel() < options_.tauxLignesInvalides)
+        {
+            tampon.finLigne(); // Ligne sans film
+            continue;
+        }
+        tampon.ajouter(" \"", 2);
+        tampon.ajouter(getNomFilm(film));
+        tampon.ajouter('"');
+        tampon.finLigne();
+    }
+}
+
+/// Retourne le nom du film généré à un index donné.
+/// \param index    L'index du film.
+/// \return         Le nom du film.
+std::string GenerateurDonnees::getNomFilm(std::uint64_t index)
+{
+    return "Film " + std::to_string(index);
+}
+
+/// Retourne l'identifiant de l'utilisateur généré à un index donné.
+/// \param index    L'index de l'utilisateur.
+/// \return         L'identifiant de l'utilisateur.
+std::string GenerateurDonnees::getIdUtilisateur(std::uint64_t index)
+{
+    return "utilisateur" + std::to_string(index) + "@email.com";
+}
@@ -8,23 +8,226 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <unordered_set>
+#include <utility>
+#include "AnalyseurLogs.h"
 #include "Foncteurs.h"
+#include "Instrumentation.h"
+#include "PoolTaches.h"
 #include "RawPointerBackInserter.h"
 
-/// Constructeur par copie.
-/// \param other    Le gestionnaire de films à partir duquel copier la classe.
-GestionnaireFilms::GestionnaireFilms(const GestionnaireFilms& other)
+namespace
 {
-    films_.reserve(other.films_.size());
-    filtreNomFilms_.reserve(other.filtreNomFilms_.size());
-    filtreGenreFilms_.reserve(other.filtreGenreFilms_.size());
-    filtrePaysFilms_.reserve(other.filtrePaysFilms_.size());
+    // Taille de lot à partir de laquelle le filtre par nom est construit en parallèle, un shard par tâche
+    constexpr std::size_t seuilIndexationParallele = 4096;
+
+    using FiltreCategorie = std::vector<const Film*>;
+
+    constexpr auto getGenreFilm = [](const Film& film) { return film.genre; };
+    constexpr auto getPaysFilm = [](const Film& film) { return film.pays; };
 
-    for (const auto& film : other.films_)
+    /// Lit les films d'un fichier de description des films.
+    /// \param fichier  Le fichier ouvert à partir duquel lire les films.
+    /// \param films    Le vecteur auquel ajouter les films lus.
+    /// \param rejets   Le collecteur auquel signaler les lignes qui n'ont pas pu être interprétées.
+    /// \return         True si toutes les lignes ont été interprétées, false sinon.
+    bool lireFilms(std::istream& fichier, std::vector<Film>& films, CollecteurRejets& rejets)
     {
-        // TODO: Uncomment une fois que la fonction ajouterFilm est écrite
-        ajouterFilm(*film);
+        bool succesParsing = true;
+        std::string ligne;
+        while (lireLigne(fichier, ligne))
+        {
+            INSTRUMENTER_PHASE(AnalyseLignes);
+            std::istringstream stream(ligne);
+
+            std::string nom;
+            int genre;
+            int pays;
+            std::string realisateur;
+            int annee;
+
+            if (stream >> std::quoted(nom) >> genre >> pays >> std::quoted(realisateur) >> annee)
+            {
+                films.push_back(Film{std::move(nom),
+                                     static_cast<Film::Genre>(genre),
+                                     static_cast<Pays>(pays),
+                                     std::move(realisateur),
+                                     annee});
+            }
+            else
+            {
+                INSTRUMENTER_COMPTEUR(LignesRejetees, 1);
+                rejets.rejeter(RaisonRejet::LigneMalFormee, ligne);
+                succesParsing = false;
+            }
+        }
+        return succesParsing;
     }
+
+    /// Construit un filtre par catégorie à partir de tous les films. Chaque bloc de films est réparti par une tâche
+    /// distincte, puis les blocs sont concaténés dans l'ordre pour que chaque catégorie garde l'ordre d'ajout.
+    /// \param films         Les films du gestionnaire.
+    /// \param getCategorie  La fonction qui retourne la catégorie d'un film dans ce filtre.
+    /// \return              Le filtre complet.
+    template<typename Categorie, typename GetCategorie>
+    std::unordered_map<Categorie, CopieSurEcriture<FiltreCategorie>>
+    construireFiltre(const std::vector<std::shared_ptr<const Film>>& films, GetCategorie getCategorie)
+    {
+        INSTRUMENTER_PHASE(IndexationFilms);
+        using Partiel = std::unordered_map<Categorie, FiltreCategorie>;
+        Partiel categories = PoolTaches::getPoolGlobal().parallelReduce(
+            0,
+            films.size(),
+            seuilIndexationParallele,
+            Partiel(),
+            [&](std::size_t debut, std::size_t fin) {
+                Partiel partiel;
+                for (std::size_t i = debut; i < fin; i++)
+                {
+                    partiel[getCategorie(*films[i])].push_back(films[i].get());
+                }
+                return partiel;
+            },
+            [](Partiel resultat, Partiel partiel) {
+                if (resultat.empty())
+                {
+                    return partiel;
+                }
+                for (auto& [categorie, filmsCategorie] : partiel)
+                {
+                    FiltreCategorie& destination = resultat[categorie];
+                    destination.insert(destination.end(), filmsCategorie.begin(), filmsCategorie.end());
+                }
+                return resultat;
+            });
+
+        std::unordered_map<Categorie, CopieSurEcriture<FiltreCategorie>> filtre;
+        for (auto& [categorie, filmsCategorie] : categories)
+        {
+            filtre[categorie].modifier() = std::move(filmsCategorie);
+        }
+        return filtre;
+    }
+
+    /// Réserve la place d'un lot de films dans les catégories d'un filtre.
+    /// \param filtre        Le filtre, ou nullptr s'il n'est pas construit et n'a donc rien à maintenir.
+    /// \param films         Les films du lot.
+    /// \param getCategorie  La fonction qui retourne la catégorie d'un film dans ce filtre.
+    template<typename Filtre, typename GetCategorie>
+    void reserverDansFiltre(Filtre* filtre, const std::vector<Film>& films, GetCategorie getCategorie)
+    {
+        if (filtre == nullptr)
+        {
+            return;
+        }
+        std::unordered_map<typename Filtre::key_type, std::size_t> nombreParCategorie;
+        for (const Film& film : films)
+        {
+            nombreParCategorie[getCategorie(film)]++;
+        }
+        for (const auto& [categorie, nombre] : nombreParCategorie)
+        {
+            FiltreCategorie& filmsCategorie = (*filtre)[categorie].modifier();
+            filmsCategorie.reserve(filmsCategorie.size() + nombre);
+        }
+    }
+
+    /// Ajoute un film à la fin de sa catégorie dans un filtre.
+    /// \param filtre        Le filtre, ou nullptr s'il n'est pas construit et n'a donc rien à maintenir.
+    /// \param categorie     La catégorie du film dans ce filtre.
+    /// \param film          Le film à ajouter.
+    template<typename Filtre>
+    void ajouterAuFiltre(Filtre* filtre, typename Filtre::key_type categorie, const Film* film)
+    {
+        if (filtre != nullptr)
+        {
+            (*filtre)[categorie].modifier().push_back(film);
+        }
+    }
+
+    /// Retire des films de certaines catégories d'un filtre.
+    /// \param filtre        Le filtre, ou nullptr s'il n'est pas construit et n'a donc rien à maintenir.
+    /// \param categories    Les catégories qui contiennent les films à retirer.
+    /// \param estRetire     Retourne true pour un film à retirer.
+    template<typename Filtre, typename Categories, typename EstRetire>
+    void retirerDuFiltre(Filtre* filtre, const Categories& categories, EstRetire estRetire)
+    {
+        if (filtre == nullptr)
+        {
+            return;
+        }
+        for (typename Filtre::key_type categorie : categories)
+        {
+            FiltreCategorie& films = (*filtre)[categorie].modifier();
+            films.erase(std::remove_if(films.begin(), films.end(), estRetire), films.end());
+        }
+    }
+
+    /// Nouvelles données d'un film modifié par un rechargement et film qui les porte après la modification: le même
+    /// objet s'il est modifié sur place, un nouvel objet sinon.
+    struct RemplacementFilm
+    {
+        const Film* donnees;
+        const Film* film;
+    };
+
+    /// Remplace des films dans un filtre par catégorie, avant que les films modifiés sur place ne le soient. Un film
+    /// qui reste dans sa catégorie garde sa position; un film qui en change est retiré de l'ancienne et ajouté à la
+    /// fin de la nouvelle.
+    /// \param filtre           Le filtre par genre ou par pays, ou nullptr s'il n'est pas construit.
+    /// \param remplacements    Chaque film actuel associé à ses nouvelles données et au film qui le remplace.
+    /// \param getCategorie     La fonction qui retourne la catégorie d'un film dans ce filtre.
+    template<typename Categorie, typename GetCategorie>
+    void remplacerDansFiltre(std::unordered_map<Categorie, CopieSurEcriture<FiltreCategorie>>* filtre,
+                             const std::unordered_map<const Film*, RemplacementFilm>& remplacements,
+                             GetCategorie getCategorie)
+    {
+        if (filtre == nullptr)
+        {
+            return;
+        }
+        std::unordered_set<Categorie> categoriesTouchees;
+        for (const auto& [ancien, nouveau] : remplacements)
+        {
+            categoriesTouchees.insert(getCategorie(*ancien));
+        }
+        for (Categorie categorie : categoriesTouchees)
+        {
+            FiltreCategorie& films = (*filtre)[categorie].modifier();
+            std::size_t taille = 0;
+            for (const Film* film : films)
+            {
+                auto remplacement = remplacements.find(film);
+                if (remplacement == remplacements.end())
+                {
+                    films[taille++] = film;
+                }
+                else if (getCategorie(*remplacement->second.donnees) == categorie)
+                {
+                    films[taille++] = remplacement->second.film;
+                }
+            }
+            films.resize(taille);
+        }
+        for (const auto& [ancien, nouveau] : remplacements)
+        {
+            if (getCategorie(*nouveau.donnees) != getCategorie(*ancien))
+            {
+                (*filtre)[getCategorie(*nouveau.donnees)].modifier().push_back(nouveau.film);
+            }
+        }
+    }
+} // namespace
+
+/// Constructeur par copie. Le stockage est partagé avec l'original et n'est dupliqué que lors d'une modification,
+/// ce qui rend la copie O(1) peu importe le nombre de films.
+/// \param other    Le gestionnaire de films à partir duquel copier la classe.
+GestionnaireFilms::GestionnaireFilms(const GestionnaireFilms& other)
+    : films_(other.films_)
+    , filtreNomFilms_(other.filtreNomFilms_)
+    , filtreGenreFilms_(other.filtreGenreFilms_)
+    , filtrePaysFilms_(other.filtrePaysFilms_)
+{
 }
 
 /// Opérateur d'assignation par copie utilisant le copy-and-swap idiom.
@@ -36,6 +239,9 @@ GestionnaireFilms& GestionnaireFilms::operator=(GestionnaireFilms other)
     std::swap(filtreNomFilms_, other.filtreNomFilms_);
     std::swap(filtreGenreFilms_, other.filtreGenreFilms_);
     std::swap(filtrePaysFilms_, other.filtrePaysFilms_);
+    std::swap(cacheAnnees_, other.cacheAnnees_);
+    std::swap(generationsAnnees_, other.generationsAnnees_);
+    std::swap(generation_, other.generation_);
     return *this;
 }
 
@@ -49,11 +255,20 @@ std::ostream& operator<<(std::ostream& outputStream, const GestionnaireFilms& ge
     outputStream << "Le gestionnaire de films contient " << gestionnaireFilms.getNombreFilms() << " films.\n"
                  << "Affichage par catégories:\n";
 
+    // Un filtre par genre désactivé est construit temporairement pour l'affichage
+    GestionnaireFilms::IndexGenres::Filtre filtreTemporaire;
+    const GestionnaireFilms::IndexGenres::Filtre* filtreGenres = gestionnaireFilms.getFiltreGenres();
+    if (filtreGenres == nullptr)
+    {
+        filtreTemporaire = construireFiltre<Film::Genre>(gestionnaireFilms.films_.lire(), getGenreFilm);
+        filtreGenres = &filtreTemporaire;
+    }
+
     // TODO: Réécrire l'implémentation avec des range-based for et structured bindings (voir énoncé du TP)
-    for (const auto& [key, value] : gestionnaireFilms.filtreGenreFilms_)
+    for (const auto& [key, value] : *filtreGenres)
     {
         Film::Genre genre = key;
-        std::vector<const Film*> listeFilms = value;
+        const std::vector<const Film*>& listeFilms = value.lire();
         outputStream << "Genre: " << getGenreString(genre) << " (" << listeFilms.size() << " films):\n";
         for (auto & element : listeFilms)
         {
@@ -65,46 +280,156 @@ std::ostream& operator<<(std::ostream& outputStream, const GestionnaireFilms& ge
 
 /// Ajoute les films à partir d'un fichier de description des films.
 /// \param nomFichier   Le fichier à partir duquel lire les informations des films.
-/// \return             True si tout le chargement s'est effectué avec succès, false sinon.
-bool GestionnaireFilms::chargerDepuisFichier(const std::string& nomFichier)
+/// \param options      Le traitement des lignes qui n'ont pas pu être interprétées.
+/// \return             Le nombre de films chargés et de lignes rejetées, et le succès si le fichier a été ouvert et
+///                     que toutes ses lignes ont été interprétées.
+BilanChargement GestionnaireFilms::chargerDepuisFichier(const std::string& nomFichier, const OptionsRejets& options)
 {
+    INSTRUMENTER_PHASE(ChargementFilms);
+    BilanChargement bilan;
     std::ifstream fichier(nomFichier);
     if (fichier)
     {
-        films_.clear();
-        filtreNomFilms_.clear();
-        filtreGenreFilms_.clear();
-        filtrePaysFilms_.clear();
+        films_ = {};
+        filtreNomFilms_ = {};
+        filtreGenreFilms_.reinitialiser();
+        filtrePaysFilms_.reinitialiser();
+        cacheAnnees_.vider();
+        generationsAnnees_.clear();
 
-        bool succesParsing = true;
+        CollecteurRejets rejets("GestionnaireFilms", options);
+        std::vector<Film> films;
+        bilan.succes = lireFilms(fichier, films, rejets);
+        ajouterFilms(std::move(films));
+        bilan.nombreLignesChargees = getNombreFilms();
+        bilan.nombreRejets = rejets.terminer();
+        return bilan;
+    }
+    std::cerr << "Erreur GestionnaireFilms: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+    return bilan;
+}
 
-        std::string ligne;
-        while (std::getline(fichier, ligne))
+/// Recharge les films à partir d'un fichier de description des films en n'appliquant que les différences avec le
+/// contenu actuel: les films absents du fichier sont supprimés, les nouveaux sont ajoutés et ceux dont l'empreinte
+/// a changé sont modifiés. Les films inchangés gardent leur adresse et leur position dans chaque filtre. Un film
+/// modifié est modifié sur place et garde son adresse, sauf s'il est partagé avec une copie du gestionnaire: il est
+/// alors remplacé par un nouvel objet, pour que la copie ne voie pas la modification. Dans les deux cas, il garde sa
+/// position dans l'ordre d'ajout et dans les catégories qu'il ne quitte pas.
+/// \param nomFichier       Le fichier à partir duquel lire les informations des films.
+/// \param analyseurLogs    L'analyseur dont les lignes référencent ces films, ou nullptr. Les lignes des films
+///                         supprimés en sont retirées et celles des films remplacés désignent le nouvel objet.
+/// \return                 Le nombre de films ajoutés, modifiés, supprimés et inchangés.
+BilanRechargement GestionnaireFilms::rechargerDepuisFichier(const std::string& nomFichier,
+                                                            AnalyseurLogs* analyseurLogs)
+{
+    INSTRUMENTER_PHASE(ChargementFilms);
+    BilanRechargement bilan;
+    std::ifstream fichier(nomFichier);
+    if (!fichier)
+    {
+        std::cerr << "Erreur GestionnaireFilms: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+        return bilan;
+    }
+    std::vector<Film> films;
+    CollecteurRejets rejets("GestionnaireFilms", OptionsRejets());
+    bilan.succes = lireFilms(fichier, films, rejets);
+    rejets.terminer();
+
+    // Comme pour ajouterFilms, la première occurrence d'un nom répété dans le fichier est conservée
+    std::unordered_set<const Film*> filmsConserves;
+    std::unordered_set<std::string> nomsNouveaux;
+    std::unordered_map<const Film*, std::shared_ptr<const Film>> remplacements;
+    std::vector<Film> ajouts;
+    for (Film& film : films)
+    {
+        const Film* filmActuel = getFilmParNom(film.nom);
+        if (filmActuel == nullptr)
         {
-            std::istringstream stream(ligne);
+            if (nomsNouveaux.insert(film.nom).second)
+            {
+                ajouts.push_back(std::move(film));
+            }
+        }
+        else if (filmsConserves.insert(filmActuel).second)
+        {
+            if (getEmpreinte(film) == getEmpreinte(*filmActuel))
+            {
+                bilan.nombreInchanges++;
+            }
+            else
+            {
+                remplacements.emplace(filmActuel, std::make_shared<Film>(std::move(film)));
+            }
+        }
+    }
 
-            std::string nom;
-            int genre;
-            int pays;
-            std::string realisateur;
-            int annee;
+    std::vector<std::string> suppressions;
+    for (const std::shared_ptr<const Film>& film : films_.lire())
+    {
+        if (filmsConserves.count(film.get()) == 0)
+        {
+            suppressions.push_back(film->nom);
+        }
+    }
 
-            if (stream >> std::quoted(nom) >> genre >> pays >> std::quoted(realisateur) >> annee)
+    if (!remplacements.empty())
+    {
+        // Les anciens films restent en vie jusqu'à la mise à jour des filtres, qui lisent leurs catégories, et les
+        // films modifiés sur place ne le sont qu'après
+        std::vector<std::shared_ptr<const Film>> anciensFilms;
+        std::unordered_map<const Film*, RemplacementFilm> nouveauxFilms;
+        std::unordered_map<const Film*, const Film*> filmsRemplaces;
+        for (std::shared_ptr<const Film>& film : films_.modifier())
+        {
+            auto remplacement = remplacements.find(film.get());
+            if (remplacement == remplacements.end())
             {
-                // TODO: Uncomment une fois que la fonction ajouterFilm est écrite
-                ajouterFilm(Film{nom, static_cast<Film::Genre>(genre), static_cast<Pays>(pays), realisateur, annee});
+                continue;
             }
-            else
+            invaliderAnnee(film->annee);
+            invaliderAnnee(remplacement->second->annee);
+            if (film.use_count() == 1)
             {
-                std::cerr << "Erreur GestionnaireFilms: la ligne " << ligne
-                          << " n'a pas pu être interprétée correctement\n";
-                succesParsing = false;
+                nouveauxFilms.emplace(film.get(), RemplacementFilm{remplacement->second.get(), film.get()});
+                continue;
             }
+            nouveauxFilms.emplace(film.get(), RemplacementFilm{remplacement->second.get(), remplacement->second.get()});
+            filmsRemplaces.emplace(film.get(), remplacement->second.get());
+            filtreNomFilms_[getIndexShardNom(film->nom)].modifier()[film->nom] = remplacement->second.get();
+            anciensFilms.push_back(std::exchange(film, remplacement->second));
         }
-        return succesParsing;
+        remplacerDansFiltre(filtreGenreFilms_.modifier(), nouveauxFilms, getGenreFilm);
+        remplacerDansFiltre(filtrePaysFilms_.modifier(), nouveauxFilms, getPaysFilm);
+        for (const auto& [film, remplacement] : nouveauxFilms)
+        {
+            if (remplacement.film == film)
+            {
+                // Les films sont créés non constants: seul le gestionnaire, qui en est l'unique détenteur, les modifie
+                const_cast<Film&>(*film) = *remplacement.donnees;
+            }
+        }
+        if (analyseurLogs != nullptr && !filmsRemplaces.empty())
+        {
+            analyseurLogs->remplacerFilms(filmsRemplaces);
+        }
+        bilan.nombreModifications = remplacements.size();
     }
-    std::cerr << "Erreur GestionnaireFilms: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
-    return false;
+
+    if (analyseurLogs != nullptr && !suppressions.empty())
+    {
+        std::vector<const Film*> filmsSupprimes;
+        filmsSupprimes.reserve(suppressions.size());
+        for (const std::string& nomFilm : suppressions)
+        {
+            filmsSupprimes.push_back(getFilmParNom(nomFilm));
+        }
+        analyseurLogs->retirerLignesFilms(filmsSupprimes);
+    }
+    supprimerFilms(suppressions);
+    bilan.nombreSuppressions = suppressions.size();
+    bilan.nombreAjouts = ajouts.size();
+    ajouterFilms(std::move(ajouts));
+    return bilan;
 }
 
 
@@ -115,40 +440,182 @@ bool GestionnaireFilms::ajouterFilm(const Film& film)
 {
     if(getFilmParNom(film.nom) != nullptr)
         return false;
-    films_.push_back(std::move(std::make_unique<Film>(film)));
-    filtreNomFilms_.emplace(film.nom, films_.back().get());
-    filtreGenreFilms_[film.genre].push_back(films_.back().get());
-    filtrePaysFilms_[film.pays].push_back(films_.back().get());
+    insererFilm(std::make_shared<Film>(film));
 
     return true; 
 }
 
+/// Ajoute un film au gestionnaire en déplaçant ses données plutôt qu'en les copiant.
+/// \param film         Le film à ajouter
+/// \return             true si le film a ete ajoute avec succes false sinon
+bool GestionnaireFilms::ajouterFilm(Film&& film)
+{
+    if(getFilmParNom(film.nom) != nullptr)
+        return false;
+    insererFilm(std::make_shared<Film>(std::move(film)));
+
+    return true;
+}
+
 /// Supprime un filmdu gestionnaire à partir de son nom.
 /// \param nomFilm      Le nom du film a supprimer
 /// \return             true si lefilm a ete supprime avec succes false sinon 
 bool GestionnaireFilms::supprimerFilm(const std::string& nomFilm)
 {
-    std::vector<std::unique_ptr<Film>>::iterator trouve = find_if(films_.begin(), films_.end(), [&nomFilm](std::unique_ptr<Film>& film){return film->nom == nomFilm;});
-    if(trouve == films_.end())
+    const Film* film = getFilmParNom(nomFilm);
+    if(film == nullptr)
         return false;
-    Film film = *(trouve->get());
-    filtreNomFilms_.erase(nomFilm);
-    std::vector<const Film*>& vecteurPays = filtrePaysFilms_[film.pays];
-    std::vector<const Film*>& vecteurGenre = filtreGenreFilms_[film.genre];
-    
-    vecteurPays.erase(std::remove(vecteurPays.begin(), vecteurPays.end(), trouve->get()), vecteurPays.end());
-    vecteurGenre.erase(std::remove(vecteurGenre.begin(), vecteurGenre.end(),trouve->get()), vecteurGenre.end());
+    invaliderAnnee(film->annee);
+    filtreNomFilms_[getIndexShardNom(nomFilm)].modifier().erase(nomFilm);
+    auto estFilm = [film](const Film* element) { return element == film; };
+    retirerDuFiltre(filtrePaysFilms_.modifier(), std::array<Pays, 1>{film->pays}, estFilm);
+    retirerDuFiltre(filtreGenreFilms_.modifier(), std::array<Film::Genre, 1>{film->genre}, estFilm);
 
-    films_.erase(trouve);
+    std::vector<std::shared_ptr<const Film>>& films = films_.modifier();
+    films.erase(std::find_if(films.begin(), films.end(), [film](const std::shared_ptr<const Film>& element) {
+        return element.get() == film;
+    }));
 
     return true;
 }
 
+/// Ajoute un lot de films en réservant la capacité de tous les conteneurs une seule fois.
+/// Un film dont le nom est déjà présent (dans le gestionnaire ou plus tôt dans le lot) n'est pas ajouté.
+/// \param films        Les films à ajouter, déplacés dans le gestionnaire
+/// \return             Pour chaque film du lot, true s'il a été ajouté, false sinon
+std::vector<bool> GestionnaireFilms::ajouterFilms(std::vector<Film> films)
+{
+    INSTRUMENTER_PHASE(IndexationFilms);
+    if (films.empty())
+    {
+        return {};
+    }
+
+    films_.modifier().reserve(films_.lire().size() + films.size());
+    for (CopieSurEcriture<FiltreNoms>& shard : filtreNomFilms_)
+    {
+        shard.modifier().reserve(shard.lire().size() + films.size() / nombreShardsNoms + 1);
+    }
+    IndexGenres::Filtre* filtreGenres = filtreGenreFilms_.modifier();
+    IndexPays::Filtre* filtrePays = filtrePaysFilms_.modifier();
+    reserverDansFiltre(filtreGenres, films, getGenreFilm);
+    reserverDansFiltre(filtrePays, films, getPaysFilm);
+
+    std::vector<bool> resultats;
+    resultats.reserve(films.size());
+    if (films.size() < seuilIndexationParallele)
+    {
+        for (Film& film : films)
+        {
+            resultats.push_back(ajouterFilm(std::move(film)));
+        }
+        return resultats;
+    }
+
+    // Les films sont alloués en parallèle, puis chaque shard du filtre par nom est rempli par une tâche distincte
+    // dans l'ordre du lot, pour que le premier de deux films du même nom soit conservé comme en séquentiel.
+    PoolTaches& pool = PoolTaches::getPoolGlobal();
+    std::vector<std::shared_ptr<const Film>> nouveauxFilms(films.size());
+    std::vector<std::size_t> indexShards(films.size());
+    pool.parallelFor(0, films.size(), 0, [&](std::size_t debut, std::size_t fin) {
+        for (std::size_t i = debut; i < fin; i++)
+        {
+            indexShards[i] = getIndexShardNom(films[i].nom);
+            nouveauxFilms[i] = std::make_shared<Film>(std::move(films[i]));
+        }
+    });
+    std::array<std::vector<std::size_t>, nombreShardsNoms> filmsParShard;
+    for (std::size_t i = 0; i < indexShards.size(); i++)
+    {
+        filmsParShard[indexShards[i]].push_back(i);
+    }
+    std::vector<char> estAjoute(films.size(), false); // Pas std::vector<bool>: chaque tâche écrit ses propres cases
+    pool.parallelFor(0, nombreShardsNoms, 1, [&](std::size_t debut, std::size_t fin) {
+        for (std::size_t shard = debut; shard < fin; shard++)
+        {
+            if (filmsParShard[shard].empty())
+            {
+                continue;
+            }
+            FiltreNoms& filtre = filtreNomFilms_[shard].modifier();
+            for (std::size_t i : filmsParShard[shard])
+            {
+                estAjoute[i] = filtre.emplace(nouveauxFilms[i]->nom, nouveauxFilms[i].get()).second;
+            }
+        }
+    });
+
+    std::vector<std::shared_ptr<const Film>>& vecteurFilms = films_.modifier();
+    for (std::size_t i = 0; i < nouveauxFilms.size(); i++)
+    {
+        resultats.push_back(estAjoute[i]);
+        if (estAjoute[i])
+        {
+            const Film* film = nouveauxFilms[i].get();
+            invaliderAnnee(film->annee);
+            ajouterAuFiltre(filtreGenres, film->genre, film);
+            ajouterAuFiltre(filtrePays, film->pays, film);
+            vecteurFilms.push_back(std::move(nouveauxFilms[i]));
+        }
+    }
+    return resultats;
+}
+
+/// Supprime un lot de films en un seul parcours du vecteur de films et des catégories touchées, soit O(N + k)
+/// plutôt que O(N * k) avec des appels répétés à supprimerFilm.
+/// \param nomsFilms    Les noms des films à supprimer
+/// \return             Pour chaque nom du lot, true si le film a été supprimé, false s'il était introuvable
+std::vector<bool> GestionnaireFilms::supprimerFilms(const std::vector<std::string>& nomsFilms)
+{
+    std::vector<bool> resultats;
+    resultats.reserve(nomsFilms.size());
+    std::unordered_set<const Film*> filmsSupprimes;
+    std::unordered_set<Film::Genre> genresTouches;
+    std::unordered_set<Pays> paysTouches;
+    for (const std::string& nomFilm : nomsFilms)
+    {
+        const Film* film = getFilmParNom(nomFilm);
+        resultats.push_back(film != nullptr);
+        if (film != nullptr)
+        {
+            filtreNomFilms_[getIndexShardNom(nomFilm)].modifier().erase(nomFilm);
+            invaliderAnnee(film->annee);
+            filmsSupprimes.insert(film);
+            genresTouches.insert(film->genre);
+            paysTouches.insert(film->pays);
+        }
+    }
+    if (filmsSupprimes.empty())
+    {
+        return resultats;
+    }
+
+    auto estSupprime = [&filmsSupprimes](const Film* film) { return filmsSupprimes.count(film) != 0; };
+    retirerDuFiltre(filtreGenreFilms_.modifier(), genresTouches, estSupprime);
+    retirerDuFiltre(filtrePaysFilms_.modifier(), paysTouches, estSupprime);
+    std::vector<std::shared_ptr<const Film>>& films = films_.modifier();
+    films.erase(std::remove_if(films.begin(),
+                               films.end(),
+                               [&estSupprime](const std::shared_ptr<const Film>& film) { return estSupprime(film.get()); }),
+                films.end());
+    return resultats;
+}
+
 /// Retourne le nombre de filmsprésentement dans le gestionnaire.
 /// \return        Le nombre de films presentement dans le gestionnaire
 std::size_t GestionnaireFilms::getNombreFilms() const
 {
-    return films_.size();
+    return films_.lire().size();
+}
+
+/// Retourne la liste de tous les films du gestionnaire, dans leur ordre d'ajout.
+/// \return        Un vecteur contenant un pointeur vers chaque film
+std::vector<const Film*> GestionnaireFilms::getFilms() const
+{
+    std::vector<const Film*> films;
+    films.reserve(films_.lire().size());
+    std::copy(films_.lire().begin(), films_.lire().end(), RawPointerBackInserter(films));
+    return films;
 }
 
 /// Trouve et retourne un film en le cherchant à partir de son nom.
@@ -156,8 +623,9 @@ std::size_t GestionnaireFilms::getNombreFilms() const
 /// \retrurn       Un pointeur vers le film
 const Film* GestionnaireFilms::getFilmParNom(const std::string& nom) const
 {
-    auto film = filtreNomFilms_.find(nom);
-    if(film == filtreNomFilms_.end())
+    const FiltreNoms& filtreNoms = filtreNomFilms_[getIndexShardNom(nom)].lire();
+    auto film = filtreNoms.find(nom);
+    if(film == filtreNoms.end())
         return nullptr;
     return film->second;
 }
@@ -167,10 +635,15 @@ const Film* GestionnaireFilms::getFilmParNom(const std::string& nom) const
 /// \return             Un vecteur contenant tous les films d'un genre donne
 std::vector<const Film*> GestionnaireFilms::getFilmsParGenre(Film::Genre genre) const
 {
-    auto it = filtreGenreFilms_.find(genre);
-    if(it == filtreGenreFilms_.end())
+    const IndexGenres::Filtre* filtreGenres = getFiltreGenres();
+    if (filtreGenres == nullptr)
+    {
+        return getFilmsSelon(PredicatsFilms::genre(genre));
+    }
+    auto it = filtreGenres->find(genre);
+    if(it == filtreGenres->end())
         return std::vector<const Film*>();
-    return filtreGenreFilms_.at(genre);
+    return it->second.lire();
 }
 
 /// Retourne une copie de la liste des films appartenant à un pays donné.
@@ -178,10 +651,15 @@ std::vector<const Film*> GestionnaireFilms::getFilmsParGenre(Film::Genre genre)
 /// \return         Un vecteur contenant les films appartenant a un pays donne
 std::vector<const Film*> GestionnaireFilms::getFilmsParPays(Pays pays) const
 {
-    auto it = filtrePaysFilms_.find(pays);
-    if(it == filtrePaysFilms_.end())
+    const IndexPays::Filtre* filtrePays = getFiltrePays();
+    if (filtrePays == nullptr)
+    {
+        return getFilmsSelon(PredicatsFilms::pays(pays));
+    }
+    auto it = filtrePays->find(pays);
+    if(it == filtrePays->end())
         return std::vector<const Film*>();
-    return filtrePaysFilms_.at(pays);
+    return it->second.lire();
 }
 
 /// Retourne  une  liste  des  films  produits  entre  deux  années  passées  en  paramètre
@@ -190,9 +668,146 @@ std::vector<const Film*> GestionnaireFilms::getFilmsParPays(Pays pays) const
 /// \return             Un vecteur contaenant les films sortis entre les deux anees passees en parametre 
 std::vector<const Film*> GestionnaireFilms::getFilmsEntreAnnees(int anneeDebut, int anneeFin)
 {
+    std::uint64_t cle = static_cast<std::uint64_t>(static_cast<std::uint32_t>(anneeDebut)) << 32 |
+                        static_cast<std::uint32_t>(anneeFin);
+    std::optional<std::vector<const Film*>> resultat = cacheAnnees_.trouver(cle, [&](std::uint64_t generation) {
+        auto annee = generationsAnnees_.lower_bound(anneeDebut);
+        for (; annee != generationsAnnees_.end() && annee->first <= anneeFin; ++annee)
+        {
+            if (annee->second > generation)
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (resultat)
+    {
+        return std::move(*resultat);
+    }
+
     std::vector<const Film*> filmsEntreAnnees;
-    copy_if(films_.begin(), films_.end(), RawPointerBackInserter(filmsEntreAnnees), EstDansIntervalleDatesFilm(anneeDebut, anneeFin));
+    copy_if(films_.lire().begin(), films_.lire().end(), RawPointerBackInserter(filmsEntreAnnees), EstDansIntervalleDatesFilm(anneeDebut, anneeFin));
+    cacheAnnees_.inserer(cle, filmsEntreAnnees, generation_);
     return filmsEntreAnnees;
 }
 
+/// Retourne les octets alloués sur le tas par chaque membre. Le stockage partagé avec une copie du gestionnaire est
+/// compté dans chacune des copies.
+/// \return             Le rapport d'utilisation mémoire, films compris dans films_.
+UtilisationMemoire GestionnaireFilms::getUtilisationMemoire() const
+{
+    std::size_t octetsFiltreNoms = 0;
+    for (const CopieSurEcriture<FiltreNoms>& shard : filtreNomFilms_)
+    {
+        octetsFiltreNoms += octetsTas(shard);
+    }
+    std::size_t octetsCache =
+        cacheAnnees_.getOctetsTas() + generationsAnnees_.size() * tailleNoeudArbre<std::pair<const int, std::uint64_t>>;
+
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("films_", octetsTas(films_));
+    utilisationMemoire.ajouter("filtreNomFilms_", octetsFiltreNoms);
+    utilisationMemoire.ajouter("filtreGenreFilms_", filtreGenreFilms_.getOctetsTas());
+    utilisationMemoire.ajouter("filtrePaysFilms_", filtrePaysFilms_.getOctetsTas());
+    utilisationMemoire.ajouter("cacheAnnees_", octetsCache);
+    return utilisationMemoire;
+}
+
+/// Change le nombre maximal de résultats conservés par le cache des requêtes.
+/// \param capacite     Le nombre maximal de résultats; 0 désactive le cache.
+void GestionnaireFilms::definirCapaciteCache(std::size_t capacite)
+{
+    cacheAnnees_.definirCapacite(capacite);
+}
+
+/// \return Les succès, défauts, invalidations et évictions du cache des requêtes.
+StatistiquesCache GestionnaireFilms::getStatistiquesCache() const
+{
+    return cacheAnnees_.getStatistiques();
+}
+
+/// Réactive un filtre secondaire désactivé. Il est construit à sa prochaine requête.
+/// \param index    Le filtre à réactiver.
+void GestionnaireFilms::activerIndex(Index index)
+{
+    switch (index)
+    {
+        case Index::Genre:
+            filtreGenreFilms_.activer();
+            break;
+        case Index::Pays:
+            filtrePaysFilms_.activer();
+            break;
+    }
+}
+
+/// Désactive un filtre secondaire et libère sa mémoire. Ses requêtes parcourent alors tous les films et les
+/// modifications ne le maintiennent plus.
+/// \param index    Le filtre à désactiver.
+void GestionnaireFilms::desactiverIndex(Index index)
+{
+    switch (index)
+    {
+        case Index::Genre:
+            filtreGenreFilms_.desactiver();
+            break;
+        case Index::Pays:
+            filtrePaysFilms_.desactiver();
+            break;
+    }
+}
+
+/// Indique si un filtre secondaire a été construit par une requête, et est donc maintenu à chaque modification.
+/// \param index    Le filtre.
+/// \return         True si le filtre est construit, false s'il est désactivé ou n'a pas encore été demandé.
+bool GestionnaireFilms::estIndexConstruit(Index index) const
+{
+    return index == Index::Genre ? filtreGenreFilms_.estConstruit() : filtrePaysFilms_.estConstruit();
+}
+
+/// Insère un film déjà alloué dans le vecteur de films et dans tous les filtres.
+/// \param film     Le film à insérer, dont le nom ne doit pas déjà être présent.
+/// \return         Un pointeur vers le film inséré.
+const Film* GestionnaireFilms::insererFilm(std::shared_ptr<const Film> film)
+{
+    const Film* nouveauFilm = film.get();
+    films_.modifier().push_back(std::move(film));
+    filtreNomFilms_[getIndexShardNom(nouveauFilm->nom)].modifier().emplace(nouveauFilm->nom, nouveauFilm);
+    ajouterAuFiltre(filtreGenreFilms_.modifier(), nouveauFilm->genre, nouveauFilm);
+    ajouterAuFiltre(filtrePaysFilms_.modifier(), nouveauFilm->pays, nouveauFilm);
+    invaliderAnnee(nouveauFilm->annee);
+    return nouveauFilm;
+}
+
+/// Note qu'un film d'une année a été ajouté, modifié ou supprimé, ce qui périme les résultats du cache dont
+/// l'intervalle contient cette année.
+/// \param annee    L'année du film touché.
+void GestionnaireFilms::invaliderAnnee(int annee)
+{
+    generationsAnnees_[annee] = ++generation_;
+}
+
+/// Retourne le filtre par genre, en le construisant d'abord s'il n'a encore jamais été demandé.
+/// \return Le filtre, ou nullptr s'il est désactivé.
+const GestionnaireFilms::IndexGenres::Filtre* GestionnaireFilms::getFiltreGenres() const
+{
+    return filtreGenreFilms_.lire([this] { return construireFiltre<Film::Genre>(films_.lire(), getGenreFilm); });
+}
+
+/// Retourne le filtre par pays, en le construisant d'abord s'il n'a encore jamais été demandé.
+/// \return Le filtre, ou nullptr s'il est désactivé.
+const GestionnaireFilms::IndexPays::Filtre* GestionnaireFilms::getFiltrePays() const
+{
+    return filtrePaysFilms_.lire([this] { return construireFiltre<Pays>(films_.lire(), getPaysFilm); });
+}
+
+/// Retourne l'index du shard du filtre par nom qui contient un nom de film donné.
+/// \param nom      Le nom du film.
+/// \return         L'index du shard.
+std::size_t GestionnaireFilms::getIndexShardNom(const std::string& nom)
+{
+    return std::hash<std::string>{}(nom) % nombreShardsNoms;
+}
+
 
@@ -6,7 +6,71 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <sstream>
+#include "AnalyseurLogs.h"
+#include "Instrumentation.h"
+
+namespace
+{
+    /// Lit les utilisateurs d'un fichier de données d'utilisateurs.
+    /// \param fichier         Le fichier ouvert à partir duquel lire les utilisateurs.
+    /// \param utilisateurs    Le vecteur auquel ajouter les utilisateurs lus.
+    /// \param rejets          Le collecteur auquel signaler les lignes qui n'ont pas pu être interprétées.
+    /// \return                True si toutes les lignes ont été interprétées, false sinon.
+    bool lireUtilisateurs(std::istream &fichier, std::vector<Utilisateur> &utilisateurs, CollecteurRejets &rejets)
+    {
+        bool succesParsing = true;
+        std::string ligne;
+        while (lireLigne(fichier, ligne))
+        {
+            INSTRUMENTER_PHASE(AnalyseLignes);
+            std::istringstream stream(ligne);
+
+            std::string id;
+            std::string nom;
+            int age;
+            int pays;
+
+            if (stream >> id >> std::quoted(nom) >> age >> pays)
+            {
+                utilisateurs.push_back(Utilisateur{std::move(id), std::move(nom), age, static_cast<Pays>(pays)});
+            }
+            else
+            {
+                INSTRUMENTER_COMPTEUR(LignesRejetees, 1);
+                rejets.rejeter(RaisonRejet::LigneMalFormee, ligne);
+                succesParsing = false;
+            }
+        }
+        return succesParsing;
+    }
+} // namespace
+
+/// Constructeur par copie. Les filtres sont reconstruits pour pointer vers les utilisateurs de la copie.
+/// \param other    Le gestionnaire d'utilisateurs à partir duquel copier la classe.
+GestionnaireUtilisateurs::GestionnaireUtilisateurs(const GestionnaireUtilisateurs &other)
+{
+    utilisateurs_.reserve(other.utilisateurs_.size());
+    filtrePaysUtilisateurs_.reserve(other.filtrePaysUtilisateurs_.size());
+
+    for (const auto &[id, utilisateur] : other.utilisateurs_)
+    {
+        ajouterUtilisateur(utilisateur);
+    }
+}
+
+/// Opérateur d'assignation par copie utilisant le copy-and-swap idiom.
+/// \param other    Le gestionnaire d'utilisateurs à partir duquel copier la classe.
+/// \return         Référence à l'objet actuel.
+GestionnaireUtilisateurs &GestionnaireUtilisateurs::operator=(GestionnaireUtilisateurs other)
+{
+    std::swap(utilisateurs_, other.utilisateurs_);
+    std::swap(filtrePaysUtilisateurs_, other.filtrePaysUtilisateurs_);
+    std::swap(filtreAgeUtilisateurs_, other.filtreAgeUtilisateurs_);
+    return *this;
+}
 
 /// Affiche les informations des utilisateurs gérés par le gestionnaire d'utilisateurs à la sortie du stream donné.
 /// \param outputStream         Le stream auquel écrire les informations des utilisateurs.
@@ -31,42 +95,115 @@ std::ostream &operator<<(std::ostream &outputStream, const GestionnaireUtilisate
 
 /// Ajoute les utilisateurs à partir d'un fichier de données d'utilisateurs.
 /// \param nomFichier   Le fichier à partir duquel lire les informations des utilisateurs.
-/// \return             True si tout le chargement s'est effectué avec succès, false sinon.
-bool GestionnaireUtilisateurs::chargerDepuisFichier(const std::string &nomFichier)
+/// \param options      Le traitement des lignes qui n'ont pas pu être interprétées.
+/// \return             Le nombre d'utilisateurs chargés et de lignes rejetées, et le succès si le fichier a été
+///                     ouvert et que toutes ses lignes ont été interprétées.
+BilanChargement GestionnaireUtilisateurs::chargerDepuisFichier(const std::string &nomFichier,
+                                                               const OptionsRejets &options)
 {
+    INSTRUMENTER_PHASE(ChargementUtilisateurs);
+    BilanChargement bilan;
     std::ifstream fichier(nomFichier);
     if (fichier)
     {
         utilisateurs_.clear();
+        filtrePaysUtilisateurs_.clear();
+        filtreAgeUtilisateurs_.clear();
 
-        bool succesParsing = true;
-
-        std::string ligne;
-        while (std::getline(fichier, ligne))
-        {
-            std::istringstream stream(ligne);
+        CollecteurRejets rejets("GestionnaireUtilisateurs", options);
+        std::vector<Utilisateur> utilisateurs;
+        bilan.succes = lireUtilisateurs(fichier, utilisateurs, rejets);
+        ajouterUtilisateurs(std::move(utilisateurs));
+        bilan.nombreLignesChargees = getNombreUtilisateurs();
+        bilan.nombreRejets = rejets.terminer();
+        return bilan;
+    }
+    std::cerr << "Erreur GestionnaireUtilisateurs: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+    return bilan;
+}
 
-            std::string id;
-            std::string nom;
-            int age;
-            int pays;
+/// Recharge les utilisateurs à partir d'un fichier de données d'utilisateurs en n'appliquant que les différences
+/// avec le contenu actuel: les utilisateurs absents du fichier sont supprimés, les nouveaux sont ajoutés et ceux
+/// dont l'empreinte a changé sont modifiés sur place et réindexés. Tous les utilisateurs conservés, modifiés ou non,
+/// gardent leur adresse, si bien que les lignes de log qui les référencent restent valides.
+/// \param nomFichier       Le fichier à partir duquel lire les informations des utilisateurs.
+/// \param analyseurLogs    L'analyseur dont les lignes référencent ces utilisateurs, ou nullptr. Les lignes des
+///                         utilisateurs supprimés en sont retirées.
+/// \return                 Le nombre d'utilisateurs ajoutés, modifiés, supprimés et inchangés.
+BilanRechargement GestionnaireUtilisateurs::rechargerDepuisFichier(const std::string &nomFichier,
+                                                                   AnalyseurLogs* analyseurLogs)
+{
+    INSTRUMENTER_PHASE(ChargementUtilisateurs);
+    BilanRechargement bilan;
+    std::ifstream fichier(nomFichier);
+    if (!fichier)
+    {
+        std::cerr << "Erreur GestionnaireUtilisateurs: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+        return bilan;
+    }
+    std::vector<Utilisateur> utilisateurs;
+    CollecteurRejets rejets("GestionnaireUtilisateurs", OptionsRejets());
+    bilan.succes = lireUtilisateurs(fichier, utilisateurs, rejets);
+    rejets.terminer();
 
-            if (stream >> id >> std::quoted(nom) >> age >> pays)
+    // Comme pour ajouterUtilisateurs, la première occurrence d'un ID répété dans le fichier est conservée
+    std::unordered_set<const Utilisateur*> utilisateursConserves;
+    std::unordered_set<std::string> idsNouveaux;
+    std::vector<Utilisateur> ajouts;
+    for (Utilisateur &utilisateur : utilisateurs)
+    {
+        auto it = utilisateurs_.find(utilisateur.id);
+        if (it == utilisateurs_.end())
+        {
+            if (idsNouveaux.insert(utilisateur.id).second)
             {
-                // TODO: Uncomment une fois que la fonction ajouterUtilisateur est écrite
-                ajouterUtilisateur(Utilisateur{id, nom, age, static_cast<Pays>(pays)});
+                ajouts.push_back(std::move(utilisateur));
+            }
+        }
+        else if (utilisateursConserves.insert(&it->second).second)
+        {
+            if (getEmpreinte(utilisateur) == getEmpreinte(it->second))
+            {
+                bilan.nombreInchanges++;
             }
             else
             {
-                std::cerr << "Erreur GestionnaireUtilisateurs: la ligne " << ligne
-                          << " n'a pas pu être interprétée correctement\n";
-                succesParsing = false;
+                desindexerUtilisateur(&it->second);
+                it->second = std::move(utilisateur);
+                indexerUtilisateur(&it->second);
+                bilan.nombreModifications++;
             }
         }
-        return succesParsing;
     }
-    std::cerr << "Erreur GestionnaireUtilisateurs: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
-    return false;
+
+    if (analyseurLogs != nullptr && utilisateursConserves.size() < utilisateurs_.size())
+    {
+        std::vector<const Utilisateur*> utilisateursSupprimes;
+        for (const auto& [id, utilisateur] : utilisateurs_)
+        {
+            if (utilisateursConserves.count(&utilisateur) == 0)
+            {
+                utilisateursSupprimes.push_back(&utilisateur);
+            }
+        }
+        analyseurLogs->retirerLignesUtilisateurs(utilisateursSupprimes);
+    }
+    for (auto it = utilisateurs_.begin(); it != utilisateurs_.end();)
+    {
+        if (utilisateursConserves.count(&it->second) == 0)
+        {
+            desindexerUtilisateur(&it->second);
+            it = utilisateurs_.erase(it);
+            bilan.nombreSuppressions++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    bilan.nombreAjouts = ajouts.size();
+    ajouterUtilisateurs(std::move(ajouts));
+    return bilan;
 }
 
 /// Ajoute un utilisateur au gestionnaire, en l’insérant dans la map avec son ID comme clé et l’utilisateur comme valeur.
@@ -74,7 +211,39 @@ bool GestionnaireUtilisateurs::chargerDepuisFichier(const std::string &nomFichie
 /// \return                 true si l'utilisateur a et eajoute avec succes false sinon
 bool GestionnaireUtilisateurs::ajouterUtilisateur(const Utilisateur &utilisateur)
 {
-    return utilisateurs_.emplace(utilisateur.id, utilisateur).second;
+    auto [it, estAjoute] = utilisateurs_.emplace(utilisateur.id, utilisateur);
+    if (estAjoute)
+        indexerUtilisateur(&it->second);
+    return estAjoute;
+}
+
+/// Ajoute un utilisateur au gestionnaire en déplaçant ses données plutôt qu'en les copiant.
+/// \param utilisateur      L'utilisateur a ajouter
+/// \return                 true si l'utilisateur a ete ajoute avec succes false sinon
+bool GestionnaireUtilisateurs::ajouterUtilisateur(Utilisateur &&utilisateur)
+{
+    if (utilisateurs_.find(utilisateur.id) != utilisateurs_.end())
+        return false;
+    std::string id = utilisateur.id;
+    auto it = utilisateurs_.emplace(std::move(id), std::move(utilisateur)).first;
+    indexerUtilisateur(&it->second);
+    return true;
+}
+
+/// Ajoute un lot d'utilisateurs en réservant la capacité de la map une seule fois.
+/// \param utilisateurs     Les utilisateurs à ajouter, déplacés dans le gestionnaire
+/// \return                 Pour chaque utilisateur du lot, true s'il a été ajouté, false si son ID existait déjà
+std::vector<bool> GestionnaireUtilisateurs::ajouterUtilisateurs(std::vector<Utilisateur> utilisateurs)
+{
+    INSTRUMENTER_PHASE(IndexationUtilisateurs);
+    utilisateurs_.reserve(utilisateurs_.size() + utilisateurs.size());
+    std::vector<bool> resultats;
+    resultats.reserve(utilisateurs.size());
+    for (Utilisateur &utilisateur : utilisateurs)
+    {
+        resultats.push_back(ajouterUtilisateur(std::move(utilisateur)));
+    }
+    return resultats;
 }
 
 /// Supprime un utilisateur du gestionnaire à partir de son ID
@@ -82,7 +251,12 @@ bool GestionnaireUtilisateurs::ajouterUtilisateur(const Utilisateur &utilisateur
 /// \return                 true si l'utilisateur a ete supprime avec succes false sinon
 bool GestionnaireUtilisateurs::supprimerUtilisateur(const std::string &idUtilisateur)
 {
-    return utilisateurs_.erase(idUtilisateur);
+    auto it = utilisateurs_.find(idUtilisateur);
+    if (it == utilisateurs_.end())
+        return false;
+    desindexerUtilisateur(&it->second);
+    utilisateurs_.erase(it);
+    return true;
 }
 
 /// Retourne le nombre d’utilisateurs présentement dans le gestionnaire.
@@ -92,6 +266,19 @@ std::size_t GestionnaireUtilisateurs::getNombreUtilisateurs() const
     return utilisateurs_.size();
 }
 
+/// Retourne la liste de tous les utilisateurs du gestionnaire, dans un ordre quelconque.
+/// \return      Un vecteur contenant un pointeur vers chaque utilisateur
+std::vector<const Utilisateur*> GestionnaireUtilisateurs::getUtilisateurs() const
+{
+    std::vector<const Utilisateur*> utilisateurs;
+    utilisateurs.reserve(utilisateurs_.size());
+    for (const auto& [id, utilisateur] : utilisateurs_)
+    {
+        utilisateurs.push_back(&utilisateur);
+    }
+    return utilisateurs;
+}
+
 /// Trouve et retourne un utilisateur en le cherchant à partir de son ID.
 /// \param id       ID de l'utilisateur a retourner
 /// \return          L'utilisateur correspondant a l'id, nullptr si il n'est pas trouve
@@ -102,3 +289,113 @@ const Utilisateur *GestionnaireUtilisateurs::getUtilisateurParId(const std::stri
         return nullptr;
     return &it->second;
 }
+
+/// Retourne la liste des utilisateurs d'un pays donné.
+/// \param pays     Le pays des utilisateurs a retourner
+/// \return         Un vecteur contenant les utilisateurs du pays, dans un ordre quelconque
+std::vector<const Utilisateur *> GestionnaireUtilisateurs::getUtilisateursParPays(Pays pays) const
+{
+    auto it = filtrePaysUtilisateurs_.find(pays);
+    if (it == filtrePaysUtilisateurs_.end())
+        return std::vector<const Utilisateur *>();
+    return std::vector<const Utilisateur *>(it->second.begin(), it->second.end());
+}
+
+/// Retourne la liste des utilisateurs dont l'âge est compris entre deux bornes inclusives.
+/// \param ageMin   L'âge minimal des utilisateurs a retourner
+/// \param ageMax   L'âge maximal des utilisateurs a retourner
+/// \return         Un vecteur contenant les utilisateurs, en ordre croissant d'âge
+std::vector<const Utilisateur *> GestionnaireUtilisateurs::getUtilisateursEntreAges(int ageMin, int ageMax) const
+{
+    std::vector<const Utilisateur *> utilisateurs;
+    if (ageMin > ageMax)
+        return utilisateurs;
+    auto [debut, fin] = getIntervalleAges(ageMin, ageMax);
+    for (auto it = debut; it != fin; ++it)
+    {
+        utilisateurs.push_back(it->second);
+    }
+    return utilisateurs;
+}
+
+/// Retourne la liste des utilisateurs d'un pays donné dont l'âge est compris entre deux bornes inclusives.
+/// Le plus petit des deux filtres est parcouru et l'autre critère est vérifié sur chaque utilisateur. La taille de
+/// l'intervalle d'âges n'est comptée que jusqu'à celle du filtre par pays, pour que le choix ne coûte jamais plus que
+/// le parcours du plus petit filtre.
+/// \param pays     Le pays des utilisateurs a retourner
+/// \param ageMin   L'âge minimal des utilisateurs a retourner
+/// \param ageMax   L'âge maximal des utilisateurs a retourner
+/// \return         Un vecteur contenant les utilisateurs correspondant aux deux critères
+std::vector<const Utilisateur *> GestionnaireUtilisateurs::getUtilisateursParPaysEntreAges(Pays pays,
+                                                                                          int ageMin,
+                                                                                          int ageMax) const
+{
+    std::vector<const Utilisateur *> utilisateurs;
+    auto itPays = filtrePaysUtilisateurs_.find(pays);
+    if (itPays == filtrePaysUtilisateurs_.end() || ageMin > ageMax)
+        return utilisateurs;
+
+    auto [debutAges, finAges] = getIntervalleAges(ageMin, ageMax);
+    std::size_t nombreAges = 0;
+    for (auto it = debutAges; it != finAges && nombreAges <= itPays->second.size(); ++it)
+    {
+        nombreAges++;
+    }
+    if (nombreAges <= itPays->second.size())
+    {
+        for (auto it = debutAges; it != finAges; ++it)
+        {
+            if (it->second->pays == pays)
+                utilisateurs.push_back(it->second);
+        }
+    }
+    else
+    {
+        for (const Utilisateur *utilisateur : itPays->second)
+        {
+            if (utilisateur->age >= ageMin && utilisateur->age <= ageMax)
+                utilisateurs.push_back(utilisateur);
+        }
+    }
+    return utilisateurs;
+}
+
+/// Retourne les octets alloués sur le tas par chaque membre.
+/// \return                 Le rapport d'utilisation mémoire, utilisateurs compris dans utilisateurs_.
+UtilisationMemoire GestionnaireUtilisateurs::getUtilisationMemoire() const
+{
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("utilisateurs_", octetsTas(utilisateurs_));
+    utilisationMemoire.ajouter("filtrePaysUtilisateurs_", octetsTas(filtrePaysUtilisateurs_));
+    utilisationMemoire.ajouter("filtreAgeUtilisateurs_", octetsTas(filtreAgeUtilisateurs_));
+    return utilisationMemoire;
+}
+
+/// Ajoute un utilisateur déjà présent dans la map aux filtres par pays et par âge.
+/// \param utilisateur  Pointeur vers l'utilisateur conservé dans la map
+void GestionnaireUtilisateurs::indexerUtilisateur(const Utilisateur *utilisateur)
+{
+    filtrePaysUtilisateurs_[utilisateur->pays].insert(utilisateur);
+    filtreAgeUtilisateurs_.emplace(utilisateur->age, utilisateur);
+}
+
+/// Retourne les bornes des utilisateurs du filtre par âge dont l'âge est compris entre deux bornes inclusives.
+/// \param ageMin   L'âge minimal, au plus ageMax
+/// \param ageMax   L'âge maximal
+/// \return         Le début et la fin de l'intervalle dans le filtre par âge
+std::pair<GestionnaireUtilisateurs::FiltreAges::const_iterator, GestionnaireUtilisateurs::FiltreAges::const_iterator>
+    GestionnaireUtilisateurs::getIntervalleAges(int ageMin, int ageMax) const
+{
+    auto debut = filtreAgeUtilisateurs_.lower_bound({ageMin, nullptr});
+    auto fin = ageMax == std::numeric_limits<int>::max() ? filtreAgeUtilisateurs_.end()
+                                                         : filtreAgeUtilisateurs_.lower_bound({ageMax + 1, nullptr});
+    return {debut, fin};
+}
+
+/// Retire un utilisateur des filtres par pays et par âge.
+/// \param utilisateur  Pointeur vers l'utilisateur conservé dans la map
+void GestionnaireUtilisateurs::desindexerUtilisateur(const Utilisateur *utilisateur)
+{
+    filtrePaysUtilisateurs_[utilisateur->pays].erase(utilisateur);
+    filtreAgeUtilisateurs_.erase({utilisateur->age, utilisateur});
+}
@@ -0,0 +1,127 @@
+/// Conversions entre les timestamps des logs et des secondes depuis l'époque Unix.
+
+#include "Horodatage.h"
+
+namespace
+{
+    constexpr std::int64_t secondesParJour = 86400;
+
+    /// Convertit une date du calendrier grégorien en nombre de jours depuis le 1970-01-01.
+    /// \param annee    L'année.
+    /// \param mois     Le mois (1 à 12).
+    /// \param jour     Le jour du mois (1 à 31).
+    /// \return         Le nombre de jours depuis l'époque Unix.
+    std::int64_t getJoursDepuisEpoque(std::int64_t annee, std::int64_t mois, std::int64_t jour)
+    {
+        annee -= mois <= 2 ? 1 : 0;
+        std::int64_t ere = (annee >= 0 ? annee : annee - 399) / 400;
+        std::int64_t anneeEre = annee - ere * 400;
+        std::int64_t jourAnnee = (153 * (mois + (mois > 2 ? -3 : 9)) + 2) / 5 + jour - 1;
+        std::int64_t jourEre = anneeEre * 365 + anneeEre / 4 - anneeEre / 100 + jourAnnee;
+        return ere * 146097 + jourEre - 719468;
+    }
+
+    /// Lit un nombre d'un nombre fixe de chiffres.
+    /// \param texte    Le début des chiffres à lire.
+    /// \param nombre   Le nombre de chiffres.
+    /// \param valeur   La valeur lue.
+    /// \return         True si tous les caractères sont des chiffres, false sinon.
+    bool lireChiffres(const char* texte, int nombre, std::int64_t& valeur)
+    {
+        valeur = 0;
+        for (int i = 0; i < nombre; i++)
+        {
+            if (texte[i] < '0' || texte[i] > '9')
+            {
+                return false;
+            }
+            valeur = valeur * 10 + (texte[i] - '0');
+        }
+        return true;
+    }
+
+    /// Écrit un nombre sur un nombre fixe de chiffres, complété par des zéros.
+    /// \param valeur       La valeur à écrire.
+    /// \param nombre       Le nombre de chiffres.
+    /// \param destination  Le tampon dans lequel écrire.
+    void ecrireChiffres(std::int64_t valeur, int nombre, char* destination)
+    {
+        for (int i = nombre - 1; i >= 0; i--)
+        {
+            destination[i] = static_cast<char>('0' + valeur % 10);
+            valeur /= 10;
+        }
+    }
+} // namespace
+
+/// Convertit un timestamp au format "AAAA-MM-JJTHH:MM:SSZ" en secondes depuis l'époque Unix.
+/// \param timestamp    Le timestamp à convertir.
+/// \return             Le nombre de secondes, ou std::nullopt si le timestamp est mal formé.
+std::optional<std::int64_t> convertirTimestamp(const std::string& timestamp)
+{
+    if (timestamp.size() != longueurTimestamp || timestamp[4] != '-' || timestamp[7] != '-' || timestamp[10] != 'T' ||
+        timestamp[13] != ':' || timestamp[16] != ':' || timestamp[19] != 'Z')
+    {
+        return std::nullopt;
+    }
+    std::int64_t annee, mois, jour, heure, minute, seconde;
+    const char* texte = timestamp.data();
+    if (!lireChiffres(texte, 4, annee) || !lireChiffres(texte + 5, 2, mois) || !lireChiffres(texte + 8, 2, jour) ||
+        !lireChiffres(texte + 11, 2, heure) || !lireChiffres(texte + 14, 2, minute) ||
+        !lireChiffres(texte + 17, 2, seconde) || mois < 1 || mois > 12 || jour < 1 || jour > 31)
+    {
+        return std::nullopt;
+    }
+    return getJoursDepuisEpoque(annee, mois, jour) * secondesParJour + heure * 3600 + minute * 60 + seconde;
+}
+
+/// Écrit le timestamp correspondant à un nombre de secondes depuis l'époque Unix, sans allocation.
+/// \param secondes     Le nombre de secondes depuis l'époque Unix.
+/// \param destination  Le tampon d'au moins longueurTimestamp caractères dans lequel écrire.
+void formaterTimestamp(std::int64_t secondes, char* destination)
+{
+    std::int64_t jours = getJourTimestamp(secondes);
+    std::int64_t secondesJour = secondes - jours * secondesParJour;
+
+    // Conversion inverse de getJoursDepuisEpoque
+    jours += 719468;
+    std::int64_t ere = (jours >= 0 ? jours : jours - 146096) / 146097;
+    std::int64_t jourEre = jours - ere * 146097;
+    std::int64_t anneeEre = (jourEre - jourEre / 1460 + jourEre / 36524 - jourEre / 146096) / 365;
+    std::int64_t jourAnnee = jourEre - (365 * anneeEre + anneeEre / 4 - anneeEre / 100);
+    std::int64_t moisDecale = (5 * jourAnnee + 2) / 153;
+    std::int64_t jour = jourAnnee - (153 * moisDecale + 2) / 5 + 1;
+    std::int64_t mois = moisDecale < 10 ? moisDecale + 3 : moisDecale - 9;
+    std::int64_t annee = anneeEre + ere * 400 + (mois <= 2 ? 1 : 0);
+
+    ecrireChiffres(annee, 4, destination);
+    destination[4] = '-';
+    ecrireChiffres(mois, 2, destination + 5);
+    destination[7] = '-';
+    ecrireChiffres(jour, 2, destination + 8);
+    destination[10] = 'T';
+    ecrireChiffres(secondesJour / 3600, 2, destination + 11);
+    destination[13] = ':';
+    ecrireChiffres(secondesJour / 60 % 60, 2, destination + 14);
+    destination[16] = ':';
+    ecrireChiffres(secondesJour % 60, 2, destination + 17);
+    destination[19] = 'Z';
+}
+
+/// Retourne le timestamp correspondant à un nombre de secondes depuis l'époque Unix.
+/// \param secondes     Le nombre de secondes depuis l'époque Unix.
+/// \return             Le timestamp au format "AAAA-MM-JJTHH:MM:SSZ".
+std::string formaterTimestamp(std::int64_t secondes)
+{
+    std::string timestamp(longueurTimestamp, ' ');
+    formaterTimestamp(secondes, timestamp.data());
+    return timestamp;
+}
+
+/// Retourne le numéro du jour (depuis l'époque Unix) qui contient un instant donné.
+/// \param secondes     Le nombre de secondes depuis l'époque Unix.
+/// \return             Le nombre de jours complets depuis l'époque Unix (arrondi vers le bas).
+std::int64_t getJourTimestamp(std::int64_t secondes)
+{
+    return (secondes >= 0 ? secondes : secondes - (secondesParJour - 1)) / secondesParJour;
+}
@@ -0,0 +1,285 @@
+/// Ingestion concurrente de lignes de log avec compteurs de vues répartis.
+
+#include "IngesteurConcurrent.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+/// Constructeur d'un shard qui initialise tous ses compteurs à zéro.
+/// \param nombreBlocs  Le nombre de blocs de compteurs nécessaires pour couvrir tous les films.
+IngesteurConcurrent::Shard::Shard(std::size_t nombreBlocs)
+    : compteurs(nombreBlocs)
+{
+    for (BlocCompteurs& bloc : compteurs)
+    {
+        for (std::atomic<int>& valeur : bloc.valeurs)
+        {
+            valeur.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/// Constructeur qui prépare les shards et démarre le thread de fusion.
+/// \param analyseurLogs            L'analyseur de logs dans lequel fusionner les lignes ingérées.
+/// \param gestionnaireUtilisateurs Le gestionnaire des utilisateurs pour lier un utilisateur à un log.
+/// \param gestionnaireFilms        Le gestionnaire des films pour lier un film à un log.
+/// \param nombreShards             Le nombre de shards (habituellement le nombre de threads producteurs).
+/// \param intervalleFusion         L'intervalle entre deux fusions en arrière-plan.
+IngesteurConcurrent::IngesteurConcurrent(AnalyseurLogs& analyseurLogs,
+                                         const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                         const GestionnaireFilms& gestionnaireFilms,
+                                         std::size_t nombreShards,
+                                         std::chrono::milliseconds intervalleFusion)
+    : analyseurLogs_(analyseurLogs)
+    , gestionnaireUtilisateurs_(gestionnaireUtilisateurs)
+    , gestionnaireFilms_(gestionnaireFilms)
+    , films_(gestionnaireFilms.getFilms())
+    , intervalleFusion_(intervalleFusion)
+{
+    indexFilms_.reserve(films_.size());
+    vuesInitiales_.reserve(films_.size());
+    for (std::size_t i = 0; i < films_.size(); i++)
+    {
+        indexFilms_.emplace(films_[i], i);
+        vuesInitiales_.push_back(analyseurLogs_.getNombreVuesFilm(films_[i]));
+    }
+
+    std::size_t nombreBlocs = (films_.size() + compteursParBloc - 1) / compteursParBloc;
+    shards_.reserve(std::max<std::size_t>(nombreShards, 1));
+    for (std::size_t i = 0; i < std::max<std::size_t>(nombreShards, 1); i++)
+    {
+        shards_.push_back(std::make_unique<Shard>(nombreBlocs));
+    }
+
+    threadFusion_ = std::thread(&IngesteurConcurrent::boucleFusion, this);
+}
+
+/// Destructeur qui arrête le thread de fusion après avoir vidé toutes les files.
+IngesteurConcurrent::~IngesteurConcurrent()
+{
+    terminer();
+}
+
+/// Crée une poignée de producteur, avec sa propre file vers le thread de fusion, associée au prochain shard de
+/// compteurs (en tourniquet). Peut être appelée par n'importe quel thread.
+/// \return Le producteur à utiliser par un seul thread.
+IngesteurConcurrent::Producteur IngesteurConcurrent::creerProducteur()
+{
+    std::size_t indexShard = prochainShard_.fetch_add(1, std::memory_order_relaxed) % shards_.size();
+    std::lock_guard<std::mutex> verrouFusion(mutexFusion_);
+    canaux_.push_back(std::make_unique<Canal>(capaciteCanal));
+    return Producteur(*this, indexShard, *canaux_.back());
+}
+
+/// Fusionne immédiatement les lots publiés par tous les producteurs dans l'analyseur de logs. Les files des
+/// producteurs détruits sont retirées une fois vidées.
+void IngesteurConcurrent::fusionner()
+{
+    std::vector<LigneLog> lot;
+    std::vector<LigneLog> lotProducteur;
+    std::lock_guard<std::mutex> verrouFusion(mutexFusion_);
+    for (auto canal = canaux_.begin(); canal != canaux_.end();)
+    {
+        // La fermeture est lue avant de vider la file, pour ne pas oublier un lot publié juste avant
+        bool estFermee = (*canal)->estFermee();
+        while ((*canal)->essayerRetirer(lotProducteur))
+        {
+            lot.insert(lot.end(),
+                       std::make_move_iterator(lotProducteur.begin()),
+                       std::make_move_iterator(lotProducteur.end()));
+        }
+        canal = estFermee ? canaux_.erase(canal) : std::next(canal);
+    }
+    if (!lot.empty())
+    {
+        analyseurLogs_.ajouterLignesLog(std::move(lot));
+    }
+}
+
+/// Arrête le thread de fusion et vide les files restantes. Les producteurs doivent avoir été détruits.
+void IngesteurConcurrent::terminer()
+{
+    {
+        std::lock_guard<std::mutex> verrou(mutexFusion_);
+        arretDemande_ = true;
+    }
+    conditionFusion_.notify_all();
+    if (threadFusion_.joinable())
+    {
+        threadFusion_.join();
+    }
+    fusionner();
+}
+
+/// Retourne le nombre de vues d'un film en additionnant les compteurs de tous les shards.
+/// \param film     Le film dont on veut le nombre de vues.
+/// \return         Le nombre de vues du film, ou 0 si le film est inconnu.
+int IngesteurConcurrent::getNombreVuesFilm(const Film* film) const
+{
+    auto it = indexFilms_.find(film);
+    if (it == indexFilms_.end())
+    {
+        return 0;
+    }
+    std::size_t index = it->second;
+    int total = vuesInitiales_[index];
+    for (const auto& shard : shards_)
+    {
+        total += shard->compteurs[index / compteursParBloc].valeurs[index % compteursParBloc].load(
+            std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/// Retourne le film le plus populaire selon les compteurs agrégés.
+/// \return Un pointeur vers le film le plus populaire ou nullptr s'il n'y a aucune vue.
+const Film* IngesteurConcurrent::getFilmPlusPopulaire() const
+{
+    std::vector<std::pair<const Film*, int>> filmPlusPopulaire = getNFilmsPlusPopulaires(1);
+    return filmPlusPopulaire.empty() ? nullptr : filmPlusPopulaire.front().first;
+}
+
+/// Retourne les n films les plus populaires selon les compteurs agrégés.
+/// \param nombre   Le nombre de films à retourner.
+/// \return         Le vecteur des films les plus populaires avec leur nombre de vues, en ordre décroissant.
+std::vector<std::pair<const Film*, int>> IngesteurConcurrent::getNFilmsPlusPopulaires(std::size_t nombre) const
+{
+    std::vector<int> totaux = calculerTotaux();
+    std::vector<std::pair<const Film*, int>> vuesFilms;
+    for (std::size_t i = 0; i < totaux.size(); i++)
+    {
+        if (totaux[i] > 0)
+        {
+            vuesFilms.emplace_back(films_[i], totaux[i]);
+        }
+    }
+
+    std::vector<std::pair<const Film*, int>> nFilmsPlusPopulaires(std::min(vuesFilms.size(), nombre));
+    std::partial_sort_copy(vuesFilms.begin(),
+                           vuesFilms.end(),
+                           nFilmsPlusPopulaires.begin(),
+                           nFilmsPlusPopulaires.end(),
+                           [](const std::pair<const Film*, int>& film1, const std::pair<const Film*, int>& film2) {
+                               return film1.second > film2.second;
+                           });
+    return nFilmsPlusPopulaires;
+}
+
+/// Boucle du thread de fusion: vide les files à chaque intervalle jusqu'à ce que l'arrêt soit demandé.
+void IngesteurConcurrent::boucleFusion()
+{
+    std::unique_lock<std::mutex> verrou(mutexFusion_);
+    while (!arretDemande_)
+    {
+        conditionFusion_.wait_for(verrou, intervalleFusion_, [this] { return arretDemande_; });
+        if (arretDemande_)
+        {
+            break;
+        }
+        verrou.unlock();
+        fusionner();
+        verrou.lock();
+    }
+}
+
+/// Calcule le nombre de vues total de chaque film en parcourant les shards bloc par bloc.
+/// \return Le vecteur des totaux, indexé selon l'index dense des films.
+std::vector<int> IngesteurConcurrent::calculerTotaux() const
+{
+    std::vector<int> totaux = vuesInitiales_;
+    for (const auto& shard : shards_)
+    {
+        for (std::size_t i = 0; i < totaux.size(); i++)
+        {
+            totaux[i] += shard->compteurs[i / compteursParBloc].valeurs[i % compteursParBloc].load(
+                std::memory_order_relaxed);
+        }
+    }
+    return totaux;
+}
+
+/// Constructeur d'un producteur associé à un shard et à sa file.
+/// \param ingesteur    L'ingesteur auquel appartient le producteur.
+/// \param indexShard   L'index du shard dont incrémenter les compteurs.
+/// \param canal        La file dans laquelle publier les lots, dont le producteur est le seul à écrire.
+IngesteurConcurrent::Producteur::Producteur(IngesteurConcurrent& ingesteur, std::size_t indexShard, Canal& canal)
+    : ingesteur_(&ingesteur)
+    , indexShard_(indexShard)
+    , canal_(&canal)
+{
+    lot_.reserve(tailleLotProducteur);
+}
+
+/// Constructeur par déplacement: la file et le lot en cours passent au nouveau producteur.
+/// \param other    Le producteur à déplacer, qui ne publie plus rien ensuite.
+IngesteurConcurrent::Producteur::Producteur(Producteur&& other) noexcept
+    : ingesteur_(other.ingesteur_)
+    , indexShard_(other.indexShard_)
+    , canal_(std::exchange(other.canal_, nullptr))
+    , lot_(std::move(other.lot_))
+    , debutLot_(other.debutLot_)
+{
+}
+
+/// Destructeur qui publie le lot en cours et ferme la file du producteur.
+IngesteurConcurrent::Producteur::~Producteur()
+{
+    if (canal_ != nullptr)
+    {
+        publier();
+        canal_->fermer();
+    }
+}
+
+/// Publie le lot en cours dans la file du producteur, en attendant une place si la file est pleine.
+void IngesteurConcurrent::Producteur::publier()
+{
+    if (!lot_.empty())
+    {
+        canal_->ajouter(std::move(lot_));
+        lot_ = std::vector<LigneLog>();
+        lot_.reserve(tailleLotProducteur);
+    }
+}
+
+/// Crée une ligne de log, l'ajoute au lot du producteur et incrémente le compteur de vues du film. Le lot est publié
+/// s'il est plein ou si l'intervalle de fusion s'est écoulé depuis sa première ligne, vérifié toutes les
+/// lignesEntreHorloges lignes.
+/// \param timestamp        La date à laquelle le film est regardé.
+/// \param idUtilisateur    L'id de l'utilisateur qui regarde le film.
+/// \param nomFilm          Le nom du film regardé.
+/// \return                 True si l'utilisateur et le film existent et que la ligne a été ajoutée, false sinon.
+bool IngesteurConcurrent::Producteur::creerLigneLog(const std::string& timestamp,
+                                                    const std::string& idUtilisateur,
+                                                    const std::string& nomFilm)
+{
+    const Utilisateur* utilisateur = ingesteur_->gestionnaireUtilisateurs_.getUtilisateurParId(idUtilisateur);
+    const Film* film = ingesteur_->gestionnaireFilms_.getFilmParNom(nomFilm);
+    if (utilisateur == nullptr || film == nullptr)
+    {
+        return false;
+    }
+    auto it = ingesteur_->indexFilms_.find(film);
+    if (it == ingesteur_->indexFilms_.end())
+    {
+        return false;
+    }
+
+    Shard& shard = *ingesteur_->shards_[indexShard_];
+    std::size_t index = it->second;
+    shard.compteurs[index / compteursParBloc].valeurs[index % compteursParBloc].fetch_add(1,
+                                                                                         std::memory_order_relaxed);
+    if (lot_.empty())
+    {
+        debutLot_ = std::chrono::steady_clock::now();
+    }
+    lot_.push_back(LigneLog{timestamp, utilisateur, film});
+    // L'horloge coûte autant que l'ajout lui-même: elle n'est relue que toutes les lignesEntreHorloges lignes
+    if (lot_.size() >= tailleLotProducteur ||
+        (lot_.size() % lignesEntreHorloges == 0 &&
+         std::chrono::steady_clock::now() - debutLot_ >= ingesteur_->intervalleFusion_))
+    {
+        publier();
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+/// Instrumentation des chemins critiques: minuteurs par phase et compteurs atomiques.
+
+#include "Instrumentation.h"
+#include <array>
+#include <cstddef>
+
+namespace
+{
+    constexpr std::size_t nombrePhases = static_cast<std::size_t>(Instrumentation::Phase::Nombre);
+    constexpr std::size_t nombreCompteurs = static_cast<std::size_t>(Instrumentation::Compteur::Nombre);
+
+    constexpr std::array<const char*, nombrePhases> nomsPhases = {
+        "chargement_films",
+        "chargement_utilisateurs",
+        "chargement_logs",
+        "suivi_logs",
+        "lecture_fichier",
+        "analyse_lignes",
+        "resolution_logs",
+        "indexation_films",
+        "indexation_utilisateurs",
+        "insertion_logs",
+        "comptage_vues",
+        "ecriture_export",
+        "requete_nombre_vues_film",
+        "requete_nombre_vues_film_entre",
+        "requete_film_plus_populaire",
+        "requete_n_films_plus_populaires",
+        "requete_nombre_vues_utilisateur",
+        "requete_films_vus_utilisateur",
+        "requete_nombre_vues_groupe",
+        "requete_n_films_plus_populaires_groupe",
+    };
+
+    constexpr std::array<const char*, nombreCompteurs> nomsCompteurs = {
+        "lignes_lues",
+        "lignes_rejetees",
+        "utilisateurs_introuvables",
+        "films_introuvables",
+        "octets_traites",
+    };
+
+    /// Statistiques d'une phase, alignées sur une ligne de cache pour que deux phases chronométrées par des threads
+    /// différents ne se disputent pas la même ligne.
+    struct alignas(64) StatistiquesPhase
+    {
+        std::atomic<std::uint64_t> dureeNs{0};
+        std::atomic<std::uint64_t> appels{0};
+    };
+
+    struct alignas(64) CompteurAligne
+    {
+        std::atomic<std::uint64_t> valeur{0};
+    };
+
+    std::array<StatistiquesPhase, nombrePhases> statistiquesPhases;
+    std::array<CompteurAligne, nombreCompteurs> compteurs;
+} // namespace
+
+/// Ajoute une durée au total d'une phase et compte un appel.
+/// \param phase    La phase chronométrée.
+/// \param duree    La durée à ajouter.
+void Instrumentation::ajouterDuree(Phase phase, std::chrono::nanoseconds duree)
+{
+    StatistiquesPhase& statistiques = statistiquesPhases[static_cast<std::size_t>(phase)];
+    statistiques.dureeNs.fetch_add(static_cast<std::uint64_t>(duree.count()), std::memory_order_relaxed);
+    statistiques.appels.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Ajoute une valeur à un compteur.
+/// \param compteur Le compteur à incrémenter.
+/// \param valeur   La valeur à ajouter.
+void Instrumentation::incrementer(Compteur compteur, std::uint64_t valeur)
+{
+    compteurs[static_cast<std::size_t>(compteur)].valeur.fetch_add(valeur, std::memory_order_relaxed);
+}
+
+/// Retourne la valeur actuelle d'un compteur.
+/// \param compteur Le compteur à lire.
+/// \return         La valeur du compteur.
+std::uint64_t Instrumentation::getCompteur(Compteur compteur)
+{
+    return compteurs[static_cast<std::size_t>(compteur)].valeur.load(std::memory_order_relaxed);
+}
+
+/// Retourne le nombre de fois qu'une phase a été chronométrée.
+/// \param phase    La phase à lire.
+/// \return         Le nombre d'appels.
+std::uint64_t Instrumentation::getNombreAppels(Phase phase)
+{
+    return statistiquesPhases[static_cast<std::size_t>(phase)].appels.load(std::memory_order_relaxed);
+}
+
+/// Retourne le temps total passé dans une phase.
+/// \param phase    La phase à lire.
+/// \return         La durée cumulée.
+std::chrono::nanoseconds Instrumentation::getDuree(Phase phase)
+{
+    return std::chrono::nanoseconds(
+        statistiquesPhases[static_cast<std::size_t>(phase)].dureeNs.load(std::memory_order_relaxed));
+}
+
+/// Remet toutes les durées et tous les compteurs à zéro.
+void Instrumentation::reinitialiser()
+{
+    for (StatistiquesPhase& statistiques : statistiquesPhases)
+    {
+        statistiques.dureeNs.store(0, std::memory_order_relaxed);
+        statistiques.appels.store(0, std::memory_order_relaxed);
+    }
+    for (CompteurAligne& compteur : compteurs)
+    {
+        compteur.valeur.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// Écrit un rapport JSON des phases (durée totale en nanosecondes et nombre d'appels) et des compteurs. Les phases
+/// jamais chronométrées sont omises.
+/// \param sortie   Le stream dans lequel écrire le rapport.
+void Instrumentation::ecrireRapportJson(std::ostream& sortie)
+{
+    sortie << "{\"active\":" << (estActive ? "true" : "false") << ",\"phases\":{";
+    bool premier = true;
+    for (std::size_t i = 0; i < nombrePhases; i++)
+    {
+        std::uint64_t appels = statistiquesPhases[i].appels.load(std::memory_order_relaxed);
+        if (appels == 0)
+        {
+            continue;
+        }
+        sortie << (premier ? "" : ",") << '"' << nomsPhases[i] << "\":{\"duree_ns\":"
+               << statistiquesPhases[i].dureeNs.load(std::memory_order_relaxed) << ",\"appels\":" << appels << '}';
+        premier = false;
+    }
+    sortie << "},\"compteurs\":{";
+    for (std::size_t i = 0; i < nombreCompteurs; i++)
+    {
+        sortie << (i == 0 ? "" : ",") << '"' << nomsCompteurs[i]
+               << "\":" << compteurs[i].valeur.load(std::memory_order_relaxed);
+    }
+    sortie << "}}\n";
+}
@@ -0,0 +1,771 @@
+/// Journal des mutations des gestionnaires et points de contrôle, pour redémarrer sans recharger les fichiers texte.
+
+#include "JournalMutations.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /// Type d'un enregistrement, écrit sur un octet.
+    enum class TypeEnregistrement : std::uint8_t
+    {
+        Entete,
+        AjoutFilm,
+        SuppressionFilm,
+        AjoutUtilisateur,
+        SuppressionUtilisateur,
+        CreationLigneLog,
+        Fin
+    };
+
+    constexpr std::uint32_t versionFormat = 1;
+    constexpr std::size_t tailleEntete = 2 * sizeof(std::uint32_t);     // Longueur du contenu et somme de contrôle
+    constexpr std::size_t octetsTamponPointControle = std::size_t(1) << 20; // Écrits à la fois au point de contrôle
+
+    /// Calcule la somme de contrôle FNV-1a d'un contenu.
+    /// \param donnees  Le début du contenu.
+    /// \param taille   Le nombre d'octets du contenu.
+    /// \return         La somme de contrôle sur 32 bits.
+    std::uint32_t calculerSomme(const char* donnees, std::size_t taille)
+    {
+        std::uint32_t somme = 2166136261u;
+        for (std::size_t i = 0; i < taille; i++)
+        {
+            somme = (somme ^ static_cast<unsigned char>(donnees[i])) * 16777619u;
+        }
+        return somme;
+    }
+
+    /// Force l'écriture sur disque d'un fichier déjà vidé de son tampon stdio.
+    /// \return True si la synchronisation a réussi ou n'est pas disponible, false sinon.
+    bool synchroniserFichier(std::FILE* fichier)
+    {
+#if defined(__linux__)
+        return fdatasync(fileno(fichier)) == 0;
+#elif defined(__unix__) || defined(__APPLE__)
+        return fsync(fileno(fichier)) == 0;
+#else
+        (void)fichier;
+        return true;
+#endif
+    }
+
+    /// Force l'écriture sur disque des entrées d'un dossier, pour qu'un renommage survive à un arrêt brutal.
+    void synchroniserDossier(const std::filesystem::path& dossier)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        int descripteur = open(dossier.c_str(), O_RDONLY);
+        if (descripteur != -1)
+        {
+            fsync(descripteur);
+            close(descripteur);
+        }
+#else
+        (void)dossier;
+#endif
+    }
+
+    /// Encodeur d'un enregistrement: entête, type, puis champs dans l'ordre des octets de la machine. Les chaînes
+    /// sont précédées de leur longueur.
+    class EcrivainEnregistrement
+    {
+    public:
+        explicit EcrivainEnregistrement(TypeEnregistrement type)
+            : contenu_(tailleEntete, '\0')
+        {
+            ecrire(static_cast<std::uint8_t>(type));
+        }
+
+        template<typename T>
+        void ecrire(T valeur)
+        {
+            static_assert(std::is_integral_v<T>);
+            contenu_.append(reinterpret_cast<const char*>(&valeur), sizeof(T));
+        }
+
+        void ecrire(const std::string& texte)
+        {
+            ecrire(static_cast<std::uint32_t>(texte.size()));
+            contenu_ += texte;
+        }
+
+        void ecrire(const Film& film)
+        {
+            ecrire(film.nom);
+            ecrire(static_cast<std::uint8_t>(film.genre));
+            ecrire(static_cast<std::uint8_t>(film.pays));
+            ecrire(film.realisateur);
+            ecrire(static_cast<std::int32_t>(film.annee));
+        }
+
+        void ecrire(const Utilisateur& utilisateur)
+        {
+            ecrire(utilisateur.id);
+            ecrire(utilisateur.nom);
+            ecrire(static_cast<std::int32_t>(utilisateur.age));
+            ecrire(static_cast<std::uint8_t>(utilisateur.pays));
+        }
+
+        /// Remplit l'entête avec la longueur et la somme de contrôle du contenu, puis ajoute l'enregistrement.
+        /// \param sortie   Le tampon auquel ajouter l'enregistrement.
+        void terminer(std::string& sortie)
+        {
+            auto longueur = static_cast<std::uint32_t>(contenu_.size() - tailleEntete);
+            std::uint32_t somme = calculerSomme(contenu_.data() + tailleEntete, longueur);
+            std::memcpy(contenu_.data(), &longueur, sizeof(longueur));
+            std::memcpy(contenu_.data() + sizeof(longueur), &somme, sizeof(somme));
+            sortie += contenu_;
+        }
+
+    private:
+        std::string contenu_;
+    };
+
+    /// Décodeur du contenu d'un enregistrement, qui refuse de lire au-delà de sa fin.
+    class LecteurEnregistrement
+    {
+    public:
+        LecteurEnregistrement(const char* debut, std::size_t taille)
+            : position_(debut)
+            , fin_(debut + taille)
+        {
+        }
+
+        template<typename T>
+        bool lire(T& valeur)
+        {
+            static_assert(std::is_integral_v<T>);
+            if (static_cast<std::size_t>(fin_ - position_) < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&valeur, position_, sizeof(T));
+            position_ += sizeof(T);
+            return true;
+        }
+
+        bool lire(std::string& texte)
+        {
+            std::uint32_t longueur = 0;
+            if (!lire(longueur) || static_cast<std::size_t>(fin_ - position_) < longueur)
+            {
+                return false;
+            }
+            texte.assign(position_, longueur);
+            position_ += longueur;
+            return true;
+        }
+
+        bool lire(Film& film)
+        {
+            std::uint8_t genre = 0;
+            std::uint8_t pays = 0;
+            std::int32_t annee = 0;
+            bool succes = lire(film.nom) && lire(genre) && lire(pays) && lire(film.realisateur) && lire(annee);
+            film.genre = static_cast<Film::Genre>(genre);
+            film.pays = static_cast<Pays>(pays);
+            film.annee = annee;
+            return succes;
+        }
+
+        bool lire(Utilisateur& utilisateur)
+        {
+            std::int32_t age = 0;
+            std::uint8_t pays = 0;
+            bool succes = lire(utilisateur.id) && lire(utilisateur.nom) && lire(age) && lire(pays);
+            utilisateur.age = age;
+            utilisateur.pays = static_cast<Pays>(pays);
+            return succes;
+        }
+
+    private:
+        const char* position_;
+        const char* fin_;
+    };
+
+    /// Encode l'entête d'un journal ou d'un point de contrôle.
+    /// \param generation   La génération du fichier.
+    /// \param sortie       Le tampon auquel ajouter l'enregistrement.
+    void ajouterEntete(std::uint64_t generation, std::string& sortie)
+    {
+        EcrivainEnregistrement entete(TypeEnregistrement::Entete);
+        entete.ecrire(versionFormat);
+        entete.ecrire(generation);
+        entete.terminer(sortie);
+    }
+} // namespace
+
+/// Constructeur. Le journal n'est ouvert que par recuperer(), qui doit être appelée avant toute mutation.
+/// \param gestionnaireFilms        Le gestionnaire de films dont les mutations sont journalisées.
+/// \param gestionnaireUtilisateurs Le gestionnaire d'utilisateurs dont les mutations sont journalisées.
+/// \param analyseurLogs            L'analyseur dont les lignes de log créées sont journalisées.
+/// \param dossier                  Le dossier du journal et du point de contrôle, créé au besoin.
+/// \param options                  La taille des groupes et la fréquence des points de contrôle.
+JournalMutations::JournalMutations(GestionnaireFilms& gestionnaireFilms,
+                                   GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                   AnalyseurLogs& analyseurLogs,
+                                   std::filesystem::path dossier,
+                                   const OptionsJournal& options)
+    : gestionnaireFilms_(gestionnaireFilms)
+    , gestionnaireUtilisateurs_(gestionnaireUtilisateurs)
+    , analyseurLogs_(analyseurLogs)
+    , dossier_(std::move(dossier))
+    , options_(options)
+{
+}
+
+/// Destructeur qui valide le groupe en cours.
+JournalMutations::~JournalMutations()
+{
+    valider();
+    fermerJournal();
+}
+
+/// Charge le dernier point de contrôle, rejoue le journal de sa génération, puis ouvre ce journal pour y ajouter les
+/// mutations suivantes. Un enregistrement final incomplet ou corrompu est tronqué. Les gestionnaires et l'analyseur
+/// doivent être vides.
+/// \return     True si l'état a été récupéré et le journal ouvert, false sinon.
+bool JournalMutations::recuperer()
+{
+    fermerJournal();
+    tampon_.clear();
+    nombreEnAttente_ = 0;
+    mutationsDepuisPointControle_ = 0;
+    nombreMutationsRejouees_ = 0;
+    generation_ = 0;
+
+    std::error_code erreur;
+    std::filesystem::create_directories(dossier_, erreur);
+    std::uintmax_t tailleValide = 0;
+    if (std::filesystem::exists(getCheminPointControle()) && !rejouer(getCheminPointControle(), true, tailleValide))
+    {
+        std::cerr << "Erreur JournalMutations: le point de contrôle " << getCheminPointControle().string()
+                  << " est incomplet\n";
+        return false;
+    }
+
+    std::filesystem::path cheminJournal = getCheminJournal(generation_);
+    tailleValide = 0;
+    if (std::filesystem::exists(cheminJournal))
+    {
+        rejouer(cheminJournal, false, tailleValide);
+    }
+    mutationsDepuisPointControle_ = nombreMutationsRejouees_;
+
+    // Un point de contrôle interrompu après son renommage peut laisser le journal de la génération précédente
+    for (const std::filesystem::directory_entry& entree : std::filesystem::directory_iterator(dossier_, erreur))
+    {
+        std::string nom = entree.path().filename().string();
+        if (nom.rfind("journal_", 0) == 0 && entree.path() != cheminJournal)
+        {
+            std::filesystem::remove(entree.path(), erreur);
+        }
+    }
+
+    if (tailleValide > 0 && tailleValide < std::filesystem::file_size(cheminJournal, erreur))
+    {
+        std::filesystem::resize_file(cheminJournal, tailleValide, erreur);
+    }
+    return ouvrirJournal(tailleValide == 0);
+}
+
+/// Écrit les mutations en attente en un seul appel et les synchronise sur disque, puis crée un point de contrôle si
+/// assez de mutations ont été journalisées depuis le précédent. Si l'écriture ou la synchronisation échoue, le
+/// journal est tronqué à la fin du dernier groupe validé, pour qu'un enregistrement déchiré n'arrête pas le rejeu
+/// avant les groupes suivants, et le groupe reste en attente: le prochain appel réessaie de l'écrire.
+/// \return     True si les mutations en attente sont durables, false sinon.
+bool JournalMutations::valider()
+{
+    if (journal_ == nullptr)
+    {
+        return false;
+    }
+    if (tampon_.empty())
+    {
+        return true;
+    }
+    if (defaillant_ && !tronquerJournal())
+    {
+        return false;
+    }
+    bool succes = std::fwrite(tampon_.data(), 1, tampon_.size(), journal_) == tampon_.size() &&
+                  std::fflush(journal_) == 0 && (!options_.synchroniser || synchroniserFichier(journal_));
+    if (!succes)
+    {
+        std::cerr << "Erreur JournalMutations: le journal " << getCheminJournal(generation_).string()
+                  << " n'a pas pu être écrit\n";
+        defaillant_ = true;
+        tronquerJournal();
+        return false;
+    }
+    defaillant_ = false;
+    tailleValidee_ += tampon_.size();
+    tampon_.clear();
+    nombreEnAttente_ = 0;
+    nombreGroupesEcrits_++;
+    if (options_.mutationsParPointControle != 0 && mutationsDepuisPointControle_ >= options_.mutationsParPointControle)
+    {
+        return creerPointControle();
+    }
+    return true;
+}
+
+/// Écrit l'état complet dans un nouveau point de contrôle, qui remplace le précédent de manière atomique, puis
+/// commence un journal vide. Les mutations en attente font partie du point de contrôle et ne sont pas journalisées.
+/// \return     True si le point de contrôle a été créé, false sinon; le journal courant reste alors valide.
+bool JournalMutations::creerPointControle()
+{
+    if (journal_ == nullptr)
+    {
+        return false;
+    }
+    std::uint64_t generation = generation_ + 1;
+    std::filesystem::path temporaire = getCheminPointControle();
+    temporaire += ".tmp";
+    std::FILE* fichier = std::fopen(temporaire.string().c_str(), "wb");
+    if (fichier == nullptr)
+    {
+        std::cerr << "Erreur JournalMutations: le fichier " << temporaire.string() << " n'a pas pu être ouvert\n";
+        return false;
+    }
+
+    std::string contenu;
+    bool succes = true;
+    auto ecrireSiPlein = [&](bool forcer) {
+        if (forcer || contenu.size() >= octetsTamponPointControle)
+        {
+            succes = succes && std::fwrite(contenu.data(), 1, contenu.size(), fichier) == contenu.size();
+            contenu.clear();
+        }
+    };
+    ajouterEntete(generation, contenu);
+    for (const Film* film : gestionnaireFilms_.getFilms())
+    {
+        EcrivainEnregistrement enregistrement(TypeEnregistrement::AjoutFilm);
+        enregistrement.ecrire(*film);
+        enregistrement.terminer(contenu);
+        ecrireSiPlein(false);
+    }
+    for (const Utilisateur* utilisateur : gestionnaireUtilisateurs_.getUtilisateurs())
+    {
+        EcrivainEnregistrement enregistrement(TypeEnregistrement::AjoutUtilisateur);
+        enregistrement.ecrire(*utilisateur);
+        enregistrement.terminer(contenu);
+        ecrireSiPlein(false);
+    }
+    for (const LigneLog& ligneLog : analyseurLogs_.getLogs())
+    {
+        EcrivainEnregistrement enregistrement(TypeEnregistrement::CreationLigneLog);
+        enregistrement.ecrire(ligneLog.timestamp);
+        enregistrement.ecrire(ligneLog.utilisateur->id);
+        enregistrement.ecrire(ligneLog.film->nom);
+        enregistrement.terminer(contenu);
+        ecrireSiPlein(false);
+    }
+    EcrivainEnregistrement(TypeEnregistrement::Fin).terminer(contenu);
+    ecrireSiPlein(true);
+    succes = succes && std::fflush(fichier) == 0 && synchroniserFichier(fichier);
+    succes = std::fclose(fichier) == 0 && succes;
+
+    std::error_code erreur;
+    if (succes)
+    {
+        std::filesystem::rename(temporaire, getCheminPointControle(), erreur);
+    }
+    if (!succes || erreur)
+    {
+        std::cerr << "Erreur JournalMutations: le point de contrôle " << getCheminPointControle().string()
+                  << " n'a pas pu être écrit\n";
+        std::filesystem::remove(temporaire, erreur);
+        return false;
+    }
+    synchroniserDossier(dossier_);
+
+    fermerJournal();
+    std::filesystem::remove(getCheminJournal(generation_), erreur);
+    generation_ = generation;
+    tampon_.clear();
+    nombreEnAttente_ = 0;
+    mutationsDepuisPointControle_ = 0;
+    return ouvrirJournal(true);
+}
+
+/// Ajoute un film au gestionnaire et journalise l'ajout.
+/// \param film     Le film à ajouter.
+/// \return         True si le film a été ajouté et journalisé, false si un film du même nom existe déjà ou si le
+///                 journal n'a pas pu être écrit.
+bool JournalMutations::ajouterFilm(const Film& film)
+{
+    if (!accepterMutation() || !gestionnaireFilms_.ajouterFilm(film))
+    {
+        return false;
+    }
+    EcrivainEnregistrement enregistrement(TypeEnregistrement::AjoutFilm);
+    enregistrement.ecrire(film);
+    enregistrement.terminer(tampon_);
+    return journaliser();
+}
+
+/// Supprime un film du gestionnaire, avec ses lignes de log, et journalise la suppression.
+/// \param nomFilm  Le nom du film à supprimer.
+/// \return         True si le film a été supprimé et journalisé, false s'il est introuvable ou si le journal n'a pas
+///                 pu être écrit.
+bool JournalMutations::supprimerFilm(const std::string& nomFilm)
+{
+    if (!accepterMutation() || !appliquerSuppressionFilm(nomFilm))
+    {
+        return false;
+    }
+    EcrivainEnregistrement enregistrement(TypeEnregistrement::SuppressionFilm);
+    enregistrement.ecrire(nomFilm);
+    enregistrement.terminer(tampon_);
+    return journaliser();
+}
+
+/// Ajoute un utilisateur au gestionnaire et journalise l'ajout.
+/// \param utilisateur  L'utilisateur à ajouter.
+/// \return             True si l'utilisateur a été ajouté et journalisé, false si son id existe déjà ou si le
+///                     journal n'a pas pu être écrit.
+bool JournalMutations::ajouterUtilisateur(const Utilisateur& utilisateur)
+{
+    if (!accepterMutation() || !gestionnaireUtilisateurs_.ajouterUtilisateur(utilisateur))
+    {
+        return false;
+    }
+    EcrivainEnregistrement enregistrement(TypeEnregistrement::AjoutUtilisateur);
+    enregistrement.ecrire(utilisateur);
+    enregistrement.terminer(tampon_);
+    return journaliser();
+}
+
+/// Supprime un utilisateur du gestionnaire, avec ses lignes de log, et journalise la suppression.
+/// \param idUtilisateur    L'id de l'utilisateur à supprimer.
+/// \return                 True si l'utilisateur a été supprimé et journalisé, false s'il est introuvable ou si le
+///                         journal n'a pas pu être écrit.
+bool JournalMutations::supprimerUtilisateur(const std::string& idUtilisateur)
+{
+    if (!accepterMutation() || !appliquerSuppressionUtilisateur(idUtilisateur))
+    {
+        return false;
+    }
+    EcrivainEnregistrement enregistrement(TypeEnregistrement::SuppressionUtilisateur);
+    enregistrement.ecrire(idUtilisateur);
+    enregistrement.terminer(tampon_);
+    return journaliser();
+}
+
+/// Crée une ligne de log dans l'analyseur et journalise sa création.
+/// \param timestamp        La date à laquelle le film est regardé.
+/// \param idUtilisateur    L'id de l'utilisateur qui regarde le film.
+/// \param nomFilm          Le nom du film regardé.
+/// \return                 True si la ligne a été créée et journalisée, false si l'utilisateur ou le film est
+///                         introuvable ou si le journal n'a pas pu être écrit.
+bool JournalMutations::creerLigneLog(const std::string& timestamp,
+                                     const std::string& idUtilisateur,
+                                     const std::string& nomFilm)
+{
+    if (!accepterMutation() ||
+        !analyseurLogs_.creerLigneLog(timestamp, idUtilisateur, nomFilm, gestionnaireUtilisateurs_, gestionnaireFilms_))
+    {
+        return false;
+    }
+    EcrivainEnregistrement enregistrement(TypeEnregistrement::CreationLigneLog);
+    enregistrement.ecrire(timestamp);
+    enregistrement.ecrire(idUtilisateur);
+    enregistrement.ecrire(nomFilm);
+    enregistrement.terminer(tampon_);
+    return journaliser();
+}
+
+/// \return La génération du dernier point de contrôle, 0 s'il n'y en a aucun.
+std::uint64_t JournalMutations::getGeneration() const
+{
+    return generation_;
+}
+
+/// \return Le nombre de mutations du journal rejouées par le dernier appel à recuperer(), sans le point de contrôle.
+std::size_t JournalMutations::getNombreMutationsRejouees() const
+{
+    return nombreMutationsRejouees_;
+}
+
+/// \return Le nombre de groupes écrits dans le journal depuis la construction.
+std::size_t JournalMutations::getNombreGroupesEcrits() const
+{
+    return nombreGroupesEcrits_;
+}
+
+/// \return Le chemin du journal qui suit le point de contrôle d'une génération.
+std::filesystem::path JournalMutations::getCheminJournal(std::uint64_t generation) const
+{
+    return dossier_ / ("journal_" + std::to_string(generation) + ".bin");
+}
+
+/// \return Le chemin du dernier point de contrôle.
+std::filesystem::path JournalMutations::getCheminPointControle() const
+{
+    return dossier_ / "point_controle.bin";
+}
+
+/// Applique les enregistrements d'un point de contrôle ou d'un journal, jusqu'au premier enregistrement incomplet
+/// ou corrompu.
+/// \param chemin           Le fichier à rejouer.
+/// \param estPointControle True pour un point de contrôle, qui fixe la génération et doit se terminer par Fin.
+/// \param tailleValide     Le nombre d'octets des enregistrements appliqués; 0 pour un journal d'une autre
+///                         génération, qui est ignoré.
+/// \return                 False si un point de contrôle est incomplet, true sinon.
+bool JournalMutations::rejouer(const std::filesystem::path& chemin, bool estPointControle, std::uintmax_t& tailleValide)
+{
+    std::ifstream fichier(chemin, std::ios::binary);
+    std::string contenu((std::istreambuf_iterator<char>(fichier)), std::istreambuf_iterator<char>());
+
+    // Les ajouts consécutifs de même type sont appliqués par lots; un seul lot est non vide à la fois
+    std::vector<Film> films;
+    std::vector<Utilisateur> utilisateurs;
+    std::vector<AnalyseurLogs::EntreeLog> entreesLog;
+    auto appliquerLots = [&]() {
+        if (!films.empty())
+        {
+            gestionnaireFilms_.ajouterFilms(std::move(films));
+            films.clear();
+        }
+        if (!utilisateurs.empty())
+        {
+            gestionnaireUtilisateurs_.ajouterUtilisateurs(std::move(utilisateurs));
+            utilisateurs.clear();
+        }
+        if (!entreesLog.empty())
+        {
+            analyseurLogs_.creerLignesLog(std::move(entreesLog), gestionnaireUtilisateurs_, gestionnaireFilms_);
+            entreesLog.clear();
+        }
+    };
+
+    bool enteteLu = false;
+    bool finLue = false;
+    std::uint8_t typePrecedent = static_cast<std::uint8_t>(TypeEnregistrement::Entete);
+    std::size_t position = 0;
+    tailleValide = 0;
+    while (!finLue && contenu.size() - position >= tailleEntete)
+    {
+        std::uint32_t longueur = 0;
+        std::uint32_t somme = 0;
+        std::memcpy(&longueur, contenu.data() + position, sizeof(longueur));
+        std::memcpy(&somme, contenu.data() + position + sizeof(longueur), sizeof(somme));
+        const char* donnees = contenu.data() + position + tailleEntete;
+        if (contenu.size() - position - tailleEntete < longueur || calculerSomme(donnees, longueur) != somme)
+        {
+            break;
+        }
+
+        LecteurEnregistrement lecteur(donnees, longueur);
+        std::uint8_t type = 0;
+        bool valide = lecteur.lire(type) && (enteteLu || type == static_cast<std::uint8_t>(TypeEnregistrement::Entete));
+        if (type != typePrecedent)
+        {
+            appliquerLots();
+            typePrecedent = type;
+        }
+        switch (static_cast<TypeEnregistrement>(type))
+        {
+            case TypeEnregistrement::Entete:
+            {
+                std::uint32_t version = 0;
+                std::uint64_t generation = 0;
+                valide = valide && !enteteLu && lecteur.lire(version) && lecteur.lire(generation) &&
+                         version == versionFormat;
+                if (valide && estPointControle)
+                {
+                    generation_ = generation;
+                }
+                else if (valide && generation != generation_)
+                {
+                    return true;
+                }
+                enteteLu = true;
+                break;
+            }
+            case TypeEnregistrement::AjoutFilm:
+            {
+                Film film;
+                valide = valide && lecteur.lire(film);
+                if (valide)
+                {
+                    films.push_back(std::move(film));
+                }
+                break;
+            }
+            case TypeEnregistrement::SuppressionFilm:
+            {
+                std::string nomFilm;
+                valide = valide && lecteur.lire(nomFilm);
+                if (valide)
+                {
+                    appliquerSuppressionFilm(nomFilm);
+                }
+                break;
+            }
+            case TypeEnregistrement::AjoutUtilisateur:
+            {
+                Utilisateur utilisateur;
+                valide = valide && lecteur.lire(utilisateur);
+                if (valide)
+                {
+                    utilisateurs.push_back(std::move(utilisateur));
+                }
+                break;
+            }
+            case TypeEnregistrement::SuppressionUtilisateur:
+            {
+                std::string idUtilisateur;
+                valide = valide && lecteur.lire(idUtilisateur);
+                if (valide)
+                {
+                    appliquerSuppressionUtilisateur(idUtilisateur);
+                }
+                break;
+            }
+            case TypeEnregistrement::CreationLigneLog:
+            {
+                AnalyseurLogs::EntreeLog entreeLog;
+                valide = valide && lecteur.lire(entreeLog.timestamp) && lecteur.lire(entreeLog.idUtilisateur) &&
+                         lecteur.lire(entreeLog.nomFilm);
+                if (valide)
+                {
+                    entreesLog.push_back(std::move(entreeLog));
+                }
+                break;
+            }
+            case TypeEnregistrement::Fin:
+                valide = valide && estPointControle;
+                finLue = valide;
+                break;
+            default:
+                valide = false;
+                break;
+        }
+        if (!valide)
+        {
+            break;
+        }
+        if (!estPointControle && type != static_cast<std::uint8_t>(TypeEnregistrement::Entete))
+        {
+            nombreMutationsRejouees_++;
+        }
+        position += tailleEntete + longueur;
+        tailleValide = position;
+    }
+    appliquerLots();
+    return !estPointControle || finLue;
+}
+
+/// Supprime un film du gestionnaire après avoir retiré ses lignes de l'analyseur, qui ne doivent pas survivre au film
+/// qu'elles désignent.
+/// \param nomFilm  Le nom du film à supprimer.
+/// \return         True si le film a été supprimé, false s'il est introuvable.
+bool JournalMutations::appliquerSuppressionFilm(const std::string& nomFilm)
+{
+    const Film* film = gestionnaireFilms_.getFilmParNom(nomFilm);
+    if (film == nullptr)
+    {
+        return false;
+    }
+    analyseurLogs_.retirerLignesFilms({film});
+    return gestionnaireFilms_.supprimerFilm(nomFilm);
+}
+
+/// Supprime un utilisateur du gestionnaire après avoir retiré ses lignes de l'analyseur, qui ne doivent pas survivre
+/// à l'utilisateur qu'elles désignent.
+/// \param idUtilisateur    L'id de l'utilisateur à supprimer.
+/// \return                 True si l'utilisateur a été supprimé, false s'il est introuvable.
+bool JournalMutations::appliquerSuppressionUtilisateur(const std::string& idUtilisateur)
+{
+    const Utilisateur* utilisateur = gestionnaireUtilisateurs_.getUtilisateurParId(idUtilisateur);
+    if (utilisateur == nullptr)
+    {
+        return false;
+    }
+    analyseurLogs_.retirerLignesUtilisateurs({utilisateur});
+    return gestionnaireUtilisateurs_.supprimerUtilisateur(idUtilisateur);
+}
+
+/// Ouvre le journal de la génération courante en ajout.
+/// \param tronquer True pour recommencer un journal vide, qui reçoit alors son entête.
+/// \return         True si le journal est ouvert, false sinon.
+bool JournalMutations::ouvrirJournal(bool tronquer)
+{
+    // Toujours en ajout, pour que l'écriture qui suit une troncature reprenne à la nouvelle fin du journal
+    journal_ = std::fopen(getCheminJournal(generation_).string().c_str(), "ab");
+    std::error_code erreur;
+    if (journal_ != nullptr && tronquer)
+    {
+        std::filesystem::resize_file(getCheminJournal(generation_), 0, erreur);
+    }
+    if (journal_ == nullptr || erreur)
+    {
+        std::cerr << "Erreur JournalMutations: le journal " << getCheminJournal(generation_).string()
+                  << " n'a pas pu être ouvert\n";
+        fermerJournal();
+        return false;
+    }
+    // Chaque groupe est écrit en un seul appel; sans tampon stdio, un échec n'en garde aucune partie à écrire plus tard
+    std::setvbuf(journal_, nullptr, _IONBF, 0);
+    defaillant_ = false;
+    tailleValidee_ = std::filesystem::file_size(getCheminJournal(generation_), erreur);
+    if (tronquer)
+    {
+        ajouterEntete(generation_, tampon_);
+        return valider();
+    }
+    return true;
+}
+
+/// Ferme le journal sans valider le groupe en cours.
+void JournalMutations::fermerJournal()
+{
+    if (journal_ != nullptr)
+    {
+        std::fclose(journal_);
+        journal_ = nullptr;
+    }
+}
+
+/// Ramène le journal à la fin du dernier groupe validé, après une écriture qui a échoué.
+/// \return True si le journal a été tronqué, false sinon.
+bool JournalMutations::tronquerJournal()
+{
+    std::clearerr(journal_);
+    std::error_code erreur;
+    std::filesystem::resize_file(getCheminJournal(generation_), tailleValidee_, erreur);
+    return !erreur;
+}
+
+/// Vérifie qu'une mutation peut être journalisée: après un échec d'écriture, les mutations sont refusées tant que le
+/// groupe en attente n'a pas pu être validé.
+/// \return True si la mutation peut être appliquée, false sinon.
+bool JournalMutations::accepterMutation()
+{
+    return !defaillant_ || valider();
+}
+
+/// Compte la mutation qui vient d'être ajoutée au tampon et valide le groupe s'il est plein.
+/// \return True si la mutation est en attente ou validée, false si son groupe n'a pas pu être écrit; elle reste alors
+///         appliquée et en attente, et valider() réessaiera de l'écrire.
+bool JournalMutations::journaliser()
+{
+    nombreEnAttente_++;
+    mutationsDepuisPointControle_++;
+    if (nombreEnAttente_ >= options_.tailleGroupe)
+    {
+        return valider();
+    }
+    return true;
+}
@@ -0,0 +1,430 @@
+/// Stockage compressé en blocs des lignes de log triées.
+
+#include "LogsCompresses.h"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include "ColonnesLogs.h"
+#include "Foncteurs.h"
+#include "Horodatage.h"
+#include "NoyauxColonnes.h"
+
+namespace
+{
+    // Octets nuls ajoutés après le dernier bloc pour que le dépaquetage puisse toujours lire un mot de 64 bits
+    constexpr std::size_t octetsGarde = 8;
+
+    /// \return Le nombre de bits nécessaires pour représenter une valeur, 0 pour 0.
+    unsigned int getBitsNecessaires(std::uint32_t valeur)
+    {
+        unsigned int bits = 0;
+        for (; valeur != 0; valeur >>= 1)
+        {
+            bits++;
+        }
+        return bits;
+    }
+
+    /// Écrit un entier non signé en varint: 7 bits par octet, le bit de poids fort indiquant qu'un octet suit.
+    void ecrireVarint(std::uint64_t valeur, std::vector<std::uint8_t>& sortie)
+    {
+        while (valeur >= 0x80)
+        {
+            sortie.push_back(static_cast<std::uint8_t>(valeur | 0x80));
+            valeur >>= 7;
+        }
+        sortie.push_back(static_cast<std::uint8_t>(valeur));
+    }
+
+    /// Lit un entier écrit par ecrireVarint.
+    /// \return La position suivant le dernier octet lu.
+    const std::uint8_t* lireVarint(const std::uint8_t* donnees, std::uint64_t& valeur)
+    {
+        valeur = 0;
+        for (unsigned int decalage = 0;; decalage += 7)
+        {
+            std::uint8_t octet = *donnees++;
+            valeur |= static_cast<std::uint64_t>(octet & 0x7F) << decalage;
+            if ((octet & 0x80) == 0)
+            {
+                return donnees;
+            }
+        }
+    }
+
+    /// Empaquète valeur - minimum sur bits bits par valeur, en commençant par les bits de poids faible.
+    void empaqueter(const std::uint32_t* valeurs,
+                    std::size_t nombre,
+                    std::uint32_t minimum,
+                    unsigned int bits,
+                    std::vector<std::uint8_t>& sortie)
+    {
+        std::uint64_t accumulateur = 0;
+        unsigned int bitsAccumules = 0;
+        for (std::size_t i = 0; i < nombre; i++)
+        {
+            accumulateur |= static_cast<std::uint64_t>(valeurs[i] - minimum) << bitsAccumules;
+            for (bitsAccumules += bits; bitsAccumules >= 8; bitsAccumules -= 8)
+            {
+                sortie.push_back(static_cast<std::uint8_t>(accumulateur));
+                accumulateur >>= 8;
+            }
+        }
+        if (bitsAccumules > 0)
+        {
+            sortie.push_back(static_cast<std::uint8_t>(accumulateur));
+        }
+    }
+
+    /// Dépaquète des valeurs écrites par empaqueter. Les huit octets qui suivent les données doivent être lisibles.
+    void depaqueter(const std::uint8_t* donnees,
+                    std::size_t nombre,
+                    std::uint32_t minimum,
+                    unsigned int bits,
+                    std::uint32_t* valeurs)
+    {
+        if (bits == 0)
+        {
+            std::fill(valeurs, valeurs + nombre, minimum);
+            return;
+        }
+        std::uint64_t masque = (std::uint64_t(1) << bits) - 1;
+        for (std::size_t i = 0; i < nombre; i++)
+        {
+            std::size_t position = i * bits;
+            const std::uint8_t* octets = donnees + position / 8;
+            std::uint64_t mot = 0;
+            for (unsigned int octet = 0; octet < 8; octet++)
+            {
+                mot |= static_cast<std::uint64_t>(octets[octet]) << (8 * octet);
+            }
+            valeurs[i] = minimum + static_cast<std::uint32_t>((mot >> (position % 8)) & masque);
+        }
+    }
+
+    /// Trie et dédoublonne des pointeurs pour en faire un dictionnaire d'identifiants denses.
+    template<typename T>
+    void trierSansDoublons(std::vector<const T*>& elements)
+    {
+        std::sort(elements.begin(), elements.end());
+        elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+        elements.shrink_to_fit();
+    }
+
+    /// Associe chaque élément d'un dictionnaire trié à son identifiant dense, pour la durée de la compression.
+    template<typename T>
+    std::unordered_map<const T*, std::uint32_t> indexer(const std::vector<const T*>& elements)
+    {
+        std::unordered_map<const T*, std::uint32_t> ids;
+        ids.reserve(elements.size());
+        for (std::size_t i = 0; i < elements.size(); i++)
+        {
+            ids.emplace(elements[i], static_cast<std::uint32_t>(i));
+        }
+        return ids;
+    }
+
+    /// Recherche l'identifiant dense d'un élément par recherche binaire dans un dictionnaire trié.
+    /// \return L'identifiant, ou std::nullopt si l'élément n'apparaît dans aucune ligne compressée.
+    template<typename T>
+    std::optional<std::uint32_t> getId(const T* element, const std::vector<const T*>& elements)
+    {
+        auto it = std::lower_bound(elements.begin(), elements.end(), element);
+        if (it == elements.end() || *it != element)
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::uint32_t>(it - elements.begin());
+    }
+} // namespace
+
+/// Constructeur qui compresse des lignes de log, de préférence triées par timestamp: les différences d'instants sont
+/// alors petites et les intervalles des en-têtes de blocs ne se chevauchent pas.
+/// \param logs     Les lignes de log à compresser.
+LogsCompresses::LogsCompresses(const std::vector<LigneLog>& logs)
+{
+    // Premier passage: instants et dictionnaires, triés par adresse pour que la recherche d'un identifiant ne
+    // demande pas de table de hachage une fois la compression terminée
+    std::vector<std::int64_t> instants;
+    instants.reserve(logs.size());
+    char timestamp[longueurTimestamp];
+    for (const LigneLog& ligneLog : logs)
+    {
+        std::optional<std::int64_t> instant = convertirTimestamp(ligneLog.timestamp);
+        if (instant)
+        {
+            formaterTimestamp(*instant, timestamp);
+        }
+        if (!instant || ligneLog.timestamp.compare(0, std::string::npos, timestamp, longueurTimestamp) != 0)
+        {
+            instants.push_back(ColonnesLogs::secondesInvalides);
+            lignesNonCompressees_.push_back(ligneLog);
+            continue;
+        }
+        instants.push_back(*instant);
+        utilisateurs_.push_back(ligneLog.utilisateur);
+        films_.push_back(ligneLog.film);
+    }
+    trierSansDoublons(utilisateurs_);
+    trierSansDoublons(films_);
+    std::unordered_map<const Utilisateur*, std::uint32_t> idsUtilisateurs = indexer(utilisateurs_);
+    std::unordered_map<const Film*, std::uint32_t> idsFilms = indexer(films_);
+
+    // Second passage: encodage des blocs
+    std::array<std::int64_t, tailleBloc> secondes;
+    std::array<std::uint32_t, tailleBloc> utilisateurs;
+    std::array<std::uint32_t, tailleBloc> films;
+    std::size_t nombre = 0;
+    for (std::size_t i = 0; i < logs.size(); i++)
+    {
+        if (instants[i] == ColonnesLogs::secondesInvalides)
+        {
+            continue;
+        }
+        secondes[nombre] = instants[i];
+        utilisateurs[nombre] = idsUtilisateurs[logs[i].utilisateur];
+        films[nombre] = idsFilms[logs[i].film];
+        if (++nombre == tailleBloc)
+        {
+            ajouterBloc(secondes.data(), utilisateurs.data(), films.data(), nombre);
+            nombre = 0;
+        }
+    }
+    if (nombre > 0)
+    {
+        ajouterBloc(secondes.data(), utilisateurs.data(), films.data(), nombre);
+    }
+    donnees_.insert(donnees_.end(), octetsGarde, 0);
+
+    blocs_.shrink_to_fit();
+    donnees_.shrink_to_fit();
+    lignesNonCompressees_.shrink_to_fit();
+}
+
+/// \return Le nombre de lignes conservées, compressées ou non.
+std::size_t LogsCompresses::getTaille() const
+{
+    std::size_t nombreLignes = lignesNonCompressees_.size();
+    if (!blocs_.empty())
+    {
+        nombreLignes += (blocs_.size() - 1) * tailleBloc + blocs_.back().nombreLignes;
+    }
+    return nombreLignes;
+}
+
+/// \return Le nombre de blocs compressés.
+std::size_t LogsCompresses::getNombreBlocs() const
+{
+    return blocs_.size();
+}
+
+/// \return Le nombre moyen d'octets alloués sur le tas par ligne, en-têtes et dictionnaires d'identifiants compris.
+double LogsCompresses::getOctetsParLigne() const
+{
+    std::size_t taille = getTaille();
+    return taille == 0 ? 0.0 : static_cast<double>(getUtilisationMemoire().getTotal()) / static_cast<double>(taille);
+}
+
+/// Décompresse toutes les lignes. Si les lignes compressées étaient triées, le résultat leur est identique.
+/// \return Les lignes de log, triées par timestamp.
+std::vector<LigneLog> LogsCompresses::decompresser() const
+{
+    std::vector<LigneLog> lignesLog;
+    lignesLog.reserve(getTaille());
+    std::array<std::int64_t, tailleBloc> secondes;
+    std::array<std::uint32_t, tailleBloc> utilisateurs;
+    std::array<std::uint32_t, tailleBloc> films;
+    for (const EnteteBloc& bloc : blocs_)
+    {
+        decoderSecondes(bloc, secondes.data());
+        decoderUtilisateurs(bloc, utilisateurs.data());
+        decoderFilms(bloc, films.data());
+        for (std::size_t i = 0; i < bloc.nombreLignes; i++)
+        {
+            lignesLog.push_back(
+                LigneLog{formaterTimestamp(secondes[i]), utilisateurs_[utilisateurs[i]], films_[films[i]]});
+        }
+    }
+
+    auto milieu = static_cast<std::ptrdiff_t>(lignesLog.size());
+    lignesLog.insert(lignesLog.end(), lignesNonCompressees_.begin(), lignesNonCompressees_.end());
+    std::inplace_merge(lignesLog.begin(), lignesLog.begin() + milieu, lignesLog.end(), ComparateurLog());
+    return lignesLog;
+}
+
+/// \return Le rapport des octets alloués sur le tas par chaque membre.
+UtilisationMemoire LogsCompresses::getUtilisationMemoire() const
+{
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("blocs_", blocs_.capacity() * sizeof(EnteteBloc));
+    utilisationMemoire.ajouter("donnees_", octetsTas(donnees_));
+    utilisationMemoire.ajouter("utilisateurs_", octetsTas(utilisateurs_));
+    utilisationMemoire.ajouter("films_", octetsTas(films_));
+    utilisationMemoire.ajouter("lignesNonCompressees_", octetsTas(lignesNonCompressees_));
+    return utilisationMemoire;
+}
+
+/// Retourne le nombre de vues d'un film dans un intervalle de temps. Les blocs dont l'intervalle d'instants ou de
+/// films exclut la requête ne sont pas décodés, et les instants ne sont décodés que pour les blocs à cheval sur une
+/// borne de l'intervalle. Les lignes non compressées sont comptées selon l'instant de leur timestamp, comme dans
+/// AnalyseurLogs, s'il peut être interprété.
+/// \param film     Le film dont on veut le nombre de vues
+/// \param debut    Le timestamp du début (inclus) de l'intervalle
+/// \param fin      Le timestamp de la fin (exclue) de l'intervalle
+/// \return         Le nombre de vues dans l'intervalle, ou 0 si un des timestamps est mal formé
+int LogsCompresses::getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const
+{
+    std::optional<std::int64_t> secondesDebut = convertirTimestamp(debut);
+    std::optional<std::int64_t> secondesFin = convertirTimestamp(fin);
+    if (!secondesDebut || !secondesFin)
+    {
+        return 0;
+    }
+
+    std::size_t nombreVues = 0;
+    for (const LigneLog& ligneLog : lignesNonCompressees_)
+    {
+        if (ligneLog.film == film)
+        {
+            std::optional<std::int64_t> instant = convertirTimestamp(ligneLog.timestamp);
+            nombreVues += instant && *instant >= *secondesDebut && *instant < *secondesFin;
+        }
+    }
+    std::optional<std::uint32_t> idFilm = getId(film, films_);
+    if (!idFilm)
+    {
+        return static_cast<int>(nombreVues);
+    }
+
+    std::array<std::int64_t, tailleBloc> secondes;
+    std::array<std::uint32_t, tailleBloc> films;
+    for (const EnteteBloc& bloc : blocs_)
+    {
+        if (bloc.secondesMax < *secondesDebut || bloc.secondesMin >= *secondesFin || *idFilm < bloc.filmMin ||
+            *idFilm > bloc.filmMax)
+        {
+            continue;
+        }
+        decoderFilms(bloc, films.data());
+        if (bloc.secondesMin >= *secondesDebut && bloc.secondesMax < *secondesFin)
+        {
+            nombreVues += NoyauxColonnes::compterEgal(films.data(), bloc.nombreLignes, *idFilm);
+        }
+        else
+        {
+            decoderSecondes(bloc, secondes.data());
+            nombreVues += NoyauxColonnes::compterEgalDansIntervalle(
+                films.data(), secondes.data(), bloc.nombreLignes, *idFilm, *secondesDebut, *secondesFin);
+        }
+    }
+    return static_cast<int>(nombreVues);
+}
+
+/// Retourne le nombre de vues total pour un utilisateur. Seule la colonne des utilisateurs des blocs dont
+/// l'intervalle d'identifiants contient l'utilisateur est décodée.
+/// \param utilisateur      L'utilisateur dont on veut savoir le nombre de vues
+/// \return                 Le nombre de vues de l'utilisateur
+int LogsCompresses::getNombreVuesPourUtilisateur(const Utilisateur* utilisateur) const
+{
+    std::size_t nombreVues = static_cast<std::size_t>(
+        std::count_if(lignesNonCompressees_.begin(), lignesNonCompressees_.end(), [utilisateur](const LigneLog& ligneLog) {
+            return ligneLog.utilisateur == utilisateur;
+        }));
+    std::optional<std::uint32_t> idUtilisateur = getId(utilisateur, utilisateurs_);
+    if (!idUtilisateur)
+    {
+        return static_cast<int>(nombreVues);
+    }
+
+    std::array<std::uint32_t, tailleBloc> utilisateurs;
+    for (const EnteteBloc& bloc : blocs_)
+    {
+        if (*idUtilisateur >= bloc.utilisateurMin && *idUtilisateur <= bloc.utilisateurMax)
+        {
+            decoderUtilisateurs(bloc, utilisateurs.data());
+            nombreVues += NoyauxColonnes::compterEgal(utilisateurs.data(), bloc.nombreLignes, *idUtilisateur);
+        }
+    }
+    return static_cast<int>(nombreVues);
+}
+
+/// Encode un bloc à la fin de donnees_ et ajoute son en-tête.
+/// \param secondes         Les instants des lignes du bloc.
+/// \param utilisateurs     Les identifiants denses des utilisateurs.
+/// \param films            Les identifiants denses des films.
+/// \param nombre           Le nombre de lignes, au plus tailleBloc.
+void LogsCompresses::ajouterBloc(const std::int64_t* secondes,
+                                 const std::uint32_t* utilisateurs,
+                                 const std::uint32_t* films,
+                                 std::size_t nombre)
+{
+    EnteteBloc bloc;
+    bloc.secondesMin = *std::min_element(secondes, secondes + nombre);
+    bloc.secondesMax = *std::max_element(secondes, secondes + nombre);
+    auto [utilisateurMin, utilisateurMax] = std::minmax_element(utilisateurs, utilisateurs + nombre);
+    bloc.utilisateurMin = *utilisateurMin;
+    bloc.utilisateurMax = *utilisateurMax;
+    auto [filmMin, filmMax] = std::minmax_element(films, films + nombre);
+    bloc.filmMin = *filmMin;
+    bloc.filmMax = *filmMax;
+    bloc.decalage = donnees_.size();
+    bloc.nombreLignes = static_cast<std::uint8_t>(nombre);
+    bloc.bitsUtilisateur = static_cast<std::uint8_t>(getBitsNecessaires(bloc.utilisateurMax - bloc.utilisateurMin));
+    bloc.bitsFilm = static_cast<std::uint8_t>(getBitsNecessaires(bloc.filmMax - bloc.filmMin));
+
+    // Différences successives à partir du minimum, en zigzag pour rester petites si les lignes ne sont pas triées
+    std::uint64_t precedent = static_cast<std::uint64_t>(bloc.secondesMin);
+    for (std::size_t i = 0; i < nombre; i++)
+    {
+        auto difference = static_cast<std::int64_t>(static_cast<std::uint64_t>(secondes[i]) - precedent);
+        ecrireVarint((static_cast<std::uint64_t>(difference) << 1) ^ static_cast<std::uint64_t>(difference >> 63),
+                     donnees_);
+        precedent = static_cast<std::uint64_t>(secondes[i]);
+    }
+    bloc.octetsSecondes = static_cast<std::uint16_t>(donnees_.size() - bloc.decalage);
+
+    empaqueter(utilisateurs, nombre, bloc.utilisateurMin, bloc.bitsUtilisateur, donnees_);
+    empaqueter(films, nombre, bloc.filmMin, bloc.bitsFilm, donnees_);
+    blocs_.push_back(bloc);
+}
+
+/// Décode les instants d'un bloc.
+/// \param bloc         L'en-tête du bloc.
+/// \param secondes     Le tableau d'au moins bloc.nombreLignes éléments dans lequel écrire les instants.
+void LogsCompresses::decoderSecondes(const EnteteBloc& bloc, std::int64_t* secondes) const
+{
+    const std::uint8_t* donnees = donnees_.data() + bloc.decalage;
+    std::uint64_t precedent = static_cast<std::uint64_t>(bloc.secondesMin);
+    for (std::size_t i = 0; i < bloc.nombreLignes; i++)
+    {
+        std::uint64_t zigzag;
+        donnees = lireVarint(donnees, zigzag);
+        precedent += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        secondes[i] = static_cast<std::int64_t>(precedent);
+    }
+}
+
+/// Décode les identifiants d'utilisateurs d'un bloc.
+/// \param bloc             L'en-tête du bloc.
+/// \param utilisateurs     Le tableau d'au moins bloc.nombreLignes éléments dans lequel écrire les identifiants.
+void LogsCompresses::decoderUtilisateurs(const EnteteBloc& bloc, std::uint32_t* utilisateurs) const
+{
+    depaqueter(donnees_.data() + bloc.decalage + bloc.octetsSecondes,
+               bloc.nombreLignes,
+               bloc.utilisateurMin,
+               bloc.bitsUtilisateur,
+               utilisateurs);
+}
+
+/// Décode les identifiants de films d'un bloc.
+/// \param bloc     L'en-tête du bloc.
+/// \param films    Le tableau d'au moins bloc.nombreLignes éléments dans lequel écrire les identifiants.
+void LogsCompresses::decoderFilms(const EnteteBloc& bloc, std::uint32_t* films) const
+{
+    std::size_t octetsUtilisateurs = (std::size_t(bloc.nombreLignes) * bloc.bitsUtilisateur + 7) / 8;
+    depaqueter(donnees_.data() + bloc.decalage + bloc.octetsSecondes + octetsUtilisateurs,
+               bloc.nombreLignes,
+               bloc.filmMin,
+               bloc.bitsFilm,
+               films);
+}
@@ -0,0 +1,351 @@
+/// Stockage des lignes de log optimisé pour l'écriture, pour les lignes qui arrivent dans le désordre.
+
+#include "LogsLSM.h"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <queue>
+#include "Horodatage.h"
+
+namespace
+{
+    using Sequence = LogsLSM::Sequence;
+
+    /// Fusionne des séquences triées en une seule séquence triée.
+    /// \param sequences    Les séquences à fusionner.
+    /// \return             La séquence fusionnée.
+    Sequence fusionnerSequences(const std::vector<const Sequence*>& sequences)
+    {
+        std::size_t taille = 0;
+        for (const Sequence* sequence : sequences)
+        {
+            taille += sequence->size();
+        }
+        Sequence fusionnee;
+        fusionnee.reserve(taille);
+
+        using Tete = std::pair<Sequence::const_iterator, std::size_t>; // Position et index de la séquence
+        auto apres = [](const Tete& tete1, const Tete& tete2) {
+            return tete2.first->timestamp < tete1.first->timestamp;
+        };
+        std::priority_queue<Tete, std::vector<Tete>, decltype(apres)> tetes(apres);
+        for (std::size_t i = 0; i < sequences.size(); i++)
+        {
+            if (!sequences[i]->empty())
+            {
+                tetes.emplace(sequences[i]->begin(), i);
+            }
+        }
+        while (!tetes.empty())
+        {
+            Tete tete = tetes.top();
+            tetes.pop();
+            fusionnee.push_back(*tete.first);
+            if (++tete.first != sequences[tete.second]->end())
+            {
+                tetes.push(tete);
+            }
+        }
+        return fusionnee;
+    }
+} // namespace
+
+/// Constructeur qui démarre le thread de compaction.
+/// \param tailleMemtable       Le nombre de lignes de la memtable avant qu'elle ne devienne une séquence.
+/// \param facteurCompaction    Le nombre de séquences d'un niveau fusionnées ensemble, au moins 2.
+LogsLSM::LogsLSM(std::size_t tailleMemtable, std::size_t facteurCompaction)
+    : tailleMemtable_(std::max<std::size_t>(tailleMemtable, 1))
+    , facteurCompaction_(std::max<std::size_t>(facteurCompaction, 2))
+    , threadCompaction_(&LogsLSM::compacter, this)
+{
+}
+
+/// Destructeur qui arrête le thread de compaction. Une compaction en cours est menée à terme.
+LogsLSM::~LogsLSM()
+{
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        arreter_ = true;
+    }
+    conditionCompaction_.notify_one();
+    threadCompaction_.join();
+}
+
+/// Constructeur par copie: les lignes sont reprises en une seule séquence, déjà fusionnée.
+/// \param other    Le stockage à copier.
+LogsLSM::LogsLSM(const LogsLSM& other) : LogsLSM(other.tailleMemtable_, other.facteurCompaction_)
+{
+    *this = other;
+}
+
+/// Opérateur d'assignation: les lignes sont reprises en une seule séquence et une compaction en cours est abandonnée.
+/// \param other    Le stockage à copier.
+/// \return         Référence à l'objet actuel.
+LogsLSM& LogsLSM::operator=(const LogsLSM& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    Sequence lignes = other.getLogs();
+    std::lock_guard<std::mutex> verrou(mutex_);
+    tailleMemtable_ = other.tailleMemtable_;
+    facteurCompaction_ = other.facteurCompaction_;
+    memtable_.clear();
+    sequences_.clear();
+    vuesFilms_.clear();
+    for (const LigneLog& ligneLog : lignes)
+    {
+        vuesFilms_[ligneLog.film]++;
+    }
+    if (!lignes.empty())
+    {
+        sequences_.push_back(std::make_shared<const Sequence>(std::move(lignes)));
+    }
+    return *this;
+}
+
+/// Ajoute une ligne de log à la memtable, qui devient une séquence lorsqu'elle est pleine.
+/// \param ligneLog     La ligne de log à ajouter, de n'importe quel timestamp.
+void LogsLSM::ajouterLigneLog(const LigneLog& ligneLog)
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    memtable_.insert(ligneLog);
+    vuesFilms_[ligneLog.film]++;
+    if (memtable_.size() >= tailleMemtable_)
+    {
+        viderMemtable();
+    }
+}
+
+/// Oublie toutes les lignes. Le résultat d'une compaction en cours est abandonné.
+void LogsLSM::vider()
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    memtable_.clear();
+    sequences_.clear();
+    vuesFilms_.clear();
+}
+
+/// Attend qu'aucune compaction ne soit possible ni en cours, par exemple pour mesurer le nombre de séquences.
+void LogsLSM::attendreCompactions()
+{
+    std::unique_lock<std::mutex> verrou(mutex_);
+    std::vector<std::shared_ptr<const Sequence>> aFusionner;
+    conditionTerminee_.wait(verrou, [&] { return !compactionEnCours_ && !choisirCompaction(aFusionner); });
+}
+
+/// Retourne toutes les lignes, fusionnées dans l'ordre des timestamps.
+/// \return Les lignes de la memtable et de toutes les séquences.
+std::vector<LigneLog> LogsLSM::getLogs() const
+{
+    std::vector<std::shared_ptr<const Sequence>> sequences;
+    Sequence memtable;
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        sequences = sequences_;
+        memtable.assign(memtable_.begin(), memtable_.end());
+    }
+    std::vector<const Sequence*> aFusionner = {&memtable};
+    for (const std::shared_ptr<const Sequence>& sequence : sequences)
+    {
+        aFusionner.push_back(sequence.get());
+    }
+    return fusionnerSequences(aFusionner);
+}
+
+/// \return Le nombre de lignes conservées.
+std::size_t LogsLSM::getTaille() const
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    std::size_t taille = memtable_.size();
+    for (const std::shared_ptr<const Sequence>& sequence : sequences_)
+    {
+        taille += sequence->size();
+    }
+    return taille;
+}
+
+/// Retourne le nombre de lignes dont le timestamp précède une limite, par recherche binaire dans chaque séquence.
+/// \param timestamp    La limite, exclue.
+/// \return             Le nombre de lignes antérieures à la limite.
+std::size_t LogsLSM::getNombreLignesAvant(const std::string& timestamp) const
+{
+    LigneLog limite{timestamp, nullptr, nullptr};
+    std::lock_guard<std::mutex> verrou(mutex_);
+    auto nombreLignes = static_cast<std::size_t>(std::distance(memtable_.begin(), memtable_.lower_bound(limite)));
+    for (const std::shared_ptr<const Sequence>& sequence : sequences_)
+    {
+        nombreLignes += static_cast<std::size_t>(
+            std::lower_bound(sequence->begin(), sequence->end(), limite, ComparateurLog()) - sequence->begin());
+    }
+    return nombreLignes;
+}
+
+/// \return Le nombre de séquences immuables, sans compter la memtable.
+std::size_t LogsLSM::getNombreSequences() const
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    return sequences_.size();
+}
+
+/// \return Le nombre de compactions terminées depuis la construction.
+std::size_t LogsLSM::getNombreCompactions() const
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    return nombreCompactions_;
+}
+
+/// Retourne les octets alloués sur le tas par la memtable, les séquences et les vues par film.
+/// \return                 Le rapport d'utilisation mémoire
+UtilisationMemoire LogsLSM::getUtilisationMemoire() const
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    std::size_t octetsMemtable = memtable_.size() * tailleNoeudArbre<LigneLog>;
+    for (const LigneLog& ligneLog : memtable_)
+    {
+        octetsMemtable += octetsTas(ligneLog);
+    }
+    std::size_t octetsSequences = sequences_.capacity() * sizeof(std::shared_ptr<const Sequence>);
+    for (const std::shared_ptr<const Sequence>& sequence : sequences_)
+    {
+        octetsSequences += octetsTas(sequence);
+    }
+
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("memtable_", octetsMemtable);
+    utilisationMemoire.ajouter("sequences_", octetsSequences);
+    utilisationMemoire.ajouter("vuesFilms_", octetsTas(vuesFilms_));
+    return utilisationMemoire;
+}
+
+/// Retourne le nombre de vues d'un film, tenu à jour à chaque insertion.
+/// \param film     Le film dont on veut le nombre de vues
+/// \return         Le nombre de vues du film
+int LogsLSM::getNombreVuesFilm(const Film* film) const
+{
+    std::lock_guard<std::mutex> verrou(mutex_);
+    auto vues = vuesFilms_.find(film);
+    return vues != vuesFilms_.end() ? vues->second : 0;
+}
+
+/// Retourne le nombre de vues d'un film dans un intervalle de temps. L'intervalle est trouvé par recherche binaire
+/// dans la memtable et dans chaque séquence.
+/// \param film     Le film dont on veut le nombre de vues
+/// \param debut    Le timestamp du début (inclus) de l'intervalle
+/// \param fin      Le timestamp de la fin (exclue) de l'intervalle
+/// \return         Le nombre de vues dans l'intervalle, ou 0 si un des timestamps est mal formé
+int LogsLSM::getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const
+{
+    std::optional<std::int64_t> secondesDebut = convertirTimestamp(debut);
+    std::optional<std::int64_t> secondesFin = convertirTimestamp(fin);
+    if (!secondesDebut || !secondesFin)
+    {
+        return 0;
+    }
+    // Les timestamps canoniques se comparent comme les instants qu'ils représentent
+    LigneLog ligneDebut{formaterTimestamp(*secondesDebut), nullptr, nullptr};
+    LigneLog ligneFin{formaterTimestamp(*secondesFin), nullptr, nullptr};
+    auto estDuFilm = [film](const LigneLog& ligneLog) {
+        return ligneLog.film == film;
+    };
+
+    std::vector<std::shared_ptr<const Sequence>> sequences;
+    int nombreVues = 0;
+    {
+        std::lock_guard<std::mutex> verrou(mutex_);
+        sequences = sequences_;
+        nombreVues += static_cast<int>(
+            std::count_if(memtable_.lower_bound(ligneDebut), memtable_.lower_bound(ligneFin), estDuFilm));
+    }
+    for (const std::shared_ptr<const Sequence>& sequence : sequences)
+    {
+        auto premier = std::lower_bound(sequence->begin(), sequence->end(), ligneDebut, ComparateurLog());
+        auto dernier = std::lower_bound(premier, sequence->end(), ligneFin, ComparateurLog());
+        nombreVues += static_cast<int>(std::count_if(premier, dernier, estDuFilm));
+    }
+    return nombreVues;
+}
+
+/// \return Le niveau d'une séquence: 0 jusqu'à facteurCompaction memtables, puis 1 de plus par facteur.
+std::size_t LogsLSM::getNiveau(const Sequence& sequence) const
+{
+    std::size_t niveau = 0;
+    for (std::size_t seuil = tailleMemtable_ * facteurCompaction_; sequence.size() >= seuil;
+         seuil *= facteurCompaction_)
+    {
+        niveau++;
+    }
+    return niveau;
+}
+
+/// Transforme la memtable en séquence et réveille le thread de compaction. Le verrou doit être tenu.
+void LogsLSM::viderMemtable()
+{
+    sequences_.push_back(std::make_shared<const Sequence>(memtable_.begin(), memtable_.end()));
+    memtable_.clear();
+    conditionCompaction_.notify_one();
+}
+
+/// Choisit les séquences à fusionner: facteurCompaction séquences du plus petit niveau qui en compte autant. Le
+/// verrou doit être tenu.
+/// \param aFusionner   Les séquences choisies.
+/// \return             True si une compaction est possible, false sinon.
+bool LogsLSM::choisirCompaction(std::vector<std::shared_ptr<const Sequence>>& aFusionner) const
+{
+    std::map<std::size_t, std::vector<std::shared_ptr<const Sequence>>> niveaux;
+    for (const std::shared_ptr<const Sequence>& sequence : sequences_)
+    {
+        niveaux[getNiveau(*sequence)].push_back(sequence);
+    }
+    for (auto& [niveau, sequences] : niveaux)
+    {
+        if (sequences.size() >= facteurCompaction_)
+        {
+            sequences.resize(facteurCompaction_);
+            aFusionner = std::move(sequences);
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Boucle du thread de compaction: fusionne les séquences choisies sans tenir le verrou, puis les remplace par leur
+/// fusion si elles sont toujours là.
+void LogsLSM::compacter()
+{
+    std::unique_lock<std::mutex> verrou(mutex_);
+    while (true)
+    {
+        std::vector<std::shared_ptr<const Sequence>> aFusionner;
+        conditionCompaction_.wait(verrou, [&] { return arreter_ || choisirCompaction(aFusionner); });
+        if (arreter_)
+        {
+            return;
+        }
+        compactionEnCours_ = true;
+        verrou.unlock();
+
+        std::vector<const Sequence*> sequences;
+        for (const std::shared_ptr<const Sequence>& sequence : aFusionner)
+        {
+            sequences.push_back(sequence.get());
+        }
+        auto fusionnee = std::make_shared<const Sequence>(fusionnerSequences(sequences));
+
+        verrou.lock();
+        auto fin = std::remove_if(sequences_.begin(), sequences_.end(), [&](const auto& sequence) {
+            return std::find(aFusionner.begin(), aFusionner.end(), sequence) != aFusionner.end();
+        });
+        // Si vider() a été appelé pendant la fusion, les séquences ne sont plus là et la fusion est abandonnée
+        if (static_cast<std::size_t>(sequences_.end() - fin) == aFusionner.size())
+        {
+            sequences_.erase(fin, sequences_.end());
+            sequences_.push_back(std::move(fusionnee));
+            nombreCompactions_++;
+        }
+        compactionEnCours_ = false;
+        conditionTerminee_.notify_all();
+    }
+}
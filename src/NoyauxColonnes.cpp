@@ -0,0 +1,300 @@
+/// Noyaux de parcours vectorisés sur les colonnes des logs.
+
+#include "NoyauxColonnes.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    /// \return Le nombre de bits à 1 dans un masque.
+    inline std::size_t compterBits(unsigned int bits)
+    {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_popcount(bits));
+#else
+        std::size_t nombre = 0;
+        for (; bits != 0; bits &= bits - 1)
+        {
+            nombre++;
+        }
+        return nombre;
+#endif
+    }
+
+    /// \return L'index du bit à 1 le moins significatif d'un masque non nul.
+    inline std::uint32_t premierBit(unsigned int bits)
+    {
+#if defined(__GNUC__)
+        return static_cast<std::uint32_t>(__builtin_ctz(bits));
+#else
+        std::uint32_t index = 0;
+        for (; (bits & 1u) == 0; bits >>= 1)
+        {
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    /// Ajoute à indices la position de chaque bit à 1 d'un masque, décalée de base.
+    /// \return La position suivant la dernière écrite.
+    inline std::uint32_t* ecrireIndices(unsigned int bits, std::uint32_t base, std::uint32_t* indices)
+    {
+        for (; bits != 0; bits &= bits - 1)
+        {
+            *indices++ = base + premierBit(bits);
+        }
+        return indices;
+    }
+
+#if defined(__AVX2__)
+    inline std::uint32_t sommerVoies(__m256i voies)
+    {
+        __m128i somme = _mm_add_epi32(_mm256_castsi256_si128(voies), _mm256_extracti128_si256(voies, 1));
+        somme = _mm_add_epi32(somme, _mm_shuffle_epi32(somme, 0x4E));
+        somme = _mm_add_epi32(somme, _mm_shuffle_epi32(somme, 0xB1));
+        return static_cast<std::uint32_t>(_mm_cvtsi128_si32(somme));
+    }
+#elif defined(__SSE2__)
+    inline std::uint32_t sommerVoies(__m128i voies)
+    {
+        voies = _mm_add_epi32(voies, _mm_shuffle_epi32(voies, 0x4E));
+        voies = _mm_add_epi32(voies, _mm_shuffle_epi32(voies, 0xB1));
+        return static_cast<std::uint32_t>(_mm_cvtsi128_si32(voies));
+    }
+#endif
+
+    // Nombre maximal d'itérations vectorielles avant de vider les accumulateurs, pour qu'aucune voie de 32 bits ne
+    // déborde sur de très grandes colonnes
+    constexpr std::size_t iterationsParVidange = 1u << 30;
+} // namespace
+
+/// \return Le nom du jeu d'instructions utilisé par les noyaux: "avx2", "sse2" ou "scalaire".
+const char* NoyauxColonnes::getJeuInstructions()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalaire";
+#endif
+}
+
+/// Compte les valeurs égales à une cible.
+/// \param valeurs  La colonne à parcourir.
+/// \param taille   Le nombre de valeurs.
+/// \param cible    La valeur recherchée.
+/// \return         Le nombre de valeurs égales à la cible.
+std::size_t NoyauxColonnes::compterEgal(const std::uint32_t* valeurs, std::size_t taille, std::uint32_t cible)
+{
+    std::size_t nombre = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i vecteurCible = _mm256_set1_epi32(static_cast<int>(cible));
+    while (taille - i >= 8)
+    {
+        // Chaque égalité vaut -1 dans sa voie: soustraire le masque incrémente le compteur de la voie
+        __m256i compteurs = _mm256_setzero_si256();
+        std::size_t finBloc = i + std::min((taille - i) / 8, iterationsParVidange) * 8;
+        for (; i < finBloc; i += 8)
+        {
+            __m256i bloc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valeurs + i));
+            compteurs = _mm256_sub_epi32(compteurs, _mm256_cmpeq_epi32(bloc, vecteurCible));
+        }
+        nombre += sommerVoies(compteurs);
+    }
+#elif defined(__SSE2__)
+    const __m128i vecteurCible = _mm_set1_epi32(static_cast<int>(cible));
+    while (taille - i >= 4)
+    {
+        __m128i compteurs = _mm_setzero_si128();
+        std::size_t finBloc = i + std::min((taille - i) / 4, iterationsParVidange) * 4;
+        for (; i < finBloc; i += 4)
+        {
+            __m128i bloc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valeurs + i));
+            compteurs = _mm_sub_epi32(compteurs, _mm_cmpeq_epi32(bloc, vecteurCible));
+        }
+        nombre += sommerVoies(compteurs);
+    }
+#endif
+    for (; i < taille; i++)
+    {
+        nombre += valeurs[i] == cible;
+    }
+    return nombre;
+}
+
+/// Compte les lignes dont la valeur est égale à une cible et dont l'instant est dans [debut, fin).
+/// \param valeurs  La colonne de valeurs à comparer à la cible.
+/// \param secondes La colonne des instants, de même taille.
+/// \param taille   Le nombre de lignes.
+/// \param cible    La valeur recherchée.
+/// \param debut    Le début (inclus) de l'intervalle, en secondes.
+/// \param fin      La fin (exclue) de l'intervalle, en secondes.
+/// \return         Le nombre de lignes qui satisfont les deux conditions.
+std::size_t NoyauxColonnes::compterEgalDansIntervalle(const std::uint32_t* valeurs,
+                                                      const std::int64_t* secondes,
+                                                      std::size_t taille,
+                                                      std::uint32_t cible,
+                                                      std::int64_t debut,
+                                                      std::int64_t fin)
+{
+    std::size_t nombre = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    // debut <= s équivaut à !(debut > s); les deux comparaisons 64 bits couvrent les huit valeurs 32 bits du bloc
+    const __m256i vecteurCible = _mm256_set1_epi32(static_cast<int>(cible));
+    const __m256i vecteurDebut = _mm256_set1_epi64x(debut);
+    const __m256i vecteurFin = _mm256_set1_epi64x(fin);
+    for (; i + 8 <= taille; i += 8)
+    {
+        __m256i bloc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valeurs + i));
+        unsigned int egaux =
+            static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(bloc, vecteurCible))));
+        if (egaux == 0)
+        {
+            continue;
+        }
+        __m256i instants1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secondes + i));
+        __m256i instants2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secondes + i + 4));
+        __m256i dans1 = _mm256_andnot_si256(_mm256_cmpgt_epi64(vecteurDebut, instants1),
+                                            _mm256_cmpgt_epi64(vecteurFin, instants1));
+        __m256i dans2 = _mm256_andnot_si256(_mm256_cmpgt_epi64(vecteurDebut, instants2),
+                                            _mm256_cmpgt_epi64(vecteurFin, instants2));
+        unsigned int dansIntervalle =
+            static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(dans1))) |
+            static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(dans2))) << 4;
+        nombre += compterBits(egaux & dansIntervalle);
+    }
+#elif defined(__SSE2__)
+    // SSE2 n'a pas de comparaison 64 bits: seules les lignes égales à la cible voient leur instant vérifié
+    const __m128i vecteurCible = _mm_set1_epi32(static_cast<int>(cible));
+    for (; i + 4 <= taille; i += 4)
+    {
+        __m128i bloc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valeurs + i));
+        unsigned int egaux =
+            static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(bloc, vecteurCible))));
+        for (; egaux != 0; egaux &= egaux - 1)
+        {
+            std::int64_t instant = secondes[i + premierBit(egaux)];
+            nombre += instant >= debut && instant < fin;
+        }
+    }
+#endif
+    for (; i < taille; i++)
+    {
+        nombre += valeurs[i] == cible && secondes[i] >= debut && secondes[i] < fin;
+    }
+    return nombre;
+}
+
+/// Écrit la position de chaque valeur égale à une cible.
+/// \param valeurs  La colonne à parcourir.
+/// \param taille   Le nombre de valeurs, au plus 2^32.
+/// \param cible    La valeur recherchée.
+/// \param indices  Le tableau d'au moins taille éléments dans lequel écrire les positions, en ordre croissant.
+/// \return         Le nombre de positions écrites.
+std::size_t NoyauxColonnes::filtrerEgal(const std::uint32_t* valeurs,
+                                        std::size_t taille,
+                                        std::uint32_t cible,
+                                        std::uint32_t* indices)
+{
+    std::uint32_t* sortie = indices;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i vecteurCible = _mm256_set1_epi32(static_cast<int>(cible));
+    for (; i + 8 <= taille; i += 8)
+    {
+        __m256i bloc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valeurs + i));
+        unsigned int egaux =
+            static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(bloc, vecteurCible))));
+        sortie = ecrireIndices(egaux, static_cast<std::uint32_t>(i), sortie);
+    }
+#elif defined(__SSE2__)
+    const __m128i vecteurCible = _mm_set1_epi32(static_cast<int>(cible));
+    for (; i + 4 <= taille; i += 4)
+    {
+        __m128i bloc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valeurs + i));
+        unsigned int egaux =
+            static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(bloc, vecteurCible))));
+        sortie = ecrireIndices(egaux, static_cast<std::uint32_t>(i), sortie);
+    }
+#endif
+    for (; i < taille; i++)
+    {
+        *sortie = static_cast<std::uint32_t>(i);
+        sortie += valeurs[i] == cible;
+    }
+    return static_cast<std::size_t>(sortie - indices);
+}
+
+/// Compte les valeurs dont l'entrée dans un masque vaut 1.
+/// \param valeurs  La colonne à parcourir.
+/// \param taille   Le nombre de valeurs.
+/// \param masque   Le masque, indexé par valeur, dont chaque entrée vaut 0 ou 1.
+/// \return         Le nombre de valeurs présentes dans le masque.
+std::size_t NoyauxColonnes::compterDansMasque(const std::uint32_t* valeurs,
+                                              std::size_t taille,
+                                              const std::uint32_t* masque)
+{
+    std::size_t nombre = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    while (taille - i >= 8)
+    {
+        __m256i compteurs = _mm256_setzero_si256();
+        std::size_t finBloc = i + std::min((taille - i) / 8, iterationsParVidange) * 8;
+        for (; i < finBloc; i += 8)
+        {
+            __m256i bloc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valeurs + i));
+            compteurs = _mm256_add_epi32(compteurs, _mm256_i32gather_epi32(reinterpret_cast<const int*>(masque), bloc, 4));
+        }
+        nombre += sommerVoies(compteurs);
+    }
+#endif
+    // Sans instruction de collecte, SSE2 n'apporte rien: la boucle scalaire est déjà sans branchement
+    for (; i < taille; i++)
+    {
+        nombre += masque[valeurs[i]];
+    }
+    return nombre;
+}
+
+/// Ajoute chaque valeur à un histogramme. Il n'y a pas d'instruction de dispersion en AVX2 et deux voies peuvent
+/// viser le même compteur: ce noyau reste scalaire, mais ne fait qu'un accès mémoire par valeur.
+/// \param valeurs      La colonne à parcourir.
+/// \param taille       Le nombre de valeurs.
+/// \param compteurs    L'histogramme, indexé par valeur, auquel ajouter les occurrences.
+void NoyauxColonnes::histogramme(const std::uint32_t* valeurs, std::size_t taille, std::uint32_t* compteurs)
+{
+    for (std::size_t i = 0; i < taille; i++)
+    {
+        compteurs[valeurs[i]]++;
+    }
+}
+
+/// Ajoute à un histogramme la valeur de chaque ligne dont la clé est présente dans un masque. Comme pour
+/// histogramme, la mise à jour reste scalaire: sélectionner les lignes par collecte AVX2 avant de les compter
+/// s'est révélé plus lent que cette boucle sans branchement.
+/// \param cles         La colonne des clés, comparées au masque.
+/// \param valeurs      La colonne des valeurs à compter, de même taille.
+/// \param taille       Le nombre de lignes.
+/// \param masque       Le masque, indexé par clé, dont chaque entrée vaut 0 ou 1.
+/// \param compteurs    L'histogramme, indexé par valeur, auquel ajouter les occurrences.
+void NoyauxColonnes::histogrammeMasque(const std::uint32_t* cles,
+                                       const std::uint32_t* valeurs,
+                                       std::size_t taille,
+                                       const std::uint32_t* masque,
+                                       std::uint32_t* compteurs)
+{
+    for (std::size_t i = 0; i < taille; i++)
+    {
+        compteurs[valeurs[i]] += masque[cles[i]];
+    }
+}
@@ -0,0 +1,266 @@
+/// Stockage des lignes de log partitionné par période.
+
+#include "PartitionsLogs.h"
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include "Foncteurs.h"
+#include "Horodatage.h"
+
+namespace
+{
+    /// Ajoute des lignes triées aux lignes triées d'une partition et compte leurs vues.
+    /// \param partition    La partition à compléter.
+    /// \param debut        La première ligne à ajouter.
+    /// \param fin          La position suivant la dernière ligne à ajouter.
+    void fusionnerDansPartition(PartitionsLogs::Partition& partition,
+                                std::vector<LigneLog>::iterator debut,
+                                std::vector<LigneLog>::iterator fin)
+    {
+        for (auto it = debut; it != fin; ++it)
+        {
+            partition.vuesFilms[it->film]++;
+        }
+        auto tailleInitiale = static_cast<std::ptrdiff_t>(partition.lignes.size());
+        partition.lignes.insert(partition.lignes.end(), std::make_move_iterator(debut), std::make_move_iterator(fin));
+        std::inplace_merge(partition.lignes.begin(),
+                           partition.lignes.begin() + tailleInitiale,
+                           partition.lignes.end(),
+                           ComparateurLog());
+    }
+} // namespace
+
+/// Constructeur d'un stockage vide.
+/// \param granularite  La durée couverte par chaque partition.
+PartitionsLogs::PartitionsLogs(GranularitePartition granularite)
+    : granularite_(granularite)
+{
+}
+
+/// Constructeur qui partitionne des lignes de log.
+/// \param logs         Les lignes à partitionner, dans n'importe quel ordre.
+/// \param granularite  La durée couverte par chaque partition.
+PartitionsLogs::PartitionsLogs(const std::vector<LigneLog>& logs, GranularitePartition granularite)
+    : granularite_(granularite)
+{
+    ajouterLignesLog(logs);
+}
+
+/// Ajoute une ligne de log à sa partition. Seules les lignes de cette partition sont déplacées.
+/// \param ligneLog     La ligne de log à ajouter.
+void PartitionsLogs::ajouterLigneLog(const LigneLog& ligneLog)
+{
+    taille_++;
+    std::string cle = getCle(ligneLog.timestamp);
+    if (cle.empty())
+    {
+        auto position = std::lower_bound(
+            lignesHorsPartition_.begin(), lignesHorsPartition_.end(), ligneLog, ComparateurLog());
+        lignesHorsPartition_.insert(position, ligneLog);
+        return;
+    }
+    Partition& partition = partitions_[std::move(cle)];
+    auto position = std::lower_bound(partition.lignes.begin(), partition.lignes.end(), ligneLog, ComparateurLog());
+    partition.lignes.insert(position, ligneLog);
+    partition.vuesFilms[ligneLog.film]++;
+}
+
+/// Ajoute un lot de lignes de log. Le lot est trié, puis chaque tranche qui tombe dans une même partition y est
+/// fusionnée d'un bloc.
+/// \param lignesLog    Les lignes de log à ajouter, dans n'importe quel ordre.
+void PartitionsLogs::ajouterLignesLog(std::vector<LigneLog> lignesLog)
+{
+    taille_ += lignesLog.size();
+    auto horsPartition = std::stable_partition(lignesLog.begin(), lignesLog.end(), [this](const LigneLog& ligneLog) {
+        return !getCle(ligneLog.timestamp).empty();
+    });
+    std::stable_sort(lignesLog.begin(), horsPartition, ComparateurLog());
+    std::stable_sort(horsPartition, lignesLog.end(), ComparateurLog());
+
+    for (auto debut = lignesLog.begin(); debut != horsPartition;)
+    {
+        std::string cle = getCle(debut->timestamp);
+        auto fin = std::find_if(debut, horsPartition, [&](const LigneLog& ligneLog) {
+            return ligneLog.timestamp.compare(0, cle.size(), cle) != 0;
+        });
+        fusionnerDansPartition(partitions_[cle], debut, fin);
+        debut = fin;
+    }
+
+    auto tailleInitiale = static_cast<std::ptrdiff_t>(lignesHorsPartition_.size());
+    lignesHorsPartition_.insert(lignesHorsPartition_.end(),
+                                std::make_move_iterator(horsPartition),
+                                std::make_move_iterator(lignesLog.end()));
+    std::inplace_merge(lignesHorsPartition_.begin(),
+                       lignesHorsPartition_.begin() + tailleInitiale,
+                       lignesHorsPartition_.end(),
+                       ComparateurLog());
+}
+
+/// Supprime la plus ancienne partition, sans toucher aux autres.
+/// \return True si une partition a été supprimée, false s'il n'y en avait aucune.
+bool PartitionsLogs::supprimerPlusAnciennePartition()
+{
+    if (partitions_.empty())
+    {
+        return false;
+    }
+    taille_ -= partitions_.begin()->second.lignes.size();
+    partitions_.erase(partitions_.begin());
+    return true;
+}
+
+/// Supprime les partitions dont la période se termine au plus tard à un instant donné, chacune d'un bloc. Les lignes
+/// hors partition dont le timestamp précède la période de cet instant sont retirées avec elles.
+/// \param timestamp    L'instant avant lequel supprimer les partitions.
+/// \return             Le nombre de partitions supprimées, 0 si le timestamp est mal formé.
+std::size_t PartitionsLogs::supprimerPartitionsAvant(const std::string& timestamp)
+{
+    std::optional<std::int64_t> secondes = convertirTimestamp(timestamp);
+    if (!secondes)
+    {
+        return 0;
+    }
+    // Une clé précède, dans l'ordre des timestamps, toutes les lignes de sa période et suit celles des précédentes
+    LigneLog debutPeriode{getCle(formaterTimestamp(*secondes)), nullptr, nullptr};
+    auto fin = partitions_.lower_bound(debutPeriode.timestamp);
+    std::size_t nombrePartitions = 0;
+    for (auto it = partitions_.begin(); it != fin; ++it, nombrePartitions++)
+    {
+        taille_ -= it->second.lignes.size();
+    }
+    partitions_.erase(partitions_.begin(), fin);
+    auto finHorsPartition = std::lower_bound(
+        lignesHorsPartition_.begin(), lignesHorsPartition_.end(), debutPeriode, ComparateurLog());
+    taille_ -= static_cast<std::size_t>(finHorsPartition - lignesHorsPartition_.begin());
+    lignesHorsPartition_.erase(lignesHorsPartition_.begin(), finHorsPartition);
+    return nombrePartitions;
+}
+
+/// \return La durée couverte par chaque partition.
+GranularitePartition PartitionsLogs::getGranularite() const
+{
+    return granularite_;
+}
+
+/// \return Le nombre de lignes conservées, dans les partitions et hors partition.
+std::size_t PartitionsLogs::getTaille() const
+{
+    return taille_;
+}
+
+/// \return Le nombre de partitions.
+std::size_t PartitionsLogs::getNombrePartitions() const
+{
+    return partitions_.size();
+}
+
+/// \return Les partitions, par préfixe de timestamp.
+const std::map<std::string, PartitionsLogs::Partition>& PartitionsLogs::getPartitions() const
+{
+    return partitions_;
+}
+
+/// Retourne les octets alloués sur le tas par les partitions et par les lignes hors partition.
+/// \return                 Le rapport d'utilisation mémoire
+UtilisationMemoire PartitionsLogs::getUtilisationMemoire() const
+{
+    std::size_t octetsLignes = 0;
+    std::size_t octetsVuesFilms = 0;
+    std::size_t octetsNoeuds = 0;
+    for (const auto& [cle, partition] : partitions_)
+    {
+        octetsNoeuds += tailleNoeudArbre<std::pair<const std::string, Partition>> + octetsTas(cle);
+        octetsLignes += octetsTas(partition.lignes);
+        octetsVuesFilms += octetsTas(partition.vuesFilms);
+    }
+
+    UtilisationMemoire utilisationMemoire;
+    utilisationMemoire.ajouter("partitions_", octetsNoeuds);
+    utilisationMemoire.ajouter("partitions_.lignes", octetsLignes);
+    utilisationMemoire.ajouter("partitions_.vuesFilms", octetsVuesFilms);
+    utilisationMemoire.ajouter("lignesHorsPartition_", octetsTas(lignesHorsPartition_));
+    return utilisationMemoire;
+}
+
+/// Retourne le nombre de vues d'un film en additionnant les agrégats des partitions.
+/// \param film     Le film dont on veut le nombre de vues
+/// \return         Le nombre de vues du film
+int PartitionsLogs::getNombreVuesFilm(const Film* film) const
+{
+    int nombreVues = static_cast<int>(
+        std::count_if(lignesHorsPartition_.begin(), lignesHorsPartition_.end(), [film](const LigneLog& ligneLog) {
+            return ligneLog.film == film;
+        }));
+    for (const auto& [cle, partition] : partitions_)
+    {
+        auto vues = partition.vuesFilms.find(film);
+        nombreVues += vues != partition.vuesFilms.end() ? vues->second : 0;
+    }
+    return nombreVues;
+}
+
+/// Retourne le nombre de vues d'un film dans un intervalle de temps. Seules les partitions qui chevauchent
+/// l'intervalle sont lues; pour celles dont toutes les lignes sont dans l'intervalle, l'agrégat suffit, et les autres
+/// sont bornées par recherche binaire.
+/// \param film     Le film dont on veut le nombre de vues
+/// \param debut    Le timestamp du début (inclus) de l'intervalle
+/// \param fin      Le timestamp de la fin (exclue) de l'intervalle
+/// \return         Le nombre de vues dans l'intervalle, ou 0 si un des timestamps est mal formé
+int PartitionsLogs::getNombreVuesFilmEntre(const Film* film, const std::string& debut, const std::string& fin) const
+{
+    std::optional<std::int64_t> secondesDebut = convertirTimestamp(debut);
+    std::optional<std::int64_t> secondesFin = convertirTimestamp(fin);
+    if (!secondesDebut || !secondesFin || *secondesDebut >= *secondesFin)
+    {
+        return 0;
+    }
+
+    int nombreVues = 0;
+    for (const LigneLog& ligneLog : lignesHorsPartition_)
+    {
+        std::optional<std::int64_t> secondes = convertirTimestamp(ligneLog.timestamp);
+        nombreVues += ligneLog.film == film && secondes && *secondes >= *secondesDebut && *secondes < *secondesFin;
+    }
+
+    // Les timestamps canoniques se comparent comme les instants qu'ils représentent
+    LigneLog ligneDebut{formaterTimestamp(*secondesDebut), nullptr, nullptr};
+    LigneLog ligneFin{formaterTimestamp(*secondesFin), nullptr, nullptr};
+    std::string cleFin = getCle(ligneFin.timestamp);
+    auto it = partitions_.lower_bound(getCle(ligneDebut.timestamp));
+    for (; it != partitions_.end() && it->first <= cleFin; ++it)
+    {
+        const Partition& partition = it->second;
+        if (partition.lignes.front().timestamp >= ligneDebut.timestamp &&
+            partition.lignes.back().timestamp < ligneFin.timestamp)
+        {
+            auto vues = partition.vuesFilms.find(film);
+            nombreVues += vues != partition.vuesFilms.end() ? vues->second : 0;
+            continue;
+        }
+        auto premier = std::lower_bound(partition.lignes.begin(), partition.lignes.end(), ligneDebut, ComparateurLog());
+        auto dernier = std::lower_bound(premier, partition.lignes.end(), ligneFin, ComparateurLog());
+        nombreVues += static_cast<int>(std::count_if(premier, dernier, [film](const LigneLog& ligneLog) {
+            return ligneLog.film == film;
+        }));
+    }
+    return nombreVues;
+}
+
+/// Retourne la clé de la partition d'un timestamp, c'est-à-dire son préfixe "AAAA-MM-JJ" ou "AAAA-MM".
+/// \param timestamp    Le timestamp de la ligne.
+/// \return             La clé, ou une chaîne vide si le timestamp n'est pas au format canonique.
+std::string PartitionsLogs::getCle(const std::string& timestamp) const
+{
+    std::optional<std::int64_t> secondes = convertirTimestamp(timestamp);
+    char canonique[longueurTimestamp];
+    if (secondes)
+    {
+        formaterTimestamp(*secondes, canonique);
+    }
+    if (!secondes || !std::equal(canonique, canonique + longueurTimestamp, timestamp.begin()))
+    {
+        return std::string();
+    }
+    return timestamp.substr(0, granularite_ == GranularitePartition::Jour ? 10 : 7);
+}
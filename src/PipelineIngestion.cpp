@@ -0,0 +1,290 @@
+/// Chargement d'un fichier de logs par un pipeline d'étapes concurrentes.
+
+#include "PipelineIngestion.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include "FileBornee.h"
+#include "Foncteurs.h"
+#include "Instrumentation.h"
+
+namespace
+{
+    using Horloge = std::chrono::steady_clock;
+
+    /// Chronomètre qui répartit le temps d'une étape entre le travail et l'attente de ses files.
+    class ChronometreEtape
+    {
+    public:
+        explicit ChronometreEtape(PipelineIngestion::StatistiquesEtape& statistiques)
+            : statistiques_(statistiques)
+            , debut_(Horloge::now())
+        {
+        }
+
+        ~ChronometreEtape()
+        {
+            statistiques_.dureeTravail = Horloge::now() - debut_ - statistiques_.dureeAttenteEntree -
+                                         statistiques_.dureeAttenteSortie;
+        }
+
+        ChronometreEtape(const ChronometreEtape&) = delete;
+        ChronometreEtape& operator=(const ChronometreEtape&) = delete;
+
+        template<typename T>
+        bool retirer(FileBornee<T>& file, T& lot)
+        {
+            Horloge::time_point debutAttente = Horloge::now();
+            bool estRetire = file.retirer(lot);
+            statistiques_.dureeAttenteEntree += Horloge::now() - debutAttente;
+            return estRetire;
+        }
+
+        template<typename T>
+        void ajouter(FileBornee<T>& file, T lot)
+        {
+            statistiques_.nombreElements += lot.size();
+            Horloge::time_point debutAttente = Horloge::now();
+            file.ajouter(std::move(lot));
+            statistiques_.dureeAttenteSortie += Horloge::now() - debutAttente;
+        }
+
+    private:
+        PipelineIngestion::StatistiquesEtape& statistiques_;
+        Horloge::time_point debut_;
+    };
+
+    /// Fusionne les deux dernières séquences triées, la plus ancienne en premier pour que les lignes de même
+    /// timestamp restent dans l'ordre du fichier, comme avec le chargement séquentiel.
+    /// \param sequences    Les séquences triées, de la plus ancienne à la plus récente.
+    void fusionnerDernieresSequences(std::vector<std::vector<LigneLog>>& sequences)
+    {
+        std::vector<LigneLog> recente = std::move(sequences.back());
+        sequences.pop_back();
+        std::vector<LigneLog>& ancienne = sequences.back();
+        std::vector<LigneLog> fusion;
+        fusion.reserve(ancienne.size() + recente.size());
+        std::merge(std::make_move_iterator(ancienne.begin()),
+                   std::make_move_iterator(ancienne.end()),
+                   std::make_move_iterator(recente.begin()),
+                   std::make_move_iterator(recente.end()),
+                   std::back_inserter(fusion),
+                   ComparateurLog());
+        ancienne = std::move(fusion);
+    }
+} // namespace
+
+/// Retourne le débit de l'étape en ne comptant que son temps de travail, soit le débit qu'elle soutiendrait si
+/// elle n'attendait jamais les autres. L'étape au plus faible débit est le goulot d'étranglement.
+/// \return Le nombre d'éléments traités par seconde de travail.
+double PipelineIngestion::StatistiquesEtape::getDebit() const
+{
+    double secondes = std::chrono::duration<double>(dureeTravail).count();
+    return secondes > 0.0 ? static_cast<double>(nombreElements) / secondes : 0.0;
+}
+
+/// Constructeur qui conserve l'analyseur à remplir et les gestionnaires servant à résoudre les lignes.
+/// \param analyseurLogs            L'analyseur de logs à remplir.
+/// \param gestionnaireUtilisateurs Le gestionnaire des utilisateurs pour lier un utilisateur à un log.
+/// \param gestionnaireFilms        Le gestionnaire des films pour lier un film à un log.
+/// \param tailleLot                Le nombre de lignes passées d'une étape à l'autre en une seule opération.
+/// \param capaciteFiles            Le nombre de lots en attente entre deux étapes avant que la première ne bloque.
+PipelineIngestion::PipelineIngestion(AnalyseurLogs& analyseurLogs,
+                                     const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                     const GestionnaireFilms& gestionnaireFilms,
+                                     std::size_t tailleLot,
+                                     std::size_t capaciteFiles)
+    : analyseurLogs_(analyseurLogs)
+    , gestionnaireUtilisateurs_(gestionnaireUtilisateurs)
+    , gestionnaireFilms_(gestionnaireFilms)
+    , tailleLot_(std::max<std::size_t>(tailleLot, 1))
+    , capaciteFiles_(std::max<std::size_t>(capaciteFiles, 1))
+{
+}
+
+/// Remplace le contenu de l'analyseur par les lignes de log d'un fichier, comme AnalyseurLogs::chargerDepuisFichier:
+/// la configuration de l'analyseur est conservée, sa rétention est appliquée à la fin du chargement et les lignes
+/// rejetées sont signalées de la même manière.
+/// \param nomFichier   Le fichier à partir duquel lire les logs.
+/// \param options      Le traitement des lignes mal formées et de celles dont l'utilisateur ou le film est
+///                     introuvable.
+/// \return             Le nombre de lignes chargées et de lignes rejetées, et le succès si le fichier a été ouvert
+///                     et que toutes ses lignes ont été interprétées.
+BilanChargement PipelineIngestion::chargerDepuisFichier(const std::string& nomFichier, const OptionsRejets& options)
+{
+    BilanChargement bilan;
+    std::ifstream fichier(nomFichier);
+    if (!fichier)
+    {
+        std::cerr << "Erreur PipelineIngestion: le fichier " << nomFichier << " n'a pas pu être ouvert\n";
+        return bilan;
+    }
+    analyseurLogs_.vider();
+    statistiques_ = {StatistiquesEtape{"lecture"},
+                     StatistiquesEtape{"analyse"},
+                     StatistiquesEtape{"resolution"},
+                     StatistiquesEtape{"indexation"},
+                     StatistiquesEtape{"fusion"}};
+
+    FileBornee<std::vector<std::string>> fileLignes(capaciteFiles_);
+    FileBornee<std::vector<AnalyseurLogs::EntreeLog>> fileEntrees(capaciteFiles_);
+    FileBornee<std::vector<LigneLog>> fileLignesLog(capaciteFiles_);
+    bool succesParsing = true;
+
+    // Les étapes d'analyse et de résolution rejettent des lignes en parallèle; les rejets sont rares
+    CollecteurRejets rejets("PipelineIngestion", options);
+    std::mutex mutexRejets;
+    auto rejeter = [&](RaisonRejet raison, std::string_view ligne) {
+        std::lock_guard<std::mutex> verrou(mutexRejets);
+        rejets.rejeter(raison, ligne);
+    };
+
+    std::thread lecture([&] {
+        ChronometreEtape chronometre(statistiques_[0]);
+        std::vector<std::string> lot;
+        lot.reserve(tailleLot_);
+        std::string ligne;
+        while (lireLigne(fichier, ligne))
+        {
+            lot.push_back(std::move(ligne));
+            if (lot.size() == tailleLot_)
+            {
+                chronometre.ajouter(fileLignes, std::move(lot));
+                lot = {};
+                lot.reserve(tailleLot_);
+            }
+        }
+        if (!lot.empty())
+        {
+            chronometre.ajouter(fileLignes, std::move(lot));
+        }
+        fileLignes.fermer();
+    });
+
+    std::thread analyse([&] {
+        ChronometreEtape chronometre(statistiques_[1]);
+        std::vector<std::string> lignes;
+        while (chronometre.retirer(fileLignes, lignes))
+        {
+            std::vector<AnalyseurLogs::EntreeLog> entreesLog;
+            entreesLog.reserve(lignes.size());
+            for (const std::string& ligne : lignes)
+            {
+                AnalyseurLogs::EntreeLog entreeLog;
+                if (AnalyseurLogs::analyserLigne(ligne, entreeLog))
+                {
+                    entreesLog.push_back(std::move(entreeLog));
+                }
+                else
+                {
+                    INSTRUMENTER_COMPTEUR(LignesRejetees, 1);
+                    rejeter(RaisonRejet::LigneMalFormee, ligne);
+                    succesParsing = false;
+                }
+            }
+            chronometre.ajouter(fileEntrees, std::move(entreesLog));
+        }
+        fileEntrees.fermer();
+    });
+
+    std::thread resolution([&] {
+        ChronometreEtape chronometre(statistiques_[2]);
+        std::vector<AnalyseurLogs::EntreeLog> entreesLog;
+        while (chronometre.retirer(fileEntrees, entreesLog))
+        {
+            std::vector<LigneLog> lignesLog;
+            lignesLog.reserve(entreesLog.size());
+            for (AnalyseurLogs::EntreeLog& entreeLog : entreesLog)
+            {
+                const Utilisateur* utilisateur = gestionnaireUtilisateurs_.getUtilisateurParId(entreeLog.idUtilisateur);
+                const Film* film = gestionnaireFilms_.getFilmParNom(entreeLog.nomFilm);
+                INSTRUMENTER_COMPTEUR(UtilisateursIntrouvables, utilisateur == nullptr);
+                INSTRUMENTER_COMPTEUR(FilmsIntrouvables, film == nullptr);
+                if (utilisateur != nullptr && film != nullptr)
+                {
+                    lignesLog.push_back(LigneLog{std::move(entreeLog.timestamp), utilisateur, film});
+                }
+                else
+                {
+                    rejeter(utilisateur == nullptr ? RaisonRejet::UtilisateurIntrouvable : RaisonRejet::FilmIntrouvable,
+                            AnalyseurLogs::formaterLigne(entreeLog));
+                }
+            }
+            chronometre.ajouter(fileLignesLog, std::move(lignesLog));
+        }
+        fileLignesLog.fermer();
+    });
+
+    // L'indexation s'exécute sur le thread appelant, pendant que les autres étapes avancent. Une séquence est fusionnée
+    // avec la précédente tant que celle-ci n'est pas plus de deux fois plus longue: les séquences restent peu
+    // nombreuses et chaque ligne n'est fusionnée qu'un nombre logarithmique de fois.
+    std::vector<std::vector<LigneLog>> sequences;
+    {
+        ChronometreEtape chronometre(statistiques_[3]);
+        std::vector<LigneLog> lot;
+        while (chronometre.retirer(fileLignesLog, lot))
+        {
+            statistiques_[3].nombreElements += lot.size();
+            std::stable_sort(lot.begin(), lot.end(), ComparateurLog());
+            sequences.push_back(std::move(lot));
+            lot = {};
+            while (sequences.size() >= 2 && sequences[sequences.size() - 2].size() <= 2 * sequences.back().size())
+            {
+                fusionnerDernieresSequences(sequences);
+            }
+        }
+    }
+
+    // Les dernières séquences sont réunies puis transmises à l'analyseur, qui n'a plus à les trier, une seule fois,
+    // puisque chaque ajout à l'analyseur coûte un passage complet sur les logs déjà présents
+    {
+        ChronometreEtape chronometre(statistiques_[4]);
+        while (sequences.size() >= 2)
+        {
+            fusionnerDernieresSequences(sequences);
+        }
+        std::vector<LigneLog> lignesLog = sequences.empty() ? std::vector<LigneLog>() : std::move(sequences.back());
+        statistiques_[4].nombreElements = lignesLog.size();
+        bilan.nombreLignesChargees = lignesLog.size();
+        analyseurLogs_.ajouterLignesLog(std::move(lignesLog));
+        analyseurLogs_.appliquerRetention();
+    }
+
+    lecture.join();
+    analyse.join();
+    resolution.join();
+    bilan.succes = succesParsing;
+    bilan.nombreRejets = rejets.terminer();
+    return bilan;
+}
+
+/// Retourne les mesures de chaque étape pour le dernier chargement, dans l'ordre du pipeline.
+/// \return Les statistiques des étapes.
+const std::vector<PipelineIngestion::StatistiquesEtape>& PipelineIngestion::getStatistiques() const
+{
+    return statistiques_;
+}
+
+/// Affiche les mesures de chaque étape du dernier chargement.
+/// \param outputStream         Le stream auquel écrire les mesures.
+/// \param pipelineIngestion    Le pipeline dont on affiche les mesures.
+/// \return                     Une référence au stream.
+std::ostream& operator<<(std::ostream& outputStream, const PipelineIngestion& pipelineIngestion)
+{
+    outputStream << std::left << std::setw(12) << "etape" << std::right << std::setw(12) << "elements"
+                 << std::setw(14) << "travail (ms)" << std::setw(14) << "entree (ms)" << std::setw(14)
+                 << "sortie (ms)" << std::setw(16) << "debit (el/s)" << '\n';
+    for (const PipelineIngestion::StatistiquesEtape& etape : pipelineIngestion.statistiques_)
+    {
+        outputStream << std::left << std::setw(12) << etape.nom << std::right << std::setw(12) << etape.nombreElements
+                     << std::fixed << std::setprecision(1) << std::setw(14)
+                     << std::chrono::duration<double, std::milli>(etape.dureeTravail).count() << std::setw(14)
+                     << std::chrono::duration<double, std::milli>(etape.dureeAttenteEntree).count() << std::setw(14)
+                     << std::chrono::duration<double, std::milli>(etape.dureeAttenteSortie).count() << std::setw(16)
+                     << std::setprecision(0) << etape.getDebit() << '\n';
+    }
+    return outputStream;
+}
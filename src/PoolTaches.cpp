@@ -0,0 +1,189 @@
+/// Ordonnanceur de tâches à vol de travail partagé par les chargements et les requêtes d'agrégation.
+
+#include "PoolTaches.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    /// Pool et index du travailleur exécuté par le thread courant, pour qu'une tâche soumise depuis un travailleur
+    /// aille dans sa propre file.
+    thread_local const PoolTaches* poolCourant = nullptr;
+    thread_local std::size_t indexTravailleurCourant = 0;
+
+    /// Épingle un thread sur un coeur. Sans effet hors de Linux.
+    /// \param thread   Le thread à épingler.
+    /// \param coeur    L'index du coeur.
+    void epinglerThread([[maybe_unused]] std::thread& thread, [[maybe_unused]] std::size_t coeur)
+    {
+#ifdef __linux__
+        cpu_set_t ensemble;
+        CPU_ZERO(&ensemble);
+        CPU_SET(coeur % CPU_SETSIZE, &ensemble);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(ensemble), &ensemble);
+#endif
+    }
+} // namespace
+
+/// Constructeur qui démarre les threads travailleurs.
+/// \param nombreTravailleurs   Le nombre de threads travailleurs (au moins 1).
+/// \param epinglerTravailleurs True pour épingler le travailleur i sur le coeur i (Linux seulement).
+PoolTaches::PoolTaches(std::size_t nombreTravailleurs, bool epinglerTravailleurs)
+{
+    nombreTravailleurs = std::max<std::size_t>(nombreTravailleurs, 1);
+    for (std::size_t i = 0; i < nombreTravailleurs; i++)
+    {
+        travailleurs_.push_back(std::make_unique<Travailleur>());
+    }
+    std::size_t nombreCoeurs = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    for (std::size_t i = 0; i < nombreTravailleurs; i++)
+    {
+        threads_.emplace_back(&PoolTaches::boucleTravailleur, this, i);
+        if (epinglerTravailleurs)
+        {
+            epinglerThread(threads_.back(), i % nombreCoeurs);
+        }
+    }
+}
+
+/// Destructeur qui termine les tâches en attente puis arrête les travailleurs.
+PoolTaches::~PoolTaches()
+{
+    {
+        std::lock_guard<std::mutex> verrou(mutexAttente_);
+        arretDemande_ = true;
+    }
+    conditionAttente_.notify_all();
+    for (std::thread& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+/// Retourne le pool partagé par toute l'application, créé au premier appel. Il compte un travailleur de moins que
+/// le nombre de coeurs, puisque le thread qui attend un parallelFor participe aussi au travail.
+/// \return Le pool global.
+PoolTaches& PoolTaches::getPoolGlobal()
+{
+    static PoolTaches pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
+/// Ajoute une tâche à exécuter par un travailleur. Depuis un travailleur du pool, la tâche va dans sa propre file;
+/// sinon, les tâches sont réparties à tour de rôle entre les travailleurs.
+/// \param tache    La tâche à exécuter.
+void PoolTaches::soumettre(std::function<void()> tache)
+{
+    std::size_t index = poolCourant == this
+                            ? indexTravailleurCourant
+                            : prochainTravailleur_.fetch_add(1, std::memory_order_relaxed) % travailleurs_.size();
+    {
+        std::lock_guard<std::mutex> verrou(travailleurs_[index]->mutex);
+        travailleurs_[index]->taches.push_back(std::move(tache));
+    }
+    {
+        std::lock_guard<std::mutex> verrou(mutexAttente_);
+        nombreTachesEnAttente_.fetch_add(1, std::memory_order_relaxed);
+    }
+    conditionAttente_.notify_one();
+}
+
+/// Retourne le nombre de threads travailleurs.
+/// \return Le nombre de travailleurs.
+std::size_t PoolTaches::getNombreTravailleurs() const
+{
+    return travailleurs_.size();
+}
+
+/// Choisit la taille des blocs d'un parallelFor.
+/// \param nombreElements   Le nombre d'éléments à répartir.
+/// \param tailleGrain      La taille demandée, ou 0 pour la choisir automatiquement.
+/// \return                 La taille des blocs.
+std::size_t PoolTaches::getTailleGrain(std::size_t nombreElements, std::size_t tailleGrain) const
+{
+    if (tailleGrain == 0)
+    {
+        tailleGrain = nombreElements / (4 * (travailleurs_.size() + 1));
+    }
+    return std::max<std::size_t>(tailleGrain, 1);
+}
+
+/// Exécute une tâche: la plus récente de la file de départ si c'est celle du thread courant, sinon la plus
+/// ancienne de la première file non vide en partant de la file de départ.
+/// \param indexDepart  L'index de la première file à consulter.
+/// \return             True si une tâche a été exécutée, false si toutes les files sont vides.
+bool PoolTaches::executerUneTache(std::size_t indexDepart)
+{
+    std::function<void()> tache;
+    for (std::size_t i = 0; i < travailleurs_.size() && !tache; i++)
+    {
+        std::size_t index = (indexDepart + i) % travailleurs_.size();
+        bool estProprietaire = poolCourant == this && index == indexTravailleurCourant;
+        Travailleur& travailleur = *travailleurs_[index];
+        std::lock_guard<std::mutex> verrou(travailleur.mutex);
+        if (!travailleur.taches.empty())
+        {
+            if (estProprietaire)
+            {
+                tache = std::move(travailleur.taches.back());
+                travailleur.taches.pop_back();
+            }
+            else
+            {
+                tache = std::move(travailleur.taches.front());
+                travailleur.taches.pop_front();
+            }
+        }
+    }
+    if (!tache)
+    {
+        return false;
+    }
+    nombreTachesEnAttente_.fetch_sub(1, std::memory_order_relaxed);
+    tache();
+    return true;
+}
+
+/// Attend la fin de tous les blocs d'un groupe en exécutant d'autres tâches pendant ce temps.
+/// \param groupe   Le groupe à attendre.
+void PoolTaches::attendre(Groupe& groupe)
+{
+    std::size_t indexDepart = poolCourant == this ? indexTravailleurCourant : 0;
+    while (groupe.blocsRestants.load(std::memory_order_acquire) != 0)
+    {
+        if (!executerUneTache(indexDepart))
+        {
+            std::this_thread::yield();
+        }
+    }
+    if (groupe.erreur)
+    {
+        std::rethrow_exception(groupe.erreur);
+    }
+}
+
+/// Boucle d'un travailleur: exécute ses tâches, vole celles des autres, puis dort jusqu'à la prochaine soumission.
+/// \param index    L'index du travailleur.
+void PoolTaches::boucleTravailleur(std::size_t index)
+{
+    poolCourant = this;
+    indexTravailleurCourant = index;
+    while (true)
+    {
+        if (executerUneTache(index))
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> verrou(mutexAttente_);
+        conditionAttente_.wait(verrou, [this] {
+            return arretDemande_ || nombreTachesEnAttente_.load(std::memory_order_relaxed) != 0;
+        });
+        if (arretDemande_ && nombreTachesEnAttente_.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/// Protocole texte compact du serveur de requêtes.
+
+#include "ProcesseurRequetes.h"
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    constexpr int nombreGenres = 9;
+    constexpr int nombrePays = 9;
+
+    /// Ajoute un nom entre guillemets à une réponse, dans le format lu par std::quoted.
+    /// \param nom      Le nom à ajouter.
+    /// \param reponse  La réponse à compléter.
+    void ajouterNom(const std::string& nom, std::string& reponse)
+    {
+        reponse += " \"";
+        for (char caractere : nom)
+        {
+            if (caractere == '"' || caractere == '\\')
+            {
+                reponse += '\\';
+            }
+            reponse += caractere;
+        }
+        reponse += '"';
+    }
+} // namespace
+
+/// Constructeur qui conserve des références vers les données à interroger.
+/// \param gestionnaireFilms        Le gestionnaire des films.
+/// \param gestionnaireUtilisateurs Le gestionnaire des utilisateurs.
+/// \param analyseurLogs            L'analyseur de logs, modifié par les requêtes LOG.
+ProcesseurRequetes::ProcesseurRequetes(GestionnaireFilms& gestionnaireFilms,
+                                       GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                       AnalyseurLogs& analyseurLogs)
+    : gestionnaireFilms_(gestionnaireFilms)
+    , gestionnaireUtilisateurs_(gestionnaireUtilisateurs)
+    , analyseurLogs_(analyseurLogs)
+{
+}
+
+/// Traite une requête et écrit la réponse correspondante, terminée par un saut de ligne.
+/// \param requete  La requête, sans son saut de ligne.
+/// \param reponse  La chaîne à laquelle la réponse est ajoutée.
+void ProcesseurRequetes::traiter(const std::string& requete, std::string& reponse)
+{
+    std::istringstream stream(requete);
+    std::string commande;
+    stream >> commande;
+
+    if (commande == "FILM" || commande == "VUES_FILM")
+    {
+        std::string nom;
+        const Film* film = stream >> std::quoted(nom) ? gestionnaireFilms_.getFilmParNom(nom) : nullptr;
+        if (film == nullptr)
+        {
+            reponse += "ERR film introuvable\n";
+        }
+        else if (commande == "FILM")
+        {
+            reponse += "OK";
+            ajouterNom(film->nom, reponse);
+            reponse += ' ' + std::to_string(static_cast<int>(film->genre)) + ' ' +
+                       std::to_string(static_cast<int>(film->pays));
+            ajouterNom(film->realisateur, reponse);
+            reponse += ' ' + std::to_string(film->annee) + '\n';
+        }
+        else
+        {
+            reponse += "OK " + std::to_string(analyseurLogs_.getNombreVuesFilm(film)) + '\n';
+        }
+    }
+    else if (commande == "GENRE" || commande == "PAYS")
+    {
+        int valeur;
+        if (!(stream >> valeur) || valeur < 0 || valeur >= (commande == "GENRE" ? nombreGenres : nombrePays))
+        {
+            reponse += "ERR " + commande + " invalide\n";
+            return;
+        }
+        ecrireFilms(commande == "GENRE" ? gestionnaireFilms_.getFilmsParGenre(static_cast<Film::Genre>(valeur))
+                                        : gestionnaireFilms_.getFilmsParPays(static_cast<Pays>(valeur)),
+                    reponse);
+    }
+    else if (commande == "ANNEES")
+    {
+        int anneeDebut;
+        int anneeFin;
+        if (!(stream >> anneeDebut >> anneeFin))
+        {
+            reponse += "ERR années invalides\n";
+            return;
+        }
+        ecrireFilms(gestionnaireFilms_.getFilmsEntreAnnees(anneeDebut, anneeFin), reponse);
+    }
+    else if (commande == "TOP")
+    {
+        std::size_t nombre;
+        if (!(stream >> nombre))
+        {
+            reponse += "ERR nombre invalide\n";
+            return;
+        }
+        std::vector<std::pair<const Film*, int>> films = analyseurLogs_.getNFilmsPlusPopulaires(nombre);
+        reponse += "OK " + std::to_string(films.size());
+        for (const auto& [film, vues] : films)
+        {
+            ajouterNom(film->nom, reponse);
+            reponse += ' ' + std::to_string(vues);
+        }
+        reponse += '\n';
+    }
+    else if (commande == "VUES_UTILISATEUR" || commande == "FILMS_UTILISATEUR")
+    {
+        std::string id;
+        const Utilisateur* utilisateur = stream >> id ? gestionnaireUtilisateurs_.getUtilisateurParId(id) : nullptr;
+        if (utilisateur == nullptr)
+        {
+            reponse += "ERR utilisateur introuvable\n";
+        }
+        else if (commande == "VUES_UTILISATEUR")
+        {
+            reponse += "OK " + std::to_string(analyseurLogs_.getNombreVuesPourUtilisateur(utilisateur)) + '\n';
+        }
+        else
+        {
+            ecrireFilms(analyseurLogs_.getFilmsVusParUtilisateur(utilisateur), reponse);
+        }
+    }
+    else if (commande == "LOG")
+    {
+        std::string timestamp;
+        std::string id;
+        std::string nom;
+        if (!(stream >> timestamp >> id >> std::quoted(nom)))
+        {
+            reponse += "ERR ligne de log invalide\n";
+        }
+        else if (!analyseurLogs_.creerLigneLog(timestamp, id, nom, gestionnaireUtilisateurs_, gestionnaireFilms_))
+        {
+            reponse += "ERR utilisateur ou film introuvable\n";
+        }
+        else
+        {
+            reponse += "OK\n";
+        }
+    }
+    else
+    {
+        reponse += "ERR commande inconnue\n";
+    }
+}
+
+/// Ajoute une liste de films à une réponse, précédée de leur nombre.
+/// \param films    Les films à écrire.
+/// \param reponse  La réponse à compléter.
+void ProcesseurRequetes::ecrireFilms(const std::vector<const Film*>& films, std::string& reponse)
+{
+    reponse += "OK " + std::to_string(films.size());
+    for (const Film* film : films)
+    {
+        ajouterNom(film->nom, reponse);
+    }
+    reponse += '\n';
+}
@@ -0,0 +1,148 @@
+/// Collecte des lignes rejetées lors du chargement d'un fichier et bilan du chargement.
+
+#include "RejetsChargement.h"
+#include <iostream>
+#include <utility>
+
+namespace
+{
+    struct DescriptionRaison
+    {
+        std::string_view code;    // Écrit dans le fichier de quarantaine
+        std::string_view message; // Suit la ligne dans le message affiché sur la console
+    };
+
+    constexpr std::array<DescriptionRaison, nombreRaisonsRejet> descriptionsRaisons = {{
+        {"ligne_mal_formee", "n'a pas pu être interprétée correctement"},
+        {"utilisateur_introuvable", "référence un utilisateur introuvable"},
+        {"film_introuvable", "référence un film introuvable"},
+    }};
+} // namespace
+
+/// Constructeur. Le fichier de quarantaine, s'il est demandé, est créé immédiatement, même si aucune ligne n'est
+/// rejetée, pour qu'il ne contienne jamais les rejets d'un chargement précédent; avec ajouterQuarantaine, il est
+/// plutôt ouvert en ajout, pour les chargements successifs d'un même fichier suivi.
+/// \param source   Le nom de la classe qui charge le fichier, affiché au début de chaque message.
+/// \param options  Le fichier de quarantaine et le nombre maximal de lignes rejetées à afficher.
+CollecteurRejets::CollecteurRejets(std::string source, const OptionsRejets& options)
+    : source_(std::move(source))
+    , nombreMessagesConsole_(options.nombreMessagesConsole)
+    , cheminQuarantaine_(options.fichierQuarantaine)
+{
+    if (cheminQuarantaine_.empty())
+    {
+        return;
+    }
+    quarantaine_ = std::fopen(cheminQuarantaine_.string().c_str(), options.ajouterQuarantaine ? "ab" : "wb");
+    if (quarantaine_ == nullptr)
+    {
+        erreurQuarantaine_ = true;
+        std::cerr << "Erreur " << source_ << ": le fichier de quarantaine " << cheminQuarantaine_.string()
+                  << " n'a pas pu être ouvert\n";
+        return;
+    }
+    tampon_.reserve(octetsTampon);
+}
+
+/// Destructeur. Écrit les rejets restants si terminer() n'a pas été appelée.
+CollecteurRejets::~CollecteurRejets()
+{
+    fermer();
+}
+
+/// Signale une ligne rejetée.
+/// \param raison   La raison du rejet.
+/// \param ligne    La ligne rejetée, sans sa fin de ligne.
+void CollecteurRejets::rejeter(RaisonRejet raison, std::string_view ligne)
+{
+    nombreRejets_[static_cast<std::size_t>(raison)]++;
+    if (nombreMessagesAffiches_ < nombreMessagesConsole_)
+    {
+        nombreMessagesAffiches_++;
+        std::cerr << "Erreur " << source_ << ": la ligne " << ligne << ' '
+                  << descriptionsRaisons[static_cast<std::size_t>(raison)].message << '\n';
+    }
+    if (quarantaine_ != nullptr)
+    {
+        tampon_.append(getCode(raison));
+        tampon_.push_back('\t');
+        tampon_.append(ligne);
+        tampon_.push_back('\n');
+        if (tampon_.size() >= octetsTampon)
+        {
+            vider();
+        }
+    }
+}
+
+/// Termine le chargement: résume les rejets qui n'ont pas été affichés et ferme le fichier de quarantaine. Une erreur
+/// d'écriture de la quarantaine est signalée sur la console mais ne fait pas échouer le chargement.
+/// \return Le nombre de lignes rejetées pour chaque raison, indexé par RaisonRejet.
+std::array<std::size_t, nombreRaisonsRejet> CollecteurRejets::terminer()
+{
+    std::size_t nombreNonAffiches = 0;
+    for (std::size_t nombre : nombreRejets_)
+    {
+        nombreNonAffiches += nombre;
+    }
+    nombreNonAffiches -= nombreMessagesAffiches_;
+    if (nombreNonAffiches > 0)
+    {
+        std::cerr << "Erreur " << source_ << ": " << nombreNonAffiches << " autres lignes rejetées (";
+        const char* separateur = "";
+        for (std::size_t raison = 0; raison < nombreRaisonsRejet; raison++)
+        {
+            if (nombreRejets_[raison] > 0)
+            {
+                std::cerr << separateur << descriptionsRaisons[raison].code << ": " << nombreRejets_[raison];
+                separateur = ", ";
+            }
+        }
+        std::cerr << " au total)";
+        if (quarantaine_ != nullptr)
+        {
+            std::cerr << ", conservées dans " << cheminQuarantaine_.string();
+        }
+        std::cerr << '\n';
+    }
+    nombreMessagesAffiches_ += nombreNonAffiches;
+    fermer();
+    return nombreRejets_;
+}
+
+/// \param raison   La raison de rejet.
+/// \return         Le code de la raison écrit dans le fichier de quarantaine, comme "ligne_mal_formee".
+std::string_view CollecteurRejets::getCode(RaisonRejet raison)
+{
+    return descriptionsRaisons[static_cast<std::size_t>(raison)].code;
+}
+
+/// Écrit les rejets accumulés dans le fichier de quarantaine.
+void CollecteurRejets::vider()
+{
+    if (!tampon_.empty() && std::fwrite(tampon_.data(), 1, tampon_.size(), quarantaine_) != tampon_.size())
+    {
+        erreurQuarantaine_ = true;
+    }
+    tampon_.clear();
+}
+
+/// Écrit les derniers rejets et ferme le fichier de quarantaine, une seule fois.
+void CollecteurRejets::fermer()
+{
+    if (quarantaine_ == nullptr)
+    {
+        return;
+    }
+    vider();
+    if (std::fclose(quarantaine_) != 0)
+    {
+        erreurQuarantaine_ = true;
+    }
+    quarantaine_ = nullptr;
+    if (erreurQuarantaine_)
+    {
+        std::cerr << "Erreur " << source_ << ": le fichier de quarantaine " << cheminQuarantaine_.string()
+                  << " n'a pas pu être entièrement écrit\n";
+    }
+}
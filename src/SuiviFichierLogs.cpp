@@ -0,0 +1,261 @@
+/// Suivi d'un fichier de logs qui grossit en continu, à la manière de tail -F.
+
+#include "SuiviFichierLogs.h"
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "Instrumentation.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t tailleLecture = 64 * 1024;
+
+    /// Retourne l'identité (inode) et la taille d'un fichier.
+    /// \return True si le fichier existe, false sinon.
+    bool getEtatFichier(const std::string& nomFichier, std::uint64_t& identite, std::uint64_t& taille)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        struct stat etat;
+        if (stat(nomFichier.c_str(), &etat) != 0)
+        {
+            return false;
+        }
+        identite = static_cast<std::uint64_t>(etat.st_ino);
+        taille = static_cast<std::uint64_t>(etat.st_size);
+        return true;
+#else
+        std::error_code erreur;
+        taille = std::filesystem::file_size(nomFichier, erreur);
+        identite = 0;
+        return !erreur;
+#endif
+    }
+} // namespace
+
+/// Constructeur qui commence à suivre un fichier depuis son début. Les lignes déjà présentes sont appliquées au
+/// premier appel à rattraper().
+/// \param analyseurLogs            L'analyseur auquel ajouter les lignes.
+/// \param gestionnaireUtilisateurs Le gestionnaire des utilisateurs pour lier un utilisateur à un log.
+/// \param gestionnaireFilms        Le gestionnaire des films pour lier un film à un log.
+/// \param nomFichier               Le fichier de logs à suivre; il peut ne pas encore exister.
+/// \param options                  Le traitement des lignes mal formées et de celles dont l'utilisateur ou le film
+///                                 est introuvable.
+SuiviFichierLogs::SuiviFichierLogs(AnalyseurLogs& analyseurLogs,
+                                   const GestionnaireUtilisateurs& gestionnaireUtilisateurs,
+                                   const GestionnaireFilms& gestionnaireFilms,
+                                   std::string nomFichier,
+                                   const OptionsRejets& options)
+    : analyseurLogs_(analyseurLogs)
+    , gestionnaireUtilisateurs_(gestionnaireUtilisateurs)
+    , gestionnaireFilms_(gestionnaireFilms)
+    , nomFichier_(std::move(nomFichier))
+    , optionsRejets_(options)
+{
+#if defined(__linux__)
+    // Le dossier est surveillé plutôt que le fichier pour voir aussi le fichier recréé après une rotation
+    std::filesystem::path dossier = std::filesystem::path(nomFichier_).parent_path();
+    descripteurInotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descripteurInotify_ != -1 &&
+        inotify_add_watch(descripteurInotify_,
+                          dossier.empty() ? "." : dossier.c_str(),
+                          IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) == -1)
+    {
+        close(descripteurInotify_);
+        descripteurInotify_ = -1;
+    }
+#endif
+    ouvrir();
+}
+
+/// Destructeur qui ferme le descripteur inotify.
+SuiviFichierLogs::~SuiviFichierLogs()
+{
+#if defined(__linux__)
+    if (descripteurInotify_ != -1)
+    {
+        close(descripteurInotify_);
+    }
+#endif
+}
+
+/// Applique à l'analyseur les lignes complètes écrites depuis le dernier appel, puis, si le fichier a été remplacé,
+/// celles du nouveau fichier. Un fichier tronqué est relu depuis le début.
+/// \return Le nombre de lignes appliquées et de lignes rejetées, et le succès si toutes les lignes lues ont été
+///         interprétées. Un fichier qui n'existe pas encore n'est pas une erreur.
+BilanChargement SuiviFichierLogs::rattraper()
+{
+    INSTRUMENTER_PHASE(SuiviLogs);
+#if defined(__linux__)
+    // Les événements en attente sont consommés: la lecture qui suit couvre toutes les modifications signalées
+    char evenements[4096];
+    while (descripteurInotify_ != -1 && read(descripteurInotify_, evenements, sizeof(evenements)) > 0)
+    {
+    }
+#endif
+    BilanChargement bilan;
+    bilan.succes = true;
+    if (!fichier_.is_open() && !ouvrir())
+    {
+        return bilan;
+    }
+    std::size_t nombreLignesAvant = nombreLignesAppliquees_;
+    CollecteurRejets rejets("SuiviFichierLogs", optionsRejets_);
+    optionsRejets_.ajouterQuarantaine = true;
+
+    // Le remplacement est détecté avant la dernière lecture de l'ancien fichier, qui ne recevra plus de lignes
+    Changement changement = detecterChangement();
+    if (changement == Changement::Troncature)
+    {
+        // Les octets lus avant la troncature n'existent plus: la ligne incomplète n'est pas appliquée
+        nombreRotations_++;
+        position_ = 0;
+        ligneIncomplete_.clear();
+    }
+    bilan.succes = lireNouvellesLignes(changement == Changement::Rotation, rejets);
+    if (changement == Changement::Rotation)
+    {
+        nombreRotations_++;
+        fichier_.close();
+        if (ouvrir())
+        {
+            bilan.succes &= lireNouvellesLignes(false, rejets);
+        }
+    }
+    bilan.nombreLignesChargees = nombreLignesAppliquees_ - nombreLignesAvant;
+    bilan.nombreRejets = rejets.terminer();
+    return bilan;
+}
+
+/// Attend que le dossier du fichier soit modifié.
+/// \param delai    La durée maximale de l'attente.
+/// \return         True si une modification a été signalée ou si inotify n'est pas disponible, false si le délai
+///                 s'est écoulé sans modification.
+bool SuiviFichierLogs::attendre(std::chrono::milliseconds delai)
+{
+#if defined(__linux__)
+    if (descripteurInotify_ != -1)
+    {
+        pollfd descripteur{descripteurInotify_, POLLIN, 0};
+        return poll(&descripteur, 1, static_cast<int>(delai.count())) > 0;
+    }
+#endif
+    std::this_thread::sleep_for(delai);
+    return true;
+}
+
+/// \return Le descripteur inotify à surveiller en lecture dans une boucle poll(), ou -1 s'il n'est pas disponible.
+int SuiviFichierLogs::getDescripteur() const
+{
+    return descripteurInotify_;
+}
+
+/// \return La position dans le fichier suivi de l'octet qui suit la dernière ligne complète.
+std::uint64_t SuiviFichierLogs::getPosition() const
+{
+    return position_;
+}
+
+/// \return Le nombre de lignes ajoutées à l'analyseur depuis la création du suivi.
+std::size_t SuiviFichierLogs::getNombreLignesAppliquees() const
+{
+    return nombreLignesAppliquees_;
+}
+
+/// \return Le nombre de fois où le fichier a été remplacé ou tronqué.
+std::size_t SuiviFichierLogs::getNombreRotations() const
+{
+    return nombreRotations_;
+}
+
+/// Ouvre le fichier suivi et repart de son début.
+/// \return True si le fichier a pu être ouvert, false sinon.
+bool SuiviFichierLogs::ouvrir()
+{
+    std::uint64_t taille;
+    if (!getEtatFichier(nomFichier_, identiteFichier_, taille))
+    {
+        return false;
+    }
+    fichier_.open(nomFichier_, std::ios::binary);
+    position_ = 0;
+    ligneIncomplete_.clear();
+    return fichier_.is_open();
+}
+
+/// Lit le fichier ouvert jusqu'à sa fin et applique les lignes complètes à l'analyseur en un seul lot.
+/// \param dernierPassage   True si le fichier a été remplacé: sa dernière ligne, même sans saut de ligne, est alors
+///                         complète et appliquée plutôt que perdue.
+/// \param rejets           Le collecteur auquel signaler les lignes rejetées.
+/// \return                 True si toutes les lignes complètes ont été interprétées, false sinon.
+bool SuiviFichierLogs::lireNouvellesLignes(bool dernierPassage, CollecteurRejets& rejets)
+{
+    fichier_.clear();
+    fichier_.seekg(static_cast<std::streamoff>(position_ + ligneIncomplete_.size()));
+    char tampon[tailleLecture];
+    while (fichier_.read(tampon, sizeof(tampon)) || fichier_.gcount() > 0)
+    {
+        ligneIncomplete_.append(tampon, static_cast<std::size_t>(fichier_.gcount()));
+    }
+    if (dernierPassage && !ligneIncomplete_.empty())
+    {
+        ligneIncomplete_.push_back('\n');
+    }
+
+    bool succesParsing = true;
+    std::vector<AnalyseurLogs::EntreeLog> entreesLog;
+    std::size_t debut = 0;
+    for (std::size_t fin; (fin = ligneIncomplete_.find('\n', debut)) != std::string::npos; debut = fin + 1)
+    {
+        std::string ligne = ligneIncomplete_.substr(debut, fin - debut);
+        AnalyseurLogs::EntreeLog entreeLog;
+        if (AnalyseurLogs::analyserLigne(ligne, entreeLog))
+        {
+            entreesLog.push_back(std::move(entreeLog));
+        }
+        else
+        {
+            INSTRUMENTER_COMPTEUR(LignesRejetees, 1);
+            rejets.rejeter(RaisonRejet::LigneMalFormee, ligne);
+            succesParsing = false;
+        }
+    }
+    position_ += debut;
+    ligneIncomplete_.erase(0, debut);
+
+    if (!entreesLog.empty())
+    {
+        INSTRUMENTER_COMPTEUR(LignesLues, entreesLog.size());
+        std::vector<bool> resultats = analyseurLogs_.creerLignesLog(
+            std::move(entreesLog), gestionnaireUtilisateurs_, gestionnaireFilms_, &rejets);
+        nombreLignesAppliquees_ += static_cast<std::size_t>(std::count(resultats.begin(), resultats.end(), true));
+    }
+    return succesParsing;
+}
+
+/// \return Rotation si le chemin suivi désigne maintenant un autre fichier, Troncature si le fichier ouvert est plus
+///         court que ce qui en a été lu, Aucun sinon.
+SuiviFichierLogs::Changement SuiviFichierLogs::detecterChangement() const
+{
+    std::uint64_t identite;
+    std::uint64_t taille;
+    if (!getEtatFichier(nomFichier_, identite, taille))
+    {
+        return Changement::Aucun; // Renommé mais pas encore recréé: l'ancien fichier reste suivi
+    }
+    if (identite != identiteFichier_)
+    {
+        return Changement::Rotation;
+    }
+    return taille < position_ + ligneIncomplete_.size() ? Changement::Troncature : Changement::Aucun;
+}
@@ -5,14 +5,39 @@
 #include "Tests.h"
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <thread>
+#include <tuple>
 #include <vector>
 #include "AnalyseurLogs.h"
+#include "AnalyseurLogsExterne.h"
+#include "Exportation.h"
 #include "Foncteurs.h"
+#include "GenerateurDonnees.h"
 #include "GestionnaireFilms.h"
 #include "GestionnaireUtilisateurs.h"
+#include "Horodatage.h"
+#include "IngesteurConcurrent.h"
+#include "Instrumentation.h"
+#include "JournalMutations.h"
+#include "LogsLSM.h"
+#include "NoyauxColonnes.h"
+#include "PipelineIngestion.h"
+#include "PredicatsFilms.h"
+#include "ProcesseurRequetes.h"
+#include "RejetsChargement.h"
+#include "SuiviFichierLogs.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 
 namespace
 {
@@ -236,6 +261,87 @@ namespace Tests
         tests.push_back(sortieRecue == sortieAttendue);
         afficherResultatTest(5, "GestionnaireUtilisateurs::operator<<", tests.back());
 
+        // Test 6
+        std::vector<bool> ajoutsLot = gestionnaireUtilisateurs.ajouterUtilisateurs({
+            Utilisateur{"lot.1@email.com", "Prénom Nom", 20, Pays::Canada},
+            Utilisateur{"akoblin@optonline.net", "Prénom Nom", 20, Pays::Canada},
+            Utilisateur{"lot.2@email.com", "Prénom Nom", 20, Pays::Canada},
+            Utilisateur{"lot.1@email.com", "Prénom Nom", 20, Pays::Canada},
+        });
+        std::vector<bool> ajoutsLotAttendus = {true, false, true, false};
+        tests.push_back(ajoutsLot == ajoutsLotAttendus && gestionnaireUtilisateurs.getNombreUtilisateurs() == 102 &&
+                        gestionnaireUtilisateurs.getUtilisateurParId("lot.2@email.com") != nullptr);
+        afficherResultatTest(6, "GestionnaireUtilisateurs::ajouterUtilisateurs", tests.back());
+
+        // Test 7
+        std::size_t nombreJapon = gestionnaireUtilisateurs.getUtilisateursParPays(Pays::Japon).size();
+        std::vector<const Utilisateur*> utilisateursAges = gestionnaireUtilisateurs.getUtilisateursEntreAges(95, 100);
+        std::vector<const Utilisateur*> utilisateursJaponJeunes =
+            gestionnaireUtilisateurs.getUtilisateursParPaysEntreAges(Pays::Japon, 1, 10);
+        bool agesTries = std::is_sorted(utilisateursAges.begin(),
+                                        utilisateursAges.end(),
+                                        [](const Utilisateur* utilisateur1, const Utilisateur* utilisateur2) {
+                                            return utilisateur1->age < utilisateur2->age;
+                                        });
+        gestionnaireUtilisateurs.supprimerUtilisateur("scottlee@att.net");
+        std::size_t nombreJaponJeunes2 =
+            gestionnaireUtilisateurs.getUtilisateursParPaysEntreAges(Pays::Japon, 1, 10).size();
+        GestionnaireUtilisateurs gestionnaireUtilisateursCopie(gestionnaireUtilisateurs);
+        std::vector<const Utilisateur*> utilisateursJaponCopie =
+            gestionnaireUtilisateursCopie.getUtilisateursParPays(Pays::Japon);
+        bool copieIndexee =
+            utilisateursJaponCopie.size() == nombreJapon - 1 &&
+            std::all_of(utilisateursJaponCopie.begin(),
+                        utilisateursJaponCopie.end(),
+                        [&gestionnaireUtilisateursCopie](const Utilisateur* utilisateur) {
+                            return gestionnaireUtilisateursCopie.getUtilisateurParId(utilisateur->id) == utilisateur;
+                        });
+        tests.push_back(nombreJapon == 7 && utilisateursAges.size() == 6 && agesTries &&
+                        utilisateursJaponJeunes.size() == 3 && nombreJaponJeunes2 == 2 && copieIndexee);
+        afficherResultatTest(7, "GestionnaireUtilisateurs filtres pays et âge", tests.back());
+
+        // Test 8
+        // Le fichier rechargé retire le premier utilisateur, change l'âge et le pays du deuxième et ajoute un
+        // utilisateur; tous les utilisateurs conservés gardent leur adresse
+        std::filesystem::path fichierUtilisateursRecharge =
+            std::filesystem::temp_directory_path() / "td5_tests_utilisateurs.txt";
+        {
+            std::ifstream fichierUtilisateurs("utilisateurs.txt");
+            std::ofstream fichierRecharge(fichierUtilisateursRecharge);
+            std::string ligne;
+            std::getline(fichierUtilisateurs, ligne);
+            std::getline(fichierUtilisateurs, ligne);
+            fichierRecharge << "gravyface@live.com \"Euna Spinks\" 99 5\n";
+            while (std::getline(fichierUtilisateurs, ligne))
+            {
+                fichierRecharge << ligne << '\n';
+            }
+            fichierRecharge << "nouveau@email.com \"Prénom Nom\" 30 0\n";
+        }
+        GestionnaireUtilisateurs gestionnaireUtilisateursRecharge;
+        gestionnaireUtilisateursRecharge.chargerDepuisFichier("utilisateurs.txt");
+        const Utilisateur* utilisateurModifie =
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("gravyface@live.com");
+        const Utilisateur* utilisateurInchange =
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("ivoibs@yahoo.ca");
+        BilanRechargement bilanUtilisateurs =
+            gestionnaireUtilisateursRecharge.rechargerDepuisFichier(fichierUtilisateursRecharge.string());
+        std::filesystem::remove(fichierUtilisateursRecharge);
+        std::vector<const Utilisateur*> utilisateursAgesRecharge =
+            gestionnaireUtilisateursRecharge.getUtilisateursParPaysEntreAges(Pays::Japon, 99, 99);
+        bool bilanUtilisateursCorrect = bilanUtilisateurs.succes && bilanUtilisateurs.nombreAjouts == 1 &&
+                                        bilanUtilisateurs.nombreModifications == 1 &&
+                                        bilanUtilisateurs.nombreSuppressions == 1 &&
+                                        bilanUtilisateurs.nombreInchanges == 98;
+        tests.push_back(
+            bilanUtilisateursCorrect && gestionnaireUtilisateursRecharge.getNombreUtilisateurs() == 100 &&
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("gravyface@live.com") == utilisateurModifie &&
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("ivoibs@yahoo.ca") == utilisateurInchange &&
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("denton@me.com") == nullptr &&
+            gestionnaireUtilisateursRecharge.getUtilisateurParId("nouveau@email.com") != nullptr &&
+            std::vector<const Utilisateur*>{utilisateurModifie} == utilisateursAgesRecharge);
+        afficherResultatTest(8, "GestionnaireUtilisateurs::rechargerDepuisFichier", tests.back());
+
         int nombreTestsReussis = static_cast<int>(std::count(tests.begin(), tests.end(), true));
         double totalPointsSection =
             static_cast<double>(nombreTestsReussis) / static_cast<double>(tests.size()) * maxPointsSection;
@@ -313,6 +419,24 @@ namespace Tests
         tests.push_back(comparaisonPaire1 && !comparaisonPaire2 && !comparaisonPaire3);
         afficherResultatTest(3, "Foncteur ComparateurSecondElementPaire", tests.back());
 
+        // Test 4
+        using namespace PredicatsFilms;
+        Film filmHorreur{"Nom", Film::Genre::Horreur, Pays::France, "Réalisateur", 1995};
+        Film filmHorreurJapon{"Nom", Film::Genre::Horreur, Pays::Japon, "Réalisateur", 1995};
+        auto predicatEt = annee(1990, 2000) && genre(Film::Genre::Horreur) && pays(Pays::France);
+        auto predicatFoncteur = selon(EstDansIntervalleDatesFilm(anneeInferieure, anneeSuperieure)) &&
+                                !realisateur("Autre");
+        auto predicatOu = pays(Pays::Japon) || annee(1970, 1970);
+        ContraintesIndex contraintesEt;
+        predicatEt.ajouterContraintes(contraintesEt);
+        ContraintesIndex contraintesOu;
+        predicatOu.ajouterContraintes(contraintesOu);
+        tests.push_back(predicatEt(filmHorreur) && !predicatEt(filmHorreurJapon) && !predicatEt(*film5) &&
+                        predicatFoncteur(*film5) && !predicatFoncteur(*film7) && predicatOu(filmHorreurJapon) &&
+                        predicatOu(*film1) && !predicatOu(filmHorreur) && contraintesEt.genre == Film::Genre::Horreur &&
+                        contraintesEt.pays == Pays::France && !contraintesOu.genre && !contraintesOu.pays);
+        afficherResultatTest(4, "PredicatsFilms composition avec &&, || et !", tests.back());
+
         int nombreTestsReussis = static_cast<int>(std::count(tests.begin(), tests.end(), true));
         double totalPointsSection =
             static_cast<double>(nombreTestsReussis) / static_cast<double>(tests.size()) * maxPointsSection;
@@ -494,6 +618,289 @@ namespace Tests
         tests.push_back(nombre3 == gestionnaireFilms.getNombreFilms() && nombre4 == 331);
         afficherResultatTest(9, "Chargement et copy ctor toujours fonctionnels", tests.back());
 
+        // Test 10
+        GestionnaireFilms gestionnaireFilms3(gestionnaireFilms);
+        const Film* filmPartage = gestionnaireFilms3.getFilmParNom(film20.nom);
+        bool filmEstPartage = filmPartage == gestionnaireFilms.getFilmParNom(film20.nom);
+        gestionnaireFilms3.supprimerFilm(film21.nom);
+        gestionnaireFilms3.ajouterFilm(Film{"Nom25", Film::Genre::Horreur, Pays::Japon, "Réalisateur", 1970});
+        bool originalIntact = gestionnaireFilms.getNombreFilms() == 5 &&
+                              gestionnaireFilms.getFilmParNom(film21.nom) != nullptr &&
+                              gestionnaireFilms.getFilmParNom("Nom25") == nullptr &&
+                              gestionnaireFilms.getFilmsParGenre(Film::Genre::Horreur).empty() &&
+                              gestionnaireFilms.getFilmsParGenre(Film::Genre::Documentaire).size() == 5;
+        bool copieModifiee = gestionnaireFilms3.getNombreFilms() == 5 &&
+                             gestionnaireFilms3.getFilmParNom(film21.nom) == nullptr &&
+                             gestionnaireFilms3.getFilmsParGenre(Film::Genre::Horreur).size() == 1 &&
+                             gestionnaireFilms3.getFilmsParGenre(Film::Genre::Documentaire).size() == 4 &&
+                             gestionnaireFilms3.getFilmParNom(film20.nom) == filmPartage;
+        tests.push_back(filmEstPartage && originalIntact && copieModifiee);
+        afficherResultatTest(10, "Copie partagée indépendante après modification", tests.back());
+
+        // Test 11
+        std::vector<bool> ajoutsLot = gestionnaireFilms3.ajouterFilms({
+            Film{"Lot1", Film::Genre::Romance, Pays::France, "Réalisateur", 1970},
+            Film{"Lot2", Film::Genre::Romance, Pays::Chine, "Réalisateur", 1970},
+            Film{"Lot1", Film::Genre::Romance, Pays::France, "Réalisateur", 1970},
+            Film{"Lot3", Film::Genre::Horreur, Pays::France, "Réalisateur", 1970},
+        });
+        std::vector<bool> ajoutsLotAttendus = {true, true, false, true};
+        const Film* pointeurLot3 = gestionnaireFilms3.getFilmParNom("Lot3");
+        std::vector<bool> suppressionsLot = gestionnaireFilms3.supprimerFilms({"Lot1", "Inconnu", "Lot2", "Nom25"});
+        std::vector<bool> suppressionsLotAttendues = {true, false, true, true};
+        std::vector<const Film*> filmsHorreurAttendus = {pointeurLot3};
+        tests.push_back(ajoutsLot == ajoutsLotAttendus && suppressionsLot == suppressionsLotAttendues &&
+                        gestionnaireFilms3.getNombreFilms() == 5 &&
+                        gestionnaireFilms3.getFilmsParGenre(Film::Genre::Romance).empty() &&
+                        gestionnaireFilms3.getFilmsParGenre(Film::Genre::Horreur) == filmsHorreurAttendus &&
+                        gestionnaireFilms3.getFilmsParPays(Pays::France) == filmsHorreurAttendus &&
+                        gestionnaireFilms3.getFilmParNom("Lot1") == nullptr);
+        afficherResultatTest(11, "GestionnaireFilms::ajouterFilms/supprimerFilms", tests.back());
+
+        // Test 12
+        static constexpr std::size_t nombreFilmsLotParallele = 10000;
+        std::vector<Film> filmsLotParallele;
+        for (std::size_t i = 0; i < nombreFilmsLotParallele; i++)
+        {
+            // Chaque nom apparaît deux fois; seule la première occurrence (genre Action) doit être conservée
+            filmsLotParallele.push_back(
+                Film{"Parallele" + std::to_string(i % (nombreFilmsLotParallele / 2)),
+                     i < nombreFilmsLotParallele / 2 ? Film::Genre::Action : Film::Genre::Drame,
+                     Pays::Mexique,
+                     "Réalisateur",
+                     2000});
+        }
+        GestionnaireFilms gestionnaireFilmsParallele;
+        std::vector<bool> ajoutsParalleles = gestionnaireFilmsParallele.ajouterFilms(std::move(filmsLotParallele));
+        const Film* filmParallele = gestionnaireFilmsParallele.getFilmParNom("Parallele42");
+        tests.push_back(gestionnaireFilmsParallele.getNombreFilms() == nombreFilmsLotParallele / 2 &&
+                        std::count(ajoutsParalleles.begin(), ajoutsParalleles.end(), true) ==
+                            static_cast<std::ptrdiff_t>(nombreFilmsLotParallele / 2) &&
+                        ajoutsParalleles.front() && !ajoutsParalleles.back() && filmParallele != nullptr &&
+                        filmParallele->genre == Film::Genre::Action &&
+                        gestionnaireFilmsParallele.getFilmsParGenre(Film::Genre::Drame).empty() &&
+                        gestionnaireFilmsParallele.getFilmsParPays(Pays::Mexique).size() ==
+                            nombreFilmsLotParallele / 2);
+        afficherResultatTest(12, "GestionnaireFilms::ajouterFilms en parallèle", tests.back());
+
+        // Test 13
+        // Le fichier rechargé retire le premier film, change le genre du deuxième, l'année du troisième et ajoute un
+        // film; les autres films gardent leur adresse. Un film modifié qui n'est pas partagé est mis à jour sur place,
+        // et l'analyseur passé au rechargement perd les lignes du film retiré
+        std::filesystem::path fichierFilmsRecharge = std::filesystem::temp_directory_path() / "td5_tests_films.txt";
+        {
+            std::ifstream fichierFilms("films.txt");
+            std::ofstream fichierRecharge(fichierFilmsRecharge);
+            std::string ligne;
+            std::getline(fichierFilms, ligne);
+            fichierRecharge << "\"A Buddy Holly Past Life\" 6 2 \"Harvey Schwartz\" 2005\n"
+                            << "\"A Failure of Probabilities\" 2 6 \"Ed Carter\" 1999\n";
+            std::getline(fichierFilms, ligne);
+            std::getline(fichierFilms, ligne);
+            while (std::getline(fichierFilms, ligne))
+            {
+                fichierRecharge << ligne << '\n';
+            }
+            fichierRecharge << "\"Nouveau film\" 0 0 \"Réalisateur\" 2020\n";
+        }
+        GestionnaireFilms gestionnaireFilmsRecharge;
+        gestionnaireFilmsRecharge.chargerDepuisFichier("films.txt");
+        std::vector<const Film*> filmsAvant = gestionnaireFilmsRecharge.getFilms();
+        Utilisateur spectateur{"spectateur@email.com", "Prénom Nom", 20, Pays::Canada};
+        AnalyseurLogs analyseurRecharge;
+        analyseurRecharge.ajouterLigneLog(LigneLog{"2017-01-01T00:00:00Z", &spectateur, filmsAvant[0]});
+        analyseurRecharge.ajouterLigneLog(LigneLog{"2017-01-02T00:00:00Z", &spectateur, filmsAvant[1]});
+        analyseurRecharge.ajouterLigneLog(LigneLog{"2017-01-03T00:00:00Z", &spectateur, filmsAvant[1]});
+        BilanRechargement bilanFilms =
+            gestionnaireFilmsRecharge.rechargerDepuisFichier(fichierFilmsRecharge.string(), &analyseurRecharge);
+        std::vector<const Film*> filmsApres = gestionnaireFilmsRecharge.getFilms();
+        const Film* filmGenreModifie = gestionnaireFilmsRecharge.getFilmParNom("A Buddy Holly Past Life");
+        std::vector<const Film*> filmsHorreur = gestionnaireFilmsRecharge.getFilmsParGenre(Film::Genre::Horreur);
+        std::vector<const Film*> filmsFantastique =
+            gestionnaireFilmsRecharge.getFilmsParGenre(Film::Genre::Fantastique);
+        bool bilanFilmsCorrect = bilanFilms.succes && bilanFilms.nombreAjouts == 1 &&
+                                 bilanFilms.nombreModifications == 2 && bilanFilms.nombreSuppressions == 1 &&
+                                 bilanFilms.nombreInchanges == 328;
+        bool inchangesConserves = filmsApres.size() == 331 && std::equal(filmsAvant.begin() + 3,
+                                                                         filmsAvant.end(),
+                                                                         filmsApres.begin() + 2,
+                                                                         filmsApres.end() - 1);
+        bool modificationsAppliquees =
+            filmsApres[0] == filmGenreModifie && filmGenreModifie->genre == Film::Genre::Horreur &&
+            filmsApres[1]->annee == 1999 &&
+            std::count(filmsHorreur.begin(), filmsHorreur.end(), filmGenreModifie) == 1 &&
+            std::none_of(filmsFantastique.begin(),
+                         filmsFantastique.end(),
+                         [](const Film* film) { return film->nom == "A Buddy Holly Past Life"; }) &&
+            gestionnaireFilmsRecharge.getFilmParNom("A Boy and His God") == nullptr &&
+            gestionnaireFilmsRecharge.getFilmParNom("Nouveau film") == filmsApres.back();
+        const std::vector<LigneLog>& logsRecharge = analyseurRecharge.getLogs();
+        bool analyseurCoherent = filmGenreModifie == filmsAvant[1] && logsRecharge.size() == 2 &&
+                                 std::all_of(logsRecharge.begin(),
+                                             logsRecharge.end(),
+                                             [&](const LigneLog& ligne) { return ligne.film == filmGenreModifie; }) &&
+                                 analyseurRecharge.getNombreVuesFilm(filmGenreModifie) == 2;
+
+        // Un film partagé avec une copie du gestionnaire est remplacé: la copie garde l'ancienne version et
+        // l'analyseur est redirigé vers la nouvelle
+        GestionnaireFilms gestionnaireFilmsPartage;
+        gestionnaireFilmsPartage.chargerDepuisFichier("films.txt");
+        GestionnaireFilms copieFilmsPartage = gestionnaireFilmsPartage;
+        const Film* filmPartageAvant = gestionnaireFilmsPartage.getFilmParNom("A Buddy Holly Past Life");
+        AnalyseurLogs analyseurPartage;
+        analyseurPartage.ajouterLigneLog(LigneLog{"2017-01-01T00:00:00Z", &spectateur, filmPartageAvant});
+        gestionnaireFilmsPartage.rechargerDepuisFichier(fichierFilmsRecharge.string(), &analyseurPartage);
+        std::filesystem::remove(fichierFilmsRecharge);
+        const Film* filmPartageApres = gestionnaireFilmsPartage.getFilmParNom("A Buddy Holly Past Life");
+        bool copieIsolee = filmPartageApres != filmPartageAvant && filmPartageApres->genre == Film::Genre::Horreur &&
+                           copieFilmsPartage.getFilmParNom("A Buddy Holly Past Life") == filmPartageAvant &&
+                           filmPartageAvant->genre == Film::Genre::Fantastique &&
+                           copieFilmsPartage.getFilmParNom("A Boy and His God") != nullptr &&
+                           analyseurPartage.getLogs()[0].film == filmPartageApres &&
+                           analyseurPartage.getNombreVuesFilm(filmPartageApres) == 1 &&
+                           analyseurPartage.getNombreVuesFilm(filmPartageAvant) == 0;
+        tests.push_back(bilanFilmsCorrect && inchangesConserves && modificationsAppliquees && analyseurCoherent &&
+                        copieIsolee);
+        afficherResultatTest(13, "GestionnaireFilms::rechargerDepuisFichier", tests.back());
+
+        // Test 14
+        // Un film d'une autre année ne périme pas l'intervalle en cache; un film de l'intervalle le périme
+        GestionnaireFilms gestionnaireFilmsCache;
+        gestionnaireFilmsCache.chargerDepuisFichier("films.txt");
+        std::vector<const Film*> filmsAnnees90 = gestionnaireFilmsCache.getFilmsEntreAnnees(1990, 1999);
+        bool succesCache1 = gestionnaireFilmsCache.getFilmsEntreAnnees(1990, 1999) == filmsAnnees90;
+        gestionnaireFilmsCache.ajouterFilm(Film{"Film 1850", Film::Genre::Drame, Pays::France, "Réalisateur", 1850});
+        bool succesCache2 = gestionnaireFilmsCache.getFilmsEntreAnnees(1990, 1999) == filmsAnnees90;
+        StatistiquesCache statistiquesAvant = gestionnaireFilmsCache.getStatistiquesCache();
+        gestionnaireFilmsCache.ajouterFilm(Film{"Film 1995", Film::Genre::Drame, Pays::France, "Réalisateur", 1995});
+        std::vector<const Film*> filmsAnnees90Ajout = gestionnaireFilmsCache.getFilmsEntreAnnees(1990, 1999);
+        bool filmAjouteTrouve = filmsAnnees90Ajout.back() == gestionnaireFilmsCache.getFilmParNom("Film 1995");
+        gestionnaireFilmsCache.supprimerFilm("Film 1995");
+        std::vector<const Film*> filmsAnnees90Suppression = gestionnaireFilmsCache.getFilmsEntreAnnees(1990, 1999);
+        StatistiquesCache statistiquesApres = gestionnaireFilmsCache.getStatistiquesCache();
+        tests.push_back(succesCache1 && succesCache2 && statistiquesAvant.nombreSucces == 2 &&
+                        statistiquesAvant.nombreDefauts == 1 && filmsAnnees90Ajout.size() == filmsAnnees90.size() + 1 &&
+                        filmAjouteTrouve && filmsAnnees90Suppression == filmsAnnees90 &&
+                        statistiquesApres.nombreSucces == 2 && statistiquesApres.nombreDefauts == 3 &&
+                        statistiquesApres.nombreInvalidations == 2);
+        afficherResultatTest(14, "GestionnaireFilms cache de getFilmsEntreAnnees", tests.back());
+
+        // Test 15
+        // Le parcours d'un seul filtre indexé donne les mêmes films, dans le même ordre, que plusieurs filtrages
+        {
+            using namespace PredicatsFilms;
+            GestionnaireFilms gestionnaireFilmsPredicats;
+            gestionnaireFilmsPredicats.chargerDepuisFichier("films.txt");
+            std::vector<const Film*> tousLesFilms = gestionnaireFilmsPredicats.getFilms();
+            auto filtrer = [&tousLesFilms](auto predicat) {
+                std::vector<const Film*> films;
+                std::copy_if(tousLesFilms.begin(),
+                             tousLesFilms.end(),
+                             std::back_inserter(films),
+                             [&predicat](const Film* film) { return predicat(*film); });
+                return films;
+            };
+            auto predicatIndexe = annee(1980, 2010) && genre(Film::Genre::Drame) && pays(Pays::EtatsUnis);
+            auto predicatNonIndexe = annee(1980, 2010) && !genre(Film::Genre::Drame);
+            auto predicatOu = genre(Film::Genre::Horreur) || pays(Pays::Japon);
+            std::vector<const Film*> filmsIndexes = gestionnaireFilmsPredicats.getFilmsSelon(predicatIndexe);
+            tests.push_back(!filmsIndexes.empty() && filmsIndexes == filtrer(predicatIndexe) &&
+                            gestionnaireFilmsPredicats.getFilmsSelon(predicatNonIndexe) == filtrer(predicatNonIndexe) &&
+                            gestionnaireFilmsPredicats.getFilmsSelon(predicatOu) == filtrer(predicatOu) &&
+                            gestionnaireFilmsPredicats.getFilmsSelon(pays(Pays::Mexique) && annee(0, 3000)).size() ==
+                                gestionnaireFilmsPredicats.getFilmsParPays(Pays::Mexique).size());
+            afficherResultatTest(15, "GestionnaireFilms::getFilmsSelon", tests.back());
+        }
+
+        // Test 16
+        // Les filtres par genre et par pays ne sont construits qu'à leur première requête, puis maintenus
+        {
+            GestionnaireFilms gestionnaireFilmsIndex;
+            gestionnaireFilmsIndex.chargerDepuisFichier("films.txt");
+            std::vector<const Film*> tousLesFilms = gestionnaireFilmsIndex.getFilms();
+            auto filtrerGenre = [&tousLesFilms](Film::Genre genre) {
+                std::vector<const Film*> films;
+                std::copy_if(tousLesFilms.begin(),
+                             tousLesFilms.end(),
+                             std::back_inserter(films),
+                             [genre](const Film* film) { return film->genre == genre; });
+                return films;
+            };
+            bool estParesseux = gestionnaireFilmsIndex.getFilmParNom("A Boy and His God") != nullptr &&
+                                !gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Genre) &&
+                                !gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Pays) &&
+                                gestionnaireFilmsIndex.getUtilisationMemoire().getOctets("filtreGenreFilms_") == 0;
+            bool estConstruit = gestionnaireFilmsIndex.getFilmsParGenre(Film::Genre::Drame) ==
+                                    filtrerGenre(Film::Genre::Drame) &&
+                                gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Genre) &&
+                                !gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Pays);
+
+            gestionnaireFilmsIndex.ajouterFilm(
+                Film{"Film ajouté", Film::Genre::Drame, Pays::France, "Réalisateur", 2000});
+            tousLesFilms = gestionnaireFilmsIndex.getFilms();
+            bool estMaintenu = gestionnaireFilmsIndex.getFilmsParGenre(Film::Genre::Drame) ==
+                               filtrerGenre(Film::Genre::Drame);
+
+            gestionnaireFilmsIndex.desactiverIndex(GestionnaireFilms::Index::Genre);
+            gestionnaireFilmsIndex.supprimerFilm("Film ajouté");
+            tousLesFilms = gestionnaireFilmsIndex.getFilms();
+            bool estDesactive = gestionnaireFilmsIndex.getFilmsParGenre(Film::Genre::Drame) ==
+                                    filtrerGenre(Film::Genre::Drame) &&
+                                !gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Genre) &&
+                                gestionnaireFilmsIndex.getUtilisationMemoire().getOctets("filtreGenreFilms_") == 0;
+
+            gestionnaireFilmsIndex.activerIndex(GestionnaireFilms::Index::Genre);
+            std::vector<const Film*> filmsReconstruits = gestionnaireFilmsIndex.getFilmsSelon(
+                PredicatsFilms::genre(Film::Genre::Drame) && PredicatsFilms::pays(Pays::France));
+            bool estReactive = gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Genre) &&
+                               gestionnaireFilmsIndex.estIndexConstruit(GestionnaireFilms::Index::Pays) &&
+                               filmsReconstruits.size() ==
+                                   static_cast<std::size_t>(std::count_if(
+                                       tousLesFilms.begin(), tousLesFilms.end(), [](const Film* film) {
+                                           return film->genre == Film::Genre::Drame && film->pays == Pays::France;
+                                       }));
+            tests.push_back(estParesseux && estConstruit && estMaintenu && estDesactive && estReactive);
+            afficherResultatTest(16, "GestionnaireFilms filtres construits au besoin", tests.back());
+        }
+
+        // Test 17
+        // Un petit tampon force plusieurs écritures; le long nom de film est écrit sans être copié dans le tampon
+        {
+            GestionnaireFilms gestionnaireFilmsExport;
+            std::string nomLong(300, 'x');
+            gestionnaireFilmsExport.ajouterFilm(
+                Film{"Nom, \"spécial\"", Film::Genre::Drame, Pays::France, "Réal\\isateur\n", 1999});
+            gestionnaireFilmsExport.ajouterFilm(Film{nomLong, Film::Genre::Action, Pays::Canada, "R", -5});
+            OptionsExport optionsExport;
+            optionsExport.octetsTampon = 16;
+            std::filesystem::path fichierExport = std::filesystem::temp_directory_path() / "td5_tests_export.txt";
+            auto exporterEtLire = [&](FormatExport format, BilanExport& bilan) {
+                bilan = Exportation::exporterFilms(gestionnaireFilmsExport, fichierExport, format, optionsExport);
+                std::ifstream fichier(fichierExport, std::ios::binary);
+                std::ostringstream contenu;
+                contenu << fichier.rdbuf();
+                return contenu.str();
+            };
+            BilanExport bilanCsv;
+            BilanExport bilanJson;
+            BilanExport bilanNdjson;
+            std::string csv = exporterEtLire(FormatExport::Csv, bilanCsv);
+            std::string json = exporterEtLire(FormatExport::Json, bilanJson);
+            std::string ndjson = exporterEtLire(FormatExport::Ndjson, bilanNdjson);
+            std::filesystem::remove(fichierExport);
+            std::string objet1 = "{\"nom\":\"Nom, \\\"spécial\\\"\",\"genre\":\"Drame\",\"pays\":\"France\","
+                                 "\"realisateur\":\"Réal\\\\isateur\\n\",\"annee\":1999}";
+            std::string objet2 = "{\"nom\":\"" + nomLong + "\",\"genre\":\"Action\",\"pays\":\"Canada\","
+                                 "\"realisateur\":\"R\",\"annee\":-5}";
+            tests.push_back(csv == "nom,genre,pays,realisateur,annee\n\"Nom, \"\"spécial\"\"\",Drame,France,"
+                                   "\"Réal\\isateur\n\",1999\n" + nomLong + ",Action,Canada,R,-5\n" &&
+                            json == "[\n" + objet1 + ",\n" + objet2 + "\n]\n" &&
+                            ndjson == objet1 + "\n" + objet2 + "\n" && bilanCsv.succes && bilanJson.succes &&
+                            bilanNdjson.nombreEnregistrements == 2 && bilanNdjson.nombreOctets == ndjson.size() &&
+                            bilanNdjson.nombreEcritures >= 2);
+            afficherResultatTest(17, "Exportation::exporterFilms", tests.back());
+        }
+
         int nombreTestsReussis = static_cast<int>(std::count(tests.begin(), tests.end(), true));
         double totalPointsSection =
             static_cast<double>(nombreTestsReussis) / static_cast<double>(tests.size()) * maxPointsSection;
@@ -580,13 +987,17 @@ namespace Tests
             LigneLog{"2020-05-01T01:00:00Z", pointeursUtilisateurs[3], pointeursFilms[8]},
             LigneLog{"2019-03-01T01:00:00Z", pointeursUtilisateurs[1], pointeursFilms[9]},
         };
-        analyseurLogs.logs_.clear();
+        analyseurLogs.vider();
         for (const auto& ligneLog : logsAjoutes)
         {
             analyseurLogs.ajouterLigneLog(ligneLog);
         }
+        // Les lignes en retard attendent dans l'arbre LSM jusqu'à ce que getLogs() les replie
+        bool retardsEnAttente = analyseurLogs.retards_ && analyseurLogs.retards_->getTaille() > 0;
         bool logsSontOrdonnes =
-            std::is_sorted(analyseurLogs.logs_.begin(), analyseurLogs.logs_.end(), ComparateurLog());
+            retardsEnAttente && analyseurLogs.getLogs().size() == logsAjoutes.size() &&
+            analyseurLogs.retards_->getTaille() == 0 &&
+            std::is_sorted(analyseurLogs.getLogs().begin(), analyseurLogs.getLogs().end(), ComparateurLog());
         int nombreVuesFilm1 = analyseurLogs.vuesFilms_[pointeursFilms[4]];
         int nombreVuesFilm2 = analyseurLogs.vuesFilms_[pointeursFilms[5]];
         tests.push_back(logsSontOrdonnes && nombreVuesFilm1 == 6 && nombreVuesFilm2 == 1);
@@ -649,6 +1060,1012 @@ namespace Tests
         tests.push_back(filmsVus1.empty() && filmsVus2.empty() && filmsVus3 == filmsVus3Attendus && filmsVus4.empty());
         afficherResultatTest(7, "AnalyseurLogs::getFilmsVusParUtilisateur", tests.back());
 
+        // Test 8
+        AnalyseurLogs analyseurLogsLot;
+        analyseurLogsLot.ajouterLigneLog(LigneLog{"2018-01-01T05:00:00Z", pointeursUtilisateurs[0], pointeursFilms[0]});
+        std::vector<bool> creationsLot = analyseurLogsLot.creerLignesLog(
+            {
+                AnalyseurLogs::EntreeLog{"2018-01-01T09:00:00Z", "prénom.nom.1@email.com", "Nom1"},
+                AnalyseurLogs::EntreeLog{"2018-01-01T01:00:00Z", "inconnu@email.com", "Nom1"},
+                AnalyseurLogs::EntreeLog{"2018-01-01T01:00:00Z", "prénom.nom.2@email.com", "Nom2"},
+                AnalyseurLogs::EntreeLog{"2018-01-01T07:00:00Z", "prénom.nom.2@email.com", "Inconnu"},
+            },
+            gestionnaireUtilisateurs,
+            gestionnaireFilms);
+        std::vector<bool> creationsLotAttendues = {true, false, true, false};
+        bool logsLotSontOrdonnes =
+            std::is_sorted(analyseurLogsLot.getLogs().begin(), analyseurLogsLot.getLogs().end(), ComparateurLog());
+        tests.push_back(creationsLot == creationsLotAttendues && logsLotSontOrdonnes &&
+                        analyseurLogsLot.getLogs().size() == 3 &&
+                        analyseurLogsLot.getNombreVuesFilm(pointeursFilms[0]) == 2 &&
+                        analyseurLogsLot.getNombreVuesFilm(pointeursFilms[1]) == 1);
+        afficherResultatTest(8, "AnalyseurLogs::creerLignesLog", tests.back());
+
+        // Test 9
+        std::vector<const Utilisateur*> audience = {pointeursUtilisateurs[1], pointeursUtilisateurs[3]};
+        int nombreVuesAudience = analyseurLogs.getNombreVuesPourUtilisateurs(audience);
+        std::vector<std::pair<const Film*, int>> filmsPopulairesAudience =
+            analyseurLogs.getNFilmsPlusPopulairesPourUtilisateurs(1, audience);
+        std::vector<std::pair<const Film*, int>> filmsPopulairesAudienceAttendus = {
+            std::pair<const Film*, int>(pointeursFilms[4], 4),
+        };
+        tests.push_back(nombreVuesAudience == 12 && filmsPopulairesAudience == filmsPopulairesAudienceAttendus &&
+                        analyseurLogs.getNombreVuesPourUtilisateurs({}) == 0);
+        afficherResultatTest(9, "AnalyseurLogs vues par groupe d'utilisateurs", tests.back());
+
+        // Test 10
+        UtilisationMemoire memoireAvant = analyseurLogsLot.getUtilisationMemoire();
+        std::string timestampLong(100, '9');
+        analyseurLogsLot.ajouterLigneLog(LigneLog{timestampLong, pointeursUtilisateurs[0], pointeursFilms[0]});
+        UtilisationMemoire memoireApres = analyseurLogsLot.getUtilisationMemoire();
+        tests.push_back(memoireApres.getOctets("logs_") == analyseurLogsLot.logs_.capacity() * sizeof(LigneLog) &&
+                        memoireApres.getOctets("logs_.timestamp") >=
+                            memoireAvant.getOctets("logs_.timestamp") + timestampLong.size() + 1 &&
+                        memoireApres.getTotal() == memoireApres.getOctets("logs_") +
+                                                       memoireApres.getOctets("logs_.timestamp") +
+                                                       memoireApres.getOctets("vuesFilms_") +
+                                                       memoireApres.getOctets("colonnes_") +
+                                                       memoireApres.getOctets("vuesArchiveesUtilisateurs_") +
+                                                       memoireApres.getOctets("cachesRequetes_") &&
+                        memoireApres.getOctets("colonnes_") > memoireAvant.getOctets("colonnes_"));
+        afficherResultatTest(10, "AnalyseurLogs::getUtilisationMemoire", tests.back());
+
+        // Test 11
+        GestionnaireFilms gestionnaireFilmsFichier;
+        GestionnaireUtilisateurs gestionnaireUtilisateursFichier;
+        gestionnaireFilmsFichier.chargerDepuisFichier("films.txt");
+        gestionnaireUtilisateursFichier.chargerDepuisFichier("utilisateurs.txt");
+        AnalyseurLogs analyseurSequentiel;
+        BilanChargement bilanSequentiel = analyseurSequentiel.chargerDepuisFichier(
+            "logs.txt", gestionnaireUtilisateursFichier, gestionnaireFilmsFichier);
+        AnalyseurLogs analyseurPipeline;
+        PipelineIngestion pipeline(analyseurPipeline, gestionnaireUtilisateursFichier, gestionnaireFilmsFichier, 64, 2);
+        BilanChargement bilanPipeline = pipeline.chargerDepuisFichier("logs.txt");
+        bool logsIdentiques = std::equal(analyseurSequentiel.getLogs().begin(),
+                                         analyseurSequentiel.getLogs().end(),
+                                         analyseurPipeline.getLogs().begin(),
+                                         analyseurPipeline.getLogs().end(),
+                                         [](const LigneLog& ligneLog1, const LigneLog& ligneLog2) {
+                                             return ligneLog1.timestamp == ligneLog2.timestamp &&
+                                                    ligneLog1.utilisateur == ligneLog2.utilisateur &&
+                                                    ligneLog1.film == ligneLog2.film;
+                                         });
+        tests.push_back(bilanSequentiel && bilanPipeline && logsIdentiques &&
+                        bilanPipeline.nombreLignesChargees == bilanSequentiel.nombreLignesChargees &&
+                        bilanPipeline.nombreRejets == bilanSequentiel.nombreRejets &&
+                        analyseurPipeline.vuesFilms_ == analyseurSequentiel.vuesFilms_ &&
+                        pipeline.getStatistiques().size() == 5 &&
+                        pipeline.getStatistiques()[3].nombreElements == analyseurPipeline.getLogs().size() &&
+                        pipeline.getStatistiques().back().nombreElements == analyseurPipeline.getLogs().size());
+        afficherResultatTest(11, "PipelineIngestion::chargerDepuisFichier", tests.back());
+
+        // Test 12
+        static constexpr std::size_t nombreLignesParalleles = 200000;
+        std::vector<LigneLog> lignesParalleles;
+        lignesParalleles.reserve(nombreLignesParalleles);
+        for (std::size_t i = 0; i < nombreLignesParalleles; i++)
+        {
+            lignesParalleles.push_back(LigneLog{"2018-01-01T00:00:00Z",
+                                                pointeursUtilisateurs[i % nombreUtilisateurs],
+                                                pointeursFilms[(i * i) % nombreFilms]});
+        }
+        AnalyseurLogs analyseurParallele;
+        analyseurParallele.ajouterLignesLog(lignesParalleles);
+        std::vector<const Utilisateur*> audienceParallele = {pointeursUtilisateurs[0], pointeursUtilisateurs[5]};
+        std::unordered_map<const Film*, int> vuesAudienceAttendues;
+        for (const LigneLog& ligneLog : lignesParalleles)
+        {
+            if (ligneLog.utilisateur == pointeursUtilisateurs[0] || ligneLog.utilisateur == pointeursUtilisateurs[5])
+            {
+                vuesAudienceAttendues[ligneLog.film]++;
+            }
+        }
+        std::vector<std::pair<const Film*, int>> filmsPopulairesParalleles =
+            analyseurParallele.getNFilmsPlusPopulairesPourUtilisateurs(nombreFilms, audienceParallele);
+        bool vuesAudienceCorrectes = filmsPopulairesParalleles.size() == vuesAudienceAttendues.size() &&
+                                     std::is_sorted(filmsPopulairesParalleles.begin(),
+                                                    filmsPopulairesParalleles.end(),
+                                                    [](const auto& film1, const auto& film2) {
+                                                        return film1.second > film2.second;
+                                                    });
+        for (const auto& [film, vues] : filmsPopulairesParalleles)
+        {
+            vuesAudienceCorrectes &= vuesAudienceAttendues[film] == vues;
+        }
+        tests.push_back(vuesAudienceCorrectes &&
+                        analyseurParallele.getNombreVuesPourUtilisateur(pointeursUtilisateurs[3]) ==
+                            static_cast<int>(nombreLignesParalleles / nombreUtilisateurs) &&
+                        analyseurParallele.getNombreVuesPourUtilisateurs(audienceParallele) ==
+                            static_cast<int>(2 * nombreLignesParalleles / nombreUtilisateurs));
+        afficherResultatTest(12, "AnalyseurLogs agrégats en parallèle", tests.back());
+
+        // Test 13
+        std::vector<std::uint32_t> colonne(1003);
+        for (std::size_t i = 0; i < colonne.size(); i++)
+        {
+            colonne[i] = static_cast<std::uint32_t>((i * 7) % 11);
+        }
+        std::vector<std::uint32_t> indicesFiltres(colonne.size());
+        indicesFiltres.resize(NoyauxColonnes::filtrerEgal(colonne.data(), colonne.size(), 3, indicesFiltres.data()));
+        bool noyauxCorrects =
+            NoyauxColonnes::compterEgal(colonne.data(), colonne.size(), 3) ==
+                static_cast<std::size_t>(std::count(colonne.begin(), colonne.end(), 3u)) &&
+            indicesFiltres.size() == NoyauxColonnes::compterEgal(colonne.data(), colonne.size(), 3) &&
+            std::all_of(indicesFiltres.begin(), indicesFiltres.end(), [&colonne](std::uint32_t index) {
+                return colonne[index] == 3;
+            });
+        int vuesFilmEntre1 =
+            analyseurLogs.getNombreVuesFilmEntre(pointeursFilms[8], "2018-01-01T00:00:00Z", "2018-01-02T00:00:00Z");
+        int vuesFilmEntre2 =
+            analyseurLogs.getNombreVuesFilmEntre(pointeursFilms[8], "2018-01-01T07:00:00Z", "2020-05-01T01:00:00Z");
+        int vuesFilmEntre3 = analyseurLogs.getNombreVuesFilmEntre(pointeursFilms[8], "2018-01-01", "2021-01-01");
+        int vuesFilmEntre4 = analyseurLogsVide.getNombreVuesFilmEntre(
+            pointeursFilms[8], "2018-01-01T00:00:00Z", "2021-01-01T00:00:00Z");
+        tests.push_back(noyauxCorrects && vuesFilmEntre1 == 3 && vuesFilmEntre2 == 2 && vuesFilmEntre3 == 0 &&
+                        vuesFilmEntre4 == 0);
+        afficherResultatTest(13, "AnalyseurLogs colonnes et noyaux vectorisés", tests.back());
+
+        // Test 14
+        auto memesLogs = [](const std::vector<LigneLog>& logs1, const std::vector<LigneLog>& logs2) {
+            return std::equal(logs1.begin(), logs1.end(), logs2.begin(), logs2.end(),
+                              [](const LigneLog& ligneLog1, const LigneLog& ligneLog2) {
+                                  return ligneLog1.timestamp == ligneLog2.timestamp &&
+                                         ligneLog1.utilisateur == ligneLog2.utilisateur &&
+                                         ligneLog1.film == ligneLog2.film;
+                              });
+        };
+        LogsCompresses logsCompresses = analyseurLogs.compresserLogs();
+        LogsCompresses logsLotCompresses = analyseurLogsLot.compresserLogs();
+        LogsCompresses logsParallelesCompresses = analyseurParallele.compresserLogs();
+        // "24:00:00" est interprété comme minuit le lendemain, mais n'est pas la forme canonique de cet instant: ces
+        // lignes restent non compressées et doivent tout de même être comptées dans les intervalles
+        AnalyseurLogs analyseurNonCanonique;
+        analyseurNonCanonique.ajouterLignesLog({
+            LigneLog{"2018-01-31T24:00:00Z", pointeursUtilisateurs[0], pointeursFilms[2]},
+            LigneLog{"2018-02-01T12:00:00Z", pointeursUtilisateurs[1], pointeursFilms[2]},
+            LigneLog{"horodatage invalide", pointeursUtilisateurs[0], pointeursFilms[2]},
+            LigneLog{"2018-01-31T24:00:00Z", pointeursUtilisateurs[0], pointeursFilms[5]},
+            LigneLog{"2018-03-01T00:00:00Z", pointeursUtilisateurs[0], pointeursFilms[3]},
+        });
+        LogsCompresses logsNonCanoniquesCompresses = analyseurNonCanonique.compresserLogs();
+        bool nonCanoniquesComptes = true;
+        for (const Film* film : {pointeursFilms[2], pointeursFilms[3], pointeursFilms[5]})
+        {
+            int vuesAnalyseur =
+                analyseurNonCanonique.getNombreVuesFilmEntre(film, "2018-02-01T00:00:00Z", "2018-03-02T00:00:00Z");
+            nonCanoniquesComptes = nonCanoniquesComptes && vuesAnalyseur > 0 &&
+                                   logsNonCanoniquesCompresses.getNombreVuesFilmEntre(
+                                       film, "2018-02-01T00:00:00Z", "2018-03-02T00:00:00Z") == vuesAnalyseur;
+        }
+        tests.push_back(nonCanoniquesComptes && memesLogs(logsCompresses.decompresser(), analyseurLogs.getLogs()) &&
+                        memesLogs(logsLotCompresses.decompresser(), analyseurLogsLot.getLogs()) &&
+                        memesLogs(logsParallelesCompresses.decompresser(), analyseurParallele.getLogs()) &&
+                        logsParallelesCompresses.getNombreBlocs() ==
+                            (nombreLignesParalleles + LogsCompresses::tailleBloc - 1) / LogsCompresses::tailleBloc &&
+                        logsCompresses.getNombreVuesFilmEntre(
+                            pointeursFilms[8], "2018-01-01T07:00:00Z", "2020-05-01T01:00:00Z") == vuesFilmEntre2 &&
+                        logsCompresses.getNombreVuesPourUtilisateur(pointeursUtilisateurs[1]) ==
+                            analyseurLogs.getNombreVuesPourUtilisateur(pointeursUtilisateurs[1]) &&
+                        logsLotCompresses.getNombreVuesPourUtilisateur(pointeursUtilisateurs[0]) ==
+                            analyseurLogsLot.getNombreVuesPourUtilisateur(pointeursUtilisateurs[0]) &&
+                        logsParallelesCompresses.getNombreVuesPourUtilisateur(pointeursUtilisateurs[3]) ==
+                            static_cast<int>(nombreLignesParalleles / nombreUtilisateurs) &&
+                        logsParallelesCompresses.getOctetsParLigne() < 4.0);
+        afficherResultatTest(14, "AnalyseurLogs::compresserLogs", tests.back());
+
+        // Test 15
+        std::filesystem::path dossierExterne = std::filesystem::temp_directory_path() / "td5_tests_externe";
+        bool externeCorrect = false;
+        {
+            AnalyseurLogsExterne analyseurExterne(dossierExterne, 16 * 1024);
+            BilanChargement bilanExterne = analyseurExterne.chargerDepuisFichier(
+                "logs.txt", gestionnaireUtilisateursFichier, gestionnaireFilmsFichier);
+            const Film* filmPopulaire = analyseurSequentiel.getFilmPlusPopulaire();
+            std::string debutSemestre = "2018-01-01T00:00:00Z";
+            std::string finSemestre = "2018-07-01T00:00:00Z";
+            std::vector<const Utilisateur*> audienceExterne = {analyseurSequentiel.getLogs().front().utilisateur,
+                                                               analyseurSequentiel.getLogs().back().utilisateur};
+            auto vuesSeulement = [](const std::vector<std::pair<const Film*, int>>& films) {
+                std::vector<int> vues;
+                for (const auto& film : films)
+                {
+                    vues.push_back(film.second);
+                }
+                return vues;
+            };
+            auto filmsTries = [](std::vector<const Film*> films) {
+                std::sort(films.begin(), films.end());
+                return films;
+            };
+            externeCorrect =
+                bilanExterne && bilanExterne.nombreRejets == bilanSequentiel.nombreRejets &&
+                bilanExterne.nombreLignesChargees == analyseurSequentiel.getLogs().size() &&
+                analyseurExterne.getNombreLignes() == analyseurSequentiel.getLogs().size() &&
+                analyseurExterne.getNombreSequences() > 1 && analyseurExterne.getNombrePassesFusion() > 1 &&
+                analyseurExterne.getNombreVuesFilm(filmPopulaire) ==
+                    analyseurSequentiel.getNombreVuesFilm(filmPopulaire) &&
+                analyseurExterne.getNombreVuesFilmEntre(filmPopulaire, debutSemestre, finSemestre) ==
+                    analyseurSequentiel.getNombreVuesFilmEntre(filmPopulaire, debutSemestre, finSemestre) &&
+                vuesSeulement(analyseurExterne.getNFilmsPlusPopulaires(10)) ==
+                    vuesSeulement(analyseurSequentiel.getNFilmsPlusPopulaires(10)) &&
+                analyseurExterne.getNombreVuesPourUtilisateurs(audienceExterne) ==
+                    analyseurSequentiel.getNombreVuesPourUtilisateurs(audienceExterne) &&
+                filmsTries(analyseurExterne.getFilmsVusParUtilisateur(audienceExterne[0])) ==
+                    filmsTries(analyseurSequentiel.getFilmsVusParUtilisateur(audienceExterne[0])) &&
+                vuesSeulement(analyseurExterne.getNFilmsPlusPopulairesPourUtilisateurs(5, audienceExterne)) ==
+                    vuesSeulement(analyseurSequentiel.getNFilmsPlusPopulairesPourUtilisateurs(5, audienceExterne));
+        }
+        tests.push_back(externeCorrect && std::filesystem::is_empty(dossierExterne));
+        std::filesystem::remove_all(dossierExterne);
+        afficherResultatTest(15, "AnalyseurLogsExterne::chargerDepuisFichier", tests.back());
+
+        // Test 16
+        PartitionsLogs partitionsMois(analyseurSequentiel.getLogs(), GranularitePartition::Mois);
+        PartitionsLogs partitionsJours(analyseurLogs.getLogs(), GranularitePartition::Jour);
+        PartitionsLogs partitionsInsertion(GranularitePartition::Jour);
+        for (const LigneLog& ligneLog : analyseurLogs.getLogs())
+        {
+            partitionsInsertion.ajouterLigneLog(ligneLog);
+        }
+        const Film* filmPartitionne = analyseurSequentiel.getFilmPlusPopulaire();
+        bool partitionsCorrectes =
+            partitionsMois.getTaille() == analyseurSequentiel.getLogs().size() &&
+            partitionsMois.getNombreVuesFilm(filmPartitionne) ==
+                analyseurSequentiel.getNombreVuesFilm(filmPartitionne) &&
+            partitionsJours.getNombreVuesFilmEntre(pointeursFilms[8], "2018-01-01T07:00:00Z", "2020-05-01T01:00:00Z") ==
+                vuesFilmEntre2 &&
+            partitionsInsertion.getNombreVuesFilmEntre(
+                pointeursFilms[8], "2018-01-01T07:00:00Z", "2020-05-01T01:00:00Z") == vuesFilmEntre2;
+        for (const auto& [debut, fin] : {std::make_pair("2017-01-01T00:00:00Z", "2019-01-01T00:00:00Z"),
+                                         std::make_pair("2018-03-15T12:00:00Z", "2018-04-01T00:00:00Z"),
+                                         std::make_pair("2018-06-01T00:00:00Z", "2018-06-01T00:00:01Z")})
+        {
+            partitionsCorrectes &= partitionsMois.getNombreVuesFilmEntre(filmPartitionne, debut, fin) ==
+                                   analyseurSequentiel.getNombreVuesFilmEntre(filmPartitionne, debut, fin);
+        }
+        std::size_t nombrePartitionsMois = partitionsMois.getNombrePartitions();
+        std::size_t lignesPremierMois = partitionsMois.getPartitions().begin()->second.lignes.size();
+        partitionsCorrectes &= partitionsMois.supprimerPlusAnciennePartition() &&
+                               partitionsMois.getNombrePartitions() == nombrePartitionsMois - 1 &&
+                               partitionsMois.getTaille() == analyseurSequentiel.getLogs().size() - lignesPremierMois &&
+                               partitionsMois.supprimerPartitionsAvant("2100-01-01T00:00:00Z") ==
+                                   nombrePartitionsMois - 1 &&
+                               partitionsMois.getTaille() == 0;
+
+        // Les partitions d'un analyseur suivent ses ajouts et son rechargement, et la rétention en retire les
+        // partitions entièrement expirées
+        AnalyseurLogs analyseurPartitionne;
+        for (bool partitionner : {false, true})
+        {
+            analyseurPartitionne.definirPartitionnement(
+                partitionner ? std::optional(GranularitePartition::Mois) : std::nullopt);
+            analyseurPartitionne.chargerDepuisFichier(
+                "logs.txt", gestionnaireUtilisateursFichier, gestionnaireFilmsFichier);
+        }
+        auto milieuLogs = analyseurSequentiel.getLogs().begin() +
+                          static_cast<std::ptrdiff_t>(analyseurSequentiel.getLogs().size() / 2);
+        analyseurPartitionne.ajouterLignesLog(std::vector<LigneLog>(analyseurSequentiel.getLogs().begin(), milieuLogs));
+        for (auto ligneLog = milieuLogs; ligneLog != analyseurSequentiel.getLogs().end(); ++ligneLog)
+        {
+            analyseurPartitionne.ajouterLigneLog(*ligneLog);
+        }
+        partitionsCorrectes &=
+            analyseurPartitionne.getPartitions() &&
+            analyseurPartitionne.getPartitions()->getTaille() == 2 * analyseurSequentiel.getLogs().size();
+        for (const auto& [debut, fin] : {std::make_pair("2017-01-01T00:00:00Z", "2019-01-01T00:00:00Z"),
+                                         std::make_pair("2018-03-15T12:00:00Z", "2018-04-01T00:00:00Z")})
+        {
+            partitionsCorrectes &= analyseurPartitionne.getNombreVuesFilmEntre(filmPartitionne, debut, fin) ==
+                                   2 * analyseurSequentiel.getNombreVuesFilmEntre(filmPartitionne, debut, fin);
+        }
+        std::string limitePartitions =
+            formaterTimestamp(*convertirTimestamp(analyseurSequentiel.getLogs().back().timestamp) - 90 * 24 * 3600);
+        std::string debutMoisLimite = limitePartitions.substr(0, 7);
+        analyseurPartitionne.definirRetention(std::chrono::hours(90 * 24));
+        analyseurPartitionne.appliquerRetention();
+        auto premiereDuMois = std::lower_bound(analyseurSequentiel.getLogs().begin(),
+                                               analyseurSequentiel.getLogs().end(),
+                                               LigneLog{debutMoisLimite, nullptr, nullptr},
+                                               ComparateurLog());
+        partitionsCorrectes &=
+            analyseurPartitionne.getNombreLignesArchivees() > 0 &&
+            analyseurPartitionne.getLogs().size() ==
+                2 * static_cast<std::size_t>(analyseurSequentiel.getLogs().end() - premiereDuMois) &&
+            analyseurPartitionne.getPartitions()->getTaille() == analyseurPartitionne.getLogs().size() &&
+            analyseurPartitionne.getPartitions()->getPartitions().begin()->first == debutMoisLimite &&
+            analyseurPartitionne.getNombreVuesFilm(filmPartitionne) ==
+                2 * analyseurSequentiel.getNombreVuesFilm(filmPartitionne) &&
+            analyseurPartitionne.getNombreVuesFilmEntre(filmPartitionne, debutMoisLimite + "-01T00:00:00Z",
+                                                        "2100-01-01T00:00:00Z") ==
+                2 * analyseurSequentiel.getNombreVuesFilmEntre(filmPartitionne, debutMoisLimite + "-01T00:00:00Z",
+                                                               "2100-01-01T00:00:00Z");
+        tests.push_back(partitionsCorrectes);
+        afficherResultatTest(16, "AnalyseurLogs::definirPartitionnement", tests.back());
+
+        // Test 17
+        std::filesystem::path dossierSuivi = std::filesystem::temp_directory_path() / "td5_tests_suivi";
+        std::filesystem::create_directories(dossierSuivi);
+        std::filesystem::path fichierSuivi = dossierSuivi / "logs.txt";
+        auto ecrireSuivi = [&fichierSuivi](const std::string& texte) {
+            std::ofstream(fichierSuivi, std::ios::binary | std::ios::app) << texte;
+        };
+        ecrireSuivi("2018-01-01T00:00:00Z prénom.nom.1@email.com \"Nom1\"\n"
+                    "2018-01-01T01:00:00Z prénom.nom.2@email.com \"Nom2\"\n"
+                    "2018-01-01T02:00:00Z prénom.nom.2@em");
+        AnalyseurLogs analyseurSuivi;
+        bool suiviCorrect = false;
+        {
+            SuiviFichierLogs suivi(analyseurSuivi, gestionnaireUtilisateurs, gestionnaireFilms, fichierSuivi.string());
+            BilanChargement rattrapage1 = suivi.rattraper();
+            bool lignesCompletes = rattrapage1.nombreLignesChargees == 2 && suivi.getNombreLignesAppliquees() == 2 &&
+                                   analyseurSuivi.getLogs().size() == 2;
+            ecrireSuivi("ail.com \"Nom1\"\n");
+            bool modificationVue = suivi.attendre(std::chrono::milliseconds(1000));
+            BilanChargement rattrapage2 = suivi.rattraper();
+            bool ligneTerminee = analyseurSuivi.getNombreVuesFilm(pointeursFilms[0]) == 2 &&
+                                 analyseurSuivi.getNombreVuesPourUtilisateur(pointeursUtilisateurs[1]) == 2 &&
+                                 suivi.getPosition() == std::filesystem::file_size(fichierSuivi);
+            // La dernière ligne de l'ancien fichier, sans saut de ligne, est appliquée à la rotation
+            ecrireSuivi("2018-01-01T03:00:00Z prénom.nom.4@email.com \"Nom4\"");
+            std::filesystem::rename(fichierSuivi, dossierSuivi / "logs.txt.1");
+            ecrireSuivi("2018-01-02T00:00:00Z prénom.nom.3@email.com \"Nom3\"\n");
+            BilanChargement rattrapage3 = suivi.rattraper();
+            bool rotationVue = suivi.getNombreRotations() == 1;
+            // Un fichier tronqué sur place est relu depuis le début, sans appliquer la ligne incomplète d'avant
+            ecrireSuivi("2018-01-03T00:00:00Z prénom.nom.5@email.com \"Nom5\"");
+            BilanChargement rattrapage4 = suivi.rattraper();
+            std::filesystem::resize_file(fichierSuivi, 0);
+            ecrireSuivi("2018-01-04T00:00:00Z prénom.nom.6@email.com \"Nom6\"\n");
+            BilanChargement rattrapage5 = suivi.rattraper();
+            suiviCorrect = rattrapage1 && lignesCompletes && modificationVue && rattrapage2 && ligneTerminee &&
+                           rattrapage3 && rattrapage3.nombreLignesChargees == 2 && rotationVue && rattrapage4 &&
+                           rattrapage4.nombreLignesChargees == 0 && rattrapage5 &&
+                           rattrapage5.nombreLignesChargees == 1 && suivi.getNombreRotations() == 2 &&
+                           analyseurSuivi.getNombreVuesFilm(pointeursFilms[4]) == 0 &&
+                           analyseurSuivi.getNombreVuesFilm(pointeursFilms[5]) == 1 &&
+                           suivi.getPosition() == std::filesystem::file_size(fichierSuivi) &&
+                           analyseurSuivi.getLogs().size() == 6 &&
+                           analyseurSuivi.getNombreVuesFilm(pointeursFilms[3]) == 1 &&
+                           std::is_sorted(
+                               analyseurSuivi.getLogs().begin(), analyseurSuivi.getLogs().end(), ComparateurLog());
+        }
+        std::filesystem::remove_all(dossierSuivi);
+        tests.push_back(suiviCorrect);
+        afficherResultatTest(17, "SuiviFichierLogs::rattraper", tests.back());
+
+        // Test 18
+        bool lsmCorrect = false;
+        {
+            LogsLSM logsLSM(64, 2);
+            std::vector<LigneLog> lignesDesordre = analyseurSequentiel.getLogs();
+            std::reverse(lignesDesordre.begin(), lignesDesordre.end());
+            for (const LigneLog& ligneLog : lignesDesordre)
+            {
+                logsLSM.ajouterLigneLog(ligneLog);
+            }
+            logsLSM.attendreCompactions();
+            std::vector<LigneLog> logsFusionnes = logsLSM.getLogs();
+            auto parLigneComplete = [](const LigneLog& ligneLog1, const LigneLog& ligneLog2) {
+                return std::tie(ligneLog1.timestamp, ligneLog1.utilisateur->id, ligneLog1.film->nom) <
+                       std::tie(ligneLog2.timestamp, ligneLog2.utilisateur->id, ligneLog2.film->nom);
+            };
+            std::vector<LigneLog> logsAttendus = analyseurSequentiel.getLogs();
+            std::sort(logsAttendus.begin(), logsAttendus.end(), parLigneComplete);
+            bool logsTries = std::is_sorted(logsFusionnes.begin(), logsFusionnes.end(), ComparateurLog());
+            std::sort(logsFusionnes.begin(), logsFusionnes.end(), parLigneComplete);
+            const Film* filmLSM = analyseurSequentiel.getFilmPlusPopulaire();
+            lsmCorrect = logsTries && memesLogs(logsFusionnes, logsAttendus) &&
+                         logsLSM.getNombreCompactions() > 0 &&
+                         logsLSM.getNombreSequences() < analyseurSequentiel.getLogs().size() / 64 &&
+                         logsLSM.getNombreVuesFilm(filmLSM) == analyseurSequentiel.getNombreVuesFilm(filmLSM) &&
+                         logsLSM.getNombreVuesFilmEntre(filmLSM, "2018-03-15T12:00:00Z", "2018-09-01T00:00:00Z") ==
+                             analyseurSequentiel.getNombreVuesFilmEntre(
+                                 filmLSM, "2018-03-15T12:00:00Z", "2018-09-01T00:00:00Z");
+        }
+        tests.push_back(lsmCorrect);
+        afficherResultatTest(18, "LogsLSM::ajouterLigneLog", tests.back());
+
+        // Test 19
+        // Une rétention de 90 jours, appliquée en lot puis ligne par ligne, doit garder les statistiques de tout
+        // l'historique exactes
+        auto retentionCorrecte = [&](AnalyseurLogs& analyseurRetention) {
+            const Film* filmRetenu = analyseurSequentiel.getFilmPlusPopulaire();
+            const Utilisateur* utilisateurRetenu = analyseurSequentiel.getLogs().front().utilisateur;
+            std::vector<const Utilisateur*> groupeRetenu = {
+                utilisateurRetenu, analyseurSequentiel.getLogs().back().utilisateur, utilisateurRetenu};
+            std::string limite = formaterTimestamp(
+                *convertirTimestamp(analyseurSequentiel.getLogs().back().timestamp) - 90 * 24 * 3600);
+            auto premiereConservee = std::lower_bound(analyseurSequentiel.getLogs().begin(),
+                                                      analyseurSequentiel.getLogs().end(),
+                                                      LigneLog{limite, nullptr, nullptr},
+                                                      ComparateurLog());
+            return analyseurRetention.getLogs().size() + analyseurRetention.getNombreLignesArchivees() ==
+                       analyseurSequentiel.getLogs().size() &&
+                   analyseurRetention.getLogs().size() ==
+                       static_cast<std::size_t>(analyseurSequentiel.getLogs().end() - premiereConservee) &&
+                   analyseurRetention.getNFilmsPlusPopulaires(5) == analyseurSequentiel.getNFilmsPlusPopulaires(5) &&
+                   analyseurRetention.getNombreVuesFilm(filmRetenu) ==
+                       analyseurSequentiel.getNombreVuesFilm(filmRetenu) &&
+                   analyseurRetention.getNombreVuesPourUtilisateur(utilisateurRetenu) ==
+                       analyseurSequentiel.getNombreVuesPourUtilisateur(utilisateurRetenu) &&
+                   analyseurRetention.getNombreVuesPourUtilisateurs(groupeRetenu) ==
+                       analyseurSequentiel.getNombreVuesPourUtilisateurs(groupeRetenu) &&
+                   analyseurRetention.getNombreVuesFilmEntre(filmRetenu, limite, "2100-01-01T00:00:00Z") ==
+                       analyseurSequentiel.getNombreVuesFilmEntre(filmRetenu, limite, "2100-01-01T00:00:00Z");
+        };
+        AnalyseurLogs analyseurRetentionLot;
+        analyseurRetentionLot.definirRetention(std::chrono::hours(90 * 24));
+        analyseurRetentionLot.ajouterLignesLog(analyseurSequentiel.getLogs());
+        analyseurRetentionLot.appliquerRetention();
+        AnalyseurLogs analyseurRetentionLigne;
+        analyseurRetentionLigne.definirRetention(std::chrono::hours(90 * 24));
+        for (const LigneLog& ligneLog : analyseurSequentiel.getLogs())
+        {
+            analyseurRetentionLigne.ajouterLigneLog(ligneLog);
+        }
+        bool retraitParLots = analyseurRetentionLigne.getNombreLignesArchivees() > 0 &&
+                              analyseurRetentionLigne.getLogs().size() < analyseurSequentiel.getLogs().size() / 2;
+        analyseurRetentionLigne.appliquerRetention();
+        // Un chargement, direct ou par le pipeline, conserve la configuration et applique la rétention à la fin
+        AnalyseurLogs analyseurRetentionFichier;
+        analyseurRetentionFichier.definirRetention(std::chrono::hours(90 * 24));
+        analyseurRetentionFichier.chargerDepuisFichier(
+            "logs.txt", gestionnaireUtilisateursFichier, gestionnaireFilmsFichier);
+        AnalyseurLogs analyseurRetentionPipeline;
+        analyseurRetentionPipeline.definirRetention(std::chrono::hours(90 * 24));
+        analyseurRetentionPipeline.definirCapaciteCache(0);
+        PipelineIngestion(analyseurRetentionPipeline, gestionnaireUtilisateursFichier, gestionnaireFilmsFichier)
+            .chargerDepuisFichier("logs.txt");
+        analyseurRetentionPipeline.getNFilmsPlusPopulaires(5);
+        analyseurRetentionPipeline.getNFilmsPlusPopulaires(5);
+        bool configurationConservee = analyseurRetentionPipeline.getStatistiquesCache().nombreSucces == 0;
+        // Supprimer un utilisateur après la rétention décompte aussi ses vues archivées des films
+        AnalyseurLogs analyseurSuppression;
+        analyseurSuppression.definirRetention(std::chrono::hours(90 * 24));
+        analyseurSuppression.ajouterLignesLog(analyseurSequentiel.getLogs());
+        analyseurSuppression.appliquerRetention();
+        const Utilisateur* utilisateurSupprime = analyseurSequentiel.getLogs().front().utilisateur;
+        bool vuesArchiveesAvant = analyseurSuppression.vuesArchiveesUtilisateurs_.count(utilisateurSupprime) != 0;
+        analyseurSuppression.retirerLignesUtilisateurs({utilisateurSupprime});
+        std::unordered_map<const Film*, int> vuesSansUtilisateur = analyseurSequentiel.vuesFilms_;
+        for (const LigneLog& ligneLog : analyseurSequentiel.getLogs())
+        {
+            vuesSansUtilisateur[ligneLog.film] -= ligneLog.utilisateur == utilisateurSupprime ? 1 : 0;
+        }
+        bool suppressionApresRetention =
+            vuesArchiveesAvant && analyseurSuppression.getNombreVuesPourUtilisateur(utilisateurSupprime) == 0;
+        for (const auto& [film, nombreVues] : vuesSansUtilisateur)
+        {
+            suppressionApresRetention =
+                suppressionApresRetention && analyseurSuppression.getNombreVuesFilm(film) == nombreVues;
+        }
+        tests.push_back(retentionCorrecte(analyseurRetentionLot) && retraitParLots &&
+                        retentionCorrecte(analyseurRetentionLigne) &&
+                        analyseurRetentionLigne.colonnes_.getTaille() == analyseurRetentionLigne.getLogs().size() &&
+                        retentionCorrecte(analyseurRetentionFichier) && retentionCorrecte(analyseurRetentionPipeline) &&
+                        configurationConservee && suppressionApresRetention);
+        afficherResultatTest(19, "AnalyseurLogs::definirRetention", tests.back());
+
+        // Test 20
+        // Après un point de contrôle, seules les mutations suivantes sont rejouées; un enregistrement final déchiré
+        // par un arrêt brutal est ignoré puis tronqué
+        std::filesystem::path dossierJournal = std::filesystem::temp_directory_path() / "td5_tests_journal";
+        std::filesystem::remove_all(dossierJournal);
+        auto decrireEtat = [](const GestionnaireFilms& films, const GestionnaireUtilisateurs& utilisateurs,
+                              const AnalyseurLogs& analyseur) {
+            std::vector<std::string> etat = {std::to_string(films.getNombreFilms()),
+                                             std::to_string(utilisateurs.getNombreUtilisateurs())};
+            for (const LigneLog& ligneLog : analyseur.getLogs())
+            {
+                etat.push_back(ligneLog.timestamp + ' ' + ligneLog.utilisateur->id + ' ' + ligneLog.film->nom);
+            }
+            return etat;
+        };
+        std::vector<std::string> etatAvantArret;
+        bool journalEcrit = false;
+        OptionsJournal optionsJournal;
+        optionsJournal.tailleGroupe = 4;
+        optionsJournal.mutationsParPointControle = 0;
+        {
+            GestionnaireFilms filmsJournal;
+            GestionnaireUtilisateurs utilisateursJournal;
+            AnalyseurLogs analyseurJournal;
+            JournalMutations journal(
+                filmsJournal, utilisateursJournal, analyseurJournal, dossierJournal, optionsJournal);
+            journalEcrit = journal.recuperer();
+            for (int i = 0; i < 7; i++)
+            {
+                journalEcrit &=
+                    journal.ajouterFilm(*pointeursFilms[i]) && journal.ajouterUtilisateur(*pointeursUtilisateurs[i]);
+            }
+            for (int i = 0; i < 12; i++)
+            {
+                journalEcrit &= journal.creerLigneLog(formaterTimestamp(1546300800 + i * 3600),
+                                                      pointeursUtilisateurs[i % 6]->id,
+                                                      pointeursFilms[(i * 5) % 6]->nom);
+            }
+            journalEcrit &= journal.supprimerUtilisateur(pointeursUtilisateurs[6]->id) && journal.creerPointControle();
+            journalEcrit &= journal.ajouterFilm(*pointeursFilms[7]) && !journal.ajouterFilm(*pointeursFilms[7]) &&
+                            journal.creerLigneLog("2019-06-01T00:00:00Z", pointeursUtilisateurs[0]->id,
+                                                  pointeursFilms[7]->nom) &&
+                            journal.supprimerFilm(pointeursFilms[6]->nom) && journal.valider();
+            etatAvantArret = decrireEtat(filmsJournal, utilisateursJournal, analyseurJournal);
+        }
+        std::filesystem::path cheminJournal = dossierJournal / "journal_1.bin";
+        std::uintmax_t tailleJournal = std::filesystem::file_size(cheminJournal);
+        {
+            std::ofstream journalDechire(cheminJournal, std::ios::binary | std::ios::app);
+            journalDechire << std::string("\x20\x00\x00\x00\x01", 5);
+        }
+        GestionnaireFilms filmsRecuperes;
+        GestionnaireUtilisateurs utilisateursRecuperes;
+        AnalyseurLogs analyseurRecupere;
+        JournalMutations journalRecupere(
+            filmsRecuperes, utilisateursRecuperes, analyseurRecupere, dossierJournal, optionsJournal);
+        bool recuperationCorrecte = journalRecupere.recuperer() && journalRecupere.getGeneration() == 1 &&
+                                    journalRecupere.getNombreMutationsRejouees() == 3 &&
+                                    std::filesystem::file_size(cheminJournal) == tailleJournal &&
+                                    decrireEtat(filmsRecuperes, utilisateursRecuperes, analyseurRecupere) ==
+                                        etatAvantArret &&
+                                    analyseurRecupere.getNombreVuesFilm(filmsRecuperes.getFilmParNom(
+                                        pointeursFilms[7]->nom)) == 1;
+
+        // Les lignes d'un film ou d'un utilisateur supprimé disparaissent avec lui, au point de contrôle comme au
+        // rejeu du journal
+        std::filesystem::path dossierSuppressions = dossierJournal / "suppressions";
+        std::vector<std::string> etatApresSuppressions;
+        bool suppressionsCorrectes = false;
+        {
+            GestionnaireFilms filmsSuppressions;
+            GestionnaireUtilisateurs utilisateursSuppressions;
+            AnalyseurLogs analyseurSuppressions;
+            JournalMutations journal(
+                filmsSuppressions, utilisateursSuppressions, analyseurSuppressions, dossierSuppressions, optionsJournal);
+            suppressionsCorrectes = journal.recuperer();
+            for (int i = 0; i < 3; i++)
+            {
+                suppressionsCorrectes &=
+                    journal.ajouterFilm(*pointeursFilms[i]) && journal.ajouterUtilisateur(*pointeursUtilisateurs[i]);
+            }
+            for (int i = 0; i < 9; i++)
+            {
+                suppressionsCorrectes &= journal.creerLigneLog(formaterTimestamp(1546300800 + i * 3600),
+                                                               pointeursUtilisateurs[i % 3]->id,
+                                                               pointeursFilms[i / 3]->nom);
+            }
+            suppressionsCorrectes &= journal.supprimerFilm(pointeursFilms[1]->nom) && journal.creerPointControle() &&
+                                     journal.creerLigneLog("2019-06-01T00:00:00Z", pointeursUtilisateurs[2]->id,
+                                                           pointeursFilms[0]->nom) &&
+                                     journal.supprimerUtilisateur(pointeursUtilisateurs[2]->id) && journal.valider();
+            etatApresSuppressions = decrireEtat(filmsSuppressions, utilisateursSuppressions, analyseurSuppressions);
+            suppressionsCorrectes &=
+                analyseurSuppressions.getLogs().size() == 4 &&
+                analyseurSuppressions.getNombreVuesFilm(filmsSuppressions.getFilmParNom(pointeursFilms[0]->nom)) == 2 &&
+                analyseurSuppressions.getNFilmsPlusPopulaires(3).size() == 2;
+        }
+        {
+            GestionnaireFilms filmsSuppressions;
+            GestionnaireUtilisateurs utilisateursSuppressions;
+            AnalyseurLogs analyseurSuppressions;
+            JournalMutations journal(
+                filmsSuppressions, utilisateursSuppressions, analyseurSuppressions, dossierSuppressions, optionsJournal);
+            suppressionsCorrectes &=
+                journal.recuperer() && journal.getNombreMutationsRejouees() == 2 &&
+                decrireEtat(filmsSuppressions, utilisateursSuppressions, analyseurSuppressions) ==
+                    etatApresSuppressions &&
+                analyseurSuppressions.getNombreVuesFilm(filmsSuppressions.getFilmParNom(pointeursFilms[2]->nom)) == 2;
+        }
+
+        // Un groupe qui ne peut pas être écrit reste en attente et n'est pas laissé à moitié dans le journal; les
+        // mutations sont refusées jusqu'à ce qu'une nouvelle validation réussisse
+        bool echecEcritureGere = true;
+#if defined(__unix__) || defined(__APPLE__)
+        std::filesystem::path dossierEchec = dossierJournal / "echec";
+        OptionsJournal optionsEchec;
+        optionsEchec.tailleGroupe = 2;
+        optionsEchec.mutationsParPointControle = 0;
+        {
+            GestionnaireFilms filmsEchec;
+            GestionnaireUtilisateurs utilisateursEchec;
+            AnalyseurLogs analyseurEchec;
+            JournalMutations journal(filmsEchec, utilisateursEchec, analyseurEchec, dossierEchec, optionsEchec);
+            echecEcritureGere = journal.recuperer() && journal.ajouterFilm(*pointeursFilms[0]) &&
+                                journal.ajouterFilm(*pointeursFilms[1]);
+            std::uintmax_t tailleAvantEchec = std::filesystem::file_size(dossierEchec / "journal_0.bin");
+
+            // Le groupe suivant ne peut être écrit qu'en partie
+            rlimit limiteInitiale{};
+            getrlimit(RLIMIT_FSIZE, &limiteInitiale);
+            rlimit limite = limiteInitiale;
+            limite.rlim_cur = static_cast<rlim_t>(tailleAvantEchec + 8);
+            auto gestionnaireSignal = std::signal(SIGXFSZ, SIG_IGN);
+            setrlimit(RLIMIT_FSIZE, &limite);
+            bool premierAccepte = journal.ajouterFilm(*pointeursFilms[2]);
+            bool groupeEchoue = !journal.ajouterFilm(*pointeursFilms[3]);
+            bool suivanteRefusee = !journal.ajouterFilm(*pointeursFilms[4]);
+            std::uintmax_t tailleApresEchec = std::filesystem::file_size(dossierEchec / "journal_0.bin");
+            setrlimit(RLIMIT_FSIZE, &limiteInitiale);
+            std::signal(SIGXFSZ, gestionnaireSignal);
+
+            echecEcritureGere &= premierAccepte && groupeEchoue && suivanteRefusee &&
+                                 tailleApresEchec == tailleAvantEchec && filmsEchec.getNombreFilms() == 4 &&
+                                 journal.ajouterFilm(*pointeursFilms[4]) && journal.valider();
+        }
+        {
+            GestionnaireFilms filmsEchec;
+            GestionnaireUtilisateurs utilisateursEchec;
+            AnalyseurLogs analyseurEchec;
+            JournalMutations journal(filmsEchec, utilisateursEchec, analyseurEchec, dossierEchec, optionsEchec);
+            echecEcritureGere &= journal.recuperer() && journal.getNombreMutationsRejouees() == 5 &&
+                                 filmsEchec.getNombreFilms() == 5;
+        }
+#endif
+        std::filesystem::remove_all(dossierJournal);
+        tests.push_back(journalEcrit && recuperationCorrecte && suppressionsCorrectes && echecEcritureGere);
+        afficherResultatTest(20, "JournalMutations::recuperer", tests.back());
+
+        // Test 21
+        // Une vue d'un film peu populaire ne périme pas le classement, et une vue d'un autre utilisateur ne périme pas
+        // ses films vus; une vue du film le plus populaire par le même utilisateur périme les deux
+        AnalyseurLogs analyseurCache = analyseurSequentiel;
+        const Utilisateur* utilisateurCache = analyseurCache.getLogs().front().utilisateur;
+        const Utilisateur* autreUtilisateur = pointeursUtilisateurs[0];
+        std::string timestampCache = analyseurCache.getLogs().back().timestamp;
+        std::vector<std::pair<const Film*, int>> classementCache = analyseurCache.getNFilmsPlusPopulaires(10);
+        std::vector<const Film*> filmsVusCache = analyseurCache.getFilmsVusParUtilisateur(utilisateurCache);
+        const Film* filmPeuPopulaire = analyseurCache.getNFilmsPlusPopulaires(1000000).back().first;
+        analyseurCache.ajouterLigneLog(LigneLog{timestampCache, autreUtilisateur, filmPeuPopulaire});
+        StatistiquesCache statistiquesAvantVue = analyseurCache.getStatistiquesCache();
+        bool cacheConserve = analyseurCache.getNFilmsPlusPopulaires(10) == classementCache &&
+                             analyseurCache.getFilmsVusParUtilisateur(utilisateurCache) == filmsVusCache;
+        StatistiquesCache statistiquesApresVue = analyseurCache.getStatistiquesCache();
+        analyseurCache.ajouterLigneLog(LigneLog{timestampCache, utilisateurCache, classementCache.front().first});
+        std::vector<std::pair<const Film*, int>> classementApres = analyseurCache.getNFilmsPlusPopulaires(10);
+        std::vector<const Film*> filmsVusApres = analyseurCache.getFilmsVusParUtilisateur(utilisateurCache);
+        AnalyseurLogs analyseurSansCache = analyseurCache; // Une copie ne reprend pas les résultats en cache
+        std::pair<const Film*, int> premierAttendu(classementCache.front().first, classementCache.front().second + 1);
+        bool cachePerime =
+            analyseurCache.getStatistiquesCache().nombreDefauts == statistiquesApresVue.nombreDefauts + 2 &&
+            classementApres.front() == premierAttendu &&
+            classementApres.size() == 10 &&
+            classementApres.back().second == analyseurSansCache.getNFilmsPlusPopulaires(10).back().second &&
+            filmsVusApres.size() == analyseurSansCache.getFilmsVusParUtilisateur(utilisateurCache).size();
+        tests.push_back(cacheConserve && statistiquesApresVue.nombreSucces == statistiquesAvantVue.nombreSucces + 2 &&
+                        cachePerime);
+        afficherResultatTest(21, "AnalyseurLogs cache des requêtes", tests.back());
+
+        // Test 22
+        // Chaque ligne de log donne une ligne NDJSON, et la somme des vues exportées est le nombre de lignes
+        std::filesystem::path fichierLogsExport = std::filesystem::temp_directory_path() / "td5_tests_export_logs.txt";
+        std::filesystem::path fichierVuesExport = std::filesystem::temp_directory_path() / "td5_tests_export_vues.txt";
+        BilanExport bilanLogs = Exportation::exporterLogs(analyseurSequentiel, fichierLogsExport, FormatExport::Ndjson);
+        BilanExport bilanVues = Exportation::exporterVuesFilms(
+            analyseurSequentiel, gestionnaireFilmsFichier, fichierVuesExport, FormatExport::Csv);
+        std::vector<std::string> lignesLogsExport;
+        std::vector<std::string> lignesVuesExport;
+        for (auto [chemin, lignes] : {std::pair(&fichierLogsExport, &lignesLogsExport),
+                                      std::pair(&fichierVuesExport, &lignesVuesExport)})
+        {
+            std::ifstream fichier(*chemin);
+            for (std::string ligne; std::getline(fichier, ligne);)
+            {
+                lignes->push_back(ligne);
+            }
+            std::filesystem::remove(*chemin);
+        }
+        long long sommeVues = 0;
+        for (std::size_t i = 1; i < lignesVuesExport.size(); i++)
+        {
+            sommeVues += std::stoll(lignesVuesExport[i].substr(lignesVuesExport[i].rfind(',') + 1));
+        }
+        const LigneLog& premiereLigneExport = analyseurSequentiel.getLogs().front();
+        tests.push_back(bilanLogs.succes && bilanVues.succes &&
+                        lignesLogsExport.size() == analyseurSequentiel.getLogs().size() &&
+                        lignesLogsExport.front() == "{\"timestamp\":\"" + premiereLigneExport.timestamp +
+                                                        "\",\"utilisateur\":\"" +
+                                                        premiereLigneExport.utilisateur->id + "\",\"film\":\"" +
+                                                        premiereLigneExport.film->nom + "\"}" &&
+                        lignesVuesExport.size() == gestionnaireFilmsFichier.getNombreFilms() + 1 &&
+                        lignesVuesExport.front() == "film,vues" &&
+                        sommeVues == static_cast<long long>(analyseurSequentiel.getLogs().size()));
+        afficherResultatTest(22, "Exportation des logs et des vues par film", tests.back());
+
+        // Test 23
+        // Les lignes mal formées sont rejetées à la lecture, celles dont l'utilisateur ou le film est introuvable à
+        // la résolution; une seule est affichée, les autres sont résumées en un message. Les autres chargeurs de logs
+        // font le même bilan
+        std::filesystem::path fichierLogsRejets = std::filesystem::temp_directory_path() / "td5_tests_rejets.txt";
+        std::filesystem::path fichierQuarantaine =
+            std::filesystem::temp_directory_path() / "td5_tests_quarantaine.txt";
+        const std::string ligneUtilisateurInconnu = "2018-01-01T01:00:00Z inconnu@email.com \"Nom1\"";
+        const std::string ligneFilmInconnu = "2018-01-01T02:00:00Z prénom.nom.2@email.com \"Film \\\"inconnu\\\"\"";
+        std::ofstream(fichierLogsRejets) << "2018-01-01T00:00:00Z prénom.nom.1@email.com \"Nom1\"\n"
+                                         << "ligne invalide\n"
+                                         << ligneUtilisateurInconnu << '\n'
+                                         << ligneFilmInconnu << '\n'
+                                         << "autre\n";
+        OptionsRejets optionsRejets;
+        optionsRejets.fichierQuarantaine = fichierQuarantaine;
+        optionsRejets.nombreMessagesConsole = 1;
+        AnalyseurLogs analyseurRejets;
+        std::ostringstream console;
+        std::streambuf* tamponCerr = std::cerr.rdbuf(console.rdbuf());
+        BilanChargement bilanRejets = analyseurRejets.chargerDepuisFichier(
+            fichierLogsRejets.string(), gestionnaireUtilisateurs, gestionnaireFilms, optionsRejets);
+        std::cerr.rdbuf(tamponCerr);
+        std::ostringstream quarantaine;
+        quarantaine << std::ifstream(fichierQuarantaine).rdbuf();
+        std::string messagesConsole = console.str();
+
+        // Le pipeline, l'analyseur externe et le suivi du fichier rejettent les mêmes lignes pour les mêmes raisons;
+        // la quarantaine du suivi est complétée à chaque rattrapage
+        OptionsRejets optionsRejetsMuettes = optionsRejets;
+        optionsRejetsMuettes.nombreMessagesConsole = 0;
+        auto memesRejets = [&bilanRejets](const BilanChargement& bilan) {
+            return bilan.succes == bilanRejets.succes && bilan.nombreLignesChargees == 1 &&
+                   bilan.nombreRejets == bilanRejets.nombreRejets;
+        };
+        std::filesystem::path dossierRejetsExterne =
+            std::filesystem::temp_directory_path() / "td5_tests_rejets_externe";
+        std::ostringstream consoleMuette;
+        tamponCerr = std::cerr.rdbuf(consoleMuette.rdbuf());
+        AnalyseurLogs analyseurRejetsPipeline;
+        bool rejetsIdentiques =
+            memesRejets(PipelineIngestion(analyseurRejetsPipeline, gestionnaireUtilisateurs, gestionnaireFilms)
+                            .chargerDepuisFichier(fichierLogsRejets.string(), optionsRejetsMuettes));
+        {
+            AnalyseurLogsExterne analyseurRejetsExterne(dossierRejetsExterne);
+            rejetsIdentiques &= memesRejets(analyseurRejetsExterne.chargerDepuisFichier(
+                fichierLogsRejets.string(), gestionnaireUtilisateurs, gestionnaireFilms, optionsRejetsMuettes));
+        }
+        {
+            AnalyseurLogs analyseurRejetsSuivi;
+            SuiviFichierLogs suivi(analyseurRejetsSuivi,
+                                   gestionnaireUtilisateurs,
+                                   gestionnaireFilms,
+                                   fichierLogsRejets.string(),
+                                   optionsRejetsMuettes);
+            rejetsIdentiques &= memesRejets(suivi.rattraper());
+            std::ofstream(fichierLogsRejets, std::ios::app) << "encore invalide\n";
+            BilanChargement bilanSuivi = suivi.rattraper();
+            rejetsIdentiques &= bilanSuivi.nombreLignesChargees == 0 && bilanSuivi.getNombreRejets() == 1 &&
+                                bilanSuivi.getNombreRejets(RaisonRejet::LigneMalFormee) == 1;
+        }
+        std::cerr.rdbuf(tamponCerr);
+        std::ostringstream quarantaineSuivi;
+        quarantaineSuivi << std::ifstream(fichierQuarantaine).rdbuf();
+        rejetsIdentiques &= quarantaineSuivi.str() == quarantaine.str() + "ligne_mal_formee\tencore invalide\n";
+        std::filesystem::remove_all(dossierRejetsExterne);
+        std::filesystem::remove(fichierLogsRejets);
+        std::filesystem::remove(fichierQuarantaine);
+        tests.push_back(rejetsIdentiques && !bilanRejets && bilanRejets.nombreLignesChargees == 1 &&
+                        analyseurRejets.getLogs().size() == 1 &&
+                        bilanRejets.getNombreRejets(RaisonRejet::LigneMalFormee) == 2 &&
+                        bilanRejets.getNombreRejets(RaisonRejet::UtilisateurIntrouvable) == 1 &&
+                        bilanRejets.getNombreRejets(RaisonRejet::FilmIntrouvable) == 1 &&
+                        bilanRejets.getNombreRejets() == 4 &&
+                        quarantaine.str() == "ligne_mal_formee\tligne invalide\nligne_mal_formee\tautre\n"
+                                             "utilisateur_introuvable\t" + ligneUtilisateurInconnu + "\n"
+                                             "film_introuvable\t" + ligneFilmInconnu + "\n" &&
+                        std::count(messagesConsole.begin(), messagesConsole.end(), '\n') == 2 &&
+                        messagesConsole.find("3 autres lignes rejetées") != std::string::npos);
+        afficherResultatTest(23, "AnalyseurLogs::chargerDepuisFichier avec lignes rejetées", tests.back());
+
+        // Test 24
+        // Quatre producteurs se partagent les lignes de logs.txt: les vues lues dans les compteurs pendant
+        // l'ingestion, puis dans l'analyseur, sont celles du chargement séquentiel
+        std::vector<AnalyseurLogs::EntreeLog> entreesIngestion;
+        {
+            std::ifstream fichier("logs.txt");
+            for (std::string ligne; std::getline(fichier, ligne);)
+            {
+                AnalyseurLogs::EntreeLog entreeLog;
+                if (AnalyseurLogs::analyserLigne(ligne, entreeLog))
+                {
+                    entreesIngestion.push_back(std::move(entreeLog));
+                }
+            }
+        }
+        AnalyseurLogs analyseurIngestion;
+        bool compteursConcurrentsCorrects = true;
+        {
+            static constexpr std::size_t nombreProducteurs = 4;
+            IngesteurConcurrent ingesteur(analyseurIngestion,
+                                          gestionnaireUtilisateursFichier,
+                                          gestionnaireFilmsFichier,
+                                          nombreProducteurs,
+                                          std::chrono::milliseconds(1));
+            std::vector<std::thread> producteurs;
+            for (std::size_t indexProducteur = 0; indexProducteur < nombreProducteurs; indexProducteur++)
+            {
+                producteurs.emplace_back([&ingesteur, &entreesIngestion, indexProducteur] {
+                    IngesteurConcurrent::Producteur producteur = ingesteur.creerProducteur();
+                    for (std::size_t i = indexProducteur; i < entreesIngestion.size(); i += nombreProducteurs)
+                    {
+                        const AnalyseurLogs::EntreeLog& entreeLog = entreesIngestion[i];
+                        producteur.creerLigneLog(entreeLog.timestamp, entreeLog.idUtilisateur, entreeLog.nomFilm);
+                    }
+                });
+            }
+            for (std::thread& producteur : producteurs)
+            {
+                producteur.join();
+            }
+            for (const Film* film : gestionnaireFilmsFichier.getFilms())
+            {
+                compteursConcurrentsCorrects = compteursConcurrentsCorrects &&
+                    ingesteur.getNombreVuesFilm(film) == analyseurSequentiel.getNombreVuesFilm(film);
+            }
+            ingesteur.terminer();
+        }
+        bool vuesIngereesCorrectes = analyseurIngestion.getLogs().size() == analyseurSequentiel.getLogs().size() &&
+                                     std::is_sorted(analyseurIngestion.getLogs().begin(),
+                                                    analyseurIngestion.getLogs().end(),
+                                                    ComparateurLog());
+        for (const Film* film : gestionnaireFilmsFichier.getFilms())
+        {
+            vuesIngereesCorrectes = vuesIngereesCorrectes &&
+                analyseurIngestion.getNombreVuesFilm(film) == analyseurSequentiel.getNombreVuesFilm(film);
+        }
+        for (const Utilisateur* utilisateur : gestionnaireUtilisateursFichier.getUtilisateurs())
+        {
+            vuesIngereesCorrectes = vuesIngereesCorrectes &&
+                analyseurIngestion.getNombreVuesPourUtilisateur(utilisateur) ==
+                    analyseurSequentiel.getNombreVuesPourUtilisateur(utilisateur);
+        }
+        tests.push_back(compteursConcurrentsCorrects && vuesIngereesCorrectes);
+        afficherResultatTest(24, "IngesteurConcurrent avec plusieurs producteurs", tests.back());
+
+        // Test 25
+        // Le jeu généré est identique pour une même graine, chaque ligne est chargée ou rejetée, et les vues suivent
+        // la loi de Zipf: le film le plus populaire a bien plus de vues que la moyenne
+        OptionsGenerateur optionsGenerateur;
+        optionsGenerateur.graine = 7;
+        optionsGenerateur.nombreFilms = 50;
+        optionsGenerateur.nombreUtilisateurs = 40;
+        optionsGenerateur.nombreLignesLog = 2000;
+        optionsGenerateur.exposantZipf = 1.2;
+        optionsGenerateur.tauxLignesInvalides = 0.05;
+        std::filesystem::path dossierGenere = std::filesystem::temp_directory_path() / "td5_tests_generateur";
+        std::filesystem::create_directories(dossierGenere);
+        {
+            GenerateurDonnees generateur(optionsGenerateur);
+            std::ofstream films(dossierGenere / "films.txt");
+            generateur.ecrireFilms(films);
+            std::ofstream utilisateurs(dossierGenere / "utilisateurs.txt");
+            generateur.ecrireUtilisateurs(utilisateurs);
+            std::ofstream logs(dossierGenere / "logs.txt");
+            generateur.ecrireLogs(logs);
+        }
+        std::ostringstream logsGeneres1;
+        std::ostringstream logsGeneres2;
+        std::ostringstream logsAutreGraine;
+        GenerateurDonnees(optionsGenerateur).ecrireLogs(logsGeneres1);
+        GenerateurDonnees(optionsGenerateur).ecrireLogs(logsGeneres2);
+        optionsGenerateur.graine = 8;
+        GenerateurDonnees(optionsGenerateur).ecrireLogs(logsAutreGraine);
+        GestionnaireFilms gestionnaireFilmsGeneres;
+        GestionnaireUtilisateurs gestionnaireUtilisateursGeneres;
+        AnalyseurLogs analyseurGenere;
+        OptionsRejets optionsSilencieuses;
+        optionsSilencieuses.nombreMessagesConsole = 0;
+        std::ostringstream consoleGenerateur;
+        tamponCerr = std::cerr.rdbuf(consoleGenerateur.rdbuf());
+        BilanChargement bilanFilmsGeneres =
+            gestionnaireFilmsGeneres.chargerDepuisFichier((dossierGenere / "films.txt").string(), optionsSilencieuses);
+        BilanChargement bilanUtilisateursGeneres = gestionnaireUtilisateursGeneres.chargerDepuisFichier(
+            (dossierGenere / "utilisateurs.txt").string(), optionsSilencieuses);
+        BilanChargement bilanLogsGeneres = analyseurGenere.chargerDepuisFichier((dossierGenere / "logs.txt").string(),
+                                                                                gestionnaireUtilisateursGeneres,
+                                                                                gestionnaireFilmsGeneres,
+                                                                                optionsSilencieuses);
+        std::cerr.rdbuf(tamponCerr);
+        std::filesystem::remove_all(dossierGenere);
+        const Film* filmGenerePlusPopulaire = analyseurGenere.getFilmPlusPopulaire();
+        tests.push_back(logsGeneres1.str() == logsGeneres2.str() && logsGeneres1.str() != logsAutreGraine.str() &&
+                        bilanFilmsGeneres.nombreLignesChargees + bilanFilmsGeneres.getNombreRejets() == 50 &&
+                        bilanUtilisateursGeneres.nombreLignesChargees + bilanUtilisateursGeneres.getNombreRejets() ==
+                            40 &&
+                        bilanLogsGeneres.nombreLignesChargees + bilanLogsGeneres.getNombreRejets() == 2000 &&
+                        bilanLogsGeneres.getNombreRejets(RaisonRejet::LigneMalFormee) > 0 &&
+                        filmGenerePlusPopulaire != nullptr &&
+                        analyseurGenere.getNombreVuesFilm(filmGenerePlusPopulaire) >
+                            4 * static_cast<int>(bilanLogsGeneres.nombreLignesChargees / 50));
+        afficherResultatTest(25, "GenerateurDonnees", tests.back());
+
+        // Test 26
+        // Compilée, l'instrumentation compte chaque ligne et chaque octet lus et chronomètre le chargement et les
+        // requêtes; sinon, elle ne compte rien et le rapport l'indique
+        Instrumentation::reinitialiser();
+        AnalyseurLogs analyseurInstrumente;
+        BilanChargement bilanInstrumente = analyseurInstrumente.chargerDepuisFichier(
+            "logs.txt", gestionnaireUtilisateursFichier, gestionnaireFilmsFichier);
+        analyseurInstrumente.getNombreVuesFilm(gestionnaireFilmsFichier.getFilms().front());
+        std::ostringstream rapportInstrumentation;
+        Instrumentation::ecrireRapportJson(rapportInstrumentation);
+        std::uint64_t lignesLues = Instrumentation::getCompteur(Instrumentation::Compteur::LignesLues);
+        std::uint64_t octetsLus = Instrumentation::getCompteur(Instrumentation::Compteur::OctetsTraites);
+        bool instrumentationCorrecte;
+        if (Instrumentation::estActive)
+        {
+            std::size_t nombreLignesFichier = bilanInstrumente.nombreLignesChargees + bilanInstrumente.getNombreRejets();
+            instrumentationCorrecte =
+                lignesLues == nombreLignesFichier && octetsLus == std::filesystem::file_size("logs.txt") &&
+                Instrumentation::getCompteur(Instrumentation::Compteur::UtilisateursIntrouvables) >=
+                    bilanInstrumente.getNombreRejets(RaisonRejet::UtilisateurIntrouvable) &&
+                Instrumentation::getNombreAppels(Instrumentation::Phase::ChargementLogs) == 1 &&
+                Instrumentation::getNombreAppels(Instrumentation::Phase::RequeteNombreVuesFilm) == 1 &&
+                Instrumentation::getDuree(Instrumentation::Phase::ChargementLogs).count() > 0 &&
+                rapportInstrumentation.str().find("\"active\":true") != std::string::npos &&
+                rapportInstrumentation.str().find("\"chargement_logs\":{") != std::string::npos &&
+                rapportInstrumentation.str().find("\"lignes_lues\":" + std::to_string(lignesLues)) !=
+                    std::string::npos;
+        }
+        else
+        {
+            instrumentationCorrecte =
+                lignesLues == 0 && octetsLus == 0 &&
+                Instrumentation::getNombreAppels(Instrumentation::Phase::ChargementLogs) == 0 &&
+                rapportInstrumentation.str().find("\"active\":false") != std::string::npos;
+        }
+        tests.push_back(instrumentationCorrecte);
+        afficherResultatTest(26, "Instrumentation du chargement et des requêtes", tests.back());
+
+        // Test 27
+        // Chaque type de requête du serveur, bien formée ou non
+        {
+            GestionnaireFilms gestionnaireFilmsRequetes;
+            GestionnaireUtilisateurs gestionnaireUtilisateursRequetes;
+            AnalyseurLogs analyseurRequetes;
+            gestionnaireFilmsRequetes.ajouterFilm(Film{"Nom1", Film::Genre::Drame, Pays::France, "Réalisateur", 1970});
+            gestionnaireFilmsRequetes.ajouterFilm(
+                Film{"Le \"grand\" film\\", Film::Genre::Drame, Pays::Japon, "R \"2\"", 1990});
+            gestionnaireUtilisateursRequetes.ajouterUtilisateur(Utilisateur{"a@email.com", "A", 20, Pays::Canada});
+            gestionnaireUtilisateursRequetes.ajouterUtilisateur(Utilisateur{"b@email.com", "B", 30, Pays::Canada});
+            ProcesseurRequetes processeur(
+                gestionnaireFilmsRequetes, gestionnaireUtilisateursRequetes, analyseurRequetes);
+            const std::vector<std::pair<std::string, std::string>> requetesReponses = {
+                {"FILM \"Nom1\"", "OK \"Nom1\" 4 4 \"Réalisateur\" 1970"},
+                {"FILM \"Le \\\"grand\\\" film\\\\\"", "OK \"Le \\\"grand\\\" film\\\\\" 4 5 \"R \\\"2\\\"\" 1990"},
+                {"FILM \"Inconnu\"", "ERR film introuvable"},
+                {"FILM", "ERR film introuvable"},
+                {"LOG 2018-01-01T00:00:00Z a@email.com \"Nom1\"", "OK"},
+                {"LOG 2018-01-01T01:00:00Z b@email.com \"Nom1\"", "OK"},
+                {"LOG 2018-01-01T02:00:00Z b@email.com \"Le \\\"grand\\\" film\\\\\"", "OK"},
+                {"LOG 2018-01-01T03:00:00Z inconnu@email.com \"Nom1\"", "ERR utilisateur ou film introuvable"},
+                {"LOG 2018-01-01T03:00:00Z", "ERR ligne de log invalide"},
+                {"VUES_FILM \"Nom1\"", "OK 2"},
+                {"VUES_FILM \"Inconnu\"", "ERR film introuvable"},
+                {"VUES_UTILISATEUR b@email.com", "OK 2"},
+                {"VUES_UTILISATEUR inconnu@email.com", "ERR utilisateur introuvable"},
+                {"FILMS_UTILISATEUR a@email.com", "OK 1 \"Nom1\""},
+                {"FILMS_UTILISATEUR", "ERR utilisateur introuvable"},
+                {"TOP 1", "OK 1 \"Nom1\" 2"},
+                {"TOP -", "ERR nombre invalide"},
+                {"GENRE 4", "OK 2 \"Nom1\" \"Le \\\"grand\\\" film\\\\\""},
+                {"GENRE 9", "ERR GENRE invalide"},
+                {"PAYS 5", "OK 1 \"Le \\\"grand\\\" film\\\\\""},
+                {"PAYS -1", "ERR PAYS invalide"},
+                {"ANNEES 1960 1980", "OK 1 \"Nom1\""},
+                {"ANNEES 2000 2010", "OK 0"},
+                {"ANNEES 1960", "ERR années invalides"},
+                {"SUPPRIMER \"Nom1\"", "ERR commande inconnue"},
+                {"", "ERR commande inconnue"},
+            };
+            bool reponsesCorrectes = true;
+            for (const auto& [requete, reponseAttendue] : requetesReponses)
+            {
+                std::string reponse = "précédente\n";
+                processeur.traiter(requete, reponse);
+                if (reponse != "précédente\n" + reponseAttendue + "\n")
+                {
+                    reponsesCorrectes = false;
+                }
+            }
+            tests.push_back(reponsesCorrectes);
+        }
+        afficherResultatTest(27, "ProcesseurRequetes::traiter", tests.back());
+
         int nombreTestsReussis = static_cast<int>(std::count(tests.begin(), tests.end(), true));
         double totalPointsSection =
             static_cast<double>(nombreTestsReussis) / static_cast<double>(tests.size()) * maxPointsSection;
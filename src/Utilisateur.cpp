@@ -3,6 +3,20 @@
 /// \date 2020-01-12
 
 #include "Utilisateur.h"
+#include "Empreinte.h"
+
+/// Calcule l'empreinte du contenu d'un utilisateur, pour reconnaître un utilisateur modifié lors d'un rechargement.
+/// \param utilisateur  L'utilisateur dont on veut l'empreinte.
+/// \return             L'empreinte de tous les champs de l'utilisateur.
+std::uint64_t getEmpreinte(const Utilisateur& utilisateur)
+{
+    Empreinte empreinte;
+    empreinte.ajouter(utilisateur.id);
+    empreinte.ajouter(utilisateur.nom);
+    empreinte.ajouter(utilisateur.age);
+    empreinte.ajouter(static_cast<std::int64_t>(utilisateur.pays));
+    return empreinte.getValeur();
+}
 
 /// Affiche les informations d'un utilisateur à la sortie du stream donné.
 /// \param outputStream Le stream auquel écrire les informations de l'utilisateur.
@@ -0,0 +1,83 @@
+/// Comptabilité des octets alloués sur le tas par les structures de données des gestionnaires.
+
+#include "UtilisationMemoire.h"
+#include <algorithm>
+#include <iomanip>
+
+/// Ajoute les octets d'un membre au rapport.
+/// \param membre   Le nom du membre.
+/// \param octets   Les octets alloués sur le tas par le membre.
+void UtilisationMemoire::ajouter(std::string membre, std::size_t octets)
+{
+    membres.emplace_back(std::move(membre), octets);
+}
+
+/// Retourne les octets d'un membre du rapport.
+/// \param membre   Le nom du membre.
+/// \return         Les octets du membre, ou 0 s'il ne fait pas partie du rapport.
+std::size_t UtilisationMemoire::getOctets(const std::string& membre) const
+{
+    auto it = std::find_if(membres.begin(), membres.end(), [&membre](const auto& paire) {
+        return paire.first == membre;
+    });
+    return it != membres.end() ? it->second : 0;
+}
+
+/// Retourne la somme des octets de tous les membres du rapport.
+/// \return Le total des octets.
+std::size_t UtilisationMemoire::getTotal() const
+{
+    std::size_t total = 0;
+    for (const auto& [membre, octets] : membres)
+    {
+        total += octets;
+    }
+    return total;
+}
+
+/// Affiche les octets de chaque membre, puis le total.
+/// \param outputStream         Le stream auquel écrire le rapport.
+/// \param utilisationMemoire   Le rapport à afficher.
+/// \return                     Une référence au stream.
+std::ostream& operator<<(std::ostream& outputStream, const UtilisationMemoire& utilisationMemoire)
+{
+    for (const auto& [membre, octets] : utilisationMemoire.membres)
+    {
+        outputStream << std::left << std::setw(32) << membre << std::right << std::setw(16) << octets << " octets\n";
+    }
+    return outputStream << std::left << std::setw(32) << "total" << std::right << std::setw(16)
+                        << utilisationMemoire.getTotal() << " octets\n";
+}
+
+/// Retourne les octets alloués par une chaîne, soit rien si elle tient dans le tampon interne (small string
+/// optimization), soit sa capacité et le caractère nul final.
+/// \param chaine   La chaîne à mesurer.
+/// \return         Les octets alloués sur le tas.
+std::size_t octetsTas(const std::string& chaine)
+{
+    const char* debutObjet = reinterpret_cast<const char*>(&chaine);
+    bool estInterne = chaine.data() >= debutObjet && chaine.data() < debutObjet + sizeof(chaine);
+    return estInterne ? 0 : chaine.capacity() + 1;
+}
+
+/// \param film         Le film à mesurer.
+/// \return             Les octets alloués sur le tas par les chaînes du film.
+std::size_t octetsTas(const Film& film)
+{
+    return octetsTas(film.nom) + octetsTas(film.realisateur);
+}
+
+/// \param utilisateur  L'utilisateur à mesurer.
+/// \return             Les octets alloués sur le tas par les chaînes de l'utilisateur.
+std::size_t octetsTas(const Utilisateur& utilisateur)
+{
+    return octetsTas(utilisateur.id) + octetsTas(utilisateur.nom);
+}
+
+/// \param ligneLog     La ligne de log à mesurer.
+/// \return             Les octets alloués sur le tas par le timestamp (l'utilisateur et le film ne sont pas
+///                     possédés par la ligne).
+std::size_t octetsTas(const LigneLog& ligneLog)
+{
+    return octetsTas(ligneLog.timestamp);
+}
@@ -0,0 +1,308 @@
+/// Générateur de charge pour ServeurRequetes qui mesure les centiles de latence des requêtes.
+///
+/// Usage: ChargeRequetes [options]
+///   --socket chemin   Chemin du socket du serveur (défaut: /tmp/td5.sock)
+///   --clients N       Nombre de connexions simultanées, chacune avec une requête en vol (défaut: 100)
+///   --requetes N      Nombre total de requêtes à envoyer (défaut: 100000)
+///   --films N         Nombre de films du jeu de données généré par GenererDonnees (défaut: 1000)
+///   --utilisateurs N  Nombre d'utilisateurs du jeu de données généré par GenererDonnees (défaut: 1000)
+///   --ecritures R     Fraction des requêtes qui sont des LOG plutôt que des lectures (défaut: 0)
+///   --graine S        Graine du choix des requêtes (défaut: 1)
+///
+/// Les noms de films et d'utilisateurs sont ceux de GenerateurDonnees, le serveur doit donc avoir chargé un jeu de
+/// données généré avec des nombres de films et d'utilisateurs au moins aussi grands.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GenerateurDonnees.h"
+#include "Horodatage.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    using Horloge = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::string cheminSocket = "/tmp/td5.sock";
+        std::size_t nombreClients = 100;
+        std::size_t nombreRequetes = 100000;
+        std::uint64_t nombreFilms = 1000;
+        std::uint64_t nombreUtilisateurs = 1000;
+        double tauxEcritures = 0.0;
+        std::uint64_t graine = 1;
+    };
+
+    /// Générateur pseudo-aléatoire (xorshift) pour choisir les requêtes de façon reproductible.
+    class GenerateurAleatoire
+    {
+    public:
+        explicit GenerateurAleatoire(std::uint64_t graine)
+            : etat_(graine == 0 ? 1 : graine)
+        {
+        }
+
+        std::uint64_t operator()(std::uint64_t borne)
+        {
+            etat_ ^= etat_ << 13;
+            etat_ ^= etat_ >> 7;
+            etat_ ^= etat_ << 17;
+            return borne == 0 ? 0 : etat_ % borne;
+        }
+
+    private:
+        std::uint64_t etat_;
+    };
+
+    /// Connexion au serveur avec au plus une requête en vol.
+    struct Connexion
+    {
+        int descripteur = -1;
+        std::string entree;
+        Horloge::time_point debutRequete;
+        bool enAttente = false;
+    };
+
+    /// Construit une requête selon un mélange de lectures inspiré d'un usage interactif.
+    std::string creerRequete(const Options& options, GenerateurAleatoire& aleatoire, std::int64_t& secondeLog)
+    {
+        std::string film = '"' + GenerateurDonnees::getNomFilm(aleatoire(options.nombreFilms)) + '"';
+        std::string utilisateur = GenerateurDonnees::getIdUtilisateur(aleatoire(options.nombreUtilisateurs));
+        if (static_cast<double>(aleatoire(1000000)) / 1e6 < options.tauxEcritures)
+        {
+            return "LOG " + formaterTimestamp(secondeLog++) + ' ' + utilisateur + ' ' + film + '\n';
+        }
+        switch (aleatoire(10))
+        {
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+                return "FILM " + film + '\n';
+            case 4:
+            case 5:
+                return "VUES_FILM " + film + '\n';
+            case 6:
+                return "TOP 10\n";
+            case 7:
+                return "GENRE " + std::to_string(aleatoire(9)) + '\n';
+            case 8:
+                return "ANNEES 1990 1999\n";
+            default:
+                return "VUES_UTILISATEUR " + utilisateur + '\n';
+        }
+    }
+
+    /// Ouvre une connexion non bloquante au serveur.
+    /// \return Le descripteur, ou -1 en cas d'erreur.
+    int connecter(const std::string& chemin)
+    {
+        sockaddr_un adresse{};
+        adresse.sun_family = AF_UNIX;
+        std::strncpy(adresse.sun_path, chemin.c_str(), sizeof(adresse.sun_path) - 1);
+        int descripteur = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (descripteur == -1)
+        {
+            return -1;
+        }
+        if (connect(descripteur, reinterpret_cast<sockaddr*>(&adresse), sizeof(adresse)) == -1)
+        {
+            close(descripteur);
+            return -1;
+        }
+        fcntl(descripteur, F_SETFL, fcntl(descripteur, F_GETFL, 0) | O_NONBLOCK);
+        return descripteur;
+    }
+
+    /// Envoie une requête complète (les requêtes sont assez courtes pour tenir dans le tampon du socket).
+    bool envoyer(int descripteur, const std::string& requete)
+    {
+        std::size_t position = 0;
+        while (position < requete.size())
+        {
+            ssize_t ecrits = write(descripteur, requete.data() + position, requete.size() - position);
+            if (ecrits > 0)
+            {
+                position += static_cast<std::size_t>(ecrits);
+            }
+            else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double getCentile(const std::vector<double>& latencesTriees, double centile)
+    {
+        if (latencesTriees.empty())
+        {
+            return 0.0;
+        }
+        auto index = static_cast<std::size_t>(centile / 100.0 * static_cast<double>(latencesTriees.size() - 1));
+        return latencesTriees[index];
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if (i + 1 >= argc)
+                throw std::invalid_argument(argument);
+            std::string valeur = argv[++i];
+            if (argument == "--socket")
+                options.cheminSocket = valeur;
+            else if (argument == "--clients")
+                options.nombreClients = std::stoul(valeur);
+            else if (argument == "--requetes")
+                options.nombreRequetes = std::stoul(valeur);
+            else if (argument == "--films")
+                options.nombreFilms = std::stoull(valeur);
+            else if (argument == "--utilisateurs")
+                options.nombreUtilisateurs = std::stoull(valeur);
+            else if (argument == "--ecritures")
+                options.tauxEcritures = std::stod(valeur);
+            else if (argument == "--graine")
+                options.graine = std::stoull(valeur);
+            else
+                throw std::invalid_argument(argument);
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--socket chemin] [--clients N] [--requetes N] [--films N] [--utilisateurs N]"
+                     " [--ecritures R] [--graine S]\n";
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0)
+    {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+
+    std::vector<Connexion> connexions(options.nombreClients);
+    std::vector<pollfd> descripteurs(options.nombreClients);
+    for (std::size_t i = 0; i < connexions.size(); i++)
+    {
+        connexions[i].descripteur = connecter(options.cheminSocket);
+        if (connexions[i].descripteur == -1)
+        {
+            std::cerr << "Erreur ChargeRequetes: connexion " << i << " impossible: " << std::strerror(errno) << '\n';
+            return 1;
+        }
+        descripteurs[i] = pollfd{connexions[i].descripteur, POLLIN, 0};
+    }
+
+    GenerateurAleatoire aleatoire(options.graine);
+    std::int64_t secondeLog = 1609459200; // 2021-01-01T00:00:00Z, après les logs générés
+    std::vector<double> latencesUs;
+    latencesUs.reserve(options.nombreRequetes);
+    std::size_t nombreEnvoyees = 0;
+    std::size_t nombreErreurs = 0;
+
+    Horloge::time_point debut = Horloge::now();
+    auto envoyerSuivante = [&](Connexion& connexion) {
+        if (nombreEnvoyees < options.nombreRequetes)
+        {
+            connexion.debutRequete = Horloge::now();
+            connexion.enAttente = envoyer(connexion.descripteur, creerRequete(options, aleatoire, secondeLog));
+            nombreEnvoyees++;
+        }
+    };
+    for (Connexion& connexion : connexions)
+    {
+        envoyerSuivante(connexion);
+    }
+
+    char tampon[64 * 1024];
+    while (latencesUs.size() + nombreErreurs < nombreEnvoyees)
+    {
+        if (poll(descripteurs.data(), static_cast<nfds_t>(descripteurs.size()), 5000) <= 0)
+        {
+            std::cerr << "Erreur ChargeRequetes: le serveur ne répond plus\n";
+            return 1;
+        }
+        for (std::size_t i = 0; i < descripteurs.size(); i++)
+        {
+            if (!(descripteurs[i].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+                continue;
+            }
+            Connexion& connexion = connexions[i];
+            ssize_t lus;
+            while ((lus = read(connexion.descripteur, tampon, sizeof(tampon))) > 0)
+            {
+                connexion.entree.append(tampon, static_cast<std::size_t>(lus));
+            }
+            if (lus == 0 || (lus == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            {
+                std::cerr << "Erreur ChargeRequetes: connexion " << i << " fermée par le serveur\n";
+                return 1;
+            }
+            std::size_t fin = connexion.entree.find('\n');
+            if (connexion.enAttente && fin != std::string::npos)
+            {
+                auto latence = std::chrono::duration<double, std::micro>(Horloge::now() - connexion.debutRequete);
+                if (connexion.entree.compare(0, 2, "OK") == 0)
+                {
+                    latencesUs.push_back(latence.count());
+                }
+                else
+                {
+                    nombreErreurs++;
+                }
+                connexion.entree.erase(0, fin + 1);
+                connexion.enAttente = false;
+                envoyerSuivante(connexion);
+            }
+        }
+    }
+    double secondes = std::chrono::duration<double>(Horloge::now() - debut).count();
+
+    for (Connexion& connexion : connexions)
+    {
+        close(connexion.descripteur);
+    }
+
+    std::sort(latencesUs.begin(), latencesUs.end());
+    std::cout << std::fixed << std::setprecision(1) << "requêtes: " << nombreEnvoyees << " (" << nombreErreurs
+              << " ERR), clients: " << options.nombreClients << ", durée: " << secondes << " s, débit: "
+              << static_cast<double>(nombreEnvoyees) / secondes << " req/s\n"
+              << "latence (us): p50 " << getCentile(latencesUs, 50.0) << ", p90 " << getCentile(latencesUs, 90.0)
+              << ", p99 " << getCentile(latencesUs, 99.0) << ", p99.9 " << getCentile(latencesUs, 99.9) << ", max "
+              << (latencesUs.empty() ? 0.0 : latencesUs.back()) << '\n';
+}
+
+#else
+
+int main()
+{
+    std::cerr << "ChargeRequetes nécessite les sockets Unix (Linux ou macOS)\n";
+    return 1;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/// Outil en ligne de commande qui génère un jeu de données synthétique à n'importe quelle échelle.
+///
+/// Usage: GenererDonnees [options]
+///   --dossier D       Dossier de sortie (défaut: .)
+///   --films N         Nombre de films (défaut: 1000)
+///   --utilisateurs N  Nombre d'utilisateurs (défaut: 1000)
+///   --logs N          Nombre de lignes de log (défaut: 10000)
+///   --graine S        Graine du générateur (défaut: 1)
+///   --zipf S          Exposant de Zipf pour la popularité des films, 0 pour uniforme (défaut: 1.0)
+///   --ordre O         Ordre des timestamps: trie, melange ou presque-trie (défaut: trie)
+///   --desordre R      Fraction des lignes en retard pour l'ordre presque-trie (défaut: 0.01)
+///   --invalides R     Fraction des lignes mal formées (défaut: 0)
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "GenerateurDonnees.h"
+
+namespace
+{
+    /// Écrit un fichier du jeu de données à l'aide d'une fonction membre du générateur.
+    /// \param chemin       Le chemin du fichier à écrire.
+    /// \param generateur   Le générateur à utiliser.
+    /// \param ecrire       La fonction membre qui écrit le contenu du fichier.
+    /// \return             True si le fichier a été écrit avec succès, false sinon.
+    bool ecrireFichier(const std::filesystem::path& chemin,
+                       const GenerateurDonnees& generateur,
+                       void (GenerateurDonnees::*ecrire)(std::ostream&) const)
+    {
+        std::ofstream fichier(chemin, std::ios::binary);
+        if (!fichier)
+        {
+            std::cerr << "Erreur GenererDonnees: le fichier " << chemin.string() << " n'a pas pu être ouvert\n";
+            return false;
+        }
+        (generateur.*ecrire)(fichier);
+        return static_cast<bool>(fichier);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    OptionsGenerateur options;
+    std::filesystem::path dossier = ".";
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument(argument);
+            }
+            std::string valeur = argv[++i];
+            if (argument == "--dossier")
+                dossier = valeur;
+            else if (argument == "--films")
+                options.nombreFilms = std::stoull(valeur);
+            else if (argument == "--utilisateurs")
+                options.nombreUtilisateurs = std::stoull(valeur);
+            else if (argument == "--logs")
+                options.nombreLignesLog = std::stoull(valeur);
+            else if (argument == "--graine")
+                options.graine = std::stoull(valeur);
+            else if (argument == "--zipf")
+                options.exposantZipf = std::stod(valeur);
+            else if (argument == "--desordre")
+                options.tauxDesordre = std::stod(valeur);
+            else if (argument == "--invalides")
+                options.tauxLignesInvalides = std::stod(valeur);
+            else if (argument == "--ordre" && valeur == "trie")
+                options.ordre = OrdreTimestamps::Trie;
+            else if (argument == "--ordre" && valeur == "melange")
+                options.ordre = OrdreTimestamps::Melange;
+            else if (argument == "--ordre" && valeur == "presque-trie")
+                options.ordre = OrdreTimestamps::PresqueTrie;
+            else
+                throw std::invalid_argument(argument);
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--dossier D] [--films N] [--utilisateurs N] [--logs N] [--graine S] [--zipf S]"
+                     " [--ordre trie|melange|presque-trie] [--desordre R] [--invalides R]\n";
+        return 1;
+    }
+
+    std::filesystem::create_directories(dossier);
+    GenerateurDonnees generateur(options);
+    bool succes = ecrireFichier(dossier / "films.txt", generateur, &GenerateurDonnees::ecrireFilms) &&
+                  ecrireFichier(dossier / "utilisateurs.txt", generateur, &GenerateurDonnees::ecrireUtilisateurs) &&
+                  ecrireFichier(dossier / "logs.txt", generateur, &GenerateurDonnees::ecrireLogs);
+    return succes ? 0 : 1;
+}
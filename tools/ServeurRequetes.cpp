@@ -0,0 +1,371 @@
+/// Serveur résident qui charge les données une seule fois et répond aux requêtes sur un socket Unix local.
+///
+/// Usage: ServeurRequetes [--socket chemin] [--dossier D] [--suivre] [--retention jours] [--quarantaine fichier]
+///   --socket      Chemin du socket à créer (défaut: /tmp/td5.sock)
+///   --dossier     Dossier contenant films.txt, utilisateurs.txt et logs.txt (défaut: .)
+///   --suivre      Applique aux statistiques les lignes ajoutées à logs.txt pendant que le serveur tourne
+///   --retention   Ne conserve que les lignes des derniers jours; les vues de tout l'historique restent comptées
+///   --quarantaine Conserve les lignes de logs.txt rejetées dans ce fichier, précédées de leur raison
+///
+/// Le protocole est décrit dans ProcesseurRequetes.h. Une seule boucle d'événements basée sur poll() sert tous les
+/// clients; les sockets sont non bloquants et chaque client conserve ses tampons de lecture et d'écriture, ce qui
+/// permet de servir des milliers de connexions simultanées sans thread par client. Les réponses en attente d'un client
+/// sont bornées: tant qu'il ne les a pas lues, ses requêtes suivantes ne sont ni lues ni traitées.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "AnalyseurLogs.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+#include "PipelineIngestion.h"
+#include "ProcesseurRequetes.h"
+#include "SuiviFichierLogs.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::size_t tailleLecture = 64 * 1024;
+    constexpr std::size_t tailleMaximaleRequete = 64 * 1024;
+    constexpr std::size_t tailleMaximaleSortie = 1024 * 1024; // Réponses en attente au-delà desquelles un client
+                                                              // n'est plus lu
+    constexpr std::chrono::milliseconds intervalleSondageSuivi(250); // Sans inotify, le fichier suivi est sondé
+
+    /// État d'une connexion: octets reçus pas encore traités et réponses pas encore envoyées.
+    struct Client
+    {
+        std::string entree;
+        std::string sortie;
+        std::size_t positionSortie = 0;
+        bool fermer = false;
+
+        /// \return True si le client a trop de réponses en attente pour que ses requêtes suivantes soient traitées.
+        bool estSature() const { return sortie.size() - positionSortie >= tailleMaximaleSortie; }
+    };
+
+    bool rendreNonBloquant(int descripteur)
+    {
+        int options = fcntl(descripteur, F_GETFL, 0);
+        return options != -1 && fcntl(descripteur, F_SETFL, options | O_NONBLOCK) != -1;
+    }
+
+    /// Relève la limite de descripteurs ouverts au maximum permis pour accepter des milliers de clients.
+    void releverLimiteDescripteurs()
+    {
+        rlimit limite;
+        if (getrlimit(RLIMIT_NOFILE, &limite) == 0)
+        {
+            limite.rlim_cur = limite.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limite);
+        }
+    }
+
+    /// Crée le socket d'écoute au chemin donné, en remplaçant un socket laissé par une exécution précédente.
+    /// \param chemin   Le chemin du socket.
+    /// \return         Le descripteur du socket, ou -1 en cas d'erreur.
+    int creerSocketEcoute(const std::string& chemin)
+    {
+        sockaddr_un adresse{};
+        if (chemin.size() >= sizeof(adresse.sun_path))
+        {
+            std::cerr << "Erreur ServeurRequetes: le chemin " << chemin << " est trop long\n";
+            return -1;
+        }
+        adresse.sun_family = AF_UNIX;
+        std::strncpy(adresse.sun_path, chemin.c_str(), sizeof(adresse.sun_path) - 1);
+
+        int descripteur = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (descripteur == -1)
+        {
+            return -1;
+        }
+        unlink(chemin.c_str());
+        if (bind(descripteur, reinterpret_cast<sockaddr*>(&adresse), sizeof(adresse)) == -1 ||
+            listen(descripteur, SOMAXCONN) == -1 || !rendreNonBloquant(descripteur))
+        {
+            std::cerr << "Erreur ServeurRequetes: " << std::strerror(errno) << '\n';
+            close(descripteur);
+            return -1;
+        }
+        return descripteur;
+    }
+
+    /// Traite les requêtes complètes reçues d'un client, jusqu'à ce que ses réponses en attente atteignent la limite.
+    /// \return True si au moins une requête a été traitée.
+    bool traiterRequetes(Client& client, ProcesseurRequetes& processeur)
+    {
+        if (client.estSature())
+        {
+            return false;
+        }
+        // Les réponses déjà envoyées sont retirées pour que la sortie ne contienne que celles en attente
+        client.sortie.erase(0, client.positionSortie);
+        client.positionSortie = 0;
+
+        std::size_t debut = 0;
+        std::size_t fin;
+        while (!client.estSature() && (fin = client.entree.find('\n', debut)) != std::string::npos)
+        {
+            processeur.traiter(client.entree.substr(debut, fin - debut), client.sortie);
+            debut = fin + 1;
+        }
+        client.entree.erase(0, debut);
+        return debut > 0;
+    }
+
+    /// Lit ce qui est disponible sur un client et traite chaque requête complète. La lecture s'arrête dès que le
+    /// client a trop de réponses en attente; le reste sera lu lorsqu'il les aura reçues.
+    /// \return False si la connexion doit être fermée.
+    bool lireClient(int descripteur, Client& client, ProcesseurRequetes& processeur)
+    {
+        char tampon[tailleLecture];
+        while (!client.fermer && !client.estSature())
+        {
+            ssize_t lus = read(descripteur, tampon, sizeof(tampon));
+            if (lus > 0)
+            {
+                client.entree.append(tampon, static_cast<std::size_t>(lus));
+                traiterRequetes(client, processeur);
+            }
+            else if (lus == 0)
+            {
+                client.fermer = true;
+                break;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            else if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        // Une requête incomplète trop longue ferme la connexion; des requêtes complètes en attente sont normales
+        return client.entree.size() <= tailleMaximaleRequete || client.entree.find('\n') != std::string::npos;
+    }
+
+    /// Envoie le plus possible des réponses en attente d'un client.
+    /// \return False si une erreur d'écriture impose de fermer la connexion.
+    bool ecrireClient(int descripteur, Client& client)
+    {
+        while (client.positionSortie < client.sortie.size())
+        {
+            ssize_t ecrits = write(descripteur,
+                                   client.sortie.data() + client.positionSortie,
+                                   client.sortie.size() - client.positionSortie);
+            if (ecrits > 0)
+            {
+                client.positionSortie += static_cast<std::size_t>(ecrits);
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            else if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        client.sortie.clear();
+        client.positionSortie = 0;
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string cheminSocket = "/tmp/td5.sock";
+    std::filesystem::path dossier = ".";
+    bool suivre = false;
+    std::optional<std::chrono::seconds> retention;
+    OptionsRejets optionsRejets;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--socket" && i + 1 < argc)
+        {
+            cheminSocket = argv[++i];
+        }
+        else if (argument == "--dossier" && i + 1 < argc)
+        {
+            dossier = argv[++i];
+        }
+        else if (argument == "--suivre")
+        {
+            suivre = true;
+        }
+        else if (argument == "--retention" && i + 1 < argc)
+        {
+            retention = std::chrono::hours(24 * std::stoll(argv[++i]));
+        }
+        else if (argument == "--quarantaine" && i + 1 < argc)
+        {
+            optionsRejets.fichierQuarantaine = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--socket chemin] [--dossier D] [--suivre] [--retention jours] [--quarantaine fichier]\n";
+            return 1;
+        }
+    }
+
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    AnalyseurLogs analyseurLogs;
+    analyseurLogs.definirRetention(retention);
+    gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string());
+    gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string());
+    std::unique_ptr<SuiviFichierLogs> suivi;
+    if (suivre)
+    {
+        // Le suivi charge lui-même le fichier existant, puis garde sa position pour les lignes ajoutées ensuite
+        suivi = std::make_unique<SuiviFichierLogs>(
+            analyseurLogs, gestionnaireUtilisateurs, gestionnaireFilms, (dossier / "logs.txt").string(), optionsRejets);
+        suivi->rattraper();
+    }
+    else
+    {
+        PipelineIngestion(analyseurLogs, gestionnaireUtilisateurs, gestionnaireFilms)
+            .chargerDepuisFichier((dossier / "logs.txt").string(), optionsRejets);
+    }
+    ProcesseurRequetes processeur(gestionnaireFilms, gestionnaireUtilisateurs, analyseurLogs);
+
+    std::signal(SIGPIPE, SIG_IGN);
+    releverLimiteDescripteurs();
+    int ecoute = creerSocketEcoute(cheminSocket);
+    if (ecoute == -1)
+    {
+        return 1;
+    }
+    std::cout << "En écoute sur " << cheminSocket << " (" << gestionnaireFilms.getNombreFilms() << " films, "
+              << gestionnaireUtilisateurs.getNombreUtilisateurs() << " utilisateurs)" << std::endl;
+
+    // descripteurs[0] est le socket d'écoute, descripteurs[1] le suivi du fichier de logs (ignoré par poll() s'il
+    // vaut -1) et descripteurs[i] correspond à clients[i - premierClient]
+    constexpr std::size_t premierClient = 2;
+    std::vector<pollfd> descripteurs = {pollfd{ecoute, POLLIN, 0},
+                                        pollfd{suivi ? suivi->getDescripteur() : -1, POLLIN, 0}};
+    std::vector<Client> clients;
+    // Sans descripteur à surveiller, le suivi est sondé à intervalles réguliers: poll() ne doit pas attendre plus
+    bool sonderSuivi = suivi && suivi->getDescripteur() == -1;
+    auto prochainSondage = std::chrono::steady_clock::now() + intervalleSondageSuivi;
+    while (true)
+    {
+        int delai = -1;
+        if (sonderSuivi)
+        {
+            auto restant = std::chrono::ceil<std::chrono::milliseconds>(prochainSondage -
+                                                                        std::chrono::steady_clock::now());
+            delai = static_cast<int>(std::max<std::chrono::milliseconds::rep>(restant.count(), 0));
+        }
+        if (poll(descripteurs.data(), static_cast<nfds_t>(descripteurs.size()), delai) == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Erreur ServeurRequetes: " << std::strerror(errno) << '\n';
+            break;
+        }
+
+        // Les nouvelles lignes sont appliquées avant de répondre aux requêtes reçues en même temps
+        if (descripteurs[1].revents & POLLIN)
+        {
+            suivi->rattraper();
+        }
+        else if (sonderSuivi && std::chrono::steady_clock::now() >= prochainSondage)
+        {
+            suivi->rattraper();
+            prochainSondage = std::chrono::steady_clock::now() + intervalleSondageSuivi;
+        }
+
+        for (std::size_t i = descripteurs.size() - 1; i >= premierClient; i--)
+        {
+            Client& client = clients[i - premierClient];
+            bool garder = true;
+            if (descripteurs[i].revents & (POLLIN | POLLHUP))
+            {
+                garder = lireClient(descripteurs[i].fd, client, processeur);
+            }
+            else if (descripteurs[i].revents & (POLLERR | POLLNVAL))
+            {
+                garder = false;
+            }
+            // Chaque envoi peut libérer assez de place pour traiter les requêtes reçues mais mises en attente
+            if (garder)
+            {
+                do
+                {
+                    garder = ecrireClient(descripteurs[i].fd, client);
+                } while (garder && traiterRequetes(client, processeur));
+            }
+            if (garder && client.fermer && client.sortie.empty())
+            {
+                garder = false;
+            }
+
+            if (!garder)
+            {
+                close(descripteurs[i].fd);
+                descripteurs[i] = descripteurs.back();
+                descripteurs.pop_back();
+                clients[i - premierClient] = std::move(clients.back());
+                clients.pop_back();
+            }
+            else
+            {
+                short evenements = client.sortie.empty() ? 0 : POLLOUT;
+                if (!client.fermer && !client.estSature())
+                {
+                    evenements |= POLLIN;
+                }
+                descripteurs[i].events = evenements;
+            }
+        }
+
+        if (descripteurs[0].revents & POLLIN)
+        {
+            int nouveau;
+            while ((nouveau = accept(ecoute, nullptr, nullptr)) != -1)
+            {
+                if (!rendreNonBloquant(nouveau))
+                {
+                    close(nouveau);
+                    continue;
+                }
+                descripteurs.push_back(pollfd{nouveau, POLLIN, 0});
+                clients.emplace_back();
+            }
+        }
+    }
+    close(ecoute);
+    unlink(cheminSocket.c_str());
+    return 1;
+}
+
+#else
+
+int main()
+{
+    std::cerr << "ServeurRequetes nécessite les sockets Unix (Linux ou macOS)\n";
+    return 1;
+}
+
+#endif
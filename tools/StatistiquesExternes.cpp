@@ -0,0 +1,86 @@
+/// Outil en ligne de commande qui calcule les statistiques d'un fichier de logs plus gros que la mémoire disponible.
+///
+/// Usage: StatistiquesExternes [options]
+///   --dossier D       Dossier contenant films.txt, utilisateurs.txt et logs.txt (défaut: .)
+///   --travail D       Dossier des fichiers temporaires (défaut: dossier temporaire du système)
+///   --budget N        Budget mémoire du tri et de la fusion, en Mio (défaut: 64)
+///   --top N           Nombre de films les plus populaires à afficher (défaut: 10)
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "AnalyseurLogsExterne.h"
+#include "GestionnaireFilms.h"
+#include "GestionnaireUtilisateurs.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::path dossier = ".";
+    std::filesystem::path dossierTravail = std::filesystem::temp_directory_path() / "td5_statistiques_externes";
+    std::size_t budgetMemoire = AnalyseurLogsExterne::budgetMemoireDefaut;
+    std::size_t nombreFilms = 10;
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument(argument);
+            }
+            std::string valeur = argv[++i];
+            if (argument == "--dossier")
+                dossier = valeur;
+            else if (argument == "--travail")
+                dossierTravail = valeur;
+            else if (argument == "--budget")
+                budgetMemoire = std::stoull(valeur) << 20;
+            else if (argument == "--top")
+                nombreFilms = std::stoull(valeur);
+            else
+                throw std::invalid_argument(argument);
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--dossier D] [--travail D] [--budget Mio] [--top N]\n";
+        return 1;
+    }
+
+    GestionnaireFilms gestionnaireFilms;
+    GestionnaireUtilisateurs gestionnaireUtilisateurs;
+    if (!gestionnaireFilms.chargerDepuisFichier((dossier / "films.txt").string()) ||
+        !gestionnaireUtilisateurs.chargerDepuisFichier((dossier / "utilisateurs.txt").string()))
+    {
+        return 1;
+    }
+
+    AnalyseurLogsExterne analyseurLogs(dossierTravail, budgetMemoire);
+    auto debut = std::chrono::steady_clock::now();
+    BilanChargement bilan =
+        analyseurLogs.chargerDepuisFichier((dossier / "logs.txt").string(), gestionnaireUtilisateurs, gestionnaireFilms);
+    double duree = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+    std::cout << analyseurLogs.getNombreLignes() << " lignes chargées (" << bilan.getNombreRejets()
+              << " rejetées) en " << duree << " s: "
+              << analyseurLogs.getNombreSequences() << " séquences, " << analyseurLogs.getNombrePassesFusion()
+              << " passes de fusion, " << analyseurLogs.getNombreSegments() << " segments\n"
+              << analyseurLogs.getUtilisationMemoire() << '\n';
+#if defined(__unix__) || defined(__APPLE__)
+    rusage utilisation{};
+    getrusage(RUSAGE_SELF, &utilisation);
+    std::cout << "mémoire résidente maximale: " << utilisation.ru_maxrss << " Kio\n";
+#endif
+
+    std::cout << "\nFilms les plus populaires:\n";
+    for (const auto& [film, vues] : analyseurLogs.getNFilmsPlusPopulaires(nombreFilms))
+    {
+        std::cout << "  " << vues << '\t' << film->nom << '\n';
+    }
+    return bilan ? 0 : 1;
+}